@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/flat_map.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+// Looking up random present keys, and summing every value in order, in mg::flat_map, std::map
+// and a sorted std::vector of pairs searched with std::lower_bound, at sizes from fitting in L1
+// to well beyond the last level cache.
+
+namespace
+{
+    struct fixture
+    {
+        explicit fixture(std::size_t p_count)
+        {
+            std::mt19937_64 rng(p_count);
+            while (keys.size() < p_count)
+            {
+                keys.push_back(static_cast<std::uint32_t>(rng()));
+            }
+
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+            for (int i = 0; i < 4096; ++i)
+            {
+                probes.push_back(keys[rng() % keys.size()]);
+            }
+        }
+
+        std::vector<std::uint32_t> keys;
+        std::vector<std::uint32_t> probes;
+    };
+
+    template <typename Lookup>
+    void lookup_batch(benchmark::State& state, const fixture& p_fixture, Lookup p_lookup)
+    {
+        for (auto _ : state)
+        {
+            std::uint64_t total = 0;
+            for (const auto probe : p_fixture.probes)
+            {
+                total += p_lookup(probe);
+            }
+
+            benchmark::DoNotOptimize(total);
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(p_fixture.probes.size()));
+    }
+
+    template <typename Container>
+    void iterate(benchmark::State& state, const Container& p_container)
+    {
+        for (auto _ : state)
+        {
+            std::uint64_t total = 0;
+            for (const auto& [key, value] : p_container)
+            {
+                total += value;
+            }
+
+            benchmark::DoNotOptimize(total);
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(p_container.size()));
+    }
+
+    mg::flat_map<std::uint32_t, std::uint32_t> make_flat_map(const fixture& p_fixture)
+    {
+        return mg::flat_map<std::uint32_t, std::uint32_t>(mg::sorted_unique, p_fixture.keys, p_fixture.keys);
+    }
+
+    std::map<std::uint32_t, std::uint32_t> make_map(const fixture& p_fixture)
+    {
+        std::map<std::uint32_t, std::uint32_t> map;
+        for (const auto key : p_fixture.keys)
+        {
+            map.emplace(key, key);
+        }
+
+        return map;
+    }
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> make_sorted_vector(const fixture& p_fixture)
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> sorted;
+        for (const auto key : p_fixture.keys)
+        {
+            sorted.emplace_back(key, key);
+        }
+
+        return sorted;
+    }
+}
+
+static void flat_map_find(benchmark::State& state)
+{
+    const fixture data(static_cast<std::size_t>(state.range(0)));
+    const auto map = make_flat_map(data);
+    lookup_batch(state, data, [&map](std::uint32_t p_key) { return map.find(p_key)->second; });
+}
+
+static void std_map_find(benchmark::State& state)
+{
+    const fixture data(static_cast<std::size_t>(state.range(0)));
+    const auto map = make_map(data);
+    lookup_batch(state, data, [&map](std::uint32_t p_key) { return map.find(p_key)->second; });
+}
+
+static void sorted_vector_lower_bound(benchmark::State& state)
+{
+    const fixture data(static_cast<std::size_t>(state.range(0)));
+    const auto sorted = make_sorted_vector(data);
+    lookup_batch(state, data, [&sorted](std::uint32_t p_key)
+    {
+        return std::lower_bound(sorted.begin(), sorted.end(), p_key, [](const auto& p_entry, std::uint32_t p_value) { return p_entry.first < p_value; })->second;
+    });
+}
+
+static void flat_map_iterate(benchmark::State& state)
+{
+    const fixture data(static_cast<std::size_t>(state.range(0)));
+    iterate(state, make_flat_map(data));
+}
+
+static void std_map_iterate(benchmark::State& state)
+{
+    const fixture data(static_cast<std::size_t>(state.range(0)));
+    iterate(state, make_map(data));
+}
+
+static void sorted_vector_iterate(benchmark::State& state)
+{
+    const fixture data(static_cast<std::size_t>(state.range(0)));
+    iterate(state, make_sorted_vector(data));
+}
+
+BENCHMARK(flat_map_find)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(std_map_find)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(sorted_vector_lower_bound)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(flat_map_iterate)->Arg(1 << 16);
+BENCHMARK(std_map_iterate)->Arg(1 << 16);
+BENCHMARK(sorted_vector_iterate)->Arg(1 << 16);
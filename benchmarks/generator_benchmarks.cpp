@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/generator.hpp>
+#include <mg/memory.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// The same three stage pipeline (squares of the odd numbers below state.range(0), summed in chunks
+// of 64) run by streaming generators and by materializing a vector per stage. Both allocate through
+// a counting allocator, so peak_bytes reports the memory each approach holds at once.
+
+namespace
+{
+    using stats = mg::allocation_stats<false>;
+
+    template <typename T>
+    using counted = mg::counting_allocator<std::allocator<T>, false>;
+
+    constexpr std::size_t ChunkSize = 64;
+
+    mg::generator<std::uint64_t> odd_squares(std::allocator_arg_t, counted<std::byte>, std::uint64_t p_count)
+    {
+        for (std::uint64_t i = 1; i < p_count; i += 2)
+        {
+            co_yield i * i;
+        }
+    }
+
+    mg::generator<std::uint64_t> chunk_sums(std::allocator_arg_t, counted<std::byte>, mg::generator<std::uint64_t> p_values)
+    {
+        std::array<std::uint64_t, ChunkSize> buffer;
+        std::size_t size = 0;
+        for (const auto value : p_values)
+        {
+            buffer[size++] = value;
+            if (size == ChunkSize)
+            {
+                std::uint64_t sum = 0;
+                for (const auto element : buffer)
+                {
+                    sum += element;
+                }
+
+                co_yield sum;
+                size = 0;
+            }
+        }
+    }
+
+    mg::generator<std::uint64_t> plain_odd_squares(std::uint64_t p_count)
+    {
+        for (std::uint64_t i = 1; i < p_count; i += 2)
+        {
+            co_yield i * i;
+        }
+    }
+}
+
+static void generator_pipeline(benchmark::State& state)
+{
+    const auto count = static_cast<std::uint64_t>(state.range(0));
+    stats allocations;
+    const counted<std::byte> allocator(allocations);
+    for (auto _ : state)
+    {
+        std::uint64_t total = 0;
+        for (const auto sum : chunk_sums(std::allocator_arg, allocator, odd_squares(std::allocator_arg, allocator, count)))
+        {
+            total += sum;
+        }
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.counters["peak_bytes"] = static_cast<double>(allocations.peak_bytes());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void generator_pipeline_chunk_adaptor(benchmark::State& state)
+{
+    // As above, with the library's streaming chunk adaptor in place of the hand written stage.
+    const auto count = static_cast<std::uint64_t>(state.range(0));
+    for (auto _ : state)
+    {
+        std::uint64_t total = 0;
+        for (const auto chunk : mg::generators::chunk<ChunkSize>(plain_odd_squares(count)))
+        {
+            if (chunk.size() == ChunkSize)
+            {
+                for (const auto element : chunk)
+                {
+                    total += element;
+                }
+            }
+        }
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void vector_pipeline(benchmark::State& state)
+{
+    const auto count = static_cast<std::uint64_t>(state.range(0));
+    stats allocations;
+    for (auto _ : state)
+    {
+        std::vector<std::uint64_t, counted<std::uint64_t>> squares{ counted<std::uint64_t>(allocations) };
+        for (std::uint64_t i = 1; i < count; i += 2)
+        {
+            squares.push_back(i * i);
+        }
+
+        std::vector<std::uint64_t, counted<std::uint64_t>> sums{ counted<std::uint64_t>(allocations) };
+        for (std::size_t i = 0; i + ChunkSize <= squares.size(); i += ChunkSize)
+        {
+            std::uint64_t sum = 0;
+            for (std::size_t j = i; j < i + ChunkSize; ++j)
+            {
+                sum += squares[j];
+            }
+
+            sums.push_back(sum);
+        }
+
+        std::uint64_t total = 0;
+        for (const auto sum : sums)
+        {
+            total += sum;
+        }
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.counters["peak_bytes"] = static_cast<double>(allocations.peak_bytes());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(generator_pipeline)->Range(1 << 10, 1 << 22);
+BENCHMARK(generator_pipeline_chunk_adaptor)->Range(1 << 10, 1 << 22);
+BENCHMARK(vector_pipeline)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/histogram.hpp>
+
+#include <cstdint>
+
+// Values cycle through a realistic latency range, so that recording touches many buckets rather
+// than a single hot cache line.
+
+static std::uint64_t next_latency(std::uint64_t& state)
+{
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return 1000 + (state >> 44);
+}
+
+static void histogram_record(benchmark::State& state)
+{
+    static mg::latency_histogram<> histogram;
+    std::uint64_t rng = static_cast<std::uint64_t>(state.thread_index());
+    for (auto _ : state)
+    {
+        histogram.record(next_latency(rng));
+    }
+}
+
+static void histogram_record_sharded(benchmark::State& state)
+{
+    static mg::sharded_latency_histogram<> histogram;
+    std::uint64_t rng = static_cast<std::uint64_t>(state.thread_index());
+    for (auto _ : state)
+    {
+        histogram.record(next_latency(rng));
+    }
+}
+
+static void histogram_record_same_value(benchmark::State& state)
+{
+    // The worst case for the shared histogram: every thread increments the same bucket.
+    static mg::latency_histogram<> histogram;
+    for (auto _ : state)
+    {
+        histogram.record(1234);
+    }
+}
+
+static void histogram_record_same_value_sharded(benchmark::State& state)
+{
+    static mg::sharded_latency_histogram<> histogram;
+    for (auto _ : state)
+    {
+        histogram.record(1234);
+    }
+}
+
+static void histogram_snapshot_and_reset(benchmark::State& state)
+{
+    mg::latency_histogram<> histogram;
+    std::uint64_t rng = 0;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int i = 0; i < 1000; ++i)
+        {
+            histogram.record(next_latency(rng));
+        }
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(histogram.snapshot_and_reset());
+    }
+}
+
+static void histogram_serialize(benchmark::State& state)
+{
+    mg::latency_snapshot<> snapshot;
+    std::uint64_t rng = 0;
+    for (int i = 0; i < 100'000; ++i)
+    {
+        snapshot.record(next_latency(rng));
+    }
+
+    for (auto _ : state)
+    {
+        auto bytes = snapshot.serialize();
+        benchmark::DoNotOptimize(bytes.data());
+        state.counters["bytes"] = static_cast<double>(bytes.size());
+    }
+}
+
+BENCHMARK(histogram_record)->ThreadRange(1, 64);
+BENCHMARK(histogram_record_sharded)->ThreadRange(1, 64);
+BENCHMARK(histogram_record_same_value)->ThreadRange(1, 64);
+BENCHMARK(histogram_record_same_value_sharded)->ThreadRange(1, 64);
+BENCHMARK(histogram_snapshot_and_reset);
+BENCHMARK(histogram_serialize);
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/hyperloglog.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+
+// Adding values and merging dense sketches, against counting exactly with std::unordered_set, and
+// the estimate itself, which reads every register.
+
+static void hyperloglog_add(benchmark::State& state)
+{
+    const auto count = static_cast<std::uint64_t>(state.range(0));
+    for (auto _ : state)
+    {
+        mg::hyperloglog<> sketch;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            sketch.add(i);
+        }
+
+        benchmark::DoNotOptimize(sketch.estimate());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void unordered_set_insert(benchmark::State& state)
+{
+    const auto count = static_cast<std::uint64_t>(state.range(0));
+    for (auto _ : state)
+    {
+        std::unordered_set<std::uint64_t> exact;
+        for (std::uint64_t i = 0; i < count; ++i)
+        {
+            exact.insert(i);
+        }
+
+        benchmark::DoNotOptimize(exact.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <unsigned Precision>
+static mg::hyperloglog<Precision> dense_sketch(std::uint64_t p_offset)
+{
+    mg::hyperloglog<Precision> sketch;
+    for (std::uint64_t i = 0; i < 8 * sketch.register_count; ++i)
+    {
+        sketch.add(i + p_offset);
+    }
+
+    return sketch;
+}
+
+template <unsigned Precision>
+static void hyperloglog_merge(benchmark::State& state)
+{
+    auto into = dense_sketch<Precision>(0);
+    const auto from = dense_sketch<Precision>(1'000'000'000);
+    for (auto _ : state)
+    {
+        into.merge(from);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(mg::hyperloglog<Precision>::register_count));
+}
+
+template <unsigned Precision>
+static void hyperloglog_estimate(benchmark::State& state)
+{
+    const auto sketch = dense_sketch<Precision>(0);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(sketch.estimate());
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(mg::hyperloglog<Precision>::register_count));
+}
+
+BENCHMARK(hyperloglog_add)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(unordered_set_insert)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(hyperloglog_merge<12>);
+BENCHMARK(hyperloglog_merge<14>);
+BENCHMARK(hyperloglog_merge<18>);
+BENCHMARK(hyperloglog_estimate<12>);
+BENCHMARK(hyperloglog_estimate<14>);
+BENCHMARK(hyperloglog_estimate<18>);
@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/collections.hpp>
+#include <mg/memory.hpp>
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    std::vector<int> make_values(benchmark::State& state)
+    {
+        std::vector<int> values(static_cast<std::size_t>(state.range(0)));
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }
+}
+
+static void all_unique_std_allocator(benchmark::State& state)
+{
+    const auto values = make_values(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::all_unique(values.begin(), values.end()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void all_unique_pmr_monotonic(benchmark::State& state)
+{
+    const auto values = make_values(state);
+    std::pmr::monotonic_buffer_resource resource;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::all_unique(
+            values.begin(), values.end(), std::hash<int>{}, std::equal_to<>{}, std::pmr::polymorphic_allocator<std::byte>(&resource)));
+        resource.release();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void all_unique_arena(benchmark::State& state)
+{
+    const auto values = make_values(state);
+    mg::arena arena;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::all_unique(
+            values.begin(), values.end(), std::hash<int>{}, std::equal_to<>{}, mg::arena_allocator<void>(arena)));
+        arena.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <bool PerThread>
+static void all_unique_pool(benchmark::State& state)
+{
+    const auto values = make_values(state);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::all_unique(
+            values.begin(), values.end(), std::hash<int>{}, std::equal_to<>{}, mg::pool_allocator<void, PerThread>{}));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename List>
+static void list_churn(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        List values;
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(i);
+        }
+
+        values.remove_if([](int p_value) { return p_value % 3 == 0; });
+        benchmark::DoNotOptimize(values.size());
+    }
+}
+
+static void list_churn_std_allocator(benchmark::State& state)
+{
+    list_churn<std::list<int>>(state);
+}
+
+static void list_churn_pmr_monotonic(benchmark::State& state)
+{
+    std::pmr::monotonic_buffer_resource resource;
+    for (auto _ : state)
+    {
+        std::pmr::list<int> values(&resource);
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(i);
+        }
+
+        values.remove_if([](int p_value) { return p_value % 3 == 0; });
+        benchmark::DoNotOptimize(values.size());
+        values.clear();
+        resource.release();
+    }
+}
+
+static void list_churn_arena(benchmark::State& state)
+{
+    mg::arena arena;
+    for (auto _ : state)
+    {
+        std::list<int, mg::arena_allocator<int>> values(arena);
+        for (int i = 0; i < 1000; ++i)
+        {
+            values.push_back(i);
+        }
+
+        values.remove_if([](int p_value) { return p_value % 3 == 0; });
+        benchmark::DoNotOptimize(values.size());
+        values.clear();
+        arena.reset();
+    }
+}
+
+static void list_churn_pool(benchmark::State& state)
+{
+    list_churn<std::list<int, mg::pool_allocator<int>>>(state);
+}
+
+static void list_churn_pool_per_thread(benchmark::State& state)
+{
+    list_churn<std::list<int, mg::pool_allocator<int, true>>>(state);
+}
+
+BENCHMARK(all_unique_std_allocator)->Range(16, 4096);
+BENCHMARK(all_unique_pmr_monotonic)->Range(16, 4096);
+BENCHMARK(all_unique_arena)->Range(16, 4096);
+BENCHMARK(all_unique_pool<false>)->Range(16, 4096);
+BENCHMARK(all_unique_pool<true>)->Range(16, 4096);
+BENCHMARK(list_churn_std_allocator);
+BENCHMARK(list_churn_pmr_monotonic);
+BENCHMARK(list_churn_arena);
+BENCHMARK(list_churn_pool);
+BENCHMARK(list_churn_pool_per_thread);
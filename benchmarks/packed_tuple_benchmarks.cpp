@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/packed_tuple.hpp>
+#include <mg/utility.hpp>
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    template <typename Record>
+    std::vector<Record> make_records(std::int64_t p_count)
+    {
+        std::vector<Record> records;
+        records.reserve(static_cast<std::size_t>(p_count));
+        for (std::int64_t i = 0; i < p_count; ++i)
+        {
+            records.emplace_back(static_cast<char>(i), static_cast<double>(i), static_cast<char>(i >> 8), static_cast<int>(i));
+        }
+
+        return records;
+    }
+
+    template <typename Record>
+    void scan(benchmark::State& state)
+    {
+        const auto records = make_records<Record>(state.range(0));
+        for (auto _ : state)
+        {
+            double sum = 0;
+            for (const auto& record : records)
+            {
+                sum += mg::get<1>{}(record) + mg::get<3>{}(record);
+            }
+
+            benchmark::DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(Record)));
+    }
+}
+
+static void scan_std_tuple(benchmark::State& state)
+{
+    scan<std::tuple<char, double, char, int>>(state);
+}
+
+static void scan_packed_tuple(benchmark::State& state)
+{
+    scan<mg::packed_tuple<char, double, char, int>>(state);
+}
+
+BENCHMARK(scan_std_tuple)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(scan_packed_tuple)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/parallel.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+// Summing the squares of 16M doubles with mg::transform_reduce in each summation mode, from the
+// calling thread alone (an argument of 0) up to 8 threads, against a sequential
+// std::transform_reduce. Every mg result is the same whatever the thread count.
+
+namespace
+{
+    const std::vector<double>& values()
+    {
+        static const auto result = []
+        {
+            std::vector<double> data(std::size_t(1) << 24);
+            for (std::size_t i = 0; i < data.size(); ++i)
+            {
+                data[i] = static_cast<double>(i % 1'000) * 0.001;
+            }
+
+            return data;
+        }();
+
+        return result;
+    }
+
+    template <mg::summation Mode>
+    void sum_squares(benchmark::State& state)
+    {
+        const auto threads = static_cast<std::size_t>(state.range(0));
+        const auto pool = threads == 0 ? nullptr : std::make_unique<mg::thread_pool>(threads);
+        const auto& data = values();
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(mg::transform_reduce<Mode>(pool.get(), data, 0.0, std::plus<>(), [](double p_value) { return p_value * p_value; }));
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+    }
+}
+
+static void std_transform_reduce(benchmark::State& state)
+{
+    const auto& data = values();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::transform_reduce(data.begin(), data.end(), 0.0, std::plus<>(), [](double p_value) { return p_value * p_value; }));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+}
+
+BENCHMARK(std_transform_reduce)->UseRealTime();
+BENCHMARK(sum_squares<mg::summation::blocked>)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK(sum_squares<mg::summation::pairwise>)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK(sum_squares<mg::summation::kahan>)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/per_thread.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Every thread increments a counter; the variants differ only in where the counters live.
+
+static void counter_shared_atomic(benchmark::State& state)
+{
+    static std::atomic<std::uint64_t> counter{ 0 };
+    for (auto _ : state)
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void counter_adjacent_atomics(benchmark::State& state)
+{
+    // One counter per thread, but packed together so that neighbours share cache lines.
+    static std::array<std::atomic<std::uint64_t>, 64> counters{};
+    auto& counter = counters[static_cast<std::size_t>(state.thread_index())];
+    for (auto _ : state)
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void counter_padded_atomics(benchmark::State& state)
+{
+    static std::array<mg::cache_padded<std::atomic<std::uint64_t>>, 64> counters{};
+    auto& counter = *counters[static_cast<std::size_t>(state.thread_index())];
+    for (auto _ : state)
+    {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static void counter_per_thread(benchmark::State& state)
+{
+    static mg::per_thread<std::uint64_t> counter;
+    for (auto _ : state)
+    {
+        ++counter.local();
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(counter_shared_atomic)->ThreadRange(1, 64);
+BENCHMARK(counter_adjacent_atomics)->ThreadRange(1, 64);
+BENCHMARK(counter_padded_atomics)->ThreadRange(1, 64);
+BENCHMARK(counter_per_thread)->ThreadRange(1, 64);
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/probe.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+// The probe types are used directly rather than through the macros, so that the overhead of an
+// enabled probe is measured regardless of MG_ENABLE_PROBES.
+
+static void probe_baseline(benchmark::State& state)
+{
+    std::uint64_t value = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(++value);
+    }
+}
+
+static void probe_counter_add(benchmark::State& state)
+{
+    static const mg::probe::counter counter("bench.counter");
+    for (auto _ : state)
+    {
+        counter.add();
+        benchmark::ClobberMemory();
+    }
+}
+
+static void probe_gauge_add(benchmark::State& state)
+{
+    static const mg::probe::gauge gauge("bench.gauge");
+    for (auto _ : state)
+    {
+        gauge.add(1);
+        benchmark::ClobberMemory();
+    }
+}
+
+static void probe_scoped_timer(benchmark::State& state)
+{
+    static const mg::probe::timer timer("bench.timer");
+    for (auto _ : state)
+    {
+        mg::probe::scoped_timer scope(timer);
+        benchmark::ClobberMemory();
+    }
+}
+
+static void probe_clock_ticks(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::probe::timer::now());
+    }
+}
+
+static void probe_clock_steady(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+    }
+}
+
+static void probe_counter_contended(benchmark::State& state)
+{
+    // Every thread updates the same counter, which only shares a name and not a cache line.
+    static const mg::probe::counter counter("bench.counter_contended");
+    for (auto _ : state)
+    {
+        counter.add();
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(probe_baseline);
+BENCHMARK(probe_counter_add);
+BENCHMARK(probe_gauge_add);
+BENCHMARK(probe_scoped_timer);
+BENCHMARK(probe_clock_ticks);
+BENCHMARK(probe_clock_steady);
+BENCHMARK(probe_counter_contended)->ThreadRange(1, 64);
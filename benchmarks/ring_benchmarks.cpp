@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/ring.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr std::uint64_t ItemCount = 1 << 18;
+}
+
+template <typename Wait>
+static void spsc_single(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        mg::spsc_ring<std::uint64_t, 1024, Wait> ring;
+        std::jthread producer([&]
+            {
+                for (std::uint64_t i = 0; i < ItemCount; ++i)
+                {
+                    ring.push(i);
+                }
+            });
+
+        std::uint64_t sum = 0;
+        for (std::uint64_t i = 0; i < ItemCount; ++i)
+        {
+            sum += ring.pop();
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ItemCount);
+}
+
+static void spsc_batched(benchmark::State& state)
+{
+    const auto batchSize = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        mg::spsc_ring<std::uint64_t, 1024, mg::yield_wait> ring;
+        std::jthread producer([&]
+            {
+                std::vector<std::uint64_t> batch(batchSize);
+                std::uint64_t next = 0;
+                while (next < ItemCount)
+                {
+                    const auto size = std::min<std::uint64_t>(batchSize, ItemCount - next);
+                    std::iota(batch.begin(), batch.begin() + size, next);
+                    const auto pushed = ring.try_push_n(batch.begin(), size);
+                    if (pushed == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    next += pushed;
+                }
+            });
+
+        std::vector<std::uint64_t> batch(batchSize);
+        std::uint64_t received = 0;
+        std::uint64_t sum = 0;
+        while (received < ItemCount)
+        {
+            const auto count = ring.try_pop_n(batch.begin(), batchSize);
+            if (count == 0)
+            {
+                std::this_thread::yield();
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                sum += batch[i];
+            }
+
+            received += count;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * ItemCount);
+}
+
+// Producers and consumers are given by the two arguments, each moving ItemCount items in total.
+template <typename Wait>
+static void mpmc_throughput(benchmark::State& state)
+{
+    const auto producers = static_cast<std::uint64_t>(state.range(0));
+    const auto consumers = static_cast<std::uint64_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        mg::mpmc_ring<std::uint64_t, 1024, Wait> ring;
+        std::vector<std::jthread> threads;
+        for (std::uint64_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&, p]
+                {
+                    for (auto i = p; i < ItemCount; i += producers)
+                    {
+                        ring.push(i);
+                    }
+                });
+        }
+
+        for (std::uint64_t c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&, c]
+                {
+                    std::uint64_t sum = 0;
+                    for (auto i = c; i < ItemCount; i += consumers)
+                    {
+                        sum += ring.pop();
+                    }
+
+                    benchmark::DoNotOptimize(sum);
+                });
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * ItemCount);
+}
+
+BENCHMARK(spsc_single<mg::busy_wait>)->UseRealTime();
+BENCHMARK(spsc_single<mg::yield_wait>)->UseRealTime();
+BENCHMARK(spsc_single<mg::blocking_wait>)->UseRealTime();
+BENCHMARK(spsc_batched)->RangeMultiplier(4)->Range(1, 256)->UseRealTime();
+BENCHMARK(mpmc_throughput<mg::yield_wait>)->ArgsProduct({ { 1, 2, 4, 8 }, { 1, 2, 4, 8 } })->UseRealTime();
+BENCHMARK(mpmc_throughput<mg::blocking_wait>)->ArgsProduct({ { 1, 4 }, { 1, 4 } })->UseRealTime();
@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/mapped_file.hpp>
+#include <mg/serialize.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Each benchmark serializes (or deserializes) state.range(0) rows into a heap buffer, or into
+// shared memory when state.range(1) is 1. Raw rows are copied whole, std::tuple rows (whose
+// libstdc++ layout is reversed) element by element, and columns are gathered per element.
+
+namespace
+{
+    using raw_row = std::pair<std::uint64_t, double>;
+    using tuple_row = std::tuple<std::uint64_t, double, std::uint32_t, std::uint16_t>;
+
+    class bench_buffer
+    {
+    public:
+        bench_buffer(std::size_t p_size, bool p_mapped)
+        {
+            if (p_mapped)
+            {
+                m_data = m_mapped.emplace(p_size).bytes();
+            }
+            else
+            {
+                m_heap.resize(p_size);
+                m_data = m_heap;
+            }
+        }
+
+        std::span<std::byte> span() const noexcept
+        {
+            return m_data;
+        }
+
+    private:
+        std::vector<std::byte> m_heap;
+        std::optional<mg::mapped_memory> m_mapped;
+        std::span<std::byte> m_data;
+    };
+
+    template <typename Row>
+    std::vector<Row> make_rows(std::int64_t p_count)
+    {
+        std::vector<Row> rows;
+        for (std::int64_t i = 0; i < p_count; ++i)
+        {
+            if constexpr (std::is_same_v<Row, raw_row>)
+            {
+                rows.emplace_back(static_cast<std::uint64_t>(i) * 7919, i * 0.5);
+            }
+            else
+            {
+                rows.emplace_back(static_cast<std::uint64_t>(i) * 7919, i * 0.5, static_cast<std::uint32_t>(i), static_cast<std::uint16_t>(i % 1000));
+            }
+        }
+
+        return rows;
+    }
+
+    template <typename Row, typename Format = mg::wire_format<>>
+    void serialize_rows(benchmark::State& state)
+    {
+        const auto rows = make_rows<Row>(state.range(0));
+        const bench_buffer buffer(mg::max_serialized_size<Format>(rows), state.range(1) != 0);
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(mg::serialize<Format>(rows, buffer.span()));
+            benchmark::ClobberMemory();
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(Row)));
+    }
+
+    template <typename Row, typename Format = mg::wire_format<>>
+    void deserialize_rows(benchmark::State& state)
+    {
+        const auto rows = make_rows<Row>(state.range(0));
+        const bench_buffer buffer(mg::max_serialized_size<Format>(rows), state.range(1) != 0);
+        const auto written = mg::serialize<Format>(rows, buffer.span());
+        for (auto _ : state)
+        {
+            std::span<const std::byte> in(buffer.span().data(), written);
+            benchmark::DoNotOptimize(mg::deserialize<std::vector<Row>, Format>(in));
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(Row)));
+    }
+}
+
+static void serialize_raw_rows(benchmark::State& state)
+{
+    serialize_rows<raw_row>(state);
+}
+
+static void serialize_tuple_rows(benchmark::State& state)
+{
+    serialize_rows<tuple_row>(state);
+}
+
+static void serialize_tuple_rows_varint(benchmark::State& state)
+{
+    serialize_rows<tuple_row, mg::varint_format>(state);
+}
+
+static void serialize_tuple_columns(benchmark::State& state)
+{
+    const auto rows = make_rows<tuple_row>(state.range(0));
+    const bench_buffer buffer(rows.size() * sizeof(tuple_row) + 64, state.range(1) != 0);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::serialize_columns(rows, buffer.span()));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(tuple_row)));
+}
+
+static void deserialize_raw_rows(benchmark::State& state)
+{
+    deserialize_rows<raw_row>(state);
+}
+
+static void deserialize_tuple_rows(benchmark::State& state)
+{
+    deserialize_rows<tuple_row>(state);
+}
+
+static void view_tuple_columns(benchmark::State& state)
+{
+    // Zero-copy: the columns are read where they lie.
+    const auto rows = make_rows<tuple_row>(state.range(0));
+    const bench_buffer buffer(rows.size() * sizeof(tuple_row) + 64, state.range(1) != 0);
+    const auto written = mg::serialize_columns(rows, buffer.span());
+    for (auto _ : state)
+    {
+        std::span<const std::byte> in(buffer.span().data(), written);
+        const auto [ids, values, counts, codes] = mg::view_columns<tuple_row>(in);
+        double total = 0;
+        for (const auto value : values)
+        {
+            total += value;
+        }
+
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(tuple_row)));
+}
+
+BENCHMARK(serialize_raw_rows)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } })->ArgNames({ "rows", "mapped" });
+BENCHMARK(serialize_tuple_rows)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } })->ArgNames({ "rows", "mapped" });
+BENCHMARK(serialize_tuple_rows_varint)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } })->ArgNames({ "rows", "mapped" });
+BENCHMARK(serialize_tuple_columns)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } })->ArgNames({ "rows", "mapped" });
+BENCHMARK(deserialize_raw_rows)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } })->ArgNames({ "rows", "mapped" });
+BENCHMARK(deserialize_tuple_rows)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } })->ArgNames({ "rows", "mapped" });
+BENCHMARK(view_tuple_columns)->ArgsProduct({ { 1 << 10, 1 << 16 }, { 0, 1 } })->ArgNames({ "rows", "mapped" });
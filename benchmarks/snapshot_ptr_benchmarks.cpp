@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/snapshot_ptr.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+// Every thread reads a field of the current configuration; the variants differ only in how the
+// configuration is shared. Thread 0 publishes a new version every 4096 reads, so that reclamation
+// is part of the measurement.
+
+namespace
+{
+    struct config
+    {
+        std::uint64_t limit;
+        std::uint64_t padding[7];
+    };
+
+    constexpr std::uint64_t publish_interval = 4096;
+}
+
+static void read_snapshot_ptr(benchmark::State& state)
+{
+    static mg::snapshot_ptr<config> current(std::make_unique<config>());
+    std::uint64_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(current.read()->limit);
+        if (state.thread_index() == 0 && ++i % publish_interval == 0)
+        {
+            current.emplace(config{ i, {} });
+        }
+    }
+}
+
+static void read_atomic_shared_ptr(benchmark::State& state)
+{
+    static std::atomic<std::shared_ptr<const config>> current(std::make_shared<const config>());
+    std::uint64_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(current.load()->limit);
+        if (state.thread_index() == 0 && ++i % publish_interval == 0)
+        {
+            current.store(std::make_shared<const config>(config{ i, {} }));
+        }
+    }
+}
+
+static void read_shared_mutex(benchmark::State& state)
+{
+    static std::shared_mutex mutex;
+    static std::shared_ptr<const config> current = std::make_shared<const config>();
+    std::uint64_t i = 0;
+    for (auto _ : state)
+    {
+        {
+            std::shared_lock lock(mutex);
+            benchmark::DoNotOptimize(current->limit);
+        }
+
+        if (state.thread_index() == 0 && ++i % publish_interval == 0)
+        {
+            auto next = std::make_shared<const config>(config{ i, {} });
+            std::unique_lock lock(mutex);
+            current = std::move(next);
+        }
+    }
+}
+
+BENCHMARK(read_snapshot_ptr)->ThreadRange(1, 64);
+BENCHMARK(read_atomic_shared_ptr)->ThreadRange(1, 64);
+BENCHMARK(read_shared_mutex)->ThreadRange(1, 64);
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/collections.hpp>
+#include <mg/soa_vector.hpp>
+
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    using Record = std::tuple<std::int64_t, double, char, std::int32_t>;
+
+    Record make_record(std::int64_t p_idx)
+    {
+        return { p_idx, static_cast<double>(p_idx) * 0.5, static_cast<char>(p_idx), static_cast<std::int32_t>(p_idx * 3) };
+    }
+
+    std::vector<Record> make_aos(std::int64_t p_count)
+    {
+        std::vector<Record> records;
+        records.reserve(static_cast<std::size_t>(p_count));
+        for (std::int64_t i = 0; i < p_count; ++i)
+        {
+            records.push_back(make_record(i));
+        }
+
+        return records;
+    }
+
+    mg::soa_vector<std::int64_t, double, char, std::int32_t> make_soa(std::int64_t p_count)
+    {
+        mg::soa_vector<std::int64_t, double, char, std::int32_t> records;
+        records.reserve(static_cast<std::size_t>(p_count));
+        for (std::int64_t i = 0; i < p_count; ++i)
+        {
+            records.push_back(make_record(i));
+        }
+
+        return records;
+    }
+}
+
+static void scan_one_field_aos(benchmark::State& state)
+{
+    const auto records = make_aos(state.range(0));
+    for (auto _ : state)
+    {
+        double sum = 0;
+        for (const auto& record : records)
+        {
+            sum += std::get<1>(record);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void scan_one_field_soa(benchmark::State& state)
+{
+    const auto records = make_soa(state.range(0));
+    for (auto _ : state)
+    {
+        double sum = 0;
+        for (double value : records.column<1>())
+        {
+            sum += value;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void scan_two_fields_aos(benchmark::State& state)
+{
+    const auto records = make_aos(state.range(0));
+    for (auto _ : state)
+    {
+        std::int64_t sum = 0;
+        for (const auto& record : records)
+        {
+            sum += std::get<0>(record) * std::get<3>(record);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void scan_two_fields_soa(benchmark::State& state)
+{
+    const auto records = make_soa(state.range(0));
+    for (auto _ : state)
+    {
+        std::int64_t sum = 0;
+        mg::iter_zipped_ranges(
+            [&](std::int64_t p_id, std::int32_t p_weight) { sum += p_id * p_weight; },
+            records.column<0>(), records.column<3>());
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(scan_one_field_aos)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(scan_one_field_soa)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(scan_two_fields_aos)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(scan_two_fields_soa)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
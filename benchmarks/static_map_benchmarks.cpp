@@ -0,0 +1,186 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/static_map.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Each iteration looks up a batch of pseudo-random keys (including misses for the string keys),
+// comparing mg::static_map against std::unordered_map, a switch and std::lower_bound.
+
+namespace
+{
+    enum class opcode : std::uint8_t
+    {
+        nop, load, store, add, sub, mul, div, mod,
+        band, bor, bxor, shl, shr, jump, call, ret
+    };
+
+    constexpr std::array<std::pair<opcode, int>, 16> opcode_costs{ {
+        { opcode::nop, 1 }, { opcode::load, 4 }, { opcode::store, 4 }, { opcode::add, 1 },
+        { opcode::sub, 1 }, { opcode::mul, 3 }, { opcode::div, 20 }, { opcode::mod, 22 },
+        { opcode::band, 1 }, { opcode::bor, 1 }, { opcode::bxor, 1 }, { opcode::shl, 1 },
+        { opcode::shr, 1 }, { opcode::jump, 2 }, { opcode::call, 5 }, { opcode::ret, 5 } } };
+
+    constexpr std::array<std::pair<std::string_view, int>, 32> keyword_ids{ {
+        { "alignas", 0 }, { "alignof", 1 }, { "auto", 2 }, { "bool", 3 }, { "break", 4 }, { "case", 5 },
+        { "catch", 6 }, { "char", 7 }, { "class", 8 }, { "concept", 9 }, { "const", 10 }, { "constexpr", 11 },
+        { "continue", 12 }, { "decltype", 13 }, { "default", 14 }, { "delete", 15 }, { "double", 16 },
+        { "else", 17 }, { "enum", 18 }, { "explicit", 19 }, { "extern", 20 }, { "float", 21 }, { "for", 22 },
+        { "friend", 23 }, { "if", 24 }, { "inline", 25 }, { "int", 26 }, { "namespace", 27 }, { "return", 28 },
+        { "struct", 29 }, { "template", 30 }, { "while", 31 } } };
+
+    constexpr mg::static_map<opcode, int, 16> opcode_map(opcode_costs);
+    constexpr mg::static_map<std::string_view, int, 32> keyword_map(keyword_ids);
+
+    int switch_cost(opcode p_op)
+    {
+        switch (p_op)
+        {
+        case opcode::nop: return 1;
+        case opcode::load: return 4;
+        case opcode::store: return 4;
+        case opcode::add: return 1;
+        case opcode::sub: return 1;
+        case opcode::mul: return 3;
+        case opcode::div: return 20;
+        case opcode::mod: return 22;
+        case opcode::band: return 1;
+        case opcode::bor: return 1;
+        case opcode::bxor: return 1;
+        case opcode::shl: return 1;
+        case opcode::shr: return 1;
+        case opcode::jump: return 2;
+        case opcode::call: return 5;
+        case opcode::ret: return 5;
+        }
+
+        return 0;
+    }
+
+    std::uint64_t next_random(std::uint64_t& state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state >> 33;
+    }
+
+    std::vector<opcode> make_opcodes()
+    {
+        std::uint64_t rng = 0;
+        std::vector<opcode> ops(1024);
+        for (auto& op : ops)
+        {
+            op = static_cast<opcode>(next_random(rng) % opcode_costs.size());
+        }
+
+        return ops;
+    }
+
+    std::vector<std::string_view> make_words()
+    {
+        // One in four lookups misses.
+        constexpr std::array<std::string_view, 4> misses{ "x", "value", "constinit", "wchar_t" };
+        std::uint64_t rng = 0;
+        std::vector<std::string_view> words(1024);
+        for (auto& word : words)
+        {
+            const auto pick = next_random(rng);
+            word = pick % 4 == 0 ? misses[(pick >> 2) % misses.size()] : keyword_ids[(pick >> 2) % keyword_ids.size()].first;
+        }
+
+        return words;
+    }
+
+    template <typename Lookup>
+    void lookup_batch(benchmark::State& state, const auto& p_keys, Lookup p_lookup)
+    {
+        for (auto _ : state)
+        {
+            int total = 0;
+            for (const auto& key : p_keys)
+            {
+                total += p_lookup(key);
+            }
+
+            benchmark::DoNotOptimize(total);
+        }
+
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(p_keys.size()));
+    }
+
+    template <typename Key>
+    std::vector<std::pair<Key, int>> sorted(const auto& p_entries)
+    {
+        std::vector<std::pair<Key, int>> result(p_entries.begin(), p_entries.end());
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    template <typename Key>
+    int sorted_lookup(const std::vector<std::pair<Key, int>>& p_sorted, const Key& p_key)
+    {
+        const auto found = std::lower_bound(p_sorted.begin(), p_sorted.end(), p_key, [](const auto& p_entry, const Key& p_value) { return p_entry.first < p_value; });
+        return found != p_sorted.end() && found->first == p_key ? found->second : -1;
+    }
+}
+
+static void opcode_static_map(benchmark::State& state)
+{
+    lookup_batch(state, make_opcodes(), [](opcode p_op) { return *opcode_map.find(p_op); });
+}
+
+static void opcode_unordered_map(benchmark::State& state)
+{
+    const std::unordered_map<opcode, int> map(opcode_costs.begin(), opcode_costs.end());
+    lookup_batch(state, make_opcodes(), [&map](opcode p_op) { return map.find(p_op)->second; });
+}
+
+static void opcode_switch(benchmark::State& state)
+{
+    lookup_batch(state, make_opcodes(), [](opcode p_op) { return switch_cost(p_op); });
+}
+
+static void opcode_lower_bound(benchmark::State& state)
+{
+    const auto entries = sorted<opcode>(opcode_costs);
+    lookup_batch(state, make_opcodes(), [&entries](opcode p_op) { return sorted_lookup(entries, p_op); });
+}
+
+static void keyword_static_map(benchmark::State& state)
+{
+    lookup_batch(state, make_words(), [](std::string_view p_word)
+        {
+            const auto* found = keyword_map.find(p_word);
+            return found != nullptr ? *found : -1;
+        });
+}
+
+static void keyword_unordered_map(benchmark::State& state)
+{
+    const std::unordered_map<std::string_view, int> map(keyword_ids.begin(), keyword_ids.end());
+    lookup_batch(state, make_words(), [&map](std::string_view p_word)
+        {
+            const auto found = map.find(p_word);
+            return found != map.end() ? found->second : -1;
+        });
+}
+
+static void keyword_lower_bound(benchmark::State& state)
+{
+    const auto entries = sorted<std::string_view>(keyword_ids);
+    lookup_batch(state, make_words(), [&entries](std::string_view p_word) { return sorted_lookup(entries, p_word); });
+}
+
+BENCHMARK(opcode_static_map);
+BENCHMARK(opcode_unordered_map);
+BENCHMARK(opcode_switch);
+BENCHMARK(opcode_lower_bound);
+BENCHMARK(keyword_static_map);
+BENCHMARK(keyword_unordered_map);
+BENCHMARK(keyword_lower_bound);
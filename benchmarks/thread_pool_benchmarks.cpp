@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/thread_pool.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+static void task_throughput_external(benchmark::State& state)
+{
+    mg::thread_pool pool(static_cast<std::size_t>(state.range(0)));
+    constexpr int TaskCount = 10000;
+
+    std::vector<mg::future<int>> futures;
+    futures.reserve(TaskCount);
+    for (auto _ : state)
+    {
+        for (int i = 0; i < TaskCount; ++i)
+        {
+            futures.push_back(pool.submit([i] { return i; }));
+        }
+
+        for (auto& f : futures)
+        {
+            benchmark::DoNotOptimize(f.get());
+        }
+
+        futures.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * TaskCount);
+}
+
+static void task_throughput_from_worker(benchmark::State& state)
+{
+    mg::thread_pool pool(static_cast<std::size_t>(state.range(0)));
+    constexpr int TaskCount = 10000;
+
+    for (auto _ : state)
+    {
+        // Spawning from inside the pool uses the workers' own deques rather than the injection queue.
+        pool.submit([&pool]
+            {
+                std::atomic<int> remaining{ TaskCount };
+                for (int i = 0; i < TaskCount; ++i)
+                {
+                    pool.submit([&remaining] { remaining.fetch_sub(1, std::memory_order_relaxed); });
+                }
+
+                while (remaining.load(std::memory_order_relaxed) != 0)
+                {
+                    pool.submit([] {}).get();
+                }
+            }).get();
+    }
+
+    state.SetItemsProcessed(state.iterations() * TaskCount);
+}
+
+static void fork_join_latency(benchmark::State& state)
+{
+    mg::thread_pool pool(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::uint64_t> values(1024, 1);
+
+    for (auto _ : state)
+    {
+        pool.parallel_for(values, 16, [](std::uint64_t& value) { value = value * 3 + 1; });
+        benchmark::ClobberMemory();
+    }
+}
+
+BENCHMARK(task_throughput_external)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK(task_throughput_from_worker)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+BENCHMARK(fork_join_latency)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
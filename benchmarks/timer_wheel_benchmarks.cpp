@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/timer_wheel.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+// Each iteration schedules a timer with a pseudo-random delay into a wheel already holding
+// state.range(0) timers and cancels (or expires) one, comparing against a binary heap.
+
+namespace
+{
+    struct bench_clock
+    {
+        using duration = std::chrono::milliseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<bench_clock, duration>;
+
+        time_point now() const
+        {
+            return *m_now;
+        }
+
+        std::shared_ptr<time_point> m_now = std::make_shared<time_point>();
+    };
+
+    std::int64_t next_delay(std::uint64_t& state)
+    {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<std::int64_t>((state >> 33) % 60'000);
+    }
+}
+
+static void timer_wheel_schedule_cancel(benchmark::State& state)
+{
+    const bench_clock clock;
+    mg::timer_wheel<bench_clock> timers(nullptr, std::chrono::milliseconds(1), clock);
+
+    std::uint64_t rng = 0;
+    std::vector<mg::timer_handle> handles;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        handles.push_back(timers.schedule_after(std::chrono::milliseconds(next_delay(rng)), [] {}));
+    }
+
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        timers.cancel(handles[next]);
+        handles[next] = timers.schedule_after(std::chrono::milliseconds(next_delay(rng)), [] {});
+        next = next + 1 == handles.size() ? 0 : next + 1;
+    }
+}
+
+static void timer_wheel_schedule_expire(benchmark::State& state)
+{
+    const bench_clock clock;
+    mg::timer_wheel<bench_clock> timers(nullptr, std::chrono::milliseconds(1), clock);
+
+    std::uint64_t rng = 0;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        timers.schedule_after(std::chrono::milliseconds(next_delay(rng)), [] {});
+    }
+
+    for (auto _ : state)
+    {
+        // Advance a millisecond at a time, keeping the population steady.
+        timers.schedule_after(std::chrono::milliseconds(next_delay(rng)), [] {});
+        *clock.m_now += std::chrono::milliseconds(1);
+        benchmark::DoNotOptimize(timers.poll());
+    }
+}
+
+static void priority_queue_schedule_expire(benchmark::State& state)
+{
+    using entry = std::pair<std::int64_t, std::function<void()>>;
+    const auto later = [](const entry& p_left, const entry& p_right) { return p_left.first > p_right.first; };
+    std::priority_queue<entry, std::vector<entry>, decltype(later)> timers(later);
+
+    std::uint64_t rng = 0;
+    std::int64_t now = 0;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        timers.emplace(next_delay(rng), [] {});
+    }
+
+    for (auto _ : state)
+    {
+        timers.emplace(now + next_delay(rng), [] {});
+        ++now;
+        while (!timers.empty() && timers.top().first <= now)
+        {
+            timers.top().second();
+            timers.pop();
+        }
+    }
+}
+
+BENCHMARK(timer_wheel_schedule_cancel)->Range(1 << 10, 1 << 20);
+BENCHMARK(timer_wheel_schedule_expire)->Range(1 << 10, 1 << 20);
+BENCHMARK(priority_queue_schedule_expire)->Range(1 << 10, 1 << 20);
@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/trace.hpp>
+
+#include <chrono>
+#include <filesystem>
+
+// The zone type is used directly rather than through the macro, so that the overhead is measured
+// regardless of MG_ENABLE_TRACING.
+
+static void trace_zone_inactive(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        mg::trace::zone zone("bench.inactive");
+        benchmark::ClobberMemory();
+    }
+}
+
+static void trace_zone_active(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        mg::trace::start(std::filesystem::temp_directory_path() / "mg_trace_benchmarks.json", std::chrono::milliseconds(10));
+    }
+
+    for (auto _ : state)
+    {
+        mg::trace::zone zone("bench.active");
+        benchmark::ClobberMemory();
+    }
+
+    if (state.thread_index() == 0)
+    {
+        mg::trace::stop();
+    }
+}
+
+BENCHMARK(trace_zone_inactive);
+BENCHMARK(trace_zone_active)->ThreadRange(1, 8);
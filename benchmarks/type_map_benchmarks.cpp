@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/type_map.hpp>
+
+#include <any>
+#include <cstdint>
+#include <typeindex>
+#include <utility>
+#include <unordered_map>
+
+// Each iteration reads and updates the value of every one of eight types, through mg::type_map,
+// mg::concurrent_type_map, and the usual std::unordered_map<std::type_index, std::any>.
+
+namespace
+{
+    template <int Tag>
+    struct counter
+    {
+        std::uint64_t count = 0;
+    };
+
+    template <typename Map>
+    void touch_all(Map& p_map)
+    {
+        [&]<int... Tags>(std::integer_sequence<int, Tags...>)
+        {
+            (++p_map.template get<counter<Tags>>().count, ...);
+        }(std::make_integer_sequence<int, 8>{});
+    }
+
+    class any_map
+    {
+    public:
+        template <typename T>
+        T& get()
+        {
+            auto& value = m_values[std::type_index(typeid(T))];
+            if (!value.has_value())
+            {
+                value.template emplace<T>();
+            }
+
+            return *std::any_cast<T>(&value);
+        }
+
+    private:
+        std::unordered_map<std::type_index, std::any> m_values;
+    };
+}
+
+static void type_map_get(benchmark::State& state)
+{
+    mg::type_map<counter<0>, counter<1>, counter<2>, counter<3>, counter<4>, counter<5>, counter<6>, counter<7>> map;
+    for (auto _ : state)
+    {
+        touch_all(map);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 8);
+}
+
+static void concurrent_type_map_get(benchmark::State& state)
+{
+    mg::concurrent_type_map<counter<0>, counter<1>, counter<2>, counter<3>, counter<4>, counter<5>, counter<6>, counter<7>> map;
+    for (auto _ : state)
+    {
+        touch_all(map);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 8);
+}
+
+static void type_index_any_get(benchmark::State& state)
+{
+    any_map map;
+    for (auto _ : state)
+    {
+        touch_all(map);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * 8);
+}
+
+BENCHMARK(type_map_get);
+BENCHMARK(concurrent_type_map_get);
+BENCHMARK(type_index_any_get);
@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/views.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+    std::vector<float> make_values(std::int64_t p_count)
+    {
+        std::vector<float> values(static_cast<std::size_t>(p_count));
+        std::iota(values.begin(), values.end(), 0.0f);
+        return values;
+    }
+}
+
+static void dot_product_indexed(benchmark::State& state)
+{
+    const auto lhs = make_values(state.range(0));
+    const auto rhs = make_values(state.range(0));
+    for (auto _ : state)
+    {
+        float sum = 0;
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+        {
+            sum += lhs[i] * rhs[i];
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void dot_product_zip(benchmark::State& state)
+{
+    const auto lhs = make_values(state.range(0));
+    const auto rhs = make_values(state.range(0));
+    for (auto _ : state)
+    {
+        float sum = 0;
+        for (auto [l, r] : mg::views::zip(lhs, rhs))
+        {
+            sum += l * r;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void sum_plain(benchmark::State& state)
+{
+    const auto values = make_values(state.range(0));
+    for (auto _ : state)
+    {
+        float sum = 0;
+        for (float value : values)
+        {
+            sum += value;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void sum_chunked(benchmark::State& state)
+{
+    const auto values = make_values(state.range(0));
+    for (auto _ : state)
+    {
+        // Independent lanes per chunk position let the compiler vectorize without reassociating.
+        float lanes[8]{};
+        auto chunks = mg::views::chunk<8>(values);
+        for (auto chunk : chunks)
+        {
+            for (std::size_t i = 0; i < chunk.size(); ++i)
+            {
+                lanes[i] += chunk[i];
+            }
+        }
+
+        float sum = std::accumulate(std::begin(lanes), std::end(lanes), 0.0f);
+        for (float value : chunks.remainder())
+        {
+            sum += value;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(dot_product_indexed)->Range(1 << 10, 1 << 20);
+BENCHMARK(dot_product_zip)->Range(1 << 10, 1 << 20);
+BENCHMARK(sum_plain)->Range(1 << 10, 1 << 20);
+BENCHMARK(sum_chunked)->Range(1 << 10, 1 << 20);
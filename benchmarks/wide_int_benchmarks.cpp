@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include <mg/math.hpp>
+#include <mg/wide_int.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#if defined(MG_BENCH_GMP)
+#include <gmpxx.h>
+#endif
+
+// Fixed width integers against a heap allocating arbitrary precision library (GMP, when the
+// benchmarks are configured with it), raising to powers and modular exponentiation at the widths
+// of common cryptographic moduli.
+
+namespace
+{
+    template <typename T>
+    T random_value(std::uint64_t p_seed, std::size_t p_bits)
+    {
+        std::mt19937_64 random(p_seed);
+        std::array<std::uint64_t, T::limb_count> limbs{};
+        for (std::size_t i = 0; i < p_bits / 64; ++i)
+        {
+            limbs[i] = random();
+        }
+
+        // Full width and odd, as moduli are.
+        limbs[p_bits / 64 - 1] |= std::uint64_t(1) << 63;
+        limbs[0] |= 1;
+        return T::from_limbs(limbs);
+    }
+
+#if defined(MG_BENCH_GMP)
+    template <typename T>
+    mpz_class to_mpz(const T& p_value)
+    {
+        return mpz_class(mg::to_string(p_value));
+    }
+#endif
+}
+
+template <std::size_t Bits>
+static void pow_wide_uint(benchmark::State& state)
+{
+    using type = mg::wide_uint<Bits>;
+    // The largest power of 3 which fits.
+    const type power(static_cast<std::uint64_t>((Bits - 1) * 100 / 159));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::whole_pow(type(3), power));
+    }
+}
+
+template <std::size_t Bits>
+static void mul_wide_uint(benchmark::State& state)
+{
+    using type = mg::wide_uint<Bits>;
+    auto lhs = random_value<type>(1, Bits);
+    const auto rhs = random_value<type>(2, Bits);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(lhs);
+        benchmark::DoNotOptimize(lhs * rhs);
+    }
+}
+
+template <std::size_t Bits>
+static void mod_pow_wide_uint(benchmark::State& state)
+{
+    using type = mg::wide_uint<Bits>;
+    const auto base = random_value<type>(1, Bits) >> 1;
+    const auto power = random_value<type>(2, Bits);
+    const auto modulus = random_value<type>(3, Bits);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(mg::mod_pow(base, power, modulus));
+    }
+}
+
+BENCHMARK(pow_wide_uint<256>);
+BENCHMARK(pow_wide_uint<1024>);
+BENCHMARK(pow_wide_uint<4096>);
+BENCHMARK(mul_wide_uint<256>);
+BENCHMARK(mul_wide_uint<1024>);
+BENCHMARK(mul_wide_uint<4096>);
+BENCHMARK(mod_pow_wide_uint<256>);
+BENCHMARK(mod_pow_wide_uint<1024>);
+BENCHMARK(mod_pow_wide_uint<2048>);
+
+#if defined(MG_BENCH_GMP)
+template <std::size_t Bits>
+static void pow_gmp(benchmark::State& state)
+{
+    const auto power = static_cast<unsigned long>((Bits - 1) * 100 / 159);
+    for (auto _ : state)
+    {
+        // A fresh result each time, as an expression would produce.
+        mpz_class value;
+        mpz_ui_pow_ui(value.get_mpz_t(), 3, power);
+        benchmark::DoNotOptimize(value.get_mpz_t());
+    }
+}
+
+template <std::size_t Bits>
+static void mul_gmp(benchmark::State& state)
+{
+    using type = mg::wide_uint<Bits>;
+    const auto lhs = to_mpz(random_value<type>(1, Bits));
+    const auto rhs = to_mpz(random_value<type>(2, Bits));
+    for (auto _ : state)
+    {
+        mpz_class product = lhs * rhs;
+        benchmark::DoNotOptimize(product.get_mpz_t());
+    }
+}
+
+template <std::size_t Bits>
+static void mod_pow_gmp(benchmark::State& state)
+{
+    using type = mg::wide_uint<Bits>;
+    const auto base = to_mpz(random_value<type>(1, Bits) >> 1);
+    const auto power = to_mpz(random_value<type>(2, Bits));
+    const auto modulus = to_mpz(random_value<type>(3, Bits));
+    for (auto _ : state)
+    {
+        mpz_class result;
+        mpz_powm(result.get_mpz_t(), base.get_mpz_t(), power.get_mpz_t(), modulus.get_mpz_t());
+        benchmark::DoNotOptimize(result.get_mpz_t());
+    }
+}
+
+BENCHMARK(pow_gmp<256>);
+BENCHMARK(pow_gmp<1024>);
+BENCHMARK(pow_gmp<4096>);
+BENCHMARK(mul_gmp<256>);
+BENCHMARK(mul_gmp<1024>);
+BENCHMARK(mul_gmp<4096>);
+BENCHMARK(mod_pow_gmp<256>);
+BENCHMARK(mod_pow_gmp<1024>);
+BENCHMARK(mod_pow_gmp<2048>);
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "detail/alloc_guard.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+
+namespace mg
+{
+    /// <summary>
+    /// Asserts that a scope performs no more than a given number of heap allocations on the current
+    /// thread (zero by default). Allocations are observed through global operator new, so the program
+    /// must expand MG_DEFINE_ALLOC_HOOKS in exactly one translation unit; without it every guard would
+    /// trivially pass, so constructing one then reports a violation instead.
+    /// </summary>
+    /// <remarks>Only allocations made by the thread which created the guard are counted, so work done
+    /// concurrently elsewhere (such as by thread_pool workers) does not affect it.</remarks>
+    /// <remarks>When the guard is destroyed with the budget exceeded, the violation handler is called.
+    /// The default handler reports to stderr and aborts; a test binary would install one that fails
+    /// the current test instead.</remarks>
+    /// <example>
+    /// <code>
+    /// {
+    ///     mg::alloc_guard guard;
+    ///     hot_path();
+    /// } // Fails if hot_path allocated.
+    /// </code>
+    /// </example>
+    class alloc_guard
+    {
+    public:
+        using violation_handler = detail::alloc_violation_handler;
+
+        /// <summary>
+        /// Passed to the violation handler in place of the count when the hooks are not installed.
+        /// </summary>
+        static constexpr std::size_t unknown_allocations = detail::unknown_allocations;
+
+        explicit alloc_guard(std::size_t p_budget = 0) noexcept
+            : m_start(detail::thread_allocation_count()),
+            m_budget(p_budget)
+        {
+            if (!hooks_installed())
+            {
+                detail::alloc_violation().load()(detail::unknown_allocations, p_budget);
+            }
+        }
+
+        alloc_guard(const alloc_guard&) = delete;
+        alloc_guard& operator=(const alloc_guard&) = delete;
+
+        ~alloc_guard()
+        {
+            const auto count = allocations();
+            if (count > m_budget)
+            {
+                detail::alloc_violation().load()(count, m_budget);
+            }
+        }
+
+        /// <summary>
+        /// The number of allocations made by this thread since the guard was created.
+        /// </summary>
+        std::size_t allocations() const noexcept
+        {
+            return detail::thread_allocation_count() - m_start;
+        }
+
+        std::size_t budget() const noexcept
+        {
+            return m_budget;
+        }
+
+        /// <summary>
+        /// Whether MG_DEFINE_ALLOC_HOOKS is in effect for the program.
+        /// </summary>
+        static bool hooks_installed() noexcept
+        {
+            return detail::alloc_hooks_installed().load();
+        }
+
+        /// <summary>
+        /// Set the function called when a guard's budget is exceeded, returning the previous one.
+        /// </summary>
+        static violation_handler set_violation_handler(violation_handler p_handler) noexcept
+        {
+            return detail::alloc_violation().exchange(p_handler != nullptr ? p_handler : &detail::default_alloc_violation);
+        }
+
+    private:
+        std::size_t m_start;
+        std::size_t m_budget;
+    };
+}
@@ -7,6 +7,7 @@
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <ranges>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -31,6 +32,27 @@ namespace mg
         return detail::iter_zipped_tuples_impl<0, DimCount>(std::forward<Fn>(p_fn), std::forward<Tuples>(p_tuples)...);
     }
 
+    /// <summary>
+    /// Iterate in parallel over the elements of a set of runtime sized ranges. This has the same semantics as
+    /// iter_zipped_tuples: iteration stops at the end of the smallest range, and the callable may return a bool to
+    /// signal whether iteration is to continue. The shortest length is computed once up front and the ranges are
+    /// then walked by index, so a callable which does not return a bool over contiguous ranges (for example the
+    /// columns of a soa_vector) produces a loop the compiler can vectorize.
+    /// </summary>
+    /// <typeparam name="Fn">The type of the callable to invoke.</typeparam>
+    /// <typeparam name="...Ranges">The set of ranges to iterate over.</typeparam>
+    /// <param name="p_fn">The callable to invoke over the ranges. Will have one argument in parallel for each range
+    /// and can signal to stop iteration by returning false.</param>
+    /// <param name="...p_ranges">The ranges to iterate over.</param>
+    /// <returns>False if the callable signaled iteration to stop and true otherwise.</returns>
+    template <typename Fn, std::ranges::random_access_range... Ranges>
+        requires (sizeof...(Ranges) > 0 && (std::ranges::sized_range<Ranges> && ...))
+    bool iter_zipped_ranges(Fn&& p_fn, Ranges&&... p_ranges)
+    {
+        const std::size_t count = std::min({ static_cast<std::size_t>(std::ranges::size(p_ranges))... });
+        return detail::iter_zipped_ranges_impl(p_fn, count, std::ranges::begin(p_ranges)...);
+    }
+
     /// <summary>
     /// Apply a callable to all members of a tuple resulting in a new tuple.
     /// </summary>
@@ -71,6 +93,17 @@ namespace mg
     /// Convenience method to check if all elements in a iterator range are unique. This is an optimized
     /// method which will not create copies of the contained elements.
     /// </summary>
+    /// <remarks>The only allocations made are for the set of visited elements, through the given allocator.
+    /// Passing an mg::arena_allocator over an arena which is reset between calls means that, once the
+    /// arena has grown to fit the largest range, no further calls are made to malloc:
+    /// <code>
+    /// mg::arena scratch;
+    /// for (const auto&amp; batch : batches)
+    /// {
+    ///     scratch.reset();
+    ///     check(mg::all_unique(batch.begin(), batch.end(), {}, {}, mg::arena_allocator&lt;void&gt;(scratch)));
+    /// }
+    /// </code></remarks>
     /// <typeparam name="Iter">The type of the iterator which must satisfy the addressable concept.</typeparam>
     /// <typeparam name="Hash">The type of the hasher.</typeparam>
     /// <typeparam name="Equal">The type of the equality comparator.</typeparam>
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The number of global operator new calls made by the current thread, maintained by the hooks
+    /// from MG_DEFINE_ALLOC_HOOKS. Constant initialized, so it is safe to use from operator new.
+    /// </summary>
+    inline std::size_t& thread_allocation_count() noexcept
+    {
+        thread_local std::size_t count = 0;
+        return count;
+    }
+
+    inline std::atomic<bool>& alloc_hooks_installed() noexcept
+    {
+        static std::atomic<bool> installed{ false };
+        return installed;
+    }
+
+    /// <summary>
+    /// Called when an alloc_guard is violated, with the number of allocations seen (or
+    /// unknown_allocations when the hooks are not installed) and the budget.
+    /// </summary>
+    using alloc_violation_handler = void (*)(std::size_t p_allocations, std::size_t p_budget);
+
+    inline constexpr std::size_t unknown_allocations = std::numeric_limits<std::size_t>::max();
+
+    inline void default_alloc_violation(std::size_t p_allocations, std::size_t p_budget) noexcept
+    {
+        if (p_allocations == unknown_allocations)
+        {
+            std::fprintf(stderr, "mg::alloc_guard: allocations cannot be observed without MG_DEFINE_ALLOC_HOOKS.\n");
+        }
+        else
+        {
+            std::fprintf(stderr, "mg::alloc_guard: %zu allocations exceeded the budget of %zu.\n", p_allocations, p_budget);
+        }
+
+        std::abort();
+    }
+
+    inline std::atomic<alloc_violation_handler>& alloc_violation() noexcept
+    {
+        static std::atomic<alloc_violation_handler> handler{ &default_alloc_violation };
+        return handler;
+    }
+
+    inline void* hooked_allocate(std::size_t p_bytes, std::size_t p_alignment) noexcept
+    {
+        ++thread_allocation_count();
+        p_bytes = p_bytes == 0 ? 1 : p_bytes;
+        if (p_alignment <= alignof(std::max_align_t))
+        {
+            return std::malloc(p_bytes);
+        }
+
+#if defined(_WIN32)
+        return _aligned_malloc(p_bytes, p_alignment);
+#else
+        return std::aligned_alloc(p_alignment, (p_bytes + p_alignment - 1) / p_alignment * p_alignment);
+#endif
+    }
+
+    inline void hooked_free(void* p_memory, std::size_t p_alignment) noexcept
+    {
+#if defined(_WIN32)
+        if (p_alignment > alignof(std::max_align_t))
+        {
+            _aligned_free(p_memory);
+            return;
+        }
+#else
+        (void)p_alignment;
+#endif
+        std::free(p_memory);
+    }
+
+    inline void* hooked_new(std::size_t p_bytes, std::size_t p_alignment)
+    {
+        for (;;)
+        {
+            if (auto* result = hooked_allocate(p_bytes, p_alignment))
+            {
+                return result;
+            }
+
+            auto handler = std::get_new_handler();
+            if (handler == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+
+            handler();
+        }
+    }
+
+    inline void* hooked_new_nothrow(std::size_t p_bytes, std::size_t p_alignment) noexcept
+    {
+        try
+        {
+            return hooked_new(p_bytes, p_alignment);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+}
+
+/// <summary>
+/// Replace the global operator new and delete with versions that count allocations per thread, which
+/// is what alloc_guard observes. Expand this exactly once, at namespace scope, in one translation unit
+/// of the program (typically the test binary).
+/// </summary>
+#define MG_DEFINE_ALLOC_HOOKS()                                                                                     \
+    namespace mg::detail                                                                                            \
+    {                                                                                                               \
+        [[maybe_unused]] static const bool alloc_hooks_registered = (alloc_hooks_installed().store(true), true);    \
+    }                                                                                                               \
+    void* operator new(std::size_t p_bytes) { return ::mg::detail::hooked_new(p_bytes, 0); }                        \
+    void* operator new[](std::size_t p_bytes) { return ::mg::detail::hooked_new(p_bytes, 0); }                      \
+    void* operator new(std::size_t p_bytes, std::align_val_t p_alignment)                                           \
+    {                                                                                                               \
+        return ::mg::detail::hooked_new(p_bytes, static_cast<std::size_t>(p_alignment));                            \
+    }                                                                                                               \
+    void* operator new[](std::size_t p_bytes, std::align_val_t p_alignment)                                         \
+    {                                                                                                               \
+        return ::mg::detail::hooked_new(p_bytes, static_cast<std::size_t>(p_alignment));                            \
+    }                                                                                                               \
+    void* operator new(std::size_t p_bytes, const std::nothrow_t&) noexcept                                         \
+    {                                                                                                               \
+        return ::mg::detail::hooked_new_nothrow(p_bytes, 0);                                                        \
+    }                                                                                                               \
+    void* operator new[](std::size_t p_bytes, const std::nothrow_t&) noexcept                                       \
+    {                                                                                                               \
+        return ::mg::detail::hooked_new_nothrow(p_bytes, 0);                                                        \
+    }                                                                                                               \
+    void* operator new(std::size_t p_bytes, std::align_val_t p_alignment, const std::nothrow_t&) noexcept           \
+    {                                                                                                               \
+        return ::mg::detail::hooked_new_nothrow(p_bytes, static_cast<std::size_t>(p_alignment));                    \
+    }                                                                                                               \
+    void* operator new[](std::size_t p_bytes, std::align_val_t p_alignment, const std::nothrow_t&) noexcept         \
+    {                                                                                                               \
+        return ::mg::detail::hooked_new_nothrow(p_bytes, static_cast<std::size_t>(p_alignment));                    \
+    }                                                                                                               \
+    void operator delete(void* p_memory) noexcept { ::mg::detail::hooked_free(p_memory, 0); }                       \
+    void operator delete[](void* p_memory) noexcept { ::mg::detail::hooked_free(p_memory, 0); }                     \
+    void operator delete(void* p_memory, std::size_t) noexcept { ::mg::detail::hooked_free(p_memory, 0); }          \
+    void operator delete[](void* p_memory, std::size_t) noexcept { ::mg::detail::hooked_free(p_memory, 0); }        \
+    void operator delete(void* p_memory, std::align_val_t p_alignment) noexcept                                     \
+    {                                                                                                               \
+        ::mg::detail::hooked_free(p_memory, static_cast<std::size_t>(p_alignment));                                 \
+    }                                                                                                               \
+    void operator delete[](void* p_memory, std::align_val_t p_alignment) noexcept                                   \
+    {                                                                                                               \
+        ::mg::detail::hooked_free(p_memory, static_cast<std::size_t>(p_alignment));                                 \
+    }                                                                                                               \
+    void operator delete(void* p_memory, std::size_t, std::align_val_t p_alignment) noexcept                        \
+    {                                                                                                               \
+        ::mg::detail::hooked_free(p_memory, static_cast<std::size_t>(p_alignment));                                 \
+    }                                                                                                               \
+    void operator delete[](void* p_memory, std::size_t, std::align_val_t p_alignment) noexcept                      \
+    {                                                                                                               \
+        ::mg::detail::hooked_free(p_memory, static_cast<std::size_t>(p_alignment));                                 \
+    }
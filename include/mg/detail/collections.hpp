@@ -3,7 +3,12 @@
 #include "mg/functional.hpp"
 #include "mg/utility.hpp"
 
+#if MG_ENABLE_PROBES
+#include "mg/probe.hpp"
+#endif
+
 #include <cstdlib>
+#include <iterator>
 #include <tuple>
 #include <type_traits>
 #include <unordered_set>
@@ -27,9 +32,9 @@ namespace mg::detail
         }
         else
         {
-            if constexpr (std::is_assignable_v<bool&, std::invoke_result_t<TFn&&, decltype(std::get<Idx>(std::forward<Tuples>(p_tuples)))...>>)
+            if constexpr (std::is_assignable_v<bool&, std::invoke_result_t<TFn&&, decltype(mg::get<Idx>{}(std::forward<Tuples>(p_tuples)))...>>)
             {
-                bool continueIteration = std::invoke(p_fn, std::get<Idx>(std::forward<Tuples>(p_tuples))...);
+                bool continueIteration = std::invoke(p_fn, mg::get<Idx>{}(std::forward<Tuples>(p_tuples))...);
                 if (!continueIteration)
                 {
                     return false;
@@ -37,7 +42,7 @@ namespace mg::detail
             }
             else
             {
-                std::invoke(p_fn, std::get<Idx>(std::forward<Tuples>(p_tuples))...);
+                std::invoke(p_fn, mg::get<Idx>{}(std::forward<Tuples>(p_tuples))...);
             }
 
             if constexpr ((Idx + 1) < Max)
@@ -51,10 +56,35 @@ namespace mg::detail
         }
     }
 
+    template <typename Fn, typename... Iters>
+    bool iter_zipped_ranges_impl(Fn& p_fn, std::size_t p_count, Iters... p_iters)
+    {
+        if constexpr (std::is_assignable_v<bool&, std::invoke_result_t<Fn&, std::iter_reference_t<Iters>...>>)
+        {
+            for (std::size_t i = 0; i < p_count; ++i)
+            {
+                bool continueIteration = std::invoke(p_fn, p_iters[static_cast<std::iter_difference_t<Iters>>(i)]...);
+                if (!continueIteration)
+                {
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < p_count; ++i)
+            {
+                std::invoke(p_fn, p_iters[static_cast<std::iter_difference_t<Iters>>(i)]...);
+            }
+        }
+
+        return true;
+    }
+
     template <typename Fn, typename Tuple, std::size_t... I>
     auto tuple_map_impl(Tuple&& p_tuple, Fn&& p_fn, std::index_sequence<I...>)
     {
-        return std::make_tuple(p_fn(std::get<I>(std::forward<Tuple>(p_tuple)))...);
+        return std::make_tuple(p_fn(mg::get<I>{}(std::forward<Tuple>(p_tuple)))...);
     }
 
     template<
@@ -74,15 +104,24 @@ namespace mg::detail
             mg::map_args<Equal, mg::deref>,
             ReboundAlloc> identity(0, hash, equal, alloc);
 
+#if MG_ENABLE_PROBES
+        MG_PROBE_SCOPE("mg.all_unique");
+#endif
         while (first != last) {
             auto [_, inserted] = identity.emplace(std::addressof(*first));
             if (!inserted) {
+#if MG_ENABLE_PROBES
+                MG_PROBE_COUNT("mg.all_unique.elements", identity.size() + 1);
+#endif
                 return false;
             }
 
             ++first;
         }
 
+#if MG_ENABLE_PROBES
+        MG_PROBE_COUNT("mg.all_unique.elements", identity.size());
+#endif
         return true;
     }
 }
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Base of the promise types of mg's coroutines, which lets a coroutine's frame be allocated
+    /// with an allocator. When a coroutine's parameters begin with std::allocator_arg and an
+    /// allocator (after the object parameter, for member functions), its frame is allocated with a
+    /// rebound copy of that allocator; otherwise it comes from the global operator new. Either way
+    /// a small header before the frame records its size and how to free it, so that the placement
+    /// forms of operator delete, which are not given the size, can free it too.
+    /// </summary>
+    class coroutine_frame_allocation
+    {
+    public:
+        static void* operator new(std::size_t p_size)
+        {
+            return allocate(std::allocator<std::byte>(), p_size);
+        }
+
+        template <typename Alloc, typename... Args>
+        static void* operator new(std::size_t p_size, std::allocator_arg_t, const Alloc& p_allocator, const Args&...)
+        {
+            return allocate(p_allocator, p_size);
+        }
+
+        template <typename This, typename Alloc, typename... Args>
+        static void* operator new(std::size_t p_size, const This&, std::allocator_arg_t, const Alloc& p_allocator, const Args&...)
+        {
+            return allocate(p_allocator, p_size);
+        }
+
+        static void operator delete(void* p_frame, std::size_t) noexcept
+        {
+            deallocate(p_frame);
+        }
+
+        template <typename Alloc, typename... Args>
+        static void operator delete(void* p_frame, std::allocator_arg_t, const Alloc&, const Args&...) noexcept
+        {
+            deallocate(p_frame);
+        }
+
+        template <typename This, typename Alloc, typename... Args>
+        static void operator delete(void* p_frame, const This&, std::allocator_arg_t, const Alloc&, const Args&...) noexcept
+        {
+            deallocate(p_frame);
+        }
+
+    private:
+        struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block
+        {
+            std::byte m_bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+        };
+
+        struct header
+        {
+            void (*m_free)(block* p_blocks, std::size_t p_size) noexcept;
+            std::size_t m_size;
+        };
+
+        template <typename Alloc>
+        using block_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<block>;
+
+        static constexpr std::size_t align(std::size_t p_size, std::size_t p_alignment) noexcept
+        {
+            return (p_size + p_alignment - 1) & ~(p_alignment - 1);
+        }
+
+        /// <summary>
+        /// The header, padded to whole blocks so that the frame keeps the block alignment.
+        /// </summary>
+        static constexpr std::size_t header_size = (sizeof(header) + sizeof(block) - 1) / sizeof(block) * sizeof(block);
+
+        /// <summary>
+        /// The header, then the frame, then (for stateful allocators) the allocator.
+        /// </summary>
+        template <typename Alloc>
+        static constexpr std::size_t allocator_offset(std::size_t p_size) noexcept
+        {
+            return align(header_size + p_size, alignof(block_allocator<Alloc>));
+        }
+
+        template <typename Alloc>
+        static constexpr std::size_t block_count(std::size_t p_size) noexcept
+        {
+            const auto total = std::is_empty_v<block_allocator<Alloc>>
+                ? header_size + p_size
+                : allocator_offset<Alloc>(p_size) + sizeof(block_allocator<Alloc>);
+            return align(total, sizeof(block)) / sizeof(block);
+        }
+
+        static block* blocks_of(void* p_frame) noexcept
+        {
+            return reinterpret_cast<block*>(static_cast<std::byte*>(p_frame) - header_size);
+        }
+
+        template <typename Alloc>
+        static void* allocate(const Alloc& p_allocator, std::size_t p_size)
+        {
+            using allocator_type = block_allocator<Alloc>;
+            static_assert(alignof(allocator_type) <= alignof(block), "The allocator is over-aligned.");
+
+            allocator_type allocator(p_allocator);
+            block* blocks = std::allocator_traits<allocator_type>::allocate(allocator, block_count<Alloc>(p_size));
+            auto* bytes = reinterpret_cast<std::byte*>(blocks);
+            ::new (bytes) header{ &free<Alloc>, p_size };
+            if constexpr (!std::is_empty_v<allocator_type>)
+            {
+                ::new (bytes + allocator_offset<Alloc>(p_size)) allocator_type(std::move(allocator));
+            }
+
+            return bytes + header_size;
+        }
+
+        static void deallocate(void* p_frame) noexcept
+        {
+            auto* blocks = blocks_of(p_frame);
+            const auto* info = std::launder(reinterpret_cast<header*>(blocks));
+            info->m_free(blocks, info->m_size);
+        }
+
+        template <typename Alloc>
+        static void free(block* p_blocks, std::size_t p_size) noexcept
+        {
+            using allocator_type = block_allocator<Alloc>;
+            if constexpr (std::is_empty_v<allocator_type>)
+            {
+                allocator_type allocator;
+                std::allocator_traits<allocator_type>::deallocate(allocator, p_blocks, block_count<Alloc>(p_size));
+            }
+            else
+            {
+                auto* stored = std::launder(reinterpret_cast<allocator_type*>(reinterpret_cast<std::byte*>(p_blocks) + allocator_offset<Alloc>(p_size)));
+                auto allocator = std::move(*stored);
+                stored->~allocator_type();
+                std::allocator_traits<allocator_type>::deallocate(allocator, p_blocks, block_count<Alloc>(p_size));
+            }
+        }
+    };
+
+    /// <summary>
+    /// A coroutine which starts immediately and frees itself when it finishes, used to drive a task
+    /// to completion from ordinary code.
+    /// </summary>
+    struct detached_coroutine
+    {
+        struct promise_type
+        {
+            detached_coroutine get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    /// <summary>
+    /// Completion signal for sync_wait. The waiting thread may destroy it as soon as it sees the flag,
+    /// so the flag is set and notified under the lock.
+    /// </summary>
+    struct completion_signal
+    {
+        void set() noexcept
+        {
+            std::scoped_lock lock(m_mutex);
+            m_done = true;
+            m_condition.notify_one();
+        }
+
+        void wait() noexcept
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_done; });
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_done = false;
+    };
+}
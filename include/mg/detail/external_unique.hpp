@@ -0,0 +1,571 @@
+#pragma once
+
+#include "mg/detail/hash.hpp"
+#include "mg/serialize.hpp"
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Runs file I/O on a background thread, in the order it is submitted, so that the caller can
+    /// fill or parse one buffer while another is written or read.
+    /// </summary>
+    class spill_worker
+    {
+    public:
+        spill_worker()
+            : m_thread([this](std::stop_token p_stop) { run(p_stop); })
+        {
+        }
+
+        spill_worker(const spill_worker&) = delete;
+        spill_worker& operator=(const spill_worker&) = delete;
+
+        template <typename Fn>
+        std::future<void> submit(Fn&& p_fn)
+        {
+            std::packaged_task<void()> task(std::forward<Fn>(p_fn));
+            auto result = task.get_future();
+            {
+                std::scoped_lock lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+
+            m_wake.notify_one();
+            return result;
+        }
+
+    private:
+        void run(std::stop_token p_stop)
+        {
+            std::unique_lock lock(m_mutex);
+            while (true)
+            {
+                // Stopping only once the queue is drained, so that every future is satisfied.
+                m_wake.wait(lock, p_stop, [&] { return !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+
+                auto task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_wake;
+        std::deque<std::packaged_task<void()>> m_tasks;
+        // Last, so that the thread is stopped and joined before the queue is destroyed.
+        std::jthread m_thread;
+    };
+
+    /// <summary>
+    /// A uniquely named directory for spill files, removed with everything in it on destruction.
+    /// </summary>
+    class spill_directory
+    {
+    public:
+        explicit spill_directory(const std::filesystem::path& p_parent)
+        {
+            std::random_device entropy;
+            for (int attempt = 0; ; ++attempt)
+            {
+                auto path = p_parent / ("mg-unique-" + std::to_string(entropy()) + std::to_string(entropy()));
+                if (std::filesystem::create_directories(path))
+                {
+                    m_path = std::move(path);
+                    return;
+                }
+
+                if (attempt == 16)
+                {
+                    throw std::system_error(std::make_error_code(std::errc::file_exists), "Could not create a spill directory in " + p_parent.string());
+                }
+            }
+        }
+
+        spill_directory(const spill_directory&) = delete;
+        spill_directory& operator=(const spill_directory&) = delete;
+
+        ~spill_directory()
+        {
+            std::error_code ignored;
+            std::filesystem::remove_all(m_path, ignored);
+        }
+
+        std::filesystem::path next_file()
+        {
+            return m_path / (std::to_string(m_files++) + ".part");
+        }
+
+    private:
+        std::filesystem::path m_path;
+        std::size_t m_files = 0;
+    };
+
+    /// <summary>
+    /// Appends records to a set of spill files, one per partition. Each partition fills a buffer,
+    /// which once it reaches the block size is handed to the worker to be written while the next
+    /// fills; the buffers in flight are recycled in the order they were written.
+    /// </summary>
+    /// <remarks>A file is a sequence of blocks, each its length followed by whole records, so that a
+    /// record never straddles two reads.</remarks>
+    class partition_writer
+    {
+        static constexpr std::size_t in_flight = 2;
+
+    public:
+        partition_writer(spill_worker& p_worker, spill_directory& p_directory, std::size_t p_partitions, std::size_t p_blockSize)
+            : m_worker(&p_worker),
+            m_blockSize(p_blockSize),
+            m_buffers(p_partitions)
+        {
+            m_paths.reserve(p_partitions);
+            m_files.reserve(p_partitions);
+            for (std::size_t i = 0; i < p_partitions; ++i)
+            {
+                m_paths.push_back(p_directory.next_file());
+                m_files.emplace_back(m_paths.back(), std::ios::binary | std::ios::trunc);
+                if (!m_files.back())
+                {
+                    throw std::system_error(std::make_error_code(std::io_errc::stream), "Could not create the spill file " + m_paths.back().string());
+                }
+
+                m_buffers[i].reserve(p_blockSize);
+            }
+        }
+
+        partition_writer(const partition_writer&) = delete;
+        partition_writer& operator=(const partition_writer&) = delete;
+
+        ~partition_writer()
+        {
+            for (auto& slot : m_inFlight)
+            {
+                if (slot.m_done.valid())
+                {
+                    slot.m_done.wait();
+                }
+            }
+        }
+
+        std::vector<std::byte>& buffer(std::size_t p_partition) noexcept
+        {
+            return m_buffers[p_partition];
+        }
+
+        /// <summary>
+        /// Hand a partition's buffer to the worker if it has reached the block size.
+        /// </summary>
+        void commit(std::size_t p_partition)
+        {
+            if (m_buffers[p_partition].size() >= m_blockSize)
+            {
+                flush(p_partition);
+            }
+        }
+
+        /// <summary>
+        /// Write every partition's remaining records and wait for all of the writes. The buffers and
+        /// files are released, so that a writer kept alive while its partitions are checked does not
+        /// count against the memory budget.
+        /// </summary>
+        /// <returns>The paths of the spill files, by partition.</returns>
+        std::vector<std::filesystem::path> finish()
+        {
+            for (std::size_t i = 0; i < m_buffers.size(); ++i)
+            {
+                if (!m_buffers[i].empty())
+                {
+                    flush(i);
+                }
+            }
+
+            for (auto& slot : m_inFlight)
+            {
+                if (slot.m_done.valid())
+                {
+                    slot.m_done.get();
+                }
+            }
+
+            for (auto& slot : m_inFlight)
+            {
+                std::vector<std::byte>().swap(slot.m_buffer);
+            }
+
+            std::vector<std::vector<std::byte>>().swap(m_buffers);
+            for (auto& file : m_files)
+            {
+                file.close();
+                if (!file)
+                {
+                    throw std::system_error(std::make_error_code(std::io_errc::stream), "Could not write a spill file.");
+                }
+            }
+
+            std::vector<std::ofstream>().swap(m_files);
+            return std::move(m_paths);
+        }
+
+    private:
+        struct flight
+        {
+            std::vector<std::byte> m_buffer;
+            std::future<void> m_done;
+        };
+
+        void flush(std::size_t p_partition)
+        {
+            auto& slot = m_inFlight[m_next];
+            m_next = (m_next + 1) % in_flight;
+            if (slot.m_done.valid())
+            {
+                slot.m_done.get();
+            }
+
+            slot.m_buffer.clear();
+            std::swap(slot.m_buffer, m_buffers[p_partition]);
+            slot.m_done = m_worker->submit([&file = m_files[p_partition], &block = slot.m_buffer]
+                {
+                    const std::uint64_t size = block.size();
+                    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                    file.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size()));
+                    if (!file)
+                    {
+                        throw std::system_error(std::make_error_code(std::io_errc::stream), "Could not write a spill file.");
+                    }
+                });
+        }
+
+        spill_worker* m_worker;
+        std::size_t m_blockSize;
+        std::vector<std::vector<std::byte>> m_buffers;
+        std::vector<std::filesystem::path> m_paths;
+        std::vector<std::ofstream> m_files;
+        std::array<flight, in_flight> m_inFlight;
+        std::size_t m_next = 0;
+    };
+
+    /// <summary>
+    /// Reads the blocks of a spill file, with the worker reading the next block while the caller
+    /// parses the current one.
+    /// </summary>
+    class partition_reader
+    {
+    public:
+        partition_reader(spill_worker& p_worker, const std::filesystem::path& p_path)
+            : m_worker(&p_worker),
+            m_file(p_path, std::ios::binary)
+        {
+            if (!m_file)
+            {
+                throw std::system_error(std::make_error_code(std::io_errc::stream), "Could not open the spill file " + p_path.string());
+            }
+
+            prefetch();
+        }
+
+        partition_reader(const partition_reader&) = delete;
+        partition_reader& operator=(const partition_reader&) = delete;
+
+        ~partition_reader()
+        {
+            if (m_pending.valid())
+            {
+                m_pending.wait();
+            }
+        }
+
+        /// <summary>
+        /// Take the next block, which stays valid until the following call.
+        /// </summary>
+        /// <returns>The block, or an empty span at the end of the file.</returns>
+        std::span<const std::byte> next()
+        {
+            m_pending.get();
+            std::swap(m_current, m_next);
+            if (!m_current.empty())
+            {
+                prefetch();
+            }
+
+            return m_current;
+        }
+
+    private:
+        void prefetch()
+        {
+            m_pending = m_worker->submit([this]
+                {
+                    m_next.clear();
+                    std::uint64_t size = 0;
+                    if (!m_file.read(reinterpret_cast<char*>(&size), sizeof(size)))
+                    {
+                        return;
+                    }
+
+                    m_next.resize(static_cast<std::size_t>(size));
+                    if (!m_file.read(reinterpret_cast<char*>(m_next.data()), static_cast<std::streamsize>(size)))
+                    {
+                        throw std::invalid_argument("A spill file is truncated.");
+                    }
+                });
+        }
+
+        spill_worker* m_worker;
+        std::ifstream m_file;
+        std::vector<std::byte> m_current;
+        std::vector<std::byte> m_next;
+        std::future<void> m_pending;
+    };
+
+    /// <summary>
+    /// Checks a stream of elements for duplicates under a memory budget. Elements are collected in
+    /// memory, with their positions in the stream, until their estimated size exceeds the budget;
+    /// they are then hash partitioned, along with the rest of the stream, into spill files, each of
+    /// which is checked in the same way (and partitioned again with a different hash if it too
+    /// exceeds the budget). Equal elements always land in the same partition.
+    /// </summary>
+    template <typename T, typename Hash, typename Equal, typename Result, typename Options>
+    class external_unique_checker
+    {
+        // Beyond this depth a partition is checked in memory whatever its size, since further
+        // partitioning cannot separate elements whose hashes are equal.
+        static constexpr std::size_t max_depth = 4;
+
+        // Smaller blocks would make the spill files' writes and reads too small to be worthwhile.
+        static constexpr std::size_t min_block_size = 256;
+
+        struct hasher
+        {
+            const Hash* m_hash;
+
+            std::size_t operator()(const T& p_value) const
+            {
+                return (*m_hash)(p_value);
+            }
+        };
+
+        struct equality
+        {
+            const Equal* m_equal;
+
+            bool operator()(const T& p_lhs, const T& p_rhs) const
+            {
+                return (*m_equal)(p_lhs, p_rhs);
+            }
+        };
+
+    public:
+        /// <summary>
+        /// Split the budget between the elements held in memory and the blocks of a partition writer
+        /// (one per partition, plus two in flight). The blocks are given a quarter of the budget, or
+        /// at most half when that is needed for blocks of the minimum size, and the partitions are
+        /// reduced to fit; the elements in memory always keep at least half.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">The budget cannot hold a block for each of two
+        /// partitions in half of it.</exception>
+        external_unique_checker(const Options& p_options, const Hash& p_hash, const Equal& p_equal)
+            : m_options(&p_options),
+            m_hash(&p_hash),
+            m_seen(0, hasher{ &p_hash }, equality{ &p_equal })
+        {
+            const auto budget = p_options.memory_budget;
+            const auto maxBlocks = budget / 2 / min_block_size;
+            if (maxBlocks < 2 + 2)
+            {
+                throw std::invalid_argument("The memory budget is too small to partition the elements.");
+            }
+
+            m_partitions = std::clamp<std::size_t>(p_options.partitions, 2, maxBlocks - 2);
+            m_blockSize = std::max(min_block_size, budget / 4 / (m_partitions + 2));
+            m_setBudget = budget - (m_partitions + 2) * m_blockSize;
+        }
+
+        template <typename Iter, typename Sentinel>
+        Result run(Iter p_first, Sentinel p_last)
+        {
+            Result result;
+            std::uint64_t position = 0;
+            for (; p_first != p_last; ++p_first, ++position)
+            {
+                if (!insert(*p_first, position, result))
+                {
+                    return result;
+                }
+
+                if (m_used > m_setBudget)
+                {
+                    break;
+                }
+            }
+
+            if (p_first == p_last)
+            {
+                return result;
+            }
+
+            // Over budget: partition what has been seen and the rest of the stream.
+            ++p_first;
+            ++position;
+            result.spilled = true;
+            m_directory.emplace(m_options->temp_directory);
+            m_worker.emplace();
+            partition_writer writer(*m_worker, *m_directory, m_partitions, m_blockSize);
+            spill_seen(writer, 0);
+            for (; p_first != p_last; ++p_first, ++position)
+            {
+                spill(writer, 0, position, *p_first);
+            }
+
+            check_partitions(writer.finish(), 1, result);
+            return result;
+        }
+
+    private:
+        template <typename Value>
+        bool insert(Value&& p_value, std::uint64_t p_position, Result& p_result)
+        {
+            auto [existing, inserted] = m_seen.try_emplace(T(std::forward<Value>(p_value)), p_position);
+            if (!inserted)
+            {
+                p_result.duplicate = existing->first;
+                p_result.first_position = std::min(existing->second, p_position);
+                p_result.second_position = std::max(existing->second, p_position);
+                return false;
+            }
+
+            m_used += entry_cost(existing->first);
+            return true;
+        }
+
+        static std::size_t entry_cost(const T& p_value)
+        {
+            // The node and its bucket, plus an estimate of anything the element owns.
+            std::size_t cost = sizeof(std::pair<const T, std::uint64_t>) + 3 * sizeof(void*);
+            if constexpr (!std::is_trivially_copyable_v<T>)
+            {
+                cost += max_serialized_size(p_value);
+            }
+
+            return cost;
+        }
+
+        std::size_t partition_of(const T& p_value, std::size_t p_depth) const
+        {
+            const auto mixed = mix_hash(static_cast<std::uint64_t>((*m_hash)(p_value)) ^ (0x9e3779b97f4a7c15ull * (p_depth + 1)));
+            return reduce_hash(static_cast<std::uint32_t>(mixed >> 32), m_partitions);
+        }
+
+        void spill(partition_writer& p_writer, std::size_t p_depth, std::uint64_t p_position, const T& p_value)
+        {
+            const auto partition = partition_of(p_value, p_depth);
+            auto& buffer = p_writer.buffer(partition);
+            serialize(p_position, buffer);
+            serialize(p_value, buffer);
+            p_writer.commit(partition);
+        }
+
+        void spill_seen(partition_writer& p_writer, std::size_t p_depth)
+        {
+            for (const auto& [value, position] : m_seen)
+            {
+                spill(p_writer, p_depth, position, value);
+            }
+
+            m_seen.clear();
+            m_used = 0;
+        }
+
+        void check_partitions(std::vector<std::filesystem::path> p_paths, std::size_t p_depth, Result& p_result)
+        {
+            for (const auto& path : p_paths)
+            {
+                if (!check_partition(path, p_depth, p_result))
+                {
+                    return;
+                }
+            }
+        }
+
+        bool check_partition(const std::filesystem::path& p_path, std::size_t p_depth, Result& p_result)
+        {
+            std::optional<partition_writer> writer;
+            {
+                partition_reader reader(*m_worker, p_path);
+                for (auto block = reader.next(); !block.empty(); block = reader.next())
+                {
+                    while (!block.empty())
+                    {
+                        const auto position = deserialize<std::uint64_t>(block);
+                        auto value = deserialize<T>(block);
+                        if (writer)
+                        {
+                            spill(*writer, p_depth, position, value);
+                        }
+                        else if (!insert(std::move(value), position, p_result))
+                        {
+                            return false;
+                        }
+                        else if (m_used > m_setBudget && p_depth < max_depth)
+                        {
+                            writer.emplace(*m_worker, *m_directory, m_partitions, m_blockSize);
+                            spill_seen(*writer, p_depth);
+                        }
+                    }
+                }
+            }
+
+            std::error_code ignored;
+            std::filesystem::remove(p_path, ignored);
+            if (writer)
+            {
+                check_partitions(writer->finish(), p_depth + 1, p_result);
+                return !p_result.duplicate;
+            }
+
+            m_seen.clear();
+            m_used = 0;
+            return true;
+        }
+
+        const Options* m_options;
+        const Hash* m_hash;
+        std::size_t m_partitions = 0;
+        std::size_t m_blockSize = 0;
+        std::size_t m_setBudget = 0;
+        std::unordered_map<T, std::uint64_t, hasher, equality> m_seen;
+        std::size_t m_used = 0;
+        // The directory outlives the worker, so that no write is pending when it is removed.
+        std::optional<spill_directory> m_directory;
+        std::optional<spill_worker> m_worker;
+    };
+}
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MG_FLAT_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MG_FLAT_NEON 1
+#endif
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Whether the keys of a flat container are searched through a flat_search_index rather than
+    /// by binary search: arithmetic keys ordered by std::less, in contiguous storage.
+    /// </summary>
+    template <typename Key, typename Compare, typename KeyContainer>
+    constexpr bool flat_indexable =
+        std::is_arithmetic_v<Key> && !std::is_same_v<Key, bool>
+        && (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>)
+        && std::contiguous_iterator<typename KeyContainer::const_iterator>;
+
+    /// <summary>
+    /// The types by which the keys of a flat container may be looked up: any, if the comparator
+    /// is transparent, and those convertible to the key type otherwise.
+    /// </summary>
+    template <typename K, typename Key, typename Compare>
+    concept flat_lookup = requires { typename Compare::is_transparent; } || std::convertible_to<const K&, Key>;
+
+    /// <summary>
+    /// The number of keys in a node of a flat_search_index: a cache line of them.
+    /// </summary>
+    template <typename Key>
+    constexpr std::size_t flat_node_size = 64 / sizeof(Key);
+
+    inline void prefetch(const void* p_address) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p_address);
+#elif defined(_M_X64) || defined(_M_IX86)
+        _mm_prefetch(static_cast<const char*>(p_address), _MM_HINT_T0);
+#else
+        static_cast<void>(p_address);
+#endif
+    }
+
+    /// <summary>
+    /// The number of keys in a node which are less than the given key, comparing the whole node at
+    /// once. Integer keys of 4 or 8 bytes are compared with SIMD instructions where available
+    /// (unsigned ones by flipping the sign bit into signed order); the remaining key types are
+    /// compared with a fixed length loop, which the compiler vectorizes.
+    /// </summary>
+    template <typename Key>
+    std::size_t count_less(const Key* p_node, Key p_key) noexcept
+    {
+        constexpr auto node_size = flat_node_size<Key>;
+        [[maybe_unused]] constexpr bool wide_integer = std::is_integral_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8);
+#if defined(__AVX2__)
+        if constexpr (wide_integer)
+        {
+            using lane = std::conditional_t<sizeof(Key) == 4, std::int32_t, std::int64_t>;
+            constexpr auto bias = std::is_signed_v<Key> ? lane(0) : std::numeric_limits<lane>::min();
+            const auto flip = sizeof(Key) == 4 ? _mm256_set1_epi32(static_cast<int>(bias)) : _mm256_set1_epi64x(static_cast<long long>(bias));
+            const auto needle = _mm256_xor_si256(sizeof(Key) == 4 ? _mm256_set1_epi32(static_cast<int>(p_key)) : _mm256_set1_epi64x(static_cast<long long>(p_key)), flip);
+            unsigned mask = 0;
+            for (std::size_t i = 0; i < node_size; i += 32 / sizeof(Key))
+            {
+                const auto keys = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_node + i)), flip);
+                const auto less = sizeof(Key) == 4 ? _mm256_cmpgt_epi32(needle, keys) : _mm256_cmpgt_epi64(needle, keys);
+                mask = (mask << 8) | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(less)));
+            }
+
+            // Each 64 bit lane sets two bits of the 32 bit lane mask.
+            return static_cast<std::size_t>(std::popcount(mask)) * 4 / sizeof(Key);
+        }
+#elif defined(MG_FLAT_SSE2)
+        if constexpr (wide_integer && sizeof(Key) == 4)
+        {
+            const auto flip = _mm_set1_epi32(std::is_signed_v<Key> ? 0 : static_cast<int>(0x80000000u));
+            const auto needle = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(p_key)), flip);
+            unsigned mask = 0;
+            for (std::size_t i = 0; i < node_size; i += 4)
+            {
+                const auto keys = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p_node + i)), flip);
+                mask = (mask << 4) | static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, keys))));
+            }
+
+            return static_cast<std::size_t>(std::popcount(mask));
+        }
+#elif defined(MG_FLAT_NEON)
+        if constexpr (wide_integer && sizeof(Key) == 4)
+        {
+            // Less than is all ones, so subtracting it counts.
+            auto counts = vdupq_n_u32(0);
+            for (std::size_t i = 0; i < node_size; i += 4)
+            {
+                if constexpr (std::is_signed_v<Key>)
+                {
+                    counts = vsubq_u32(counts, vcltq_s32(vld1q_s32(reinterpret_cast<const std::int32_t*>(p_node + i)), vdupq_n_s32(p_key)));
+                }
+                else
+                {
+                    counts = vsubq_u32(counts, vcltq_u32(vld1q_u32(reinterpret_cast<const std::uint32_t*>(p_node + i)), vdupq_n_u32(p_key)));
+                }
+            }
+
+            return vaddvq_u32(counts);
+        }
+        else if constexpr (wide_integer)
+        {
+            auto counts = vdupq_n_u64(0);
+            for (std::size_t i = 0; i < node_size; i += 2)
+            {
+                if constexpr (std::is_signed_v<Key>)
+                {
+                    counts = vsubq_u64(counts, vcltq_s64(vld1q_s64(reinterpret_cast<const std::int64_t*>(p_node + i)), vdupq_n_s64(p_key)));
+                }
+                else
+                {
+                    counts = vsubq_u64(counts, vcltq_u64(vld1q_u64(reinterpret_cast<const std::uint64_t*>(p_node + i)), vdupq_n_u64(p_key)));
+                }
+            }
+
+            return static_cast<std::size_t>(vaddvq_u64(counts));
+        }
+#endif
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < node_size; ++i)
+        {
+            count += p_node[i] < p_key;
+        }
+
+        return count;
+    }
+
+#undef MG_FLAT_SSE2
+#undef MG_FLAT_NEON
+
+    /// <summary>
+    /// A static search tree over sorted keys, for lower_bound in a fraction of the cache misses of
+    /// binary search. The sorted keys themselves are the leaves, in nodes of a cache line each; the
+    /// levels above hold the largest key of each node below, also a cache line of them to a node,
+    /// so that each level is one cache line read and one SIMD comparison (see count_less) which
+    /// picks the child. Only the separators are stored, about a fifteenth of the size of the keys.
+    /// </summary>
+    template <typename Key>
+    class flat_search_index
+    {
+    public:
+        static constexpr std::size_t node_size = flat_node_size<Key>;
+
+        /// <summary>
+        /// Rebuild the index over the given sorted, unique keys, in time linear in the number of
+        /// leaf nodes rather than of keys.
+        /// </summary>
+        void build(std::span<const Key> p_keys)
+        {
+            m_levels.clear();
+            m_level_offsets.clear();
+            if (p_keys.empty())
+            {
+                return;
+            }
+
+            // Nodes are padded with the largest key, which is never less than a key being searched
+            // for since larger keys are answered before the search begins.
+            const auto largest = p_keys.back();
+            const auto full = p_keys.size() / node_size;
+            std::fill(m_tail.begin(), m_tail.end(), largest);
+            std::copy(p_keys.begin() + static_cast<std::ptrdiff_t>(full * node_size), p_keys.end(), m_tail.begin());
+
+            std::vector<Key> separators;
+            for (std::size_t end = node_size; end < p_keys.size() + node_size; end += node_size)
+            {
+                separators.push_back(p_keys[std::min(end, p_keys.size()) - 1]);
+            }
+
+            // Bottom up, then reversed so the root comes first.
+            std::vector<std::vector<Key>> levels;
+            while (separators.size() > 1)
+            {
+                std::vector<Key> parents;
+                for (std::size_t end = node_size; end < separators.size() + node_size; end += node_size)
+                {
+                    parents.push_back(separators[std::min(end, separators.size()) - 1]);
+                }
+
+                separators.resize((separators.size() + node_size - 1) / node_size * node_size, largest);
+                levels.push_back(std::move(separators));
+                separators = std::move(parents);
+            }
+
+            for (auto level = levels.rbegin(); level != levels.rend(); ++level)
+            {
+                m_level_offsets.push_back(m_levels.size());
+                m_levels.insert(m_levels.end(), level->begin(), level->end());
+            }
+        }
+
+        /// <summary>
+        /// The position of the first of the keys not less than the given one. The keys must be
+        /// those the index was built over. Once the leaf node is known, its position is passed to
+        /// the prefetch callable, for example to fetch the corresponding values while the leaf
+        /// itself is searched.
+        /// </summary>
+        template <typename Prefetch>
+        std::size_t lower_bound(std::span<const Key> p_keys, Key p_key, const Prefetch& p_prefetch) const noexcept
+        {
+            if (p_keys.empty() || p_keys.back() < p_key)
+            {
+                return p_keys.size();
+            }
+
+            std::size_t node = 0;
+            for (const auto offset : m_level_offsets)
+            {
+                node = node * node_size + count_less(m_levels.data() + offset + node * node_size, p_key);
+            }
+
+            const auto first = node * node_size;
+            p_prefetch(first);
+            const auto* leaf = first + node_size <= p_keys.size() ? p_keys.data() + first : m_tail.data();
+            return first + count_less(leaf, p_key);
+        }
+
+    private:
+        // The internal levels, root first, each a whole number of nodes.
+        std::vector<Key> m_levels;
+        std::vector<std::size_t> m_level_offsets;
+        // The last leaf node if the keys are not a whole number of nodes, padded.
+        std::array<Key, node_size> m_tail{};
+    };
+
+    /// <summary>
+    /// The keys of a flat_map or flat_set, kept sorted and unique, with the comparator and, where
+    /// the keys allow it, a flat_search_index over them.
+    /// </summary>
+    template <typename Key, typename Compare, typename KeyContainer>
+    class flat_keys
+    {
+    public:
+        static constexpr bool indexed = flat_indexable<Key, Compare, KeyContainer>;
+
+        flat_keys() = default;
+
+        flat_keys(KeyContainer p_keys, const Compare& p_compare)
+            : m_keys(std::move(p_keys)),
+            m_compare(p_compare)
+        {
+        }
+
+        const KeyContainer& keys() const noexcept
+        {
+            return m_keys;
+        }
+
+        KeyContainer& keys() noexcept
+        {
+            return m_keys;
+        }
+
+        const Compare& compare() const noexcept
+        {
+            return m_compare;
+        }
+
+        bool less(const auto& p_lhs, const auto& p_rhs) const
+        {
+            return m_compare(p_lhs, p_rhs);
+        }
+
+        /// <summary>
+        /// Must be called after every change to the keys.
+        /// </summary>
+        void rebuild()
+        {
+            if constexpr (indexed)
+            {
+                m_index.build(std::span<const Key>(std::data(m_keys), std::size(m_keys)));
+            }
+        }
+
+        template <typename K, typename Prefetch>
+        std::size_t lower_bound(const K& p_key, const Prefetch& p_prefetch) const
+        {
+            if constexpr (!std::is_same_v<K, Key> && !requires { typename Compare::is_transparent; })
+            {
+                return lower_bound(static_cast<Key>(p_key), p_prefetch);
+            }
+            else if constexpr (indexed && std::is_same_v<K, Key>)
+            {
+                return m_index.lower_bound(std::span<const Key>(std::data(m_keys), std::size(m_keys)), p_key, p_prefetch);
+            }
+            else
+            {
+                return static_cast<std::size_t>(std::lower_bound(m_keys.begin(), m_keys.end(), p_key, m_compare) - m_keys.begin());
+            }
+        }
+
+        template <typename K>
+        std::size_t upper_bound(const K& p_key) const
+        {
+            // With unique keys, the upper bound is past the lower bound exactly when it matches.
+            const auto lower = lower_bound(p_key, [](std::size_t) {});
+            return lower != m_keys.size() && !m_compare(p_key, m_keys[lower]) ? lower + 1 : lower;
+        }
+
+        template <typename K>
+        std::size_t find(const K& p_key) const
+        {
+            const auto lower = lower_bound(p_key, [](std::size_t) {});
+            return lower != m_keys.size() && !m_compare(p_key, m_keys[lower]) ? lower : m_keys.size();
+        }
+
+        /// <summary>
+        /// The order which sorts the given keys, with the positions of all but the first of each
+        /// run of equivalent keys removed.
+        /// </summary>
+        std::vector<std::size_t> unique_order(const KeyContainer& p_keys) const
+        {
+            std::vector<std::size_t> order(std::size(p_keys));
+            for (std::size_t i = 0; i < order.size(); ++i)
+            {
+                order[i] = i;
+            }
+
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t p_lhs, std::size_t p_rhs) { return m_compare(p_keys[p_lhs], p_keys[p_rhs]); });
+            order.erase(
+                std::unique(order.begin(), order.end(), [&](std::size_t p_lhs, std::size_t p_rhs) { return !m_compare(p_keys[p_lhs], p_keys[p_rhs]); }),
+                order.end());
+            return order;
+        }
+
+        bool sorted_unique(const KeyContainer& p_keys) const
+        {
+            return std::adjacent_find(p_keys.begin(), p_keys.end(), [&](const auto& p_lhs, const auto& p_rhs) { return !m_compare(p_lhs, p_rhs); }) == p_keys.end();
+        }
+
+        void swap(flat_keys& p_other) noexcept
+        {
+            using std::swap;
+            swap(m_keys, p_other.m_keys);
+            swap(m_compare, p_other.m_compare);
+            swap(m_index, p_other.m_index);
+        }
+
+    private:
+        KeyContainer m_keys;
+        [[no_unique_address]] Compare m_compare;
+        [[no_unique_address]] std::conditional_t<indexed, flat_search_index<Key>, std::tuple<>> m_index;
+    };
+
+    /// <summary>
+    /// Gather the elements of a container at the given positions, in that order.
+    /// </summary>
+    template <typename Container>
+    Container gather(Container& p_from, const std::vector<std::size_t>& p_order)
+    {
+        Container result;
+        if constexpr (requires { result.reserve(p_order.size()); })
+        {
+            result.reserve(p_order.size());
+        }
+
+        for (const auto position : p_order)
+        {
+            result.insert(result.end(), std::move(p_from[position]));
+        }
+
+        return result;
+    }
+}
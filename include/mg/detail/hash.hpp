@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The splitmix64 finalizer, used to scramble hashes before they are reduced to a table index.
+    /// </summary>
+    constexpr std::uint64_t mix_hash(std::uint64_t p_value) noexcept
+    {
+        p_value = (p_value ^ (p_value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        p_value = (p_value ^ (p_value >> 27)) * 0x94d049bb133111ebull;
+        return p_value ^ (p_value >> 31);
+    }
+
+    /// <summary>
+    /// Map 32 uniformly distributed bits onto [0, p_range) with a multiply and a shift, rather than
+    /// a division.
+    /// </summary>
+    constexpr std::size_t reduce_hash(std::uint32_t p_bits, std::size_t p_range) noexcept
+    {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(p_bits) * p_range) >> 32);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <bit>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The log-linear bucket layout of a latency histogram with 2^Bits sub-buckets. Values below
+    /// 2^Bits have a bucket each. Above that, every power of two range is split into 2^(Bits - 1)
+    /// equal buckets, so a bucket is never wider than 2^-(Bits - 1) of the values in it.
+    /// </summary>
+    template <unsigned Bits>
+    struct log_linear_buckets
+    {
+        static_assert(Bits >= 2 && Bits <= 16, "The histogram precision must be between 2 and 16 bits.");
+
+        static constexpr std::uint64_t linear_count = std::uint64_t(1) << Bits;
+        static constexpr std::uint64_t half_count = linear_count / 2;
+        static constexpr std::size_t bucket_count = linear_count + (64 - Bits) * half_count;
+
+        static constexpr std::size_t index_of(std::uint64_t p_value) noexcept
+        {
+            if (p_value < linear_count)
+            {
+                return static_cast<std::size_t>(p_value);
+            }
+
+            const auto shift = static_cast<unsigned>(std::bit_width(p_value)) - Bits;
+            const auto mantissa = p_value >> shift;
+            return static_cast<std::size_t>(linear_count + (shift - 1) * half_count + (mantissa - half_count));
+        }
+
+        static constexpr std::uint64_t lowest_equivalent(std::size_t p_index) noexcept
+        {
+            if (p_index < linear_count)
+            {
+                return p_index;
+            }
+
+            const auto shift = (p_index - linear_count) / half_count + 1;
+            const auto mantissa = (p_index - linear_count) % half_count + half_count;
+            return static_cast<std::uint64_t>(mantissa) << shift;
+        }
+
+        static constexpr std::uint64_t highest_equivalent(std::size_t p_index) noexcept
+        {
+            if (p_index < linear_count)
+            {
+                return p_index;
+            }
+
+            const auto shift = (p_index - linear_count) / half_count + 1;
+            return lowest_equivalent(p_index) + ((std::uint64_t(1) << shift) - 1);
+        }
+    };
+
+    /// <summary>
+    /// A small index unique to the calling thread (until more threads than fit in a size_t have
+    /// started), used to spread threads over the shards of a sharded histogram.
+    /// </summary>
+    inline std::size_t histogram_thread_index() noexcept
+    {
+        static std::atomic<std::size_t> next{ 0 };
+        thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+}
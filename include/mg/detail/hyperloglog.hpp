@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MG_HLL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Raise each register to the corresponding register of another set, which is how two sketches
+    /// are merged, a vector of registers at a time.
+    /// </summary>
+    inline void max_registers(std::uint8_t* p_into, const std::uint8_t* p_from, std::size_t p_count) noexcept
+    {
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 32 <= p_count; i += 32)
+        {
+            const auto into = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_into + i));
+            const auto from = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_from + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p_into + i), _mm256_max_epu8(into, from));
+        }
+#elif defined(MG_HLL_SSE2)
+        for (; i + 16 <= p_count; i += 16)
+        {
+            const auto into = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_into + i));
+            const auto from = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_from + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p_into + i), _mm_max_epu8(into, from));
+        }
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+        for (; i + 16 <= p_count; i += 16)
+        {
+            vst1q_u8(p_into + i, vmaxq_u8(vld1q_u8(p_into + i), vld1q_u8(p_from + i)));
+        }
+#endif
+        for (; i < p_count; ++i)
+        {
+            p_into[i] = std::max(p_into[i], p_from[i]);
+        }
+    }
+
+#undef MG_HLL_SSE2
+
+    /// <summary>
+    /// Count how many registers hold each value. Four interleaved tables break the dependency
+    /// between consecutive increments of the same count, which is otherwise the bottleneck since
+    /// most registers of a well filled sketch hold one of a few values.
+    /// </summary>
+    template <std::size_t Values>
+    std::array<std::uint32_t, Values> register_histogram(const std::uint8_t* p_registers, std::size_t p_count) noexcept
+    {
+        std::array<std::array<std::uint32_t, Values>, 4> partial{};
+        std::size_t i = 0;
+        for (; i + 4 <= p_count; i += 4)
+        {
+            ++partial[0][p_registers[i]];
+            ++partial[1][p_registers[i + 1]];
+            ++partial[2][p_registers[i + 2]];
+            ++partial[3][p_registers[i + 3]];
+        }
+
+        for (; i < p_count; ++i)
+        {
+            ++partial[0][p_registers[i]];
+        }
+
+        for (std::size_t v = 0; v < Values; ++v)
+        {
+            partial[0][v] += partial[1][v] + partial[2][v] + partial[3][v];
+        }
+
+        return partial[0];
+    }
+
+    inline double hll_sigma(double p_x) noexcept
+    {
+        if (p_x == 1.0)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        double y = 1.0;
+        double z = p_x;
+        double previous;
+        do
+        {
+            p_x *= p_x;
+            previous = z;
+            z += p_x * y;
+            y += y;
+        } while (z != previous);
+
+        return z;
+    }
+
+    inline double hll_tau(double p_x) noexcept
+    {
+        if (p_x == 0.0 || p_x == 1.0)
+        {
+            return 0.0;
+        }
+
+        double y = 1.0;
+        double z = 1.0 - p_x;
+        double previous;
+        do
+        {
+            p_x = std::sqrt(p_x);
+            previous = z;
+            y *= 0.5;
+            z -= (1.0 - p_x) * (1.0 - p_x) * y;
+        } while (z != previous);
+
+        return z / 3.0;
+    }
+
+    /// <summary>
+    /// The improved raw estimator of Ertl ("New cardinality estimation algorithms for HyperLogLog
+    /// sketches", 2017), computed from the histogram of register values. It is unbiased over the
+    /// whole range of cardinalities, from empty to far beyond the number of registers, without the
+    /// empirical bias tables or the switch to linear counting of the original algorithm.
+    /// </summary>
+    /// <param name="p_counts">For each value, the number of registers holding it; the last value
+    /// is the largest a register can hold.</param>
+    template <std::size_t Values>
+    double hll_estimate(const std::array<std::uint32_t, Values>& p_counts, double p_registers) noexcept
+    {
+        constexpr auto q = Values - 2;
+        if (p_counts[0] == p_registers)
+        {
+            return 0.0;
+        }
+
+        auto z = p_registers * hll_tau(1.0 - p_counts[q + 1] / p_registers);
+        for (auto k = q; k >= 1; --k)
+        {
+            z = 0.5 * (z + p_counts[k]);
+        }
+
+        z += p_registers * hll_sigma(p_counts[0] / p_registers);
+        return p_registers * p_registers / (2.0 * std::log(2.0) * z);
+    }
+}
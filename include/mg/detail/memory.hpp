@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Header of a block owned by an arena, followed directly by the usable bytes of the block.
+    /// </summary>
+    struct alignas(std::max_align_t) arena_block
+    {
+        std::byte* data() noexcept
+        {
+            return reinterpret_cast<std::byte*>(this + 1);
+        }
+
+        arena_block* m_next = nullptr;
+        std::size_t m_size = 0;
+    };
+
+    /// <summary>
+    /// Round an address up to the given power of two alignment.
+    /// </summary>
+    inline std::uintptr_t align_up(std::uintptr_t p_address, std::size_t p_alignment) noexcept
+    {
+        return (p_address + (p_alignment - 1)) & ~static_cast<std::uintptr_t>(p_alignment - 1);
+    }
+
+    /// <summary>
+    /// Process wide free lists of fixed size chunks, one instance for every chunk size and alignment.
+    /// This follows the same arrangement as the thread_pool task node cache: an optional thread local
+    /// list in front of a shared, locked list, which in turn is refilled a slab of chunks at a time.
+    /// Slabs are never returned, and as with the task node cache the shared state is never destroyed.
+    /// </summary>
+    template <std::size_t Size, std::size_t Align>
+    class fixed_pool
+    {
+    public:
+        static constexpr std::size_t chunk_alignment = std::max(Align, alignof(void*));
+        static constexpr std::size_t chunk_size = (std::max(Size, sizeof(void*)) + chunk_alignment - 1) / chunk_alignment * chunk_alignment;
+
+        static void* acquire()
+        {
+            auto& shared = shared_list();
+            std::scoped_lock lock(shared.m_mutex);
+            if (shared.m_head == nullptr)
+            {
+                shared.add_slab();
+            }
+
+            return pop(shared.m_head);
+        }
+
+        static void release(void* p_chunk) noexcept
+        {
+            auto& shared = shared_list();
+            std::scoped_lock lock(shared.m_mutex);
+            push(shared.m_head, p_chunk);
+        }
+
+        static void* acquire_local()
+        {
+            auto& local = local_list();
+            if (local.m_head == nullptr)
+            {
+                shared_list().refill(local);
+            }
+
+            --local.m_count;
+            return pop(local.m_head);
+        }
+
+        static void release_local(void* p_chunk) noexcept
+        {
+            auto& local = local_list();
+            push(local.m_head, p_chunk);
+            if (++local.m_count > max_local_count)
+            {
+                shared_list().drain(local, max_local_count / 2);
+            }
+        }
+
+    private:
+        static constexpr std::size_t slab_count = std::max<std::size_t>(4096 / chunk_size, 16);
+        static constexpr std::size_t max_local_count = slab_count * 8;
+
+        struct free_chunk
+        {
+            free_chunk* m_next;
+        };
+
+        static void push(free_chunk*& p_head, void* p_chunk) noexcept
+        {
+            auto* chunk = ::new (p_chunk) free_chunk{ p_head };
+            p_head = chunk;
+        }
+
+        static void* pop(free_chunk*& p_head) noexcept
+        {
+            auto* chunk = p_head;
+            p_head = chunk->m_next;
+            return chunk;
+        }
+
+        struct local_free_list;
+
+        struct shared_free_list
+        {
+            void add_slab()
+            {
+                m_slabs.reserve(m_slabs.size() + 1);
+                auto* slab = static_cast<std::byte*>(::operator new(chunk_size * slab_count, std::align_val_t(chunk_alignment)));
+                m_slabs.push_back(slab);
+                for (std::size_t i = slab_count; i-- > 0;)
+                {
+                    push(m_head, slab + i * chunk_size);
+                }
+            }
+
+            void refill(local_free_list& p_local)
+            {
+                std::scoped_lock lock(m_mutex);
+                if (m_head == nullptr)
+                {
+                    add_slab();
+                }
+
+                for (std::size_t i = 0; i < slab_count && m_head != nullptr; ++i)
+                {
+                    push(p_local.m_head, pop(m_head));
+                    ++p_local.m_count;
+                }
+            }
+
+            void drain(local_free_list& p_local, std::size_t p_keep) noexcept
+            {
+                std::scoped_lock lock(m_mutex);
+                for (; p_local.m_count > p_keep; --p_local.m_count)
+                {
+                    push(m_head, pop(p_local.m_head));
+                }
+            }
+
+            std::mutex m_mutex;
+            free_chunk* m_head = nullptr;
+            std::vector<std::byte*> m_slabs;
+        };
+
+        struct local_free_list
+        {
+            ~local_free_list()
+            {
+                shared_list().drain(*this, 0);
+            }
+
+            free_chunk* m_head = nullptr;
+            std::size_t m_count = 0;
+        };
+
+        static shared_free_list& shared_list()
+        {
+            static auto* list = new shared_free_list();
+            return *list;
+        }
+
+        static local_free_list& local_list()
+        {
+            thread_local local_free_list list;
+            return list;
+        }
+    };
+
+    /// <summary>
+    /// A statistics counter, either atomic (relaxed, so only the totals are meaningful) or a plain
+    /// integer for single threaded or thread local use.
+    /// </summary>
+    template <bool Atomic>
+    class stats_counter
+    {
+    public:
+        std::size_t add(std::size_t p_amount) noexcept
+        {
+            return m_value.fetch_add(p_amount, std::memory_order_relaxed) + p_amount;
+        }
+
+        void subtract(std::size_t p_amount) noexcept
+        {
+            m_value.fetch_sub(p_amount, std::memory_order_relaxed);
+        }
+
+        void raise_to(std::size_t p_value) noexcept
+        {
+            auto current = m_value.load(std::memory_order_relaxed);
+            while (current < p_value && !m_value.compare_exchange_weak(current, p_value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        std::size_t load() const noexcept
+        {
+            return m_value.load(std::memory_order_relaxed);
+        }
+
+        void reset() noexcept
+        {
+            m_value.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<std::size_t> m_value{ 0 };
+    };
+
+    template <>
+    class stats_counter<false>
+    {
+    public:
+        std::size_t add(std::size_t p_amount) noexcept
+        {
+            return m_value += p_amount;
+        }
+
+        void subtract(std::size_t p_amount) noexcept
+        {
+            m_value -= p_amount;
+        }
+
+        void raise_to(std::size_t p_value) noexcept
+        {
+            m_value = std::max(m_value, p_value);
+        }
+
+        std::size_t load() const noexcept
+        {
+            return m_value;
+        }
+
+        void reset() noexcept
+        {
+            m_value = 0;
+        }
+
+    private:
+        std::size_t m_value = 0;
+    };
+}
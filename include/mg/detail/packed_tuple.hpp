@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <cstdlib>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Compute the physical order of a set of types such that laying them out one after another
+    /// produces no padding between members. Types are ordered by descending alignment and then by
+    /// descending size, with ties keeping their logical order so that the layout is stable.
+    /// </summary>
+    /// <typeparam name="...Ts">The types in their logical order.</typeparam>
+    /// <returns>For each physical slot, the logical index of the type stored there.</returns>
+    template <typename... Ts>
+    constexpr std::array<std::size_t, sizeof...(Ts)> packed_order()
+    {
+        constexpr std::array<std::size_t, sizeof...(Ts)> alignments{ alignof(Ts)... };
+        constexpr std::array<std::size_t, sizeof...(Ts)> sizes{ sizeof(Ts)... };
+
+        auto before = [&](std::size_t p_lhs, std::size_t p_rhs)
+        {
+            if (alignments[p_lhs] != alignments[p_rhs])
+            {
+                return alignments[p_lhs] > alignments[p_rhs];
+            }
+
+            return sizes[p_lhs] > sizes[p_rhs];
+        };
+
+        std::array<std::size_t, sizeof...(Ts)> order{};
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+
+        // Insertion sort, since it is stable and the packs are small.
+        for (std::size_t i = 1; i < order.size(); ++i)
+        {
+            for (std::size_t j = i; j > 0 && before(order[j], order[j - 1]); --j)
+            {
+                std::swap(order[j], order[j - 1]);
+            }
+        }
+
+        return order;
+    }
+
+    /// <summary>
+    /// Invert a permutation, mapping logical indices to physical slots.
+    /// </summary>
+    template <std::size_t N>
+    constexpr std::array<std::size_t, N> invert_order(const std::array<std::size_t, N>& p_order)
+    {
+        std::array<std::size_t, N> inverse{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            inverse[p_order[i]] = i;
+        }
+
+        return inverse;
+    }
+
+    template <typename... Ts>
+    inline constexpr auto packed_order_v = packed_order<Ts...>();
+
+    template <typename... Ts>
+    inline constexpr auto packed_slots_v = invert_order(packed_order_v<Ts...>);
+
+    /// <summary>
+    /// Tag to construct packed storage by asking a getter for the initializer of every slot.
+    /// </summary>
+    struct from_getter_t {};
+
+    /// <summary>
+    /// Recursive storage of members in the exact order given. When the types are in descending
+    /// alignment order, nesting the tail inside its own struct introduces no padding beyond what a
+    /// flat struct would have, since every alignment evenly divides the alignments before it.
+    /// </summary>
+    /// <typeparam name="...Ts">The types in their physical order.</typeparam>
+    template <typename... Ts>
+    struct packed_storage
+    {
+        constexpr packed_storage() = default;
+
+        template <typename Getter>
+        constexpr packed_storage(from_getter_t, Getter&&)
+        {
+        }
+    };
+
+    template <typename T>
+    struct packed_storage<T>
+    {
+        constexpr packed_storage()
+            : m_head()
+        {
+        }
+
+        template <typename Getter>
+        constexpr packed_storage(from_getter_t, Getter&& p_getter)
+            : m_head(p_getter(std::integral_constant<std::size_t, 0>{}))
+        {
+        }
+
+        template <std::size_t Slot>
+        constexpr T& slot() noexcept
+        {
+            static_assert(Slot == 0, "The slot index is out of range.");
+            return m_head;
+        }
+
+        template <std::size_t Slot>
+        constexpr const T& slot() const noexcept
+        {
+            static_assert(Slot == 0, "The slot index is out of range.");
+            return m_head;
+        }
+
+        T m_head;
+    };
+
+    template <typename T, typename U, typename... Ts>
+    struct packed_storage<T, U, Ts...>
+    {
+        constexpr packed_storage()
+            : m_head(),
+            m_tail()
+        {
+        }
+
+        /// <summary>
+        /// Construct every slot from the getter, which is called with the slot index as an
+        /// integral_constant and returns the initializer for that slot.
+        /// </summary>
+        template <typename Getter>
+        constexpr packed_storage(from_getter_t, Getter&& p_getter)
+            : m_head(p_getter(std::integral_constant<std::size_t, 0>{})),
+            m_tail(from_getter_t{}, [&]<std::size_t Slot>(std::integral_constant<std::size_t, Slot>) -> decltype(auto)
+                {
+                    return p_getter(std::integral_constant<std::size_t, Slot + 1>{});
+                })
+        {
+        }
+
+        template <std::size_t Slot>
+        constexpr auto& slot() noexcept
+        {
+            if constexpr (Slot == 0)
+            {
+                return m_head;
+            }
+            else
+            {
+                return m_tail.template slot<Slot - 1>();
+            }
+        }
+
+        template <std::size_t Slot>
+        constexpr const auto& slot() const noexcept
+        {
+            if constexpr (Slot == 0)
+            {
+                return m_head;
+            }
+            else
+            {
+                return m_tail.template slot<Slot - 1>();
+            }
+        }
+
+        T m_head;
+        packed_storage<U, Ts...> m_tail;
+    };
+
+    /// <summary>
+    /// Rebind the logical types into some template in their physical order. Only used in an
+    /// unevaluated context.
+    /// </summary>
+    template <template <typename...> typename Tmpl, typename... Ts, std::size_t... Is>
+    Tmpl<std::tuple_element_t<packed_order_v<Ts...>[Is], std::tuple<Ts...>>...> packed_layout(std::index_sequence<Is...>);
+}
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "mg/thread_pool.hpp"
+#include "mg/utility.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Invoke a callable, replacing a void result with std::monostate so that it can be stored in a
+    /// tuple.
+    /// </summary>
+    template <typename Fn, typename... Args>
+    decltype(auto) invoke_to_value(Fn&& p_fn, Args&&... p_args)
+    {
+        if constexpr (std::is_void_v<std::invoke_result_t<Fn&&, Args&&...>>)
+        {
+            std::invoke(std::forward<Fn>(p_fn), std::forward<Args>(p_args)...);
+            return std::monostate{};
+        }
+        else
+        {
+            return std::invoke(std::forward<Fn>(p_fn), std::forward<Args>(p_args)...);
+        }
+    }
+
+    template <typename Fn, typename Tuple, std::size_t Idx>
+    using mapped_element_t = std::decay_t<decltype(invoke_to_value(std::declval<Fn&>(), mg::get<Idx>{}(std::declval<Tuple&&>())))>;
+
+    template <typename Fn, typename Tuple, std::size_t... Is>
+    auto parallel_tuple_map_submit(thread_pool& p_executor, Tuple&& p_tuple, Fn& p_fn, std::index_sequence<Is...>)
+    {
+        using Result = decltype(std::make_tuple(std::declval<mapped_element_t<Fn, Tuple, Is>>()...));
+
+        auto invoke_at = [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) -> mapped_element_t<Fn, Tuple, Idx>
+        {
+            return invoke_to_value(p_fn, mg::get<Idx>{}(std::forward<Tuple>(p_tuple)));
+        };
+
+        // Every element but the first is submitted to the executor and the first is run inline.
+        std::tuple<mg::future<mapped_element_t<Fn, Tuple, Is>>...> futures;
+        try
+        {
+            ((Is == 0
+                ? void()
+                : void(std::get<Is>(futures) = p_executor.submit([&invoke_at] { return invoke_at(std::integral_constant<std::size_t, Is>{}); }))), ...);
+        }
+        catch (...)
+        {
+            // The tasks already submitted reference this frame, so they must finish before it unwinds.
+            ((std::get<Is>(futures).valid() ? std::get<Is>(futures).wait() : void()), ...);
+            throw;
+        }
+
+        std::optional<mapped_element_t<Fn, Tuple, 0>> first;
+        std::exception_ptr firstException;
+        try
+        {
+            first.emplace(invoke_at(std::integral_constant<std::size_t, 0>{}));
+        }
+        catch (...)
+        {
+            firstException = std::current_exception();
+        }
+
+        // Everything must have finished before anything is thrown since the tasks reference the
+        // tuple and the callable.
+        ((Is == 0 ? void() : std::get<Is>(futures).wait()), ...);
+        if (firstException)
+        {
+            std::rethrow_exception(firstException);
+        }
+
+        auto take = [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>) -> mapped_element_t<Fn, Tuple, Idx>
+        {
+            if constexpr (Idx == 0)
+            {
+                return std::move(*first);
+            }
+            else
+            {
+                return std::get<Idx>(futures).get();
+            }
+        };
+
+        // Braced initialization guarantees left to right evaluation, so the first exception by index
+        // is the one that escapes.
+        return Result{ take(std::integral_constant<std::size_t, Is>{})... };
+    }
+
+    template <typename Fn, typename Tuple, std::size_t... Is>
+    auto parallel_tuple_map_impl(thread_pool* p_executor, Tuple&& p_tuple, Fn& p_fn, std::index_sequence<Is...>)
+    {
+        if constexpr (sizeof...(Is) >= 2)
+        {
+            if (p_executor != nullptr)
+            {
+                return parallel_tuple_map_submit(*p_executor, std::forward<Tuple>(p_tuple), p_fn, std::index_sequence<Is...>{});
+            }
+        }
+
+        using Result = decltype(std::make_tuple(std::declval<mapped_element_t<Fn, Tuple, Is>>()...));
+        return Result{ invoke_to_value(p_fn, mg::get<Is>{}(std::forward<Tuple>(p_tuple)))... };
+    }
+
+    /// <summary>
+    /// The number of elements in each leaf of the tree transform_reduce combines, and the number
+    /// of interleaved accumulators a leaf is reduced with. Both are fixed so that the shape of the
+    /// tree, and so the order of every operation, depends on nothing but the number of elements.
+    /// </summary>
+    inline constexpr std::size_t reduce_leaf_size = 4096;
+    inline constexpr std::size_t reduce_lanes = 8;
+
+    /// <summary>
+    /// Accumulates by the reduce operation alone.
+    /// </summary>
+    template <typename T, typename Reduce>
+    struct plain_accumulator
+    {
+        using partial = T;
+
+        partial start(T&& p_value) const
+        {
+            return std::move(p_value);
+        }
+
+        void add(partial& p_partial, T&& p_value) const
+        {
+            p_partial = std::invoke(m_reduce, std::move(p_partial), std::move(p_value));
+        }
+
+        partial merge(partial&& p_lhs, partial&& p_rhs) const
+        {
+            return std::invoke(m_reduce, std::move(p_lhs), std::move(p_rhs));
+        }
+
+        T finish(partial&& p_partial) const
+        {
+            return std::move(p_partial);
+        }
+
+        const Reduce& m_reduce;
+    };
+
+    /// <summary>
+    /// Accumulates a sum along with the rounding error of each addition (Neumaier's variant of
+    /// Kahan summation, which also holds when an addend is larger than the running sum), and adds
+    /// the error back at the end.
+    /// </summary>
+    template <typename T>
+    struct compensated_accumulator
+    {
+        struct partial
+        {
+            T sum;
+            T compensation;
+        };
+
+        partial start(T p_value) const
+        {
+            return { p_value, T(0) };
+        }
+
+        void add(partial& p_partial, T p_value) const
+        {
+            const T sum = p_partial.sum + p_value;
+            p_partial.compensation += std::abs(p_partial.sum) >= std::abs(p_value) ? (p_partial.sum - sum) + p_value : (p_value - sum) + p_partial.sum;
+            p_partial.sum = sum;
+        }
+
+        partial merge(partial p_lhs, partial p_rhs) const
+        {
+            add(p_lhs, p_rhs.sum);
+            p_lhs.compensation += p_rhs.compensation;
+            return p_lhs;
+        }
+
+        T finish(partial p_partial) const
+        {
+            return p_partial.sum + p_partial.compensation;
+        }
+    };
+
+    /// <summary>
+    /// Combine the partials of [first, last) in a balanced binary tree.
+    /// </summary>
+    template <typename Accumulator, typename Partial>
+    auto merge_tree(const Accumulator& p_accumulator, std::size_t p_first, std::size_t p_last, const Partial& p_partial)
+    {
+        if (p_last - p_first == 1)
+        {
+            return p_partial(p_first);
+        }
+
+        const auto middle = p_first + (p_last - p_first) / 2;
+        auto lhs = merge_tree(p_accumulator, p_first, middle, p_partial);
+        return p_accumulator.merge(std::move(lhs), merge_tree(p_accumulator, middle, p_last, p_partial));
+    }
+
+    template <typename Accumulator, typename Element>
+    auto reduce_sequential(const Accumulator& p_accumulator, const Element& p_element, std::size_t p_first, std::size_t p_last)
+    {
+        auto partial = p_accumulator.start(p_element(p_first));
+        for (auto i = p_first + 1; i < p_last; ++i)
+        {
+            p_accumulator.add(partial, p_element(i));
+        }
+
+        return partial;
+    }
+
+    /// <summary>
+    /// Reduce [first, last) into reduce_lanes accumulators, element i going to lane i % lanes,
+    /// which the compiler can keep in one vector register, then combine the lanes in a tree.
+    /// </summary>
+    template <typename Accumulator, typename Element>
+    auto reduce_interleaved(const Accumulator& p_accumulator, const Element& p_element, std::size_t p_first, std::size_t p_last)
+    {
+        if (p_last - p_first < reduce_lanes)
+        {
+            return reduce_sequential(p_accumulator, p_element, p_first, p_last);
+        }
+
+        auto lanes = [&]<std::size_t... Lanes>(std::index_sequence<Lanes...>)
+        {
+            return std::array{ p_accumulator.start(p_element(p_first + Lanes))... };
+        }(std::make_index_sequence<reduce_lanes>{});
+
+        auto i = p_first + reduce_lanes;
+        for (; i + reduce_lanes <= p_last; i += reduce_lanes)
+        {
+            for (std::size_t lane = 0; lane < reduce_lanes; ++lane)
+            {
+                p_accumulator.add(lanes[lane], p_element(i + lane));
+            }
+        }
+
+        for (std::size_t lane = 0; i < p_last; ++i, ++lane)
+        {
+            p_accumulator.add(lanes[lane], p_element(i));
+        }
+
+        return merge_tree(p_accumulator, 0, reduce_lanes, [&lanes](std::size_t p_lane) { return std::move(lanes[p_lane]); });
+    }
+
+    /// <summary>
+    /// Reduce [first, last) by halving down to runs of reduce_lanes elements.
+    /// </summary>
+    template <typename Accumulator, typename Element>
+    auto reduce_pairwise(const Accumulator& p_accumulator, const Element& p_element, std::size_t p_first, std::size_t p_last)
+    {
+        if (p_last - p_first <= reduce_lanes)
+        {
+            return reduce_sequential(p_accumulator, p_element, p_first, p_last);
+        }
+
+        const auto middle = p_first + (p_last - p_first) / 2;
+        auto lhs = reduce_pairwise(p_accumulator, p_element, p_first, middle);
+        return p_accumulator.merge(std::move(lhs), reduce_pairwise(p_accumulator, p_element, middle, p_last));
+    }
+
+    template <bool Pairwise, typename T, typename Accumulator, typename Element>
+    T transform_reduce_impl(thread_pool* p_executor, std::size_t p_size, T p_init, const Accumulator& p_accumulator, const Element& p_element)
+    {
+        if (p_size == 0)
+        {
+            return p_init;
+        }
+
+        const auto leaves = (p_size + reduce_leaf_size - 1) / reduce_leaf_size;
+        auto reduce_leaf = [&](std::size_t p_leaf)
+        {
+            const auto first = p_leaf * reduce_leaf_size;
+            const auto last = std::min(p_size, first + reduce_leaf_size);
+            if constexpr (Pairwise)
+            {
+                return reduce_pairwise(p_accumulator, p_element, first, last);
+            }
+            else
+            {
+                return reduce_interleaved(p_accumulator, p_element, first, last);
+            }
+        };
+
+        using partial = decltype(reduce_leaf(0));
+        auto total = [&]
+        {
+            if (p_executor == nullptr || leaves == 1)
+            {
+                return merge_tree(p_accumulator, 0, leaves, reduce_leaf);
+            }
+
+            // The leaves are reduced in parallel, in any order, but always combined in the same tree.
+            std::vector<std::optional<partial>> partials(leaves);
+            p_executor->parallel_for(std::views::iota(std::size_t(0), leaves), 1, [&](std::size_t p_leaf) { partials[p_leaf].emplace(reduce_leaf(p_leaf)); });
+            return merge_tree(p_accumulator, 0, leaves, [&partials](std::size_t p_leaf) { return std::move(*partials[p_leaf]); });
+        }();
+
+        return p_accumulator.finish(p_accumulator.merge(p_accumulator.start(std::move(p_init)), std::move(total)));
+    }
+
+    /// <summary>
+    /// Combine the elements [First, Last) of a tuple in a balanced binary tree.
+    /// </summary>
+    template <std::size_t First, std::size_t Last, typename Tuple, typename Reduce>
+    auto reduce_tuple_tree(Tuple& p_tuple, const Reduce& p_reduce)
+    {
+        if constexpr (Last - First == 1)
+        {
+            return std::move(std::get<First>(p_tuple));
+        }
+        else
+        {
+            constexpr auto middle = First + (Last - First) / 2;
+            auto lhs = reduce_tuple_tree<First, middle>(p_tuple, p_reduce);
+            return std::invoke(p_reduce, std::move(lhs), reduce_tuple_tree<middle, Last>(p_tuple, p_reduce));
+        }
+    }
+}
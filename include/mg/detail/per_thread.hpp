@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// Hands out small indices for per_thread instances (so that a thread can find its slot by
+    /// indexing rather than searching) and serial numbers which are never reused (so that a thread
+    /// can tell a recycled index from the instance it cached a slot for). Never destroyed, so that
+    /// per_thread instances with static storage duration can still release their index.
+    /// </summary>
+    class per_thread_ids
+    {
+    public:
+        static per_thread_ids& instance()
+        {
+            static auto* ids = new per_thread_ids();
+            return *ids;
+        }
+
+        std::size_t acquire()
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_free.empty())
+            {
+                return m_next++;
+            }
+
+            const auto id = m_free.back();
+            m_free.pop_back();
+            return id;
+        }
+
+        void release(std::size_t p_id)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_free.push_back(p_id);
+        }
+
+        static std::uint64_t next_serial() noexcept
+        {
+            static std::atomic<std::uint64_t> serial{ 0 };
+            return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<std::size_t> m_free;
+        std::size_t m_next = 0;
+    };
+
+    /// <summary>
+    /// The shared state of a per_thread instance: every slot ever created and those free for reuse.
+    /// It is kept alive by the instance and by every thread holding one of its slots, so that either
+    /// may go first.
+    /// </summary>
+    template <typename T, typename Slot>
+    struct per_thread_control
+    {
+        explicit per_thread_control(std::function<T()> p_init)
+            : m_init(std::move(p_init))
+        {
+        }
+
+        Slot* acquire()
+        {
+            std::scoped_lock lock(m_mutex);
+            if (!m_free.empty())
+            {
+                auto* slot = m_free.back();
+                m_free.pop_back();
+                return slot;
+            }
+
+            auto slot = std::make_unique<Slot>(std::in_place, m_init());
+
+            // Keep room for every slot to be freed, so that releasing (at thread exit) cannot throw.
+            m_free.reserve(m_slots.size() + 1);
+            m_slots.push_back(std::move(slot));
+            return m_slots.back().get();
+        }
+
+        void release(Slot* p_slot) noexcept
+        {
+            std::scoped_lock lock(m_mutex);
+            m_free.push_back(p_slot);
+        }
+
+        std::function<T()> m_init;
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<Slot>> m_slots;
+        std::vector<Slot*> m_free;
+    };
+
+    /// <summary>
+    /// A thread's slot in one per_thread instance.
+    /// </summary>
+    struct per_thread_entry
+    {
+        std::uint64_t m_serial = 0;
+        void* m_slot = nullptr;
+
+        /// <summary>
+        /// The instance's control block, kept alive until the slot has been handed back to it with
+        /// m_release.
+        /// </summary>
+        std::shared_ptr<void> m_control;
+        void (*m_release)(void* p_control, void* p_slot) = nullptr;
+    };
+
+    /// <summary>
+    /// The current thread's slots, indexed by per_thread instance index. When the thread exits every
+    /// slot is handed back for reuse by a later thread.
+    /// </summary>
+    struct per_thread_entries
+    {
+        ~per_thread_entries();
+
+        std::vector<per_thread_entry> m_entries;
+    };
+
+    /// <summary>
+    /// The current thread's entries, or null before the thread first uses a per_thread. Kept as a
+    /// trivially destructible thread local so that finding a slot is a plain TLS load.
+    /// </summary>
+    inline thread_local std::vector<per_thread_entry>* t_per_thread_entries = nullptr;
+    inline thread_local bool t_per_thread_exited = false;
+
+    inline per_thread_entries::~per_thread_entries()
+    {
+        t_per_thread_entries = nullptr;
+        t_per_thread_exited = true;
+        for (auto& entry : m_entries)
+        {
+            if (entry.m_release != nullptr)
+            {
+                entry.m_release(entry.m_control.get(), entry.m_slot);
+            }
+        }
+    }
+
+    /// <summary>
+    /// The current thread's entry for the given instance index, which is empty or stale if the
+    /// thread has not used that instance. Null once the thread's entries have been destroyed (when
+    /// called from another thread local destructor).
+    /// </summary>
+    inline per_thread_entry* thread_entry(std::size_t p_index)
+    {
+        if (t_per_thread_entries == nullptr) [[unlikely]]
+        {
+            if (t_per_thread_exited)
+            {
+                return nullptr;
+            }
+
+            thread_local per_thread_entries entries;
+            t_per_thread_entries = &entries.m_entries;
+        }
+
+        auto& entries = *t_per_thread_entries;
+        if (p_index >= entries.size())
+        {
+            entries.resize(std::max(p_index + 1, entries.size() * 2));
+        }
+
+        return &entries[p_index];
+    }
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define MG_PROBE_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MG_PROBE_HAS_TSC 1
+#else
+#define MG_PROBE_HAS_TSC 0
+#endif
+
+namespace mg::probe
+{
+    enum class kind
+    {
+        counter,
+        gauge,
+        timer
+    };
+}
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The number of 64 bit slots available to probes in every thread. Counters and gauges take one
+    /// slot and timers take three (count, total ticks, and maximum ticks).
+    /// </summary>
+    inline constexpr std::size_t probe_slot_count = 1024;
+
+    /// <summary>
+    /// A thread's probe values. Slots are only ever written by the owning thread (with relaxed loads
+    /// and stores, so no locked instructions) and are read by whichever thread aggregates them. Each
+    /// block is cache line aligned so that threads never share a line.
+    /// </summary>
+    struct alignas(64) probe_thread_block
+    {
+        void add(std::size_t p_slot, std::uint64_t p_amount) noexcept
+        {
+            auto& slot = m_slots[p_slot];
+            slot.store(slot.load(std::memory_order_relaxed) + p_amount, std::memory_order_relaxed);
+        }
+
+        void raise_to(std::size_t p_slot, std::uint64_t p_value) noexcept
+        {
+            auto& slot = m_slots[p_slot];
+            if (slot.load(std::memory_order_relaxed) < p_value)
+            {
+                slot.store(p_value, std::memory_order_relaxed);
+            }
+        }
+
+        std::array<std::atomic<std::uint64_t>, probe_slot_count> m_slots{};
+    };
+
+    /// <summary>
+    /// A raw timestamp, from the time stamp counter where available and the steady clock otherwise.
+    /// </summary>
+    inline std::uint64_t probe_ticks() noexcept
+    {
+#if MG_PROBE_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    struct probe_descriptor
+    {
+        std::string m_name;
+        probe::kind m_kind;
+        std::size_t m_slot;
+    };
+
+    /// <summary>
+    /// Process wide record of the registered probes and of every thread's block of values. The
+    /// values of exited threads are folded into a retired block so that nothing is lost, which
+    /// is why the registry is never destroyed: a thread may exit after static destruction.
+    /// </summary>
+    class probe_registry
+    {
+    public:
+        static probe_registry& instance()
+        {
+            static auto* registry = new probe_registry();
+            return *registry;
+        }
+
+        /// <summary>
+        /// Register a probe, returning its first slot. Registering an existing name returns the
+        /// slot already assigned to it, so that probes with the same name are aggregated together.
+        /// </summary>
+        std::size_t register_probe(std::string_view p_name, probe::kind p_kind)
+        {
+            std::scoped_lock lock(m_mutex);
+            for (const auto& descriptor : m_descriptors)
+            {
+                if (descriptor.m_name == p_name)
+                {
+                    if (descriptor.m_kind != p_kind)
+                    {
+                        throw std::invalid_argument("A probe with this name is already registered with a different kind.");
+                    }
+
+                    return descriptor.m_slot;
+                }
+            }
+
+            const auto width = p_kind == probe::kind::timer ? 3 : 1;
+            if (m_usedSlots + width > probe_slot_count)
+            {
+                throw std::length_error("There are no probe slots remaining.");
+            }
+
+            m_descriptors.push_back({ std::string(p_name), p_kind, m_usedSlots });
+            m_usedSlots += width;
+            return m_descriptors.back().m_slot;
+        }
+
+        probe_thread_block* attach()
+        {
+            auto* block = new probe_thread_block();
+            std::scoped_lock lock(m_mutex);
+            m_blocks.push_back(block);
+            return block;
+        }
+
+        void detach(probe_thread_block* p_block) noexcept
+        {
+            std::scoped_lock lock(m_mutex);
+            for (const auto& descriptor : m_descriptors)
+            {
+                merge(m_retired, *p_block, descriptor);
+            }
+
+            std::erase(m_blocks, p_block);
+            delete p_block;
+        }
+
+        /// <summary>
+        /// Call the visitor with every probe and its values summed over all threads (as a block).
+        /// </summary>
+        template <typename Visitor>
+        void visit(Visitor&& p_visitor)
+        {
+            std::scoped_lock lock(m_mutex);
+            for (const auto& descriptor : m_descriptors)
+            {
+                probe_thread_block total;
+                merge(total, m_retired, descriptor);
+                for (auto* block : m_blocks)
+                {
+                    merge(total, *block, descriptor);
+                }
+
+                p_visitor(descriptor, total);
+            }
+        }
+
+        void reset() noexcept
+        {
+            std::scoped_lock lock(m_mutex);
+            for (auto* block : m_blocks)
+            {
+                clear(*block);
+            }
+
+            clear(m_retired);
+        }
+
+        /// <summary>
+        /// Nanoseconds per tick. With the time stamp counter this is calibrated against the steady
+        /// clock over the lifetime of the registry, so it costs nothing on the recording path and
+        /// gets more accurate the later it is asked for (waiting briefly if asked very early).
+        /// </summary>
+        double nanoseconds_per_tick() const
+        {
+#if MG_PROBE_HAS_TSC
+            constexpr auto MinimumWindow = std::chrono::milliseconds(10);
+            while (std::chrono::steady_clock::now() - m_startTime < MinimumWindow)
+            {
+            }
+
+            const auto ticks = probe_ticks() - m_startTicks;
+            const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_startTime);
+            return ticks == 0 ? 0.0 : elapsed.count() / static_cast<double>(ticks);
+#else
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration(1)).count();
+#endif
+        }
+
+    private:
+        probe_registry()
+            : m_startTicks(probe_ticks()),
+            m_startTime(std::chrono::steady_clock::now())
+        {
+        }
+
+        static void merge(probe_thread_block& p_into, const probe_thread_block& p_from, const probe_descriptor& p_descriptor) noexcept
+        {
+            const auto load = [&](std::size_t p_offset) { return p_from.m_slots[p_descriptor.m_slot + p_offset].load(std::memory_order_relaxed); };
+            p_into.add(p_descriptor.m_slot, load(0));
+            if (p_descriptor.m_kind == probe::kind::timer)
+            {
+                p_into.add(p_descriptor.m_slot + 1, load(1));
+                p_into.raise_to(p_descriptor.m_slot + 2, load(2));
+            }
+        }
+
+        static void clear(probe_thread_block& p_block) noexcept
+        {
+            for (auto& slot : p_block.m_slots)
+            {
+                slot.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::mutex m_mutex;
+        std::vector<probe_descriptor> m_descriptors;
+        std::size_t m_usedSlots = 0;
+        std::vector<probe_thread_block*> m_blocks;
+        probe_thread_block m_retired;
+        std::uint64_t m_startTicks;
+        std::chrono::steady_clock::time_point m_startTime;
+    };
+
+    /// <summary>
+    /// The current thread's block, or null before the thread first records anything. Kept as a
+    /// trivially destructible thread local so that the recording fast path is a plain TLS load.
+    /// </summary>
+    inline thread_local probe_thread_block* t_probe_block = nullptr;
+
+    /// <summary>
+    /// Owns a thread's block and hands its values to the registry when the thread exits. Recording
+    /// after that point (from other thread local destructors) goes to a discarded block.
+    /// </summary>
+    struct probe_thread_owner
+    {
+        probe_thread_owner()
+            : m_block(probe_registry::instance().attach())
+        {
+        }
+
+        ~probe_thread_owner()
+        {
+            static auto* discarded = new probe_thread_block();
+            t_probe_block = discarded;
+            probe_registry::instance().detach(m_block);
+        }
+
+        probe_thread_block* m_block;
+    };
+
+    inline probe_thread_block& probe_block()
+    {
+        if (t_probe_block == nullptr) [[unlikely]]
+        {
+            thread_local probe_thread_owner owner;
+            t_probe_block = owner.m_block;
+        }
+
+        return *t_probe_block;
+    }
+}
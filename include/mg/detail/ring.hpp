@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The size that is assumed for a cache line when separating data written by different threads:
+    /// std::hardware_destructive_interference_size where the standard library provides it, and 64
+    /// otherwise. GCC warns about any use of the constant, since it depends on the tuning flags, so
+    /// that is silenced; every part of a program should be built with the same flags anyway.
+    /// </summary>
+#if defined(__cpp_lib_hardware_interference_size)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+    inline constexpr std::size_t cache_line_size = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+    inline constexpr std::size_t cache_line_size = 64;
+#endif
+
+    /// <summary>
+    /// Hint to the processor that the current thread is busy waiting.
+    /// </summary>
+    inline void cpu_relax() noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    /// <summary>
+    /// Uninitialized storage for one element of a ring.
+    /// </summary>
+    template <typename T>
+    struct ring_slot
+    {
+        T* get() noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(m_storage));
+        }
+
+        alignas(T) std::byte m_storage[sizeof(T)];
+    };
+
+    /// <summary>
+    /// A ring slot tagged with the sequence number used by the Vyukov bounded queue to tell which lap
+    /// of the ring the slot is ready for.
+    /// </summary>
+    template <typename T>
+    struct sequenced_ring_slot : ring_slot<T>
+    {
+        std::atomic<std::size_t> m_sequence{ 0 };
+    };
+
+    /// <summary>
+    /// The slots of a ring with a power of two capacity fixed at compile time, held inline.
+    /// </summary>
+    template <typename Slot, std::size_t Capacity>
+    class ring_storage
+    {
+    public:
+        static_assert(std::has_single_bit(Capacity), "The capacity of a ring must be a power of two.");
+
+        static constexpr std::size_t capacity() noexcept
+        {
+            return Capacity;
+        }
+
+        Slot& operator[](std::size_t p_position) noexcept
+        {
+            return m_slots[p_position & (Capacity - 1)];
+        }
+
+    private:
+        std::array<Slot, Capacity> m_slots;
+    };
+
+    /// <summary>
+    /// The slots of a ring with a capacity chosen at runtime, which is rounded up to a power of two.
+    /// </summary>
+    template <typename Slot>
+    class ring_storage<Slot, std::dynamic_extent>
+    {
+    public:
+        explicit ring_storage(std::size_t p_capacity)
+            : m_mask(checked_capacity(p_capacity) - 1),
+            m_slots(std::make_unique<Slot[]>(m_mask + 1))
+        {
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return m_mask + 1;
+        }
+
+        Slot& operator[](std::size_t p_position) noexcept
+        {
+            return m_slots[p_position & m_mask];
+        }
+
+    private:
+        static std::size_t checked_capacity(std::size_t p_capacity)
+        {
+            if (p_capacity == 0 || p_capacity > (std::size_t(1) << (sizeof(std::size_t) * 8 - 2)))
+            {
+                throw std::invalid_argument("The capacity of a ring must be non-zero and representable as a power of two.");
+            }
+
+            return std::bit_ceil(p_capacity);
+        }
+
+        std::size_t m_mask;
+        std::unique_ptr<Slot[]> m_slots;
+    };
+
+    /// <summary>
+    /// Parks the blocking operations of a ring using the escalation of the given wait strategy, and
+    /// wakes them after the opposite side makes progress. The predicate given to wait_until is the
+    /// operation itself, so it is attempted (and only succeeds) once per check. Strategies which never sleep make notify
+    /// free; those that do cost a fence per notification, plus a system call only when a thread is
+    /// actually asleep.
+    /// </summary>
+    template <typename Wait>
+    class ring_waiter
+    {
+    public:
+        template <typename Ready>
+        void wait_until(Ready&& p_ready)
+        {
+            for (std::size_t i = 0; i < Wait::spin_count; ++i)
+            {
+                if (p_ready())
+                {
+                    return;
+                }
+
+                cpu_relax();
+            }
+
+            for (std::size_t i = 0; i < Wait::yield_count; ++i)
+            {
+                if (p_ready())
+                {
+                    return;
+                }
+
+                std::this_thread::yield();
+            }
+
+            for (;;)
+            {
+                if constexpr (Wait::blocks)
+                {
+                    // Announce the sleeper before the final check so that a notifier which misses it
+                    // is guaranteed to be seen by the check instead (and vice versa).
+                    const auto epoch = m_epoch.load(std::memory_order_acquire);
+                    m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                    bool ready;
+                    try
+                    {
+                        ready = p_ready();
+                    }
+                    catch (...)
+                    {
+                        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                        throw;
+                    }
+
+                    if (!ready)
+                    {
+                        m_epoch.wait(epoch, std::memory_order_acquire);
+                    }
+
+                    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    if (ready)
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    if (p_ready())
+                    {
+                        return;
+                    }
+
+                    if constexpr (Wait::yield_count != 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    else
+                    {
+                        cpu_relax();
+                    }
+                }
+            }
+        }
+
+        void notify() noexcept
+        {
+            if constexpr (Wait::blocks)
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_sleepers.load(std::memory_order_relaxed) != 0)
+                {
+                    m_epoch.fetch_add(1, std::memory_order_release);
+                    m_epoch.notify_all();
+                }
+            }
+        }
+
+    private:
+        alignas(cache_line_size) std::atomic<std::uint32_t> m_epoch{ 0 };
+        std::atomic<std::uint32_t> m_sleepers{ 0 };
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <type_traits>
 #include <utility>
 
 namespace mg::detail
@@ -31,4 +33,20 @@ namespace mg::detail
             return make_offset_sequence<T, Min, Max, Stride, Ints..., next>();
         }
     }
+
+    /// <summary>
+    /// The position of the first occurrence of T in Ts, or sizeof...(Ts) if it does not occur.
+    /// </summary>
+    template <typename T, typename... Ts>
+    constexpr std::size_t type_index_of() noexcept
+    {
+        constexpr bool matches[] = { std::is_same_v<T, Ts>..., false };
+        std::size_t index = 0;
+        while (index < sizeof...(Ts) && !matches[index])
+        {
+            ++index;
+        }
+
+        return index;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,829 @@
+#pragma once
+
+#include "mg/collections.hpp"
+#include "mg/utility.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mg::detail
+{
+    template <typename T>
+    concept wire_scalar = (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+    template <typename T>
+    concept wire_tuple = std::is_class_v<T> && requires { std::tuple_size<T>::value; };
+
+    template <typename T>
+    struct is_wire_sequence : std::false_type {};
+
+    template <typename T, typename Alloc>
+    struct is_wire_sequence<std::vector<T, Alloc>> : std::true_type {};
+
+    template <typename Char, typename Traits, typename Alloc>
+    struct is_wire_sequence<std::basic_string<Char, Traits, Alloc>> : std::true_type {};
+
+    template <typename T, std::size_t Extent>
+    struct is_wire_sequence<std::span<T, Extent>> : std::true_type {};
+
+    template <typename T>
+    concept wire_sequence = is_wire_sequence<T>::value;
+
+    /// <summary>
+    /// A trivially copyable class which is neither tuple-like nor a sequence, and so is written as its
+    /// object representation.
+    /// </summary>
+    template <typename T>
+    concept wire_class = std::is_class_v<T> && std::is_trivially_copyable_v<T> && !wire_tuple<T> && !wire_sequence<T>;
+
+    template <typename T, typename Fn>
+    constexpr bool all_tuple_elements(Fn p_fn)
+    {
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+        {
+            return (p_fn.template operator()<std::remove_cvref_t<std::tuple_element_t<Is, T>>>() && ...);
+        }(std::make_index_sequence<std::tuple_size_v<T>>());
+    }
+
+    template <typename T>
+    constexpr bool is_wire_serializable()
+    {
+        if constexpr (wire_scalar<T> || wire_class<T>)
+        {
+            return true;
+        }
+        else if constexpr (wire_tuple<T>)
+        {
+            return all_tuple_elements<T>([]<typename E>() { return is_wire_serializable<E>(); });
+        }
+        else if constexpr (wire_sequence<T>)
+        {
+            return is_wire_serializable<std::remove_cv_t<std::ranges::range_value_t<T>>>();
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    template <std::unsigned_integral U>
+    constexpr U byteswap(U p_value) noexcept
+    {
+        U result = 0;
+        for (std::size_t i = 0; i < sizeof(U); ++i)
+        {
+            result = static_cast<U>((result << 8) | (p_value & 0xff));
+            p_value = static_cast<U>(p_value >> 8);
+        }
+
+        return result;
+    }
+
+    template <std::size_t Size>
+    using unsigned_of_size = std::conditional_t<Size == 1, std::uint8_t,
+        std::conditional_t<Size == 2, std::uint16_t,
+        std::conditional_t<Size == 4, std::uint32_t, std::uint64_t>>>;
+
+    constexpr std::size_t varint_size(std::uint64_t p_value) noexcept
+    {
+        return std::max<std::size_t>(1, (static_cast<std::size_t>(std::bit_width(p_value)) + 6) / 7);
+    }
+
+    /// <summary>
+    /// Writes into a fixed region of memory, which lies within a buffer starting at p_begin.
+    /// </summary>
+    class wire_writer
+    {
+    public:
+        wire_writer(std::byte* p_begin, std::byte* p_cursor, std::byte* p_end) noexcept
+            : m_begin(p_begin),
+            m_cursor(p_cursor),
+            m_end(p_end)
+        {
+        }
+
+        std::byte* cursor() const noexcept
+        {
+            return m_cursor;
+        }
+
+        std::byte* reserve(std::size_t p_bytes)
+        {
+            if (p_bytes > static_cast<std::size_t>(m_end - m_cursor))
+            {
+                throw std::length_error("The buffer is too small for the serialized value.");
+            }
+
+            return std::exchange(m_cursor, m_cursor + p_bytes);
+        }
+
+        void bytes(const void* p_data, std::size_t p_bytes)
+        {
+            auto* out = reserve(p_bytes);
+            if (p_bytes != 0)
+            {
+                std::memcpy(out, p_data, p_bytes);
+            }
+        }
+
+        void varint(std::uint64_t p_value)
+        {
+            auto* out = reserve(varint_size(p_value));
+            while (p_value >= 0x80)
+            {
+                *out++ = static_cast<std::byte>((p_value & 0x7f) | 0x80);
+                p_value >>= 7;
+            }
+
+            *out = static_cast<std::byte>(p_value);
+        }
+
+        /// <summary>
+        /// Write the length of the padding, then the padding, so that the next write is aligned
+        /// relative to the start of the buffer. The encoding so does not depend on where the buffer
+        /// lies in memory, nor change if the buffer is moved.
+        /// </summary>
+        void pad(std::size_t p_alignment)
+        {
+            const auto offset = static_cast<std::size_t>(m_cursor - m_begin) + 1;
+            const auto padding = (p_alignment - offset % p_alignment) % p_alignment;
+            auto* out = reserve(1 + padding);
+            std::memset(out, 0, 1 + padding);
+            *out = static_cast<std::byte>(padding);
+        }
+
+    private:
+        std::byte* m_begin;
+        std::byte* m_cursor;
+        std::byte* m_end;
+    };
+
+    /// <summary>
+    /// Consumes bytes from the front of a span.
+    /// </summary>
+    class wire_reader
+    {
+    public:
+        explicit wire_reader(std::span<const std::byte>& p_in) noexcept
+            : m_in(&p_in)
+        {
+        }
+
+        std::size_t remaining() const noexcept
+        {
+            return m_in->size();
+        }
+
+        const std::byte* take(std::size_t p_bytes)
+        {
+            if (p_bytes > m_in->size())
+            {
+                throw std::invalid_argument("The serialized data is truncated.");
+            }
+
+            const auto* result = m_in->data();
+            *m_in = m_in->subspan(p_bytes);
+            return result;
+        }
+
+        std::uint64_t varint()
+        {
+            std::uint64_t result = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7)
+            {
+                const auto byte = std::to_integer<std::uint64_t>(*take(1));
+                result |= (byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    if (shift == 63 && byte > 1)
+                    {
+                        break;
+                    }
+
+                    return result;
+                }
+            }
+
+            throw std::invalid_argument("The serialized data contains an invalid integer.");
+        }
+
+        void skip_padding(std::size_t p_alignment)
+        {
+            const auto padding = std::to_integer<std::size_t>(*take(1));
+            if (padding >= p_alignment)
+            {
+                throw std::invalid_argument("The serialized data contains invalid padding.");
+            }
+
+            take(padding);
+        }
+
+    private:
+        std::span<const std::byte>* m_in;
+    };
+
+    /// <summary>
+    /// Whether a tuple-like type's members lie in their declared order with no padding, so that its
+    /// object representation is the concatenation of theirs. The layout of std::tuple is unspecified
+    /// (libstdc++ stores its members in reverse), so this is checked once on a probe object.
+    /// </summary>
+    template <typename T>
+    bool has_packed_layout() noexcept
+    {
+        static const bool packed = []
+        {
+            const T probe{};
+            const auto* base = reinterpret_cast<const std::byte*>(std::addressof(probe));
+            std::size_t offset = 0;
+            bool result = true;
+            mg::iter_zipped_tuples([&](const auto& p_member)
+                {
+                    result = result && reinterpret_cast<const std::byte*>(std::addressof(p_member)) == base + offset;
+                    offset += sizeof(p_member);
+                }, probe);
+            return result && offset == sizeof(T);
+        }();
+        return packed;
+    }
+
+    /// <summary>
+    /// The encoding of values in a wire format, which writes scalars in a fixed byte order (or
+    /// integers as varints), tuple-like types as their elements in order, sequences as a varint count
+    /// followed by their elements, and other trivially copyable classes as their object representation.
+    /// </summary>
+    /// <remarks>Values whose object representation is already their encoding (raw values) are copied
+    /// with a single memcpy, as are contiguous arrays of them. Arrays of fixed width elements are
+    /// preceded by padding which aligns them in memory, so that raw arrays can be viewed in place.</remarks>
+    template <typename Format>
+    struct wire_codec
+    {
+        static constexpr bool native = Format::order == std::endian::native;
+
+        template <typename T>
+        static constexpr bool is_varint_scalar()
+        {
+            if constexpr (std::is_enum_v<T>)
+            {
+                return is_varint_scalar<std::underlying_type_t<T>>();
+            }
+            else
+            {
+                return Format::varint && std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) > 1;
+            }
+        }
+
+        /// <summary>
+        /// Whether every value of the type has the same encoded size.
+        /// </summary>
+        template <typename T>
+        static constexpr bool is_fixed_width()
+        {
+            if constexpr (wire_scalar<T>)
+            {
+                return !is_varint_scalar<T>();
+            }
+            else if constexpr (wire_tuple<T>)
+            {
+                return all_tuple_elements<T>([]<typename E>() { return is_fixed_width<E>(); });
+            }
+            else
+            {
+                return wire_class<T>;
+            }
+        }
+
+        /// <summary>
+        /// The alignment given to arrays of a fixed width type. Scalars use their size, rather than
+        /// their (platform dependent) alignment, so that the padding is the same everywhere.
+        /// </summary>
+        template <typename T>
+        static constexpr std::size_t wire_alignment()
+        {
+            if constexpr (wire_scalar<T>)
+            {
+                return sizeof(T);
+            }
+            else if constexpr (wire_tuple<T>)
+            {
+                std::size_t result = 1;
+                all_tuple_elements<T>([&]<typename E>() { result = std::max(result, wire_alignment<E>()); return true; });
+                return result;
+            }
+            else
+            {
+                return alignof(T);
+            }
+        }
+
+        /// <summary>
+        /// Whether a type is raw irrespective of its layout: a scalar in the format's byte order, or a
+        /// trivially copyable class.
+        /// </summary>
+        template <typename T>
+        static constexpr bool is_raw_scalar_or_class()
+        {
+            if constexpr (wire_scalar<T>)
+            {
+                return sizeof(T) == 1 || (native && !is_varint_scalar<T>());
+            }
+            else
+            {
+                return wire_class<T>;
+            }
+        }
+
+        template <typename T>
+        static constexpr bool may_be_raw()
+        {
+            if constexpr (wire_tuple<T>)
+            {
+                return std::is_default_constructible_v<T> && !std::is_polymorphic_v<T>
+                    && all_tuple_elements<T>([]<typename E>() { return may_be_raw<E>(); });
+            }
+            else
+            {
+                return is_raw_scalar_or_class<T>();
+            }
+        }
+
+        template <typename T>
+        static bool is_raw() noexcept
+        {
+            if constexpr (!may_be_raw<T>())
+            {
+                return false;
+            }
+            else if constexpr (wire_tuple<T>)
+            {
+                return all_tuple_elements<T>([]<typename E>() { return is_raw<E>(); }) && has_packed_layout<T>();
+            }
+            else
+            {
+                return true;
+            }
+        }
+
+        template <typename T>
+        static constexpr std::size_t min_size()
+        {
+            if constexpr (wire_scalar<T>)
+            {
+                return is_varint_scalar<T>() ? 1 : sizeof(T);
+            }
+            else if constexpr (wire_tuple<T>)
+            {
+                std::size_t result = 0;
+                all_tuple_elements<T>([&]<typename E>() { result += min_size<E>(); return true; });
+                return result;
+            }
+            else if constexpr (wire_sequence<T>)
+            {
+                return 1;
+            }
+            else
+            {
+                return sizeof(T);
+            }
+        }
+
+        template <typename T>
+        static std::size_t max_size(const T& p_value)
+        {
+            if constexpr (is_fixed_width<T>())
+            {
+                return min_size<T>();
+            }
+            else if constexpr (wire_scalar<T>)
+            {
+                return varint_size(to_varint(p_value));
+            }
+            else if constexpr (wire_tuple<T>)
+            {
+                std::size_t result = 0;
+                mg::iter_zipped_tuples([&result](const auto& p_element) { result += max_size(p_element); }, p_value);
+                return result;
+            }
+            else
+            {
+                using element_type = std::remove_cv_t<std::ranges::range_value_t<T>>;
+                const auto count = static_cast<std::size_t>(std::ranges::size(p_value));
+                auto result = varint_size(count);
+                if constexpr (is_fixed_width<element_type>())
+                {
+                    result += array_padding<element_type>() + count * min_size<element_type>();
+                }
+                else
+                {
+                    for (const auto& element : p_value)
+                    {
+                        result += max_size(element);
+                    }
+                }
+
+                return result;
+            }
+        }
+
+        template <typename T>
+        static constexpr std::size_t array_padding()
+        {
+            return wire_alignment<T>() > 1 ? wire_alignment<T>() : 0;
+        }
+
+        template <typename T>
+        static void pad_array(wire_writer& p_out)
+        {
+            if constexpr (array_padding<T>() != 0)
+            {
+                p_out.pad(wire_alignment<T>());
+            }
+        }
+
+        template <typename T>
+        static void skip_array_padding(wire_reader& p_in)
+        {
+            if constexpr (array_padding<T>() != 0)
+            {
+                p_in.skip_padding(wire_alignment<T>());
+            }
+        }
+
+        template <typename T>
+        static std::uint64_t to_varint(T p_value) noexcept
+        {
+            if constexpr (std::is_enum_v<T>)
+            {
+                return to_varint(static_cast<std::underlying_type_t<T>>(p_value));
+            }
+            else if constexpr (std::is_signed_v<T>)
+            {
+                // Zigzag, so that small negative values are also short.
+                const auto value = static_cast<std::int64_t>(p_value);
+                return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+            }
+            else
+            {
+                return static_cast<std::uint64_t>(p_value);
+            }
+        }
+
+        template <typename T>
+        static T from_varint(std::uint64_t p_value)
+        {
+            if constexpr (std::is_enum_v<T>)
+            {
+                return static_cast<T>(from_varint<std::underlying_type_t<T>>(p_value));
+            }
+            else
+            {
+                const auto value = std::is_signed_v<T>
+                    ? static_cast<std::uint64_t>(static_cast<std::int64_t>(p_value >> 1) ^ -static_cast<std::int64_t>(p_value & 1))
+                    : p_value;
+                const auto result = static_cast<T>(value);
+                if (static_cast<std::uint64_t>(static_cast<std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>(result)) != value)
+                {
+                    throw std::invalid_argument("The serialized data contains an out of range integer.");
+                }
+
+                return result;
+            }
+        }
+
+        template <typename T>
+        static void write_fixed(T p_value, std::byte* p_out) noexcept
+        {
+            auto bits = std::bit_cast<unsigned_of_size<sizeof(T)>>(p_value);
+            if constexpr (!native)
+            {
+                bits = byteswap(bits);
+            }
+
+            std::memcpy(p_out, &bits, sizeof(bits));
+        }
+
+        template <typename T>
+        static T read_fixed(const std::byte* p_in) noexcept
+        {
+            unsigned_of_size<sizeof(T)> bits;
+            std::memcpy(&bits, p_in, sizeof(bits));
+            if constexpr (!native)
+            {
+                bits = byteswap(bits);
+            }
+
+            return std::bit_cast<T>(bits);
+        }
+
+        template <typename T>
+        static void write(const T& p_value, wire_writer& p_out)
+        {
+            if constexpr (wire_scalar<T>)
+            {
+                if constexpr (is_varint_scalar<T>())
+                {
+                    p_out.varint(to_varint(p_value));
+                }
+                else
+                {
+                    write_fixed(p_value, p_out.reserve(sizeof(T)));
+                }
+            }
+            else if constexpr (wire_tuple<T>)
+            {
+                if constexpr (may_be_raw<T>())
+                {
+                    if (is_raw<T>())
+                    {
+                        p_out.bytes(std::addressof(p_value), sizeof(T));
+                        return;
+                    }
+                }
+
+                mg::iter_zipped_tuples([&p_out](const auto& p_element) { write(p_element, p_out); }, p_value);
+            }
+            else if constexpr (wire_sequence<T>)
+            {
+                write_array(std::ranges::size(p_value), p_value, p_out);
+            }
+            else
+            {
+                static_assert(native, "Classes which are not tuple-like are written as their object representation, so only in native byte order.");
+                p_out.bytes(std::addressof(p_value), sizeof(T));
+            }
+        }
+
+        template <typename Range>
+        static void write_array(std::size_t p_count, const Range& p_elements, wire_writer& p_out)
+        {
+            using element_type = std::remove_cv_t<std::ranges::range_value_t<Range>>;
+            p_out.varint(p_count);
+            if constexpr (is_fixed_width<element_type>())
+            {
+                pad_array<element_type>(p_out);
+                if constexpr (std::ranges::contiguous_range<const Range> && may_be_raw<element_type>())
+                {
+                    if (is_raw<element_type>())
+                    {
+                        p_out.bytes(std::ranges::data(p_elements), p_count * sizeof(element_type));
+                        return;
+                    }
+                }
+            }
+
+            for (const auto& element : p_elements)
+            {
+                write(element, p_out);
+            }
+        }
+
+        template <typename T>
+        static T read(wire_reader& p_in)
+        {
+            if constexpr (wire_scalar<T>)
+            {
+                if constexpr (is_varint_scalar<T>())
+                {
+                    return from_varint<T>(p_in.varint());
+                }
+                else
+                {
+                    return read_fixed<T>(p_in.take(sizeof(T)));
+                }
+            }
+            else if constexpr (wire_tuple<T>)
+            {
+                static_assert(std::is_default_constructible_v<T>, "Tuple-like types are deserialized by assigning to each element of a default constructed value.");
+                T value{};
+                if constexpr (may_be_raw<T>())
+                {
+                    if (is_raw<T>())
+                    {
+                        std::memcpy(static_cast<void*>(std::addressof(value)), p_in.take(sizeof(T)), sizeof(T));
+                        return value;
+                    }
+                }
+
+                mg::iter_zipped_tuples([&p_in](auto& p_element) { p_element = read<std::remove_cvref_t<decltype(p_element)>>(p_in); }, value);
+                return value;
+            }
+            else if constexpr (wire_sequence<T>)
+            {
+                static_assert(requires(T& p_sequence) { p_sequence.push_back(std::declval<typename T::value_type>()); }, "Spans cannot be deserialized into; see view_array.");
+                return read_sequence<T>(p_in);
+            }
+            else
+            {
+                static_assert(native, "Classes which are not tuple-like are read as their object representation, so only in native byte order.");
+                std::array<std::byte, sizeof(T)> bytes;
+                std::memcpy(bytes.data(), p_in.take(sizeof(T)), sizeof(T));
+                return std::bit_cast<T>(bytes);
+            }
+        }
+
+        static std::size_t read_count(wire_reader& p_in, std::size_t p_minSize)
+        {
+            const auto count = p_in.varint();
+            if (p_minSize != 0 && count > p_in.remaining() / p_minSize)
+            {
+                throw std::invalid_argument("The serialized data is truncated.");
+            }
+
+            return static_cast<std::size_t>(count);
+        }
+
+        template <typename T>
+        static T read_sequence(wire_reader& p_in)
+        {
+            using element_type = typename T::value_type;
+            const auto count = read_count(p_in, min_size<element_type>());
+            T result;
+            if constexpr (is_fixed_width<element_type>())
+            {
+                skip_array_padding<element_type>(p_in);
+                if constexpr (std::ranges::contiguous_range<T> && may_be_raw<element_type>())
+                {
+                    if (is_raw<element_type>())
+                    {
+                        result.resize(count);
+                        if (count != 0)
+                        {
+                            std::memcpy(static_cast<void*>(std::ranges::data(result)), p_in.take(count * sizeof(element_type)), count * sizeof(element_type));
+                        }
+
+                        return result;
+                    }
+                }
+            }
+
+            result.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                result.push_back(read<element_type>(p_in));
+            }
+
+            return result;
+        }
+
+        template <typename T>
+        static std::span<const T> view_array(std::size_t p_count, wire_reader& p_in)
+        {
+            static_assert(is_raw_scalar_or_class<T>(), "Only arrays of scalars in native byte order (and not varints) or of trivially copyable classes can be viewed in place.");
+            skip_array_padding<T>(p_in);
+            const auto* data = p_in.take(p_count * sizeof(T));
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+            {
+                throw std::invalid_argument("The serialized array is not suitably aligned to be viewed in place.");
+            }
+
+            return std::span<const T>(reinterpret_cast<const T*>(data), p_count);
+        }
+
+        template <typename Tuple>
+        static std::size_t max_columns_size(std::span<const Tuple> p_rows)
+        {
+            auto result = varint_size(p_rows.size());
+            [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                (
+                    [&]
+                    {
+                        using element_type = std::remove_cvref_t<std::tuple_element_t<Is, Tuple>>;
+                        if constexpr (is_fixed_width<element_type>())
+                        {
+                            result += array_padding<element_type>() + p_rows.size() * min_size<element_type>();
+                        }
+                        else
+                        {
+                            for (const auto& row : p_rows)
+                            {
+                                result += max_size(mg::get<Is>{}(row));
+                            }
+                        }
+                    }(), ...);
+            }(std::make_index_sequence<std::tuple_size_v<Tuple>>());
+            return result;
+        }
+
+        template <typename Tuple>
+        static void write_columns(std::span<const Tuple> p_rows, wire_writer& p_out)
+        {
+            p_out.varint(p_rows.size());
+            [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                (write_column<Is>(p_rows, p_out), ...);
+            }(std::make_index_sequence<std::tuple_size_v<Tuple>>());
+        }
+
+        template <std::size_t Idx, typename Tuple>
+        static void write_column(std::span<const Tuple> p_rows, wire_writer& p_out)
+        {
+            using element_type = std::remove_cvref_t<std::tuple_element_t<Idx, Tuple>>;
+            if constexpr (is_fixed_width<element_type>())
+            {
+                pad_array<element_type>(p_out);
+                if constexpr (is_raw_scalar_or_class<element_type>())
+                {
+                    // Gather the column with fixed size copies into its reserved region.
+                    auto* out = p_out.reserve(p_rows.size() * sizeof(element_type));
+                    for (const auto& row : p_rows)
+                    {
+                        std::memcpy(out, std::addressof(mg::get<Idx>{}(row)), sizeof(element_type));
+                        out += sizeof(element_type);
+                    }
+
+                    return;
+                }
+                else if constexpr (wire_scalar<element_type>)
+                {
+                    auto* out = p_out.reserve(p_rows.size() * sizeof(element_type));
+                    for (const auto& row : p_rows)
+                    {
+                        write_fixed(mg::get<Idx>{}(row), out);
+                        out += sizeof(element_type);
+                    }
+
+                    return;
+                }
+            }
+
+            for (const auto& row : p_rows)
+            {
+                write(mg::get<Idx>{}(row), p_out);
+            }
+        }
+
+        template <typename Tuple>
+        static std::vector<Tuple> read_columns(wire_reader& p_in)
+        {
+            static_assert(std::is_default_constructible_v<Tuple>, "Rows are deserialized by assigning to each element of a default constructed value.");
+            const auto count = read_count(p_in, min_size<Tuple>());
+            std::vector<Tuple> rows(count);
+            [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                (read_column<Is>(std::span<Tuple>(rows), p_in), ...);
+            }(std::make_index_sequence<std::tuple_size_v<Tuple>>());
+            return rows;
+        }
+
+        template <std::size_t Idx, typename Tuple>
+        static void read_column(std::span<Tuple> p_rows, wire_reader& p_in)
+        {
+            using element_type = std::remove_cvref_t<std::tuple_element_t<Idx, Tuple>>;
+            if constexpr (is_fixed_width<element_type>())
+            {
+                skip_array_padding<element_type>(p_in);
+                if constexpr (wire_scalar<element_type> || wire_class<element_type>)
+                {
+                    const auto* in = p_in.take(p_rows.size() * sizeof(element_type));
+                    for (auto& row : p_rows)
+                    {
+                        if constexpr (wire_scalar<element_type>)
+                        {
+                            mg::get<Idx>{}(row) = read_fixed<element_type>(in);
+                        }
+                        else
+                        {
+                            std::memcpy(std::addressof(mg::get<Idx>{}(row)), in, sizeof(element_type));
+                        }
+
+                        in += sizeof(element_type);
+                    }
+
+                    return;
+                }
+            }
+
+            for (auto& row : p_rows)
+            {
+                mg::get<Idx>{}(row) = read<element_type>(p_in);
+            }
+        }
+
+        template <typename Tuple>
+        static auto view_columns(wire_reader& p_in)
+        {
+            const auto count = read_count(p_in, min_size<Tuple>());
+            return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                // Braced initialization, so that the columns are read in order.
+                return std::tuple<std::span<const std::remove_cvref_t<std::tuple_element_t<Is, Tuple>>>...>{
+                    view_array<std::remove_cvref_t<std::tuple_element_t<Is, Tuple>>>(count, p_in)... };
+            }(std::make_index_sequence<std::tuple_size_v<Tuple>>());
+        }
+    };
+}
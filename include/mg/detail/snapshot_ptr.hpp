@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// A reader's announcement in an epoch domain: the epoch it pinned at, or zero while it is not
+    /// pinned, and how deeply its pins are nested. Only the owning thread writes either; writers
+    /// read the epoch through an atomic_ref, which keeps the record movable for per_thread.
+    /// </summary>
+    struct epoch_record
+    {
+        alignas(std::atomic_ref<std::uint64_t>::required_alignment) std::uint64_t m_epoch = 0;
+        std::uint32_t m_nesting = 0;
+    };
+
+    /// <summary>
+    /// An object unlinked from a shared structure, with the epoch it was retired in, waiting for
+    /// every reader which might still see it to unpin.
+    /// </summary>
+    struct retired_object
+    {
+        void* m_object;
+        void (*m_deleter)(void*);
+        std::uint64_t m_epoch;
+    };
+
+    /// <summary>
+    /// Whether an object retired in the given epoch can be freed, given the oldest epoch a reader
+    /// is pinned at (the maximum if none is). A reader which pinned at or before the retirement may
+    /// have loaded the object before it was unlinked; one which pinned after cannot have.
+    /// </summary>
+    constexpr bool reclaimable(std::uint64_t p_retired, std::uint64_t p_oldest_pinned) noexcept
+    {
+        return p_retired < p_oldest_pinned;
+    }
+
+    inline constexpr std::uint64_t no_pinned_epoch = std::numeric_limits<std::uint64_t>::max();
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The raw memory backing a soa_vector. A single block is allocated for a given capacity and
+    /// carved into one column per type, each column starting on a multiple of the column alignment.
+    /// This type does not track or manage the lifetime of any objects within the columns.
+    /// </summary>
+    /// <typeparam name="...Ts">The types of the columns.</typeparam>
+    template <typename... Ts>
+    struct soa_storage
+    {
+        static constexpr std::size_t alignment = std::max({ std::size_t{ 64 }, alignof(Ts)... });
+
+        static constexpr std::size_t max_capacity =
+            static_cast<std::size_t>(std::numeric_limits<std::ptrdiff_t>::max())
+            / (sizeof(Ts) + ...)
+            / 2;
+
+        /// <summary>
+        /// Allocate uninitialized storage for the given number of records.
+        /// </summary>
+        /// <param name="p_capacity">The number of records to allocate space for.</param>
+        /// <returns>The storage, which must later be released with deallocate.</returns>
+        static soa_storage allocate(std::size_t p_capacity)
+        {
+            if (p_capacity > max_capacity)
+            {
+                throw std::length_error("The requested soa_vector capacity is too large.");
+            }
+
+            soa_storage storage;
+            if (p_capacity == 0)
+            {
+                return storage;
+            }
+
+            constexpr std::array<std::size_t, sizeof...(Ts)> sizes{ sizeof(Ts)... };
+            std::array<std::size_t, sizeof...(Ts)> offsets{};
+            std::size_t total = 0;
+            for (std::size_t i = 0; i < sizes.size(); ++i)
+            {
+                offsets[i] = total;
+                total = align_up(total + (sizes[i] * p_capacity));
+            }
+
+            storage.m_block = static_cast<std::byte*>(::operator new(total, std::align_val_t{ alignment }));
+            storage.m_bytes = total;
+            storage.m_capacity = p_capacity;
+            storage.m_columns = [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                return std::tuple<Ts*...>{ reinterpret_cast<Ts*>(storage.m_block + offsets[Is])... };
+            }(std::index_sequence_for<Ts...>{});
+
+            return storage;
+        }
+
+        void deallocate() noexcept
+        {
+            if (m_block != nullptr)
+            {
+                ::operator delete(m_block, m_bytes, std::align_val_t{ alignment });
+            }
+
+            *this = soa_storage{};
+        }
+
+        template <std::size_t Idx>
+        auto column() const noexcept
+        {
+            return std::get<Idx>(m_columns);
+        }
+
+        /// <summary>
+        /// Run a construction step over every column in order with all or nothing semantics. If the
+        /// step for one column throws, the undo step is run for every column that had already
+        /// completed (in reverse order) before the exception is propagated.
+        /// </summary>
+        /// <param name="p_construct">Callable taking the column index as an integral_constant.</param>
+        /// <param name="p_undo">Callable taking the column index as an integral_constant.</param>
+        template <std::size_t Idx = 0, typename Construct, typename Undo>
+        static void construct_columns(Construct&& p_construct, Undo&& p_undo)
+        {
+            if constexpr (Idx < sizeof...(Ts))
+            {
+                p_construct(std::integral_constant<std::size_t, Idx>{});
+                try
+                {
+                    construct_columns<Idx + 1>(p_construct, p_undo);
+                }
+                catch (...)
+                {
+                    p_undo(std::integral_constant<std::size_t, Idx>{});
+                    throw;
+                }
+            }
+        }
+
+        static constexpr std::size_t align_up(std::size_t p_bytes) noexcept
+        {
+            return (p_bytes + alignment - 1) / alignment * alignment;
+        }
+
+        std::byte* m_block = nullptr;
+        std::size_t m_bytes = 0;
+        std::size_t m_capacity = 0;
+        std::tuple<Ts*...> m_columns{};
+    };
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "mg/detail/hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The number of buckets the keys of a static_map are split into, each of which is given the
+    /// pilot which displaces its keys into free slots. Around three keys to a bucket keeps the table
+    /// of pilots small while leaving the search for the last pilots short.
+    /// </summary>
+    constexpr std::size_t static_map_bucket_count(std::size_t p_size) noexcept
+    {
+        return p_size / 3 + 1;
+    }
+
+    /// <summary>
+    /// Where the entries of a static_map are placed: either a minimal perfect hash, in which a key's
+    /// slot is computed from its hash, its bucket's pilot and the seed, or, if none was found within
+    /// the budget, sorted order for binary search.
+    /// </summary>
+    template <std::size_t N>
+    struct static_map_layout
+    {
+        static constexpr std::size_t bucket_count = static_map_bucket_count(N);
+
+        bool perfect = false;
+        std::uint64_t seed = 0;
+        /// <summary>
+        /// The pilot of each bucket, stored already mixed so that finding a slot takes one multiply.
+        /// </summary>
+        std::array<std::uint64_t, bucket_count> pilots{};
+
+        constexpr std::uint64_t seeded(std::uint64_t p_hash) const noexcept
+        {
+            return mix_hash(p_hash ^ seed);
+        }
+
+        constexpr std::size_t bucket_of(std::uint64_t p_seeded) const noexcept
+        {
+            return reduce_hash(static_cast<std::uint32_t>(p_seeded >> 32), bucket_count);
+        }
+
+        static constexpr std::uint64_t mix_pilot(std::uint32_t p_pilot) noexcept
+        {
+            return mix_hash(p_pilot);
+        }
+
+        static constexpr std::size_t slot_of(std::uint64_t p_seeded, std::uint64_t p_pilot) noexcept
+        {
+            return reduce_hash(static_cast<std::uint32_t>(((p_seeded ^ p_pilot) * 0x9e3779b97f4a7c15ull) >> 32), N);
+        }
+    };
+
+    /// <summary>
+    /// Search for a minimal perfect hash of the given key hashes in the style of CHD (compress, hash
+    /// and displace): the keys are split into buckets and, largest bucket first, each bucket is given
+    /// the first pilot which sends all of its keys to distinct free slots.
+    /// </summary>
+    /// <param name="p_hashes">The hash of every key.</param>
+    /// <param name="p_budget">The number of slots which may be tried, over every seed, before giving up.</param>
+    /// <param name="p_layout">The layout to fill in.</param>
+    /// <param name="p_order">Filled in with the index of the key stored in each slot.</param>
+    /// <returns>Whether a perfect hash was found.</returns>
+    template <std::size_t N>
+    constexpr bool build_perfect_hash(const std::array<std::uint64_t, N>& p_hashes, std::size_t p_budget, static_map_layout<N>& p_layout, std::array<std::size_t, N>& p_order)
+    {
+        constexpr auto bucket_count = static_map_layout<N>::bucket_count;
+        constexpr std::size_t seed_count = 4;
+
+        for (std::size_t attempt = 0; attempt < seed_count; ++attempt)
+        {
+            p_layout.seed = mix_hash(0x5851f42d4c957f2dull + attempt);
+
+            // Group the keys by bucket, with a counting sort into the bucket offsets.
+            std::array<std::uint64_t, N> seeded{};
+            std::array<std::size_t, N> buckets{};
+            std::array<std::size_t, bucket_count + 1> offsets{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                seeded[i] = p_layout.seeded(p_hashes[i]);
+                buckets[i] = p_layout.bucket_of(seeded[i]);
+                ++offsets[buckets[i] + 1];
+            }
+
+            for (std::size_t b = 0; b < bucket_count; ++b)
+            {
+                offsets[b + 1] += offsets[b];
+            }
+
+            std::array<std::size_t, N> members{};
+            auto cursors = offsets;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                members[cursors[buckets[i]]++] = i;
+            }
+
+            std::array<std::size_t, bucket_count> by_size{};
+            for (std::size_t b = 0; b < bucket_count; ++b)
+            {
+                by_size[b] = b;
+            }
+
+            // Largest first, breaking ties by index since std::stable_sort is not constexpr.
+            std::sort(by_size.begin(), by_size.end(), [&](std::size_t p_lhs, std::size_t p_rhs)
+                {
+                    const auto lhs_size = offsets[p_lhs + 1] - offsets[p_lhs];
+                    const auto rhs_size = offsets[p_rhs + 1] - offsets[p_rhs];
+                    return lhs_size != rhs_size ? lhs_size > rhs_size : p_lhs < p_rhs;
+                });
+
+            std::array<bool, N> taken{};
+            std::array<std::size_t, N> slots{};
+            bool placed_all = true;
+            for (const auto bucket : by_size)
+            {
+                const auto first = offsets[bucket];
+                const auto last = offsets[bucket + 1];
+                if (first == last)
+                {
+                    break;
+                }
+
+                bool placed = false;
+                for (std::uint32_t pilot = 0; !placed && p_budget > 0; ++pilot)
+                {
+                    const auto mixed = static_map_layout<N>::mix_pilot(pilot);
+                    placed = true;
+                    for (auto i = first; placed && i < last; ++i)
+                    {
+                        if (p_budget == 0)
+                        {
+                            placed = false;
+                            break;
+                        }
+
+                        --p_budget;
+                        slots[i] = static_map_layout<N>::slot_of(seeded[members[i]], mixed);
+                        placed = !taken[slots[i]] && std::find(slots.begin() + first, slots.begin() + i, slots[i]) == slots.begin() + i;
+                    }
+
+                    if (placed)
+                    {
+                        p_layout.pilots[bucket] = mixed;
+                        for (auto i = first; i < last; ++i)
+                        {
+                            taken[slots[i]] = true;
+                        }
+                    }
+                }
+
+                if (!placed)
+                {
+                    placed_all = false;
+                    break;
+                }
+            }
+
+            if (placed_all)
+            {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    p_order[slots[i]] = members[i];
+                }
+
+                p_layout.perfect = true;
+                return true;
+            }
+
+            p_layout.pilots = {};
+            if (p_budget == 0)
+            {
+                break;
+            }
+        }
+
+        p_layout.seed = 0;
+        return false;
+    }
+}
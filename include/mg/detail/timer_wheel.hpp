@@ -0,0 +1,264 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The timing core of a hierarchical timer wheel, in integer ticks and without any locking.
+    /// Level L has 64 slots, each covering 64^L ticks. A timer is placed on the level of the highest
+    /// 6 bit digit in which its deadline differs from the current tick, so that each level only holds
+    /// timers for its current 64^(L+1) tick window. When the current tick reaches a slot on a higher
+    /// level, its timers are cascaded down, each timer moving at most once per level.
+    /// </summary>
+    /// <remarks>Timers are nodes in a slab (a deque, so that growing it never moves the existing
+    /// nodes), linked into their slot's list by index, so insertion and cancellation are O(1) and
+    /// reuse freed nodes. A node's generation changes whenever it is freed,
+    /// so a stale handle cancels nothing.</remarks>
+    class timer_wheel_core
+    {
+    public:
+        static constexpr unsigned slot_bits = 6;
+        static constexpr std::size_t slot_count = std::size_t(1) << slot_bits;
+        static constexpr std::size_t level_count = (64 + slot_bits - 1) / slot_bits;
+        static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+        struct handle
+        {
+            std::uint32_t m_index = npos;
+            std::uint32_t m_generation = 0;
+        };
+
+        explicit timer_wheel_core(std::uint64_t p_tick = 0) noexcept
+            : m_tick(p_tick)
+        {
+            for (auto& level : m_heads)
+            {
+                level.fill(npos);
+            }
+        }
+
+        std::uint64_t tick() const noexcept
+        {
+            return m_tick;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        /// <summary>
+        /// Add a timer. A deadline which has already passed expires on the next advance.
+        /// </summary>
+        handle insert(std::uint64_t p_deadline, std::function<void()> p_callback)
+        {
+            std::uint32_t index;
+            if (m_freeHead != npos)
+            {
+                index = m_freeHead;
+                m_freeHead = m_nodes[index].m_next;
+            }
+            else
+            {
+                index = static_cast<std::uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+            }
+
+            auto& node = m_nodes[index];
+            node.m_callback = std::move(p_callback);
+            node.m_deadline = std::max(p_deadline, m_tick);
+            link(index);
+            ++m_size;
+            return { index, node.m_generation };
+        }
+
+        /// <summary>
+        /// Remove a pending timer.
+        /// </summary>
+        /// <returns>False if the timer has already expired or been cancelled.</returns>
+        bool cancel(handle p_handle) noexcept
+        {
+            if (p_handle.m_index >= m_nodes.size() || m_nodes[p_handle.m_index].m_generation != p_handle.m_generation
+                || !m_nodes[p_handle.m_index].m_linked)
+            {
+                return false;
+            }
+
+            unlink(p_handle.m_index);
+            m_nodes[p_handle.m_index].m_callback = nullptr;
+            free(p_handle.m_index);
+            --m_size;
+            return true;
+        }
+
+        /// <summary>
+        /// Advance the current tick, appending the callbacks of every timer whose deadline has been
+        /// reached to the output in deadline order.
+        /// </summary>
+        void advance(std::uint64_t p_tick, std::vector<std::function<void()>>& p_expired)
+        {
+            while (m_size != 0)
+            {
+                const auto next = next_slot();
+                if (!next.has_value() || next->m_deadline > p_tick)
+                {
+                    break;
+                }
+
+                m_tick = next->m_deadline;
+                auto index = std::exchange(m_heads[next->m_level][next->m_slot], npos);
+                m_occupied[next->m_level] &= ~(std::uint64_t(1) << next->m_slot);
+
+                while (index != npos)
+                {
+                    auto& node = m_nodes[index];
+                    const auto following = node.m_next;
+                    node.m_linked = false;
+                    if (next->m_level == 0 || node.m_deadline <= m_tick)
+                    {
+                        p_expired.push_back(std::move(node.m_callback));
+                        node.m_callback = nullptr;
+                        free(index);
+                        --m_size;
+                    }
+                    else
+                    {
+                        link(index);
+                    }
+
+                    index = following;
+                }
+            }
+
+            m_tick = std::max(m_tick, p_tick);
+        }
+
+        /// <summary>
+        /// A tick no later than the earliest deadline (exact if it is within 64 ticks), or nothing if
+        /// there are no timers.
+        /// </summary>
+        std::optional<std::uint64_t> next_deadline() const noexcept
+        {
+            const auto next = next_slot();
+            return next.has_value() ? std::optional(next->m_deadline) : std::nullopt;
+        }
+
+    private:
+        struct node
+        {
+            std::function<void()> m_callback;
+            std::uint64_t m_deadline = 0;
+            std::uint32_t m_previous = npos;
+            std::uint32_t m_next = npos;
+            std::uint32_t m_generation = 1;
+            std::uint8_t m_level = 0;
+            std::uint8_t m_slot = 0;
+            bool m_linked = false;
+        };
+
+        struct slot_position
+        {
+            std::size_t m_level;
+            std::size_t m_slot;
+            std::uint64_t m_deadline;
+        };
+
+        void link(std::uint32_t p_index) noexcept
+        {
+            auto& node = m_nodes[p_index];
+            const auto differing = (node.m_deadline ^ m_tick) | 1;
+            const auto level = static_cast<std::size_t>(std::bit_width(differing) - 1) / slot_bits;
+            const auto slot = static_cast<std::size_t>(node.m_deadline >> (level * slot_bits)) & (slot_count - 1);
+
+            node.m_level = static_cast<std::uint8_t>(level);
+            node.m_slot = static_cast<std::uint8_t>(slot);
+            node.m_previous = npos;
+            node.m_next = m_heads[level][slot];
+            node.m_linked = true;
+            if (node.m_next != npos)
+            {
+                m_nodes[node.m_next].m_previous = p_index;
+            }
+
+            m_heads[level][slot] = p_index;
+            m_occupied[level] |= std::uint64_t(1) << slot;
+        }
+
+        void unlink(std::uint32_t p_index) noexcept
+        {
+            auto& node = m_nodes[p_index];
+            if (node.m_previous != npos)
+            {
+                m_nodes[node.m_previous].m_next = node.m_next;
+            }
+            else
+            {
+                m_heads[node.m_level][node.m_slot] = node.m_next;
+                if (node.m_next == npos)
+                {
+                    m_occupied[node.m_level] &= ~(std::uint64_t(1) << node.m_slot);
+                }
+            }
+
+            if (node.m_next != npos)
+            {
+                m_nodes[node.m_next].m_previous = node.m_previous;
+            }
+
+            node.m_linked = false;
+        }
+
+        void free(std::uint32_t p_index) noexcept
+        {
+            auto& node = m_nodes[p_index];
+            ++node.m_generation;
+            node.m_next = m_freeHead;
+            m_freeHead = p_index;
+        }
+
+        /// <summary>
+        /// The first occupied slot, on the lowest occupied level (whose timers all expire before those
+        /// of any higher level), and the tick at which it starts.
+        /// </summary>
+        std::optional<slot_position> next_slot() const noexcept
+        {
+            for (std::size_t level = 0; level < level_count; ++level)
+            {
+                if (m_occupied[level] == 0)
+                {
+                    continue;
+                }
+
+                const auto shift = level * slot_bits;
+                const auto current = static_cast<std::size_t>(m_tick >> shift) & (slot_count - 1);
+                const auto pending = m_occupied[level] >> current;
+                const auto slot = current + static_cast<std::size_t>(std::countr_zero(pending));
+
+                // The start of the slot's range within the level's current window.
+                const auto windowBits = shift + slot_bits;
+                const auto window = windowBits >= 64 ? 0 : (m_tick >> windowBits) << windowBits;
+                const auto deadline = std::max(window | (static_cast<std::uint64_t>(slot) << shift), m_tick);
+                return slot_position{ level, slot, deadline };
+            }
+
+            return std::nullopt;
+        }
+
+        std::deque<node> m_nodes;
+        std::uint32_t m_freeHead = npos;
+        std::size_t m_size = 0;
+        std::uint64_t m_tick;
+        std::array<std::array<std::uint32_t, slot_count>, level_count> m_heads;
+        std::array<std::uint64_t, level_count> m_occupied{};
+    };
+}
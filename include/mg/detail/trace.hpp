@@ -0,0 +1,356 @@
+#pragma once
+
+#include "mg/ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mg::detail
+{
+    struct trace_event
+    {
+        const char* m_name;
+        std::int64_t m_nanoseconds;
+        // The session the event was recorded in, which the flusher checks against its own.
+        std::uint32_t m_generation;
+        char m_phase;
+    };
+
+    /// <summary>
+    /// The number of events each thread can buffer between flushes. Zones which do not fit are
+    /// dropped (whole, never leaving a begin without its end) and counted.
+    /// </summary>
+    inline constexpr std::size_t trace_buffer_capacity = std::size_t(1) << 14;
+
+    /// <summary>
+    /// A thread's pending events. The owning thread is the ring's only producer and the flusher
+    /// (holding the session lock) its only consumer.
+    /// </summary>
+    struct trace_thread_buffer
+    {
+        explicit trace_thread_buffer(std::uint32_t p_threadId)
+            : m_ring(trace_buffer_capacity),
+            m_threadId(p_threadId)
+        {
+        }
+
+        spsc_ring<trace_event, std::dynamic_extent, busy_wait> m_ring;
+        std::uint32_t m_threadId;
+
+        /// <summary>
+        /// Producer only: the number of begin events whose end has not been written. Space for
+        /// their ends is kept free so that an end is never dropped.
+        /// </summary>
+        std::size_t m_open = 0;
+        std::atomic<std::uint64_t> m_dropped{ 0 };
+
+        /// <summary>
+        /// Set (under the session lock) when the thread exits during a session, so that the flusher
+        /// deletes the buffer once it has written the remaining events.
+        /// </summary>
+        bool m_exited = false;
+    };
+
+    /// <summary>
+    /// Odd while a trace session is running. Zones check it with a single relaxed load, and stamp it
+    /// on their events: a zone straddling the end of a session, or preempted between the load and
+    /// its push, may not write into the next session, whose flusher drops events stamped otherwise.
+    /// </summary>
+    inline std::atomic<std::uint32_t> trace_generation{ 0 };
+
+    inline std::int64_t trace_now() noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// <summary>
+    /// Process wide record of every thread's trace buffer and of the current session, which writes
+    /// the buffered events to a file in the Chrome trace event format (loadable in chrome://tracing
+    /// and Perfetto). Never destroyed, since threads detach their buffers from it on exit.
+    /// </summary>
+    class trace_registry
+    {
+    public:
+        static trace_registry& instance()
+        {
+            static auto* registry = new trace_registry();
+            return *registry;
+        }
+
+        trace_thread_buffer* attach()
+        {
+            std::scoped_lock lock(m_mutex);
+            auto* buffer = new trace_thread_buffer(++m_lastThreadId);
+            m_buffers.push_back(buffer);
+            return buffer;
+        }
+
+        void detach(trace_thread_buffer* p_buffer) noexcept
+        {
+            std::scoped_lock lock(m_mutex);
+            if (m_file.is_open())
+            {
+                p_buffer->m_exited = true;
+                return;
+            }
+
+            std::erase(m_buffers, p_buffer);
+            delete p_buffer;
+        }
+
+        void start(const std::filesystem::path& p_path, std::chrono::milliseconds p_flushInterval)
+        {
+            std::scoped_lock control(m_controlMutex);
+            {
+                std::scoped_lock lock(m_mutex);
+                if (m_file.is_open())
+                {
+                    throw std::logic_error("A trace session is already running.");
+                }
+
+                m_file.open(p_path, std::ios::out | std::ios::trunc);
+                if (!m_file.is_open())
+                {
+                    throw std::runtime_error("The trace file could not be opened.");
+                }
+
+                // Discard anything left from a previous session.
+                for (auto* buffer : m_buffers)
+                {
+                    drain(*buffer);
+
+                    buffer->m_dropped.store(0, std::memory_order_relaxed);
+                }
+
+                m_file << "{\"traceEvents\":[";
+                m_firstEvent = true;
+                m_generation = trace_generation.load(std::memory_order_relaxed) + 1;
+                m_startTime = trace_now();
+                m_dropped = 0;
+            }
+
+            static std::once_flag registerExit;
+            std::call_once(registerExit, [] { std::atexit([] { instance().stop(); }); });
+
+            trace_generation.fetch_add(1, std::memory_order_release);
+            m_flusher = std::jthread([this, p_flushInterval](std::stop_token p_stop)
+                {
+                    std::mutex mutex;
+                    std::condition_variable_any wakeup;
+                    std::unique_lock lock(mutex);
+                    while (!wakeup.wait_for(lock, p_stop, p_flushInterval, [] { return false; }))
+                    {
+                        if (p_stop.stop_requested())
+                        {
+                            return;
+                        }
+
+                        flush();
+                    }
+                });
+        }
+
+        /// <summary>
+        /// End the session, writing any remaining events and closing the file. Does nothing if no
+        /// session is running.
+        /// </summary>
+        void stop()
+        {
+            std::scoped_lock control(m_controlMutex);
+            if ((trace_generation.load(std::memory_order_relaxed) & 1) == 0)
+            {
+                return;
+            }
+
+            trace_generation.fetch_add(1, std::memory_order_release);
+            m_flusher = {};
+
+            flush();
+
+            std::scoped_lock lock(m_mutex);
+            m_file << "],\"displayTimeUnit\":\"ns\",\"otherData\":{\"droppedZones\":" << m_dropped << "}}\n";
+            m_file.close();
+        }
+
+        /// <summary>
+        /// Write every buffered event to the file.
+        /// </summary>
+        void flush()
+        {
+            std::scoped_lock lock(m_mutex);
+            if (!m_file.is_open())
+            {
+                return;
+            }
+
+            for (auto* buffer : m_buffers)
+            {
+                for (const auto& event : drain(*buffer))
+                {
+                    if (event.m_generation == m_generation)
+                    {
+                        write_event(*buffer, event);
+                    }
+                }
+
+                m_dropped += buffer->m_dropped.exchange(0, std::memory_order_relaxed);
+            }
+
+            std::erase_if(m_buffers, [](trace_thread_buffer* p_buffer)
+                {
+                    if (p_buffer->m_exited)
+                    {
+                        delete p_buffer;
+                        return true;
+                    }
+
+                    return false;
+                });
+
+            m_file.flush();
+        }
+
+    private:
+        trace_registry() = default;
+
+        const std::vector<trace_event>& drain(trace_thread_buffer& p_buffer)
+        {
+            m_scratch.clear();
+            p_buffer.m_ring.try_pop_n(std::back_inserter(m_scratch), trace_buffer_capacity);
+            return m_scratch;
+        }
+
+        void write_event(const trace_thread_buffer& p_buffer, const trace_event& p_event)
+        {
+            // Microseconds with nanosecond resolution.
+            const auto offset = std::max<std::int64_t>(0, p_event.m_nanoseconds - m_startTime);
+            auto fraction = std::to_string(offset % 1000);
+            fraction.insert(0, 3 - fraction.size(), '0');
+
+            m_file << (m_firstEvent ? "\n" : ",\n");
+            m_firstEvent = false;
+
+            m_file << "{\"name\":\"";
+            for (const auto* c = p_event.m_name; *c != '\0'; ++c)
+            {
+                const auto character = static_cast<unsigned char>(*c);
+                if (character == '"' || character == '\\')
+                {
+                    m_file << '\\' << *c;
+                }
+                else if (character < 0x20)
+                {
+                    static constexpr char Hex[] = "0123456789abcdef";
+                    m_file << "\\u00" << Hex[character >> 4] << Hex[character & 0xf];
+                }
+                else
+                {
+                    m_file << *c;
+                }
+            }
+
+            m_file << "\",\"cat\":\"mg\",\"ph\":\"" << p_event.m_phase << "\",\"ts\":" << offset / 1000 << '.' << fraction
+                << ",\"pid\":1,\"tid\":" << p_buffer.m_threadId << '}';
+        }
+
+        std::mutex m_controlMutex;
+        std::mutex m_mutex;
+        std::vector<trace_thread_buffer*> m_buffers;
+        std::uint32_t m_lastThreadId = 0;
+        std::ofstream m_file;
+        bool m_firstEvent = true;
+        std::uint32_t m_generation = 0;
+        std::int64_t m_startTime = 0;
+        std::uint64_t m_dropped = 0;
+        std::vector<trace_event> m_scratch;
+        std::jthread m_flusher;
+    };
+
+    /// <summary>
+    /// The current thread's buffer, or null before the thread first records anything. Kept as a
+    /// trivially destructible thread local so that the recording path is a plain TLS load.
+    /// </summary>
+    inline thread_local trace_thread_buffer* t_trace_buffer = nullptr;
+    inline thread_local bool t_trace_exited = false;
+
+    /// <summary>
+    /// Owns a thread's buffer and hands it to the registry when the thread exits. Zones after that
+    /// point (in other thread local destructors) are not recorded.
+    /// </summary>
+    struct trace_thread_owner
+    {
+        trace_thread_owner()
+            : m_buffer(trace_registry::instance().attach())
+        {
+        }
+
+        ~trace_thread_owner()
+        {
+            t_trace_buffer = nullptr;
+            t_trace_exited = true;
+            trace_registry::instance().detach(m_buffer);
+        }
+
+        trace_thread_buffer* m_buffer;
+    };
+
+    inline trace_thread_buffer* trace_buffer()
+    {
+        if (t_trace_buffer == nullptr) [[unlikely]]
+        {
+            if (t_trace_exited)
+            {
+                return nullptr;
+            }
+
+            thread_local trace_thread_owner owner;
+            t_trace_buffer = owner.m_buffer;
+        }
+
+        return t_trace_buffer;
+    }
+
+    inline trace_thread_buffer* trace_begin(const char* p_name, std::uint32_t p_generation)
+    {
+        auto* buffer = trace_buffer();
+        if (buffer == nullptr)
+        {
+            return nullptr;
+        }
+
+        // Keep room for this zone's end and the ends of the zones enclosing it.
+        auto& ring = buffer->m_ring;
+        if (ring.capacity() - ring.size_approx() < buffer->m_open + 2)
+        {
+            buffer->m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        ring.try_push({ p_name, trace_now(), p_generation, 'B' });
+        ++buffer->m_open;
+        return buffer;
+    }
+
+    inline void trace_end(trace_thread_buffer* p_buffer, const char* p_name, std::uint32_t p_generation) noexcept
+    {
+        --p_buffer->m_open;
+        if (trace_generation.load(std::memory_order_relaxed) == p_generation)
+        {
+            p_buffer->m_ring.try_push({ p_name, trace_now(), p_generation, 'E' });
+        }
+    }
+}
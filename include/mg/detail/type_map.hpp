@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The storage of one type in a concurrent_type_map: constructed in place at most once, by the
+    /// first thread to ask for it, and read lock free after that.
+    /// </summary>
+    template <typename T>
+    class concurrent_type_slot
+    {
+    public:
+        concurrent_type_slot() = default;
+
+        concurrent_type_slot(const concurrent_type_slot&) = delete;
+        concurrent_type_slot& operator=(const concurrent_type_slot&) = delete;
+
+        ~concurrent_type_slot()
+        {
+            if (m_ready.load(std::memory_order_acquire))
+            {
+                std::destroy_at(pointer());
+            }
+        }
+
+        T* find() const noexcept
+        {
+            return m_ready.load(std::memory_order_acquire) ? pointer() : nullptr;
+        }
+
+        /// <summary>
+        /// The value, constructed from the result of the given function if no thread has yet done
+        /// so. Should the function throw, the slot stays empty and the next call tries again.
+        /// </summary>
+        template <typename Make>
+        T& get_or_make(Make&& p_make)
+        {
+            if (const auto found = find())
+            {
+                return *found;
+            }
+
+            // Not std::call_once, which deadlocks on some platforms once the function has thrown.
+            std::lock_guard lock(m_mutex);
+            if (!m_ready.load(std::memory_order_relaxed))
+            {
+                ::new (static_cast<void*>(m_storage)) T(std::forward<Make>(p_make)());
+                m_ready.store(true, std::memory_order_release);
+            }
+
+            return *pointer();
+        }
+
+    private:
+        T* pointer() const noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(const_cast<std::byte*>(m_storage)));
+        }
+
+        alignas(T) std::byte m_storage[sizeof(T)];
+        std::atomic<bool> m_ready{ false };
+        std::mutex m_mutex;
+    };
+
+    template <typename T>
+    T* slot_value(std::optional<T>& p_slot) noexcept
+    {
+        return p_slot.has_value() ? std::addressof(*p_slot) : nullptr;
+    }
+
+    template <typename T>
+    const T* slot_value(const std::optional<T>& p_slot) noexcept
+    {
+        return p_slot.has_value() ? std::addressof(*p_slot) : nullptr;
+    }
+
+    template <typename T>
+    T* slot_value(const concurrent_type_slot<T>& p_slot) noexcept
+    {
+        return p_slot.find();
+    }
+
+    /// <summary>
+    /// Adapt a callable over the values of a type map to one over its slots, for iter_zipped_tuples:
+    /// empty slots are skipped, and the callable may return a bool to stop as usual. The values
+    /// are const if the slots are.
+    /// </summary>
+    template <typename Fn>
+    auto present_slots(Fn& p_fn)
+    {
+        return [&p_fn](auto& p_slot) -> bool
+        {
+            using value_type = std::remove_pointer_t<decltype(slot_value(p_slot))>;
+            using reference = std::conditional_t<std::is_const_v<std::remove_reference_t<decltype(p_slot)>>, const value_type&, value_type&>;
+            const auto value = slot_value(p_slot);
+            if (value == nullptr)
+            {
+                return true;
+            }
+
+            if constexpr (std::is_assignable_v<bool&, std::invoke_result_t<Fn&, reference>>)
+            {
+                return std::invoke(p_fn, static_cast<reference>(*value));
+            }
+            else
+            {
+                std::invoke(p_fn, static_cast<reference>(*value));
+                return true;
+            }
+        };
+    }
+}
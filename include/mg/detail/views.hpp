@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+
+namespace mg::detail
+{
+    template <bool Const, typename T>
+    using maybe_const = std::conditional_t<Const, const T, T>;
+
+    /// <summary>
+    /// Create a chunk of exactly N elements starting at the iterator. Contiguous iterators produce a
+    /// span with a static extent and anything else produces a subrange.
+    /// </summary>
+    template <std::size_t N, std::random_access_iterator It>
+    constexpr auto make_static_chunk(const It& p_it)
+    {
+        if constexpr (std::contiguous_iterator<It>)
+        {
+            return std::span<std::remove_reference_t<std::iter_reference_t<It>>, N>(std::to_address(p_it), N);
+        }
+        else
+        {
+            return std::ranges::subrange<It>(p_it, p_it + static_cast<std::iter_difference_t<It>>(N));
+        }
+    }
+
+    /// <summary>
+    /// Create a chunk of a runtime number of elements starting at the iterator. Contiguous iterators
+    /// produce a span with a dynamic extent and anything else produces a subrange.
+    /// </summary>
+    template <std::random_access_iterator It>
+    constexpr auto make_dynamic_chunk(const It& p_it, std::size_t p_count)
+    {
+        if constexpr (std::contiguous_iterator<It>)
+        {
+            return std::span<std::remove_reference_t<std::iter_reference_t<It>>>(std::to_address(p_it), p_count);
+        }
+        else
+        {
+            return std::ranges::subrange<It>(p_it, p_it + static_cast<std::iter_difference_t<It>>(p_count));
+        }
+    }
+}
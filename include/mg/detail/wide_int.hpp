@@ -0,0 +1,703 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define MG_WIDE_MSVC_X64 1
+#elif defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace mg::detail
+{
+    /// <summary>
+    /// The digits wide integers are made of, least significant first.
+    /// </summary>
+    using limb = std::uint64_t;
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ using double_limb = unsigned __int128;
+#endif
+
+    /// <summary>
+    /// The number of limbs from which multiplication switches from the schoolbook method to
+    /// Karatsuba's, which replaces one of every four half size products with additions. Below
+    /// this the extra additions and scratch space cost more than the product saved: measured on
+    /// x86-64, schoolbook is still ahead at 24 limbs and Karatsuba a quarter faster at 32.
+    /// </summary>
+    inline constexpr std::size_t karatsuba_threshold = 32;
+
+    /// <summary>
+    /// Add with carry: the sum is written out, the carry (zero or one) returned.
+    /// </summary>
+    constexpr limb add_carry(limb p_lhs, limb p_rhs, limb p_carry, limb& p_sum) noexcept
+    {
+#if defined(MG_WIDE_MSVC_X64) || defined(__x86_64__)
+        if (!std::is_constant_evaluated())
+        {
+            unsigned long long sum;
+            const auto carry = _addcarry_u64(static_cast<unsigned char>(p_carry), p_lhs, p_rhs, &sum);
+            p_sum = sum;
+            return carry;
+        }
+#endif
+        const auto partial = p_lhs + p_rhs;
+        p_sum = partial + p_carry;
+        return static_cast<limb>(partial < p_lhs) | static_cast<limb>(p_sum < partial);
+    }
+
+    /// <summary>
+    /// Subtract with borrow: the difference is written out, the borrow (zero or one) returned.
+    /// </summary>
+    constexpr limb sub_borrow(limb p_lhs, limb p_rhs, limb p_borrow, limb& p_difference) noexcept
+    {
+#if defined(MG_WIDE_MSVC_X64) || defined(__x86_64__)
+        if (!std::is_constant_evaluated())
+        {
+            unsigned long long difference;
+            const auto borrow = _subborrow_u64(static_cast<unsigned char>(p_borrow), p_lhs, p_rhs, &difference);
+            p_difference = difference;
+            return borrow;
+        }
+#endif
+        const auto partial = p_lhs - p_rhs;
+        p_difference = partial - p_borrow;
+        return static_cast<limb>(p_lhs < p_rhs) | static_cast<limb>(partial < p_borrow);
+    }
+
+    /// <summary>
+    /// The full product of two limbs: the low limb is returned, the high one written out.
+    /// </summary>
+    constexpr limb mul_limb(limb p_lhs, limb p_rhs, limb& p_high) noexcept
+    {
+#if defined(__BMI2__) && defined(__x86_64__)
+        if (!std::is_constant_evaluated())
+        {
+            unsigned long long high;
+            const auto low = _mulx_u64(p_lhs, p_rhs, &high);
+            p_high = high;
+            return low;
+        }
+#endif
+#if defined(__SIZEOF_INT128__)
+        const auto product = static_cast<double_limb>(p_lhs) * p_rhs;
+        p_high = static_cast<limb>(product >> 64);
+        return static_cast<limb>(product);
+#else
+#if defined(MG_WIDE_MSVC_X64)
+        if (!std::is_constant_evaluated())
+        {
+            unsigned long long high;
+            const auto low = _umul128(p_lhs, p_rhs, &high);
+            p_high = high;
+            return low;
+        }
+#endif
+        const auto a_low = p_lhs & 0xffffffffu;
+        const auto a_high = p_lhs >> 32;
+        const auto b_low = p_rhs & 0xffffffffu;
+        const auto b_high = p_rhs >> 32;
+        const auto low_low = a_low * b_low;
+        const auto high_low = a_high * b_low;
+        const auto low_high = a_low * b_high;
+        const auto middle = (low_low >> 32) + (high_low & 0xffffffffu) + low_high;
+        p_high = a_high * b_high + (high_low >> 32) + (middle >> 32);
+        return (middle << 32) | (low_low & 0xffffffffu);
+#endif
+    }
+
+    /// <summary>
+    /// Divide the two limb number (high, low) by a limb greater than high, so that the quotient
+    /// fits in a limb: the quotient is returned, the remainder written out.
+    /// </summary>
+    constexpr limb div_limb(limb p_high, limb p_low, limb p_divisor, limb& p_remainder) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        const auto dividend = (static_cast<double_limb>(p_high) << 64) | p_low;
+        p_remainder = static_cast<limb>(dividend % p_divisor);
+        return static_cast<limb>(dividend / p_divisor);
+#else
+        // Hacker's Delight divlu: normalize, then divide by the divisor's high half twice.
+        const auto shift = std::countl_zero(p_divisor);
+        const auto divisor = p_divisor << shift;
+        const auto high = shift == 0 ? p_high : (p_high << shift) | (p_low >> (64 - shift));
+        const auto low = p_low << shift;
+        const auto d1 = divisor >> 32;
+        const auto d0 = divisor & 0xffffffffu;
+        const auto u1 = low >> 32;
+        const auto u0 = low & 0xffffffffu;
+
+        auto q1 = high / d1;
+        auto r = high - q1 * d1;
+        while (q1 >> 32 != 0 || q1 * d0 > ((r << 32) | u1))
+        {
+            --q1;
+            r += d1;
+            if (r >> 32 != 0)
+            {
+                break;
+            }
+        }
+
+        const auto middle = (high << 32) + u1 - q1 * divisor;
+        auto q0 = middle / d1;
+        r = middle - q0 * d1;
+        while (q0 >> 32 != 0 || q0 * d0 > ((r << 32) | u0))
+        {
+            --q0;
+            r += d1;
+            if (r >> 32 != 0)
+            {
+                break;
+            }
+        }
+
+        p_remainder = (((middle << 32) + u0) - q0 * divisor) >> shift;
+        return (q1 << 32) | q0;
+#endif
+    }
+
+#undef MG_WIDE_MSVC_X64
+
+    /// <summary>
+    /// Add a number of limbs into another, returning the carry out.
+    /// </summary>
+    constexpr limb add_limbs(limb* p_into, const limb* p_from, std::size_t p_count) noexcept
+    {
+        limb carry = 0;
+        for (std::size_t i = 0; i < p_count; ++i)
+        {
+            carry = add_carry(p_into[i], p_from[i], carry, p_into[i]);
+        }
+
+        return carry;
+    }
+
+    /// <summary>
+    /// Subtract a number of limbs from another, returning the borrow out.
+    /// </summary>
+    constexpr limb sub_limbs(limb* p_into, const limb* p_from, std::size_t p_count) noexcept
+    {
+        limb borrow = 0;
+        for (std::size_t i = 0; i < p_count; ++i)
+        {
+            borrow = sub_borrow(p_into[i], p_from[i], borrow, p_into[i]);
+        }
+
+        return borrow;
+    }
+
+    /// <summary>
+    /// Add a carry into a number of limbs, returning the carry out of the last.
+    /// </summary>
+    constexpr limb add_carry_limbs(limb* p_into, std::size_t p_count, limb p_carry) noexcept
+    {
+        for (std::size_t i = 0; i < p_count && p_carry != 0; ++i)
+        {
+            p_carry = add_carry(p_into[i], 0, p_carry, p_into[i]);
+        }
+
+        return p_carry;
+    }
+
+    /// <summary>
+    /// Compare two numbers of the same number of limbs, returning -1, 0 or 1.
+    /// </summary>
+    constexpr int compare_limbs(const limb* p_lhs, const limb* p_rhs, std::size_t p_count) noexcept
+    {
+        for (auto i = p_count; i-- > 0;)
+        {
+            if (p_lhs[i] != p_rhs[i])
+            {
+                return p_lhs[i] < p_rhs[i] ? -1 : 1;
+            }
+        }
+
+        return 0;
+    }
+
+    /// <summary>
+    /// The number of limbs up to and including the most significant non zero one.
+    /// </summary>
+    constexpr std::size_t significant_limbs(const limb* p_limbs, std::size_t p_count) noexcept
+    {
+        while (p_count > 0 && p_limbs[p_count - 1] == 0)
+        {
+            --p_count;
+        }
+
+        return p_count;
+    }
+
+    /// <summary>
+    /// Multiply and accumulate a row: into[0, count) += lhs * from[0, count), returning the limb
+    /// carried out. Small values in wide types are common, so callers skip zero limbs and multiply
+    /// only the significant ones.
+    /// </summary>
+    constexpr limb mul_add_row(limb* p_into, const limb* p_from, std::size_t p_count, limb p_lhs) noexcept
+    {
+        limb carry = 0;
+        for (std::size_t j = 0; j < p_count; ++j)
+        {
+#if defined(__SIZEOF_INT128__)
+            // a b + c + d < 2^128, and the compiler turns this into a mul and an add/adc pair per
+            // term, where separate carry intrinsics serialize on the flags.
+            const auto sum = static_cast<double_limb>(p_lhs) * p_from[j] + p_into[j] + carry;
+            p_into[j] = static_cast<limb>(sum);
+            carry = static_cast<limb>(sum >> 64);
+#else
+            limb high;
+            auto low = mul_limb(p_lhs, p_from[j], high);
+            high += add_carry(low, carry, 0, low);
+            high += add_carry(low, p_into[j], 0, low);
+            p_into[j] = low;
+            carry = high;
+#endif
+        }
+
+        return carry;
+    }
+
+    /// <summary>
+    /// The full 2N limb product of two N limb numbers, by the schoolbook method.
+    /// </summary>
+    constexpr void mul_schoolbook(const limb* p_lhs, const limb* p_rhs, std::size_t p_count, limb* p_out) noexcept
+    {
+        std::fill(p_out, p_out + 2 * p_count, limb(0));
+        const auto lhs_count = significant_limbs(p_lhs, p_count);
+        const auto rhs_count = significant_limbs(p_rhs, p_count);
+        for (std::size_t i = 0; i < lhs_count; ++i)
+        {
+            if (p_lhs[i] != 0)
+            {
+                p_out[i + rhs_count] = mul_add_row(p_out + i, p_rhs, rhs_count, p_lhs[i]);
+            }
+        }
+    }
+
+    /// <summary>
+    /// The full 2N limb square of an N limb number, which needs only half of the schoolbook
+    /// products: each a_i a_j off the diagonal is computed once and doubled.
+    /// </summary>
+    constexpr void sqr_schoolbook(const limb* p_value, std::size_t p_count, limb* p_out) noexcept
+    {
+        std::fill(p_out, p_out + 2 * p_count, limb(0));
+        const auto count = significant_limbs(p_value, p_count);
+        for (std::size_t i = 0; i + 1 < count; ++i)
+        {
+            if (p_value[i] != 0)
+            {
+                p_out[i + count] = mul_add_row(p_out + 2 * i + 1, p_value + i + 1, count - i - 1, p_value[i]);
+            }
+        }
+
+        // Double, which cannot carry out since the square fits.
+        for (auto i = 2 * count; i-- > 1;)
+        {
+            p_out[i] = p_out[i] << 1 | p_out[i - 1] >> 63;
+        }
+
+        if (count != 0)
+        {
+            p_out[0] <<= 1;
+        }
+
+        limb carry = 0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            limb high;
+            const auto low = mul_limb(p_value[i], p_value[i], high);
+            carry = add_carry(p_out[2 * i], low, carry, p_out[2 * i]);
+            carry = add_carry(p_out[2 * i + 1], high, carry, p_out[2 * i + 1]);
+        }
+    }
+
+    /// <summary>
+    /// The low N limbs of the product of two N limb numbers, by the schoolbook method, which
+    /// skips the products which only contribute to the high half.
+    /// </summary>
+    constexpr void mul_low_schoolbook(const limb* p_lhs, const limb* p_rhs, std::size_t p_count, limb* p_out) noexcept
+    {
+        std::fill(p_out, p_out + p_count, limb(0));
+        const auto lhs_count = significant_limbs(p_lhs, p_count);
+        const auto rhs_count = significant_limbs(p_rhs, p_count);
+        for (std::size_t i = 0; i < lhs_count; ++i)
+        {
+            if (p_lhs[i] != 0)
+            {
+                const auto row = std::min(rhs_count, p_count - i);
+                const auto carry = mul_add_row(p_out + i, p_rhs, row, p_lhs[i]);
+                if (i + row < p_count)
+                {
+                    p_out[i + row] = carry;
+                }
+            }
+        }
+    }
+
+    /// <summary>
+    /// Write |lhs - rhs| out, returning whether lhs is the smaller.
+    /// </summary>
+    constexpr bool abs_difference(const limb* p_lhs, const limb* p_rhs, std::size_t p_count, limb* p_out) noexcept
+    {
+        const auto less = compare_limbs(p_lhs, p_rhs, p_count) < 0;
+        if (less)
+        {
+            std::swap(p_lhs, p_rhs);
+        }
+
+        std::copy(p_lhs, p_lhs + p_count, p_out);
+        sub_limbs(p_out, p_rhs, p_count);
+        return less;
+    }
+
+    /// <summary>
+    /// The full 2N limb product of two N limb numbers. Above the threshold, split each into
+    /// halves (a1, a0) and (b1, b0) and use a0 b1 + a1 b0 = a0 b0 + a1 b1 + (a0 - a1)(b1 - b0),
+    /// so three half size products make the whole.
+    /// </summary>
+    template <std::size_t N>
+    constexpr void mul_full(const limb* p_lhs, const limb* p_rhs, limb* p_out) noexcept
+    {
+        if constexpr (N < karatsuba_threshold || N % 2 != 0)
+        {
+            if (p_lhs == p_rhs)
+            {
+                sqr_schoolbook(p_lhs, N, p_out);
+            }
+            else
+            {
+                mul_schoolbook(p_lhs, p_rhs, N, p_out);
+            }
+        }
+        else
+        {
+            constexpr auto half = N / 2;
+            mul_full<half>(p_lhs, p_rhs, p_out);
+            mul_full<half>(p_lhs + half, p_rhs + half, p_out + N);
+
+            std::array<limb, half> lhs_difference{};
+            std::array<limb, half> rhs_difference{};
+            const auto negative = abs_difference(p_lhs, p_lhs + half, half, lhs_difference.data()) != abs_difference(p_rhs + half, p_rhs, half, rhs_difference.data());
+
+            // Squares stay squares all the way down.
+            std::array<limb, N> cross{};
+            mul_full<half>(lhs_difference.data(), p_lhs == p_rhs ? lhs_difference.data() : rhs_difference.data(), cross.data());
+
+            // middle = a0 b0 + a1 b1 +- |a0 - a1| |b1 - b0|, which is never negative.
+            std::array<limb, N + 1> middle{};
+            std::copy(p_out, p_out + N, middle.begin());
+            middle[N] = add_limbs(middle.data(), p_out + N, N);
+            if (negative)
+            {
+                middle[N] -= sub_limbs(middle.data(), cross.data(), N);
+            }
+            else
+            {
+                middle[N] += add_limbs(middle.data(), cross.data(), N);
+            }
+
+            const auto carry = add_limbs(p_out + half, middle.data(), N + 1);
+            add_carry_limbs(p_out + half + N + 1, half - 1, carry);
+        }
+    }
+
+    /// <summary>
+    /// The low N limbs of the product of two N limb numbers, which is all a fixed width
+    /// multiplication keeps: the full product of the low halves plus the low halves of the two
+    /// cross products.
+    /// </summary>
+    template <std::size_t N>
+    constexpr void mul_low(const limb* p_lhs, const limb* p_rhs, limb* p_out) noexcept
+    {
+        if constexpr (N < karatsuba_threshold || N % 2 != 0)
+        {
+            mul_low_schoolbook(p_lhs, p_rhs, N, p_out);
+        }
+        else
+        {
+            constexpr auto half = N / 2;
+            mul_full<half>(p_lhs, p_rhs, p_out);
+
+            std::array<limb, half> cross{};
+            mul_low<half>(p_lhs + half, p_rhs, cross.data());
+            add_limbs(p_out + half, cross.data(), half);
+            if (p_lhs != p_rhs)
+            {
+                mul_low<half>(p_lhs, p_rhs + half, cross.data());
+            }
+
+            add_limbs(p_out + half, cross.data(), half);
+        }
+    }
+
+    /// <summary>
+    /// Divide an M limb number by a non zero N limb one (Knuth's algorithm D), writing out the M
+    /// limb quotient and the N limb remainder, either of which may be null if not wanted.
+    /// </summary>
+    template <std::size_t M, std::size_t N>
+    constexpr void divide(const limb* p_dividend, const limb* p_divisor, limb* p_quotient, limb* p_remainder) noexcept
+    {
+        const auto m = significant_limbs(p_dividend, M);
+        const auto n = significant_limbs(p_divisor, N);
+        std::array<limb, M> quotient{};
+
+        if (m < n)
+        {
+            if (p_remainder != nullptr)
+            {
+                std::fill(p_remainder, p_remainder + N, limb(0));
+                std::copy(p_dividend, p_dividend + m, p_remainder);
+            }
+        }
+        else if (n == 1)
+        {
+            limb remainder = 0;
+            for (auto i = m; i-- > 0;)
+            {
+                quotient[i] = div_limb(remainder, p_dividend[i], p_divisor[0], remainder);
+            }
+
+            if (p_remainder != nullptr)
+            {
+                std::fill(p_remainder, p_remainder + N, limb(0));
+                p_remainder[0] = remainder;
+            }
+        }
+        else if constexpr (N >= 2)
+        {
+            // Only reachable for divisors of two or more limbs, so it is not instantiated for single
+            // limb ones. Normalize so that the divisor's top limb has its high bit set, which keeps each
+            // estimated quotient limb at most two too large.
+            const auto shift = std::countl_zero(p_divisor[n - 1]);
+            std::array<limb, N> divisor{};
+            std::array<limb, M + 1> dividend{};
+            for (auto i = n; i-- > 0;)
+            {
+                divisor[i] = p_divisor[i] << shift | (shift != 0 && i > 0 ? p_divisor[i - 1] >> (64 - shift) : 0);
+            }
+
+            dividend[m] = shift != 0 ? p_dividend[m - 1] >> (64 - shift) : 0;
+            for (auto i = m; i-- > 0;)
+            {
+                dividend[i] = p_dividend[i] << shift | (shift != 0 && i > 0 ? p_dividend[i - 1] >> (64 - shift) : 0);
+            }
+
+            const auto top = divisor[n - 1];
+            const auto next = divisor[n - 2];
+            for (auto j = m - n + 1; j-- > 0;)
+            {
+                limb estimate;
+                limb remainder;
+                auto overflow = false;
+                if (dividend[j + n] >= top)
+                {
+                    estimate = ~limb(0);
+                    overflow = add_carry(dividend[j + n - 1], top, 0, remainder) != 0;
+                }
+                else
+                {
+                    estimate = div_limb(dividend[j + n], dividend[j + n - 1], top, remainder);
+                }
+
+                while (!overflow)
+                {
+                    limb high;
+                    const auto low = mul_limb(estimate, next, high);
+                    if (high < remainder || (high == remainder && low <= dividend[j + n - 2]))
+                    {
+                        break;
+                    }
+
+                    --estimate;
+                    overflow = add_carry(remainder, top, 0, remainder) != 0;
+                }
+
+                // Subtract estimate * divisor from the dividend's window.
+                limb carry = 0;
+                limb borrow = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    limb high;
+                    auto low = mul_limb(estimate, divisor[i], high);
+                    high += add_carry(low, carry, 0, low);
+                    carry = high;
+                    borrow = sub_borrow(dividend[i + j], low, borrow, dividend[i + j]);
+                }
+
+                borrow = sub_borrow(dividend[j + n], carry, borrow, dividend[j + n]);
+                if (borrow != 0)
+                {
+                    // The estimate was one too large: add the divisor back.
+                    --estimate;
+                    dividend[j + n] += add_limbs(dividend.data() + j, divisor.data(), n);
+                }
+
+                quotient[j] = estimate;
+            }
+
+            if (p_remainder != nullptr)
+            {
+                std::fill(p_remainder, p_remainder + N, limb(0));
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    p_remainder[i] = dividend[i] >> shift | (shift != 0 ? dividend[i + 1] << (64 - shift) : 0);
+                }
+            }
+        }
+
+        if (p_quotient != nullptr)
+        {
+            std::copy(quotient.begin(), quotient.end(), p_quotient);
+        }
+    }
+
+    /// <summary>
+    /// (lhs * rhs) mod modulus for N limb numbers below the modulus, through the full double
+    /// width product, so that nothing is lost to overflow.
+    /// </summary>
+    template <std::size_t N>
+    constexpr void mul_mod(const limb* p_lhs, const limb* p_rhs, const limb* p_modulus, limb* p_out) noexcept
+    {
+        std::array<limb, 2 * N> product{};
+        mul_full<N>(p_lhs, p_rhs, product.data());
+        divide<2 * N, N>(product.data(), p_modulus, nullptr, p_out);
+    }
+
+    /// <summary>
+    /// The inverse of an odd limb modulo 2^64, by Newton's iteration, which doubles the number of
+    /// correct low bits each step from the three that x x = 1 (mod 8) gives for any odd x.
+    /// </summary>
+    constexpr limb limb_inverse(limb p_odd) noexcept
+    {
+        auto inverse = p_odd;
+        for (int i = 0; i < 5; ++i)
+        {
+            inverse *= 2 - p_odd * inverse;
+        }
+
+        return inverse;
+    }
+
+    /// <summary>
+    /// Montgomery multiplication, lhs rhs / 2^(64 N) mod modulus for an odd modulus and operands
+    /// below it, so that modular products need no division. The product is formed first, which
+    /// lets squares and large operands use the faster products, then reduced a limb at a time
+    /// by adding the multiple of the modulus which clears that limb (the SOS method).
+    /// </summary>
+    /// <param name="p_inverse">-modulus^-1 mod 2^64.</param>
+    template <std::size_t N>
+    constexpr void montgomery_mul(const limb* p_lhs, const limb* p_rhs, const limb* p_modulus, limb p_inverse, limb* p_out) noexcept
+    {
+        // Stays below twice the modulus times 2^(64 N), so one limb above the product suffices.
+        std::array<limb, 2 * N + 1> total{};
+        mul_full<N>(p_lhs, p_rhs, total.data());
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            auto& above = total[i + N];
+            const auto carry = add_carry(above, mul_add_row(total.data() + i, p_modulus, N, total[i] * p_inverse), 0, above);
+            add_carry_limbs(total.data() + i + N + 1, N - i, carry);
+        }
+
+        const auto* reduced = total.data() + N;
+        std::copy(reduced, reduced + N, p_out);
+        if (total[2 * N] != 0 || compare_limbs(p_out, p_modulus, N) >= 0)
+        {
+            sub_limbs(p_out, p_modulus, N);
+        }
+    }
+
+    /// <summary>
+    /// base ^ power mod modulus for an N limb base below the modulus and a power of any number of
+    /// limbs, by fixed four bit windows: sixteen powers of the base are tabled, then each window
+    /// of the power costs four squarings and at most one multiplication. Odd moduli, which are
+    /// the common case, multiply in Montgomery form; even ones through division.
+    /// </summary>
+    template <std::size_t N>
+    constexpr void mod_pow(const limb* p_base, const limb* p_power, std::size_t p_power_limbs, const limb* p_modulus, limb* p_out) noexcept
+    {
+        using number = std::array<limb, N>;
+        const auto montgomery = (p_modulus[0] & 1) != 0;
+        const auto inverse = montgomery ? limb(0) - limb_inverse(p_modulus[0]) : limb(0);
+        const auto multiply = [&](const number& p_lhs, const number& p_rhs)
+        {
+            number result{};
+            if (montgomery)
+            {
+                montgomery_mul<N>(p_lhs.data(), p_rhs.data(), p_modulus, inverse, result.data());
+            }
+            else
+            {
+                mul_mod<N>(p_lhs.data(), p_rhs.data(), p_modulus, result.data());
+            }
+
+            return result;
+        };
+
+        number unit{};
+        unit[0] = 1;
+        number base{};
+        std::copy(p_base, p_base + N, base.begin());
+
+        // Into Montgomery form, x 2^(64 N) mod modulus, by multiplying by 2^(128 N) mod modulus.
+        auto one = unit;
+        if (montgomery)
+        {
+            std::array<limb, 2 * N + 1> square{};
+            square[2 * N] = 1;
+            number square_mod{};
+            divide<2 * N + 1, N>(square.data(), p_modulus, nullptr, square_mod.data());
+            base = multiply(base, square_mod);
+            one = multiply(unit, square_mod);
+        }
+        else
+        {
+            // 1 mod modulus, which is zero for a modulus of one.
+            one = multiply(unit, unit);
+        }
+
+        std::array<number, 16> table{};
+        table[0] = one;
+        for (std::size_t i = 1; i < table.size(); ++i)
+        {
+            table[i] = multiply(table[i - 1], base);
+        }
+
+        // Start from the most significant non zero window, which needs no squaring.
+        auto result = one;
+        const auto limbs = significant_limbs(p_power, p_power_limbs);
+        const auto windows = limbs == 0 ? 0 : (limbs - 1) * 16 + (static_cast<std::size_t>(std::bit_width(p_power[limbs - 1])) + 3) / 4;
+        for (auto window = windows; window-- > 0;)
+        {
+            const auto digit = (p_power[window / 16] >> (window % 16 * 4)) & 0xf;
+            if (window + 1 == windows)
+            {
+                result = table[digit];
+                continue;
+            }
+
+            for (int i = 0; i < 4; ++i)
+            {
+                result = multiply(result, result);
+            }
+
+            if (digit != 0)
+            {
+                result = multiply(result, table[digit]);
+            }
+        }
+
+        if (montgomery)
+        {
+            result = multiply(result, unit);
+        }
+
+        std::copy(result.begin(), result.end(), p_out);
+    }
+}
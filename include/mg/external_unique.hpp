@@ -0,0 +1,136 @@
+#pragma once
+
+#include "detail/external_unique.hpp"
+#include "mapped_file.hpp"
+#include "serialize.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+
+namespace mg
+{
+    /// <summary>
+    /// Limits on all_unique_external.
+    /// </summary>
+    struct external_unique_options
+    {
+        /// <summary>
+        /// The approximate number of bytes of memory to use, for the elements held in memory and the
+        /// buffers of the spill files together.
+        /// </summary>
+        std::size_t memory_budget = std::size_t(256) << 20;
+
+        /// <summary>
+        /// Where the spill files are written, in a subdirectory which is removed afterwards.
+        /// </summary>
+        std::filesystem::path temp_directory = std::filesystem::temp_directory_path();
+
+        /// <summary>
+        /// The number of spill files the elements are partitioned between each time they exceed the
+        /// budget. Fewer are used if a block buffer for each would take over half of the budget.
+        /// </summary>
+        std::size_t partitions = 64;
+    };
+
+    /// <summary>
+    /// The outcome of all_unique_external, which converts to true if all of the elements are unique.
+    /// </summary>
+    template <typename T>
+    struct external_unique_result
+    {
+        /// <summary>
+        /// The duplicated element, if one was found.
+        /// </summary>
+        std::optional<T> duplicate;
+
+        /// <summary>
+        /// The positions in the input of two elements equal to the duplicate, in order.
+        /// </summary>
+        std::uint64_t first_position = 0;
+        std::uint64_t second_position = 0;
+
+        /// <summary>
+        /// Whether the input exceeded the memory budget and so was partitioned into spill files.
+        /// </summary>
+        bool spilled = false;
+
+        explicit operator bool() const noexcept
+        {
+            return !duplicate.has_value();
+        }
+    };
+
+    /// <summary>
+    /// Check whether all of the elements of a stream are unique, like all_unique, for streams whose
+    /// distinct elements may not fit in memory. Elements are held in memory until they exceed the
+    /// budget, then hash partitioned into temporary spill files which are each checked in memory in
+    /// turn, with the same hash and equality, and partitioned again if they too exceed the budget.
+    /// </summary>
+    /// <remarks>The spill files are written and read on a background thread, double buffered, so that
+    /// the input is read and partitioned while the previous block is written, and each partition is
+    /// checked while its next block is read. The check stops at the first duplicate found; once the
+    /// input has spilled, that is the first within its partition rather than the first in the input.</remarks>
+    /// <remarks>The elements are spilled with mg::serialize, so must be serializable and default
+    /// constructible if they are tuples.</remarks>
+    /// <typeparam name="Iter">The type of the iterator, which need only be an input iterator.</typeparam>
+    /// <typeparam name="Hash">The type of the hasher.</typeparam>
+    /// <typeparam name="Equal">The type of the equality comparator.</typeparam>
+    /// <param name="p_first">The start of the range to consider, inclusive.</param>
+    /// <param name="p_last">The end of the range, not inclusive.</param>
+    /// <param name="p_options">The memory budget and where to spill.</param>
+    /// <param name="p_hash">Hasher of the iterator's value type.</param>
+    /// <param name="p_equal">Equality comparator of the iterator's value type.</param>
+    /// <returns>The duplicate found, if any, and where.</returns>
+    /// <exception cref="std::system_error">A spill file could not be created, written or read.</exception>
+    /// <exception cref="std::invalid_argument">The memory budget is too small to partition with, under
+    /// a few KiB.</exception>
+    /// <example><code>
+    /// mg::external_unique_options options;
+    /// options.memory_budget = std::size_t(4) &lt;&lt; 30;
+    /// options.temp_directory = "/scratch";
+    /// if (const auto result = mg::all_unique_external(keys.begin(), keys.end(), options); !result)
+    /// {
+    ///     report(*result.duplicate, result.first_position, result.second_position);
+    /// }
+    /// </code></example>
+    template <
+        std::input_iterator Iter,
+        std::sentinel_for<Iter> Sentinel,
+        typename Hash = std::hash<std::iter_value_t<Iter>>,
+        typename Equal = std::equal_to<>>
+        requires serializable<std::iter_value_t<Iter>>
+    external_unique_result<std::iter_value_t<Iter>> all_unique_external(
+        Iter p_first,
+        Sentinel p_last,
+        const external_unique_options& p_options = {},
+        const Hash& p_hash = Hash{},
+        const Equal& p_equal = Equal{})
+    {
+        using T = std::iter_value_t<Iter>;
+        detail::external_unique_checker<T, Hash, Equal, external_unique_result<T>, external_unique_options> checker(p_options, p_hash, p_equal);
+        return checker.run(std::move(p_first), std::move(p_last));
+    }
+
+    /// <summary>
+    /// Check whether all of the records of a memory mapped file are unique. See
+    /// all_unique_external(first, last).
+    /// </summary>
+    /// <typeparam name="T">The trivially copyable type of the records the file consists of.</typeparam>
+    /// <exception cref="std::invalid_argument">The file is not a whole number of records.</exception>
+    template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<>>
+        requires std::is_trivially_copyable_v<T> && serializable<T>
+    external_unique_result<T> all_unique_external(
+        const mapped_file& p_file,
+        const external_unique_options& p_options = {},
+        const Hash& p_hash = Hash{},
+        const Equal& p_equal = Equal{})
+    {
+        const auto records = p_file.as<T>();
+        return all_unique_external(records.begin(), records.end(), p_options, p_hash, p_equal);
+    }
+}
@@ -0,0 +1,904 @@
+#pragma once
+
+#include "detail/flat_map.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mg
+{
+    /// <summary>
+    /// Tag for the constructors and inserts of flat_map and flat_set whose input is already sorted
+    /// and free of duplicates, which is then taken as is.
+    /// </summary>
+    struct sorted_unique_t
+    {
+        explicit sorted_unique_t() = default;
+    };
+
+    inline constexpr sorted_unique_t sorted_unique{};
+
+    /// <summary>
+    /// A sorted associative container with unique keys, stored as a contiguous array of keys and a
+    /// separate contiguous array of values, with the semantics of C++23's std::flat_map. Iteration
+    /// is a linear scan of both arrays, and lookups touch only the keys until the match is found,
+    /// which suits read-mostly tables far better than a node based std::map. Inserting or erasing
+    /// is linear in the size of the map.
+    /// </summary>
+    /// <remarks>Arithmetic keys ordered by std::less are searched through a static search tree of
+    /// cache line sized nodes (see detail::flat_search_index), compared a node at a time with SIMD
+    /// instructions, with the value prefetched once the key's node is found. Other keys are found
+    /// by binary search.</remarks>
+    /// <remarks>Constructing from or inserting an unsorted range sorts it once and keeps the first
+    /// of each run of equivalent keys, as std::flat_map does.</remarks>
+    /// <typeparam name="Key">The key type.</typeparam>
+    /// <typeparam name="T">The mapped type.</typeparam>
+    /// <typeparam name="Compare">The strict weak ordering of the keys.</typeparam>
+    /// <example><code>
+    /// mg::flat_map&lt;std::uint32_t, route&gt; routes(std::move(prefixes), std::move(hops));
+    /// if (const auto found = routes.find(prefix); found != routes.end())
+    /// {
+    ///     forward(found-&gt;second);
+    /// }
+    /// </code></example>
+    template <
+        typename Key,
+        typename T,
+        typename Compare = std::less<Key>,
+        typename KeyContainer = std::vector<Key>,
+        typename MappedContainer = std::vector<T>>
+    class flat_map
+    {
+        template <bool Const>
+        class basic_iterator;
+
+        using keys_type = detail::flat_keys<Key, Compare, KeyContainer>;
+
+    public:
+        using key_type = Key;
+        using mapped_type = T;
+        using value_type = std::pair<Key, T>;
+        using key_compare = Compare;
+        using reference = std::pair<const Key&, T&>;
+        using const_reference = std::pair<const Key&, const T&>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using key_container_type = KeyContainer;
+        using mapped_container_type = MappedContainer;
+
+        /// <summary>
+        /// Compares values by their keys.
+        /// </summary>
+        class value_compare
+        {
+        public:
+            bool operator()(const_reference p_lhs, const_reference p_rhs) const
+            {
+                return m_compare(p_lhs.first, p_rhs.first);
+            }
+
+        private:
+            friend flat_map;
+
+            explicit value_compare(const Compare& p_compare)
+                : m_compare(p_compare)
+            {
+            }
+
+            Compare m_compare;
+        };
+
+        /// <summary>
+        /// The two arrays of a map, as taken by extract() and replace().
+        /// </summary>
+        struct containers
+        {
+            KeyContainer keys;
+            MappedContainer values;
+        };
+
+        flat_map() = default;
+
+        explicit flat_map(const Compare& p_compare)
+            : m_keys(KeyContainer(), p_compare)
+        {
+        }
+
+        /// <summary>
+        /// Take the given keys and values, which must be the same length, then sort them by key
+        /// and remove the duplicates.
+        /// </summary>
+        flat_map(KeyContainer p_keys, MappedContainer p_values, const Compare& p_compare = Compare())
+            : m_keys(std::move(p_keys), p_compare),
+            m_values(std::move(p_values))
+        {
+            sort_unique();
+        }
+
+        /// <summary>
+        /// Take the given keys and values, which must be the same length, and the keys already
+        /// sorted and unique.
+        /// </summary>
+        flat_map(sorted_unique_t, KeyContainer p_keys, MappedContainer p_values, const Compare& p_compare = Compare())
+            : m_keys(std::move(p_keys), p_compare),
+            m_values(std::move(p_values))
+        {
+            m_keys.rebuild();
+        }
+
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel>
+        flat_map(Iter p_first, Sentinel p_last, const Compare& p_compare = Compare())
+            : m_keys(KeyContainer(), p_compare)
+        {
+            insert(std::move(p_first), std::move(p_last));
+        }
+
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel>
+        flat_map(sorted_unique_t, Iter p_first, Sentinel p_last, const Compare& p_compare = Compare())
+            : m_keys(KeyContainer(), p_compare)
+        {
+            insert(sorted_unique, std::move(p_first), std::move(p_last));
+        }
+
+        flat_map(std::initializer_list<value_type> p_values, const Compare& p_compare = Compare())
+            : flat_map(p_values.begin(), p_values.end(), p_compare)
+        {
+        }
+
+        flat_map(sorted_unique_t, std::initializer_list<value_type> p_values, const Compare& p_compare = Compare())
+            : flat_map(sorted_unique, p_values.begin(), p_values.end(), p_compare)
+        {
+        }
+
+        iterator begin() noexcept { return iterator(this, 0); }
+        const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        iterator end() noexcept { return iterator(this, ssize()); }
+        const_iterator end() const noexcept { return const_iterator(this, ssize()); }
+        const_iterator cbegin() const noexcept { return begin(); }
+        const_iterator cend() const noexcept { return end(); }
+        reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        bool empty() const noexcept { return keys().empty(); }
+        size_type size() const noexcept { return keys().size(); }
+
+        /// <summary>
+        /// The value of a key, value initialized and inserted if the key is not present.
+        /// </summary>
+        T& operator[](const Key& p_key)
+        {
+            return try_emplace(p_key).first->second;
+        }
+
+        T& operator[](Key&& p_key)
+        {
+            return try_emplace(std::move(p_key)).first->second;
+        }
+
+        T& at(const Key& p_key)
+        {
+            return m_values[checked_find(p_key)];
+        }
+
+        const T& at(const Key& p_key) const
+        {
+            return m_values[checked_find(p_key)];
+        }
+
+        /// <summary>
+        /// Insert a value constructed from the arguments, unless its key is already present.
+        /// </summary>
+        /// <returns>The element with the key, and whether it was inserted.</returns>
+        template <typename... Args>
+            requires std::constructible_from<value_type, Args&&...>
+        std::pair<iterator, bool> emplace(Args&&... p_args)
+        {
+            value_type value(std::forward<Args>(p_args)...);
+            return try_emplace(std::move(value.first), std::move(value.second));
+        }
+
+        std::pair<iterator, bool> insert(const value_type& p_value)
+        {
+            return try_emplace(p_value.first, p_value.second);
+        }
+
+        std::pair<iterator, bool> insert(value_type&& p_value)
+        {
+            return try_emplace(std::move(p_value.first), std::move(p_value.second));
+        }
+
+        /// <summary>
+        /// Insert the values of a range whose keys are not already present, sorting once. Of
+        /// several values with equivalent keys, the first is inserted.
+        /// </summary>
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel>
+        void insert(Iter p_first, Sentinel p_last)
+        {
+            for (; p_first != p_last; ++p_first)
+            {
+                append(*p_first);
+            }
+
+            sort_unique();
+        }
+
+        /// <summary>
+        /// Insert the values of a range which is sorted and free of duplicates, merging it with the
+        /// existing elements in linear time. Values whose keys are already present are not inserted.
+        /// </summary>
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel>
+        void insert(sorted_unique_t, Iter p_first, Sentinel p_last)
+        {
+            const auto existing = size();
+            for (; p_first != p_last; ++p_first)
+            {
+                append(*p_first);
+            }
+
+            merge_unique(existing);
+        }
+
+        void insert(std::initializer_list<value_type> p_values)
+        {
+            insert(p_values.begin(), p_values.end());
+        }
+
+        /// <summary>
+        /// Insert a value constructed from the arguments if the key is not present. The arguments
+        /// are unused otherwise.
+        /// </summary>
+        template <typename K, typename... Args>
+            requires std::constructible_from<Key, K&&> && std::constructible_from<T, Args&&...>
+        std::pair<iterator, bool> try_emplace(K&& p_key, Args&&... p_args)
+        {
+            const auto position = m_keys.lower_bound(p_key, [](std::size_t) {});
+            if (position != size() && !m_keys.less(p_key, keys()[position]))
+            {
+                return { iterator(this, static_cast<difference_type>(position)), false };
+            }
+
+            insert_at(position, std::forward<K>(p_key), std::forward<Args>(p_args)...);
+            return { iterator(this, static_cast<difference_type>(position)), true };
+        }
+
+        /// <summary>
+        /// Insert a value, or assign it to the existing value of the key.
+        /// </summary>
+        template <typename K, typename M>
+            requires std::constructible_from<Key, K&&> && std::assignable_from<T&, M&&> && std::constructible_from<T, M&&>
+        std::pair<iterator, bool> insert_or_assign(K&& p_key, M&& p_value)
+        {
+            const auto position = m_keys.lower_bound(p_key, [](std::size_t) {});
+            if (position != size() && !m_keys.less(p_key, keys()[position]))
+            {
+                m_values[position] = std::forward<M>(p_value);
+                return { iterator(this, static_cast<difference_type>(position)), false };
+            }
+
+            insert_at(position, std::forward<K>(p_key), std::forward<M>(p_value));
+            return { iterator(this, static_cast<difference_type>(position)), true };
+        }
+
+        iterator erase(iterator p_position)
+        {
+            return erase(const_iterator(p_position));
+        }
+
+        iterator erase(const_iterator p_position)
+        {
+            return erase(p_position, std::next(p_position));
+        }
+
+        iterator erase(const_iterator p_first, const_iterator p_last)
+        {
+            const auto first = p_first - cbegin();
+            const auto last = p_last - cbegin();
+            m_keys.keys().erase(m_keys.keys().begin() + first, m_keys.keys().begin() + last);
+            m_values.erase(m_values.begin() + first, m_values.begin() + last);
+            m_keys.rebuild();
+            return iterator(this, first);
+        }
+
+        /// <summary>
+        /// Erase the element with a key, if there is one.
+        /// </summary>
+        /// <returns>The number of elements erased.</returns>
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare> && (!std::is_convertible_v<const K&, const_iterator>)
+        size_type erase(const K& p_key)
+        {
+            const auto found = m_keys.find(p_key);
+            if (found == size())
+            {
+                return 0;
+            }
+
+            erase(cbegin() + static_cast<difference_type>(found));
+            return 1;
+        }
+
+        void clear() noexcept
+        {
+            m_keys.keys().clear();
+            m_values.clear();
+            m_keys.rebuild();
+        }
+
+        void swap(flat_map& p_other) noexcept
+        {
+            m_keys.swap(p_other.m_keys);
+            std::swap(m_values, p_other.m_values);
+        }
+
+        /// <summary>
+        /// Move the keys and values out, leaving the map empty.
+        /// </summary>
+        containers extract() &&
+        {
+            containers result{ std::move(m_keys.keys()), std::move(m_values) };
+            clear();
+            return result;
+        }
+
+        /// <summary>
+        /// Replace the keys and values, which must be the same length and the keys sorted and unique.
+        /// </summary>
+        void replace(KeyContainer&& p_keys, MappedContainer&& p_values)
+        {
+            m_keys.keys() = std::move(p_keys);
+            m_values = std::move(p_values);
+            m_keys.rebuild();
+        }
+
+        key_compare key_comp() const { return m_keys.compare(); }
+        value_compare value_comp() const { return value_compare(m_keys.compare()); }
+
+        const KeyContainer& keys() const noexcept { return m_keys.keys(); }
+        const MappedContainer& values() const noexcept { return m_values; }
+
+        /// <summary>
+        /// Find the element with a key. If the comparator is transparent, keys of other types are
+        /// compared as they are; otherwise they are converted to key_type first.
+        /// </summary>
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        iterator find(const K& p_key)
+        {
+            return iterator(this, static_cast<difference_type>(find_position(p_key)));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        const_iterator find(const K& p_key) const
+        {
+            return const_iterator(this, static_cast<difference_type>(find_position(p_key)));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        bool contains(const K& p_key) const
+        {
+            return m_keys.find(p_key) != size();
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        size_type count(const K& p_key) const
+        {
+            return contains(p_key) ? 1 : 0;
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        iterator lower_bound(const K& p_key)
+        {
+            return iterator(this, static_cast<difference_type>(m_keys.lower_bound(p_key, [](std::size_t) {})));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        const_iterator lower_bound(const K& p_key) const
+        {
+            return const_iterator(this, static_cast<difference_type>(m_keys.lower_bound(p_key, [](std::size_t) {})));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        iterator upper_bound(const K& p_key)
+        {
+            return iterator(this, static_cast<difference_type>(m_keys.upper_bound(p_key)));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        const_iterator upper_bound(const K& p_key) const
+        {
+            return const_iterator(this, static_cast<difference_type>(m_keys.upper_bound(p_key)));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        std::pair<iterator, iterator> equal_range(const K& p_key)
+        {
+            return { lower_bound(p_key), upper_bound(p_key) };
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        std::pair<const_iterator, const_iterator> equal_range(const K& p_key) const
+        {
+            return { lower_bound(p_key), upper_bound(p_key) };
+        }
+
+        friend bool operator==(const flat_map& p_lhs, const flat_map& p_rhs)
+        {
+            return std::equal(p_lhs.keys().begin(), p_lhs.keys().end(), p_rhs.keys().begin(), p_rhs.keys().end())
+                && std::equal(p_lhs.m_values.begin(), p_lhs.m_values.end(), p_rhs.m_values.begin(), p_rhs.m_values.end());
+        }
+
+        friend void swap(flat_map& p_lhs, flat_map& p_rhs) noexcept
+        {
+            p_lhs.swap(p_rhs);
+        }
+
+    private:
+        difference_type ssize() const noexcept
+        {
+            return static_cast<difference_type>(size());
+        }
+
+        template <typename K>
+        std::size_t find_position(const K& p_key) const
+        {
+            // Fetch the value alongside the leaf of keys it is found in.
+            const auto lower = m_keys.lower_bound(p_key, [this](std::size_t p_first) { detail::prefetch(std::addressof(m_values[p_first])); });
+            return lower != size() && !m_keys.less(p_key, keys()[lower]) ? lower : size();
+        }
+
+        std::size_t checked_find(const Key& p_key) const
+        {
+            const auto found = find_position(p_key);
+            if (found == size())
+            {
+                throw std::out_of_range("The key is not in the flat_map.");
+            }
+
+            return found;
+        }
+
+        template <typename Value>
+        void append(Value&& p_value)
+        {
+            m_keys.keys().insert(m_keys.keys().end(), std::forward<Value>(p_value).first);
+            try
+            {
+                m_values.insert(m_values.end(), std::forward<Value>(p_value).second);
+            }
+            catch (...)
+            {
+                m_keys.keys().pop_back();
+                throw;
+            }
+        }
+
+        template <typename K, typename... Args>
+        void insert_at(std::size_t p_position, K&& p_key, Args&&... p_args)
+        {
+            const auto offset = static_cast<difference_type>(p_position);
+            m_keys.keys().emplace(m_keys.keys().begin() + offset, std::forward<K>(p_key));
+            try
+            {
+                m_values.emplace(m_values.begin() + offset, std::forward<Args>(p_args)...);
+            }
+            catch (...)
+            {
+                m_keys.keys().erase(m_keys.keys().begin() + offset);
+                throw;
+            }
+
+            m_keys.rebuild();
+        }
+
+        /// <summary>
+        /// Restore the order of the keys after appending to them, keeping the first of each run of
+        /// equivalent keys so that existing elements win over inserted ones.
+        /// </summary>
+        void sort_unique()
+        {
+            if (!m_keys.sorted_unique(keys()))
+            {
+                const auto order = m_keys.unique_order(keys());
+                auto sorted_values = detail::gather(m_values, order);
+                m_keys.keys() = detail::gather(m_keys.keys(), order);
+                m_values = std::move(sorted_values);
+            }
+
+            m_keys.rebuild();
+        }
+
+        /// <summary>
+        /// Restore the order of the keys after appending a sorted, unique run to the sorted, unique
+        /// existing ones.
+        /// </summary>
+        void merge_unique(std::size_t p_existing)
+        {
+            const auto& all = keys();
+            if (p_existing == 0 || p_existing == all.size() || m_keys.less(all[p_existing - 1], all[p_existing]))
+            {
+                m_keys.rebuild();
+                return;
+            }
+
+            std::vector<std::size_t> order;
+            order.reserve(all.size());
+            std::size_t left = 0;
+            std::size_t right = p_existing;
+            while (left < p_existing || right < all.size())
+            {
+                if (right == all.size() || (left < p_existing && !m_keys.less(all[right], all[left])))
+                {
+                    // Existing keys win ties.
+                    if (right != all.size() && !m_keys.less(all[left], all[right]))
+                    {
+                        ++right;
+                    }
+
+                    order.push_back(left++);
+                }
+                else
+                {
+                    order.push_back(right++);
+                }
+            }
+
+            auto merged_values = detail::gather(m_values, order);
+            m_keys.keys() = detail::gather(m_keys.keys(), order);
+            m_values = std::move(merged_values);
+            m_keys.rebuild();
+        }
+
+        keys_type m_keys;
+        MappedContainer m_values;
+    };
+
+    /// <summary>
+    /// Random access iterator over the elements of a flat_map. Dereferencing yields a pair of
+    /// references into the key and value arrays, which means this is a proxy iterator in the same
+    /// way that the iterator of soa_vector is.
+    /// </summary>
+    template <typename Key, typename T, typename Compare, typename KeyContainer, typename MappedContainer>
+    template <bool Const>
+    class flat_map<Key, T, Compare, KeyContainer, MappedContainer>::basic_iterator
+    {
+        using container = std::conditional_t<Const, const flat_map, flat_map>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = flat_map::value_type;
+        using reference = std::conditional_t<Const, flat_map::const_reference, flat_map::reference>;
+        using difference_type = std::ptrdiff_t;
+
+        /// <summary>
+        /// Holds the pair of references for operator-&gt;.
+        /// </summary>
+        struct pointer
+        {
+            reference m_reference;
+
+            const reference* operator->() const noexcept
+            {
+                return std::addressof(m_reference);
+            }
+        };
+
+        basic_iterator() noexcept = default;
+
+        basic_iterator(container* p_container, difference_type p_idx) noexcept
+            : m_container(p_container),
+            m_idx(p_idx)
+        {
+        }
+
+        template <bool OtherConst>
+            requires (Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& p_other) noexcept
+            : m_container(p_other.m_container),
+            m_idx(p_other.m_idx)
+        {
+        }
+
+        reference operator*() const noexcept
+        {
+            const auto idx = static_cast<size_type>(m_idx);
+            return reference(m_container->keys()[idx], m_container->m_values[idx]);
+        }
+
+        pointer operator->() const noexcept { return pointer{ **this }; }
+        reference operator[](difference_type p_offset) const noexcept { return *(*this + p_offset); }
+
+        basic_iterator& operator++() noexcept { ++m_idx; return *this; }
+        basic_iterator operator++(int) noexcept { auto copy = *this; ++m_idx; return copy; }
+        basic_iterator& operator--() noexcept { --m_idx; return *this; }
+        basic_iterator operator--(int) noexcept { auto copy = *this; --m_idx; return copy; }
+        basic_iterator& operator+=(difference_type p_offset) noexcept { m_idx += p_offset; return *this; }
+        basic_iterator& operator-=(difference_type p_offset) noexcept { m_idx -= p_offset; return *this; }
+
+        friend basic_iterator operator+(basic_iterator p_it, difference_type p_offset) noexcept { return p_it += p_offset; }
+        friend basic_iterator operator+(difference_type p_offset, basic_iterator p_it) noexcept { return p_it += p_offset; }
+        friend basic_iterator operator-(basic_iterator p_it, difference_type p_offset) noexcept { return p_it -= p_offset; }
+        friend difference_type operator-(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx - p_rhs.m_idx; }
+
+        friend bool operator==(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx == p_rhs.m_idx; }
+        friend auto operator<=>(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx <=> p_rhs.m_idx; }
+
+    private:
+        template <bool>
+        friend class basic_iterator;
+
+        container* m_container = nullptr;
+        difference_type m_idx = 0;
+    };
+
+    /// <summary>
+    /// A sorted set of unique keys stored in a contiguous array, with the semantics of C++23's
+    /// std::flat_set, and searched in the same way as the keys of a flat_map.
+    /// </summary>
+    /// <typeparam name="Key">The key type.</typeparam>
+    /// <typeparam name="Compare">The strict weak ordering of the keys.</typeparam>
+    template <typename Key, typename Compare = std::less<Key>, typename KeyContainer = std::vector<Key>>
+    class flat_set
+    {
+        using keys_type = detail::flat_keys<Key, Compare, KeyContainer>;
+
+    public:
+        using key_type = Key;
+        using value_type = Key;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using reference = Key&;
+        using const_reference = const Key&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = typename KeyContainer::const_iterator;
+        using const_iterator = typename KeyContainer::const_iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using container_type = KeyContainer;
+
+        flat_set() = default;
+
+        explicit flat_set(const Compare& p_compare)
+            : m_keys(KeyContainer(), p_compare)
+        {
+        }
+
+        /// <summary>
+        /// Take the given keys, then sort them and remove the duplicates.
+        /// </summary>
+        explicit flat_set(KeyContainer p_keys, const Compare& p_compare = Compare())
+            : m_keys(std::move(p_keys), p_compare)
+        {
+            sort_unique();
+        }
+
+        flat_set(sorted_unique_t, KeyContainer p_keys, const Compare& p_compare = Compare())
+            : m_keys(std::move(p_keys), p_compare)
+        {
+            m_keys.rebuild();
+        }
+
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel>
+        flat_set(Iter p_first, Sentinel p_last, const Compare& p_compare = Compare())
+            : m_keys(KeyContainer(), p_compare)
+        {
+            insert(std::move(p_first), std::move(p_last));
+        }
+
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel>
+        flat_set(sorted_unique_t, Iter p_first, Sentinel p_last, const Compare& p_compare = Compare())
+            : m_keys(KeyContainer(p_first, p_last), p_compare)
+        {
+            m_keys.rebuild();
+        }
+
+        flat_set(std::initializer_list<Key> p_keys, const Compare& p_compare = Compare())
+            : flat_set(p_keys.begin(), p_keys.end(), p_compare)
+        {
+        }
+
+        flat_set(sorted_unique_t, std::initializer_list<Key> p_keys, const Compare& p_compare = Compare())
+            : flat_set(sorted_unique, p_keys.begin(), p_keys.end(), p_compare)
+        {
+        }
+
+        iterator begin() const noexcept { return keys().begin(); }
+        iterator end() const noexcept { return keys().end(); }
+        const_iterator cbegin() const noexcept { return keys().begin(); }
+        const_iterator cend() const noexcept { return keys().end(); }
+        reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+        reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+
+        bool empty() const noexcept { return keys().empty(); }
+        size_type size() const noexcept { return keys().size(); }
+
+        template <typename... Args>
+            requires std::constructible_from<Key, Args&&...>
+        std::pair<iterator, bool> emplace(Args&&... p_args)
+        {
+            return insert(Key(std::forward<Args>(p_args)...));
+        }
+
+        std::pair<iterator, bool> insert(const Key& p_key)
+        {
+            return insert(Key(p_key));
+        }
+
+        std::pair<iterator, bool> insert(Key&& p_key)
+        {
+            const auto position = m_keys.lower_bound(p_key, [](std::size_t) {});
+            if (position != size() && !m_keys.less(p_key, keys()[position]))
+            {
+                return { begin() + static_cast<difference_type>(position), false };
+            }
+
+            m_keys.keys().insert(m_keys.keys().begin() + static_cast<difference_type>(position), std::move(p_key));
+            m_keys.rebuild();
+            return { begin() + static_cast<difference_type>(position), true };
+        }
+
+        /// <summary>
+        /// Insert the keys of a range which are not already present, sorting once.
+        /// </summary>
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel>
+        void insert(Iter p_first, Sentinel p_last)
+        {
+            for (; p_first != p_last; ++p_first)
+            {
+                m_keys.keys().insert(m_keys.keys().end(), *p_first);
+            }
+
+            sort_unique();
+        }
+
+        void insert(std::initializer_list<Key> p_keys)
+        {
+            insert(p_keys.begin(), p_keys.end());
+        }
+
+        iterator erase(const_iterator p_position)
+        {
+            return erase(p_position, std::next(p_position));
+        }
+
+        iterator erase(const_iterator p_first, const_iterator p_last)
+        {
+            const auto first = p_first - cbegin();
+            m_keys.keys().erase(p_first, p_last);
+            m_keys.rebuild();
+            return begin() + first;
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare> && (!std::is_convertible_v<const K&, const_iterator>)
+        size_type erase(const K& p_key)
+        {
+            const auto found = m_keys.find(p_key);
+            if (found == size())
+            {
+                return 0;
+            }
+
+            erase(cbegin() + static_cast<difference_type>(found));
+            return 1;
+        }
+
+        void clear() noexcept
+        {
+            m_keys.keys().clear();
+            m_keys.rebuild();
+        }
+
+        void swap(flat_set& p_other) noexcept
+        {
+            m_keys.swap(p_other.m_keys);
+        }
+
+        KeyContainer extract() &&
+        {
+            auto result = std::move(m_keys.keys());
+            clear();
+            return result;
+        }
+
+        void replace(KeyContainer&& p_keys)
+        {
+            m_keys.keys() = std::move(p_keys);
+            m_keys.rebuild();
+        }
+
+        key_compare key_comp() const { return m_keys.compare(); }
+        value_compare value_comp() const { return m_keys.compare(); }
+
+        const KeyContainer& keys() const noexcept { return m_keys.keys(); }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        iterator find(const K& p_key) const
+        {
+            return begin() + static_cast<difference_type>(m_keys.find(p_key));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        bool contains(const K& p_key) const
+        {
+            return m_keys.find(p_key) != size();
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        size_type count(const K& p_key) const
+        {
+            return contains(p_key) ? 1 : 0;
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        iterator lower_bound(const K& p_key) const
+        {
+            return begin() + static_cast<difference_type>(m_keys.lower_bound(p_key, [](std::size_t) {}));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        iterator upper_bound(const K& p_key) const
+        {
+            return begin() + static_cast<difference_type>(m_keys.upper_bound(p_key));
+        }
+
+        template <typename K = Key>
+            requires detail::flat_lookup<K, Key, Compare>
+        std::pair<iterator, iterator> equal_range(const K& p_key) const
+        {
+            return { lower_bound(p_key), upper_bound(p_key) };
+        }
+
+        friend bool operator==(const flat_set& p_lhs, const flat_set& p_rhs)
+        {
+            return std::equal(p_lhs.begin(), p_lhs.end(), p_rhs.begin(), p_rhs.end());
+        }
+
+        friend void swap(flat_set& p_lhs, flat_set& p_rhs) noexcept
+        {
+            p_lhs.swap(p_rhs);
+        }
+
+    private:
+        void sort_unique()
+        {
+            if (!m_keys.sorted_unique(keys()))
+            {
+                m_keys.keys() = detail::gather(m_keys.keys(), m_keys.unique_order(keys()));
+            }
+
+            m_keys.rebuild();
+        }
+
+        keys_type m_keys;
+    };
+}
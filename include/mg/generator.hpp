@@ -0,0 +1,390 @@
+#pragma once
+
+#include "detail/coroutine.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mg
+{
+    template <typename T>
+    class generator;
+
+    /// <summary>
+    /// Wraps a generator to be yielded element by element from within another generator, as in
+    /// co_yield mg::elements_of(inner()). The inner generator runs directly on the consumer's
+    /// resumptions, and hands control back to the outer one by symmetric transfer when it finishes,
+    /// so recursion costs no extra resumptions per element.
+    /// </summary>
+    template <typename Generator>
+    struct elements_of
+    {
+        explicit elements_of(Generator&& p_range) noexcept
+            : m_range(std::forward<Generator>(p_range))
+        {
+        }
+
+        Generator m_range;
+    };
+
+    template <typename Generator>
+    elements_of(Generator&&) -> elements_of<Generator>;
+
+    /// <summary>
+    /// A lazily evaluated sequence produced by a coroutine, which co_yields each element in turn. The
+    /// coroutine only runs as the sequence is iterated, so a pipeline of generators streams through
+    /// its data one element at a time instead of materializing intermediate containers.
+    /// </summary>
+    /// <remarks>A generator is a move only input range (and view), so it can be iterated once, and
+    /// works with the standard range algorithms and adaptors. Elements are yielded by reference: an
+    /// element is not copied unless the coroutine yields a const lvalue.</remarks>
+    /// <remarks>The coroutine frame is allocated with an allocator (such as mg::arena_allocator)
+    /// when the coroutine's parameters begin with std::allocator_arg and the allocator.</remarks>
+    /// <remarks>An exception thrown by the coroutine propagates from the iterator increment (or
+    /// begin) which resumed it, after which the sequence is finished.</remarks>
+    /// <typeparam name="T">The element type, or an lvalue reference to yield references.</typeparam>
+    /// <example><code>
+    /// mg::generator&lt;std::string_view&gt; lines(std::istream&amp; p_input)
+    /// {
+    ///     std::string line;
+    ///     while (std::getline(p_input, line))
+    ///     {
+    ///         co_yield line;
+    ///     }
+    /// }
+    ///
+    /// mg::generator&lt;int&gt; scratch(std::allocator_arg_t, mg::arena_allocator&lt;std::byte&gt;, int p_count);
+    /// </code></example>
+    template <typename T>
+    class generator : public std::ranges::view_interface<generator<T>>
+    {
+        static_assert(!std::is_rvalue_reference_v<T>, "Generators of rvalue references are not supported.");
+
+    public:
+        using value_type = std::remove_cvref_t<T>;
+        using reference = std::conditional_t<std::is_reference_v<T>, T, T&>;
+
+        class promise_type;
+        class iterator;
+
+        generator() noexcept = default;
+
+        generator(generator&& p_other) noexcept
+            : m_handle(std::exchange(p_other.m_handle, nullptr))
+        {
+        }
+
+        generator& operator=(generator&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                reset();
+                m_handle = std::exchange(p_other.m_handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~generator()
+        {
+            reset();
+        }
+
+        /// <summary>
+        /// Start the coroutine, running it to its first co_yield. May only be called once.
+        /// </summary>
+        iterator begin()
+        {
+            if (m_handle)
+            {
+                m_handle.promise().m_active.resume();
+            }
+
+            return iterator(m_handle);
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return {};
+        }
+
+    private:
+        using handle = std::coroutine_handle<promise_type>;
+
+        explicit generator(handle p_handle) noexcept
+            : m_handle(p_handle)
+        {
+        }
+
+        void reset() noexcept
+        {
+            if (m_handle)
+            {
+                std::exchange(m_handle, nullptr).destroy();
+            }
+        }
+
+        handle m_handle;
+    };
+
+    template <typename T>
+    class generator<T>::promise_type : public detail::coroutine_frame_allocation
+    {
+        using pointer = std::add_pointer_t<reference>;
+
+        /// <summary>
+        /// Holds a copy of a yielded const lvalue for as long as the coroutine is suspended on it.
+        /// </summary>
+        struct copy_awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(handle p_handle) noexcept { p_handle.promise().m_root->m_value = std::addressof(m_copy); }
+            void await_resume() const noexcept {}
+
+            value_type m_copy;
+        };
+
+        /// <summary>
+        /// Transfers to a nested generator, which the promise owns while it runs (rather than the
+        /// awaiter, to keep the awaiter trivial).
+        /// </summary>
+        struct nested_awaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return !m_promise->m_nested.m_handle;
+            }
+
+            std::coroutine_handle<> await_suspend(handle p_handle) noexcept
+            {
+                const auto nestedHandle = m_promise->m_nested.m_handle;
+                auto& nested = nestedHandle.promise();
+                nested.m_root = m_promise->m_root;
+                nested.m_parent = p_handle;
+                nested.m_root->m_active = nestedHandle;
+                return nestedHandle;
+            }
+
+            void await_resume()
+            {
+                const auto finished = std::move(m_promise->m_nested);
+                if (finished.m_handle && finished.m_handle.promise().m_exception)
+                {
+                    std::rethrow_exception(finished.m_handle.promise().m_exception);
+                }
+            }
+
+            promise_type* m_promise;
+        };
+
+        struct final_awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(handle p_handle) noexcept
+            {
+                auto& promise = p_handle.promise();
+                if (promise.m_parent)
+                {
+                    promise.m_root->m_active = promise.m_parent;
+                    return promise.m_parent;
+                }
+
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+    public:
+        generator get_return_object() noexcept
+        {
+            const auto self = handle::from_promise(*this);
+            m_active = self;
+            return generator(self);
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        final_awaiter final_suspend() const noexcept { return {}; }
+
+        std::suspend_always yield_value(std::remove_reference_t<reference>& p_value) noexcept
+        {
+            m_root->m_value = std::addressof(p_value);
+            return {};
+        }
+
+        std::suspend_always yield_value(std::remove_reference_t<reference>&& p_value) noexcept
+            requires (!std::is_reference_v<T>)
+        {
+            m_root->m_value = std::addressof(p_value);
+            return {};
+        }
+
+        copy_awaiter yield_value(const value_type& p_value)
+            requires (!std::is_reference_v<T> && !std::is_const_v<T>)
+        {
+            return copy_awaiter{ p_value };
+        }
+
+        nested_awaiter yield_value(elements_of<generator>&& p_nested) noexcept
+        {
+            m_nested = std::move(p_nested.m_range);
+            return nested_awaiter{ this };
+        }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception()
+        {
+            if (m_root == this)
+            {
+                throw;
+            }
+
+            m_exception = std::current_exception();
+        }
+
+        template <typename U>
+        std::suspend_never await_transform(U&&) = delete;
+
+    private:
+        friend class generator;
+        friend class iterator;
+
+        pointer m_value = nullptr;
+        promise_type* m_root = this;
+        std::coroutine_handle<> m_active;
+        handle m_parent;
+        generator m_nested;
+        std::exception_ptr m_exception;
+    };
+
+    template <typename T>
+    class generator<T>::iterator
+    {
+    public:
+        using value_type = generator::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() noexcept = default;
+        iterator(iterator&&) noexcept = default;
+        iterator& operator=(iterator&&) noexcept = default;
+
+        reference operator*() const noexcept
+        {
+            return static_cast<reference>(*m_handle.promise().m_value);
+        }
+
+        iterator& operator++()
+        {
+            m_handle.promise().m_active.resume();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        friend bool operator==(const iterator& p_it, std::default_sentinel_t) noexcept
+        {
+            return !p_it.m_handle || p_it.m_handle.done();
+        }
+
+    private:
+        friend class generator;
+
+        explicit iterator(handle p_handle) noexcept
+            : m_handle(p_handle)
+        {
+        }
+
+        handle m_handle;
+    };
+}
+
+namespace mg::detail
+{
+    template <std::ranges::input_range... Ranges>
+    generator<std::tuple<std::ranges::range_reference_t<Ranges>...>> generator_zip(Ranges... p_ranges)
+    {
+        auto its = std::tuple(std::ranges::begin(p_ranges)...);
+        const auto ends = std::tuple(std::ranges::end(p_ranges)...);
+        const auto anyEnded = [&]<std::size_t... Is>(std::index_sequence<Is...>)
+        {
+            return ((std::get<Is>(its) == std::get<Is>(ends)) || ...);
+        };
+
+        while (!anyEnded(std::index_sequence_for<Ranges...>()))
+        {
+            co_yield std::apply([](auto&... p_its) { return std::tuple<std::ranges::range_reference_t<Ranges>...>(*p_its...); }, its);
+            std::apply([](auto&... p_its) { (++p_its, ...); }, its);
+        }
+    }
+
+    template <std::size_t N, std::ranges::input_range Range>
+    generator<std::span<std::ranges::range_value_t<Range>>> generator_chunk(Range p_range)
+    {
+        std::vector<std::ranges::range_value_t<Range>> buffer;
+        buffer.reserve(N);
+        for (auto&& element : p_range)
+        {
+            buffer.push_back(std::forward<decltype(element)>(element));
+            if (buffer.size() == N)
+            {
+                co_yield std::span(buffer);
+                buffer.clear();
+            }
+        }
+
+        if (!buffer.empty())
+        {
+            co_yield std::span(buffer);
+        }
+    }
+}
+
+namespace mg::generators
+{
+    /// <summary>
+    /// The streaming counterpart of mg::views::zip for input ranges, such as generators, which the
+    /// random access zip_view cannot take. Yields tuples of references to the elements of each range
+    /// in parallel, stopping at the end of the shortest.
+    /// </summary>
+    /// <typeparam name="...Ranges">The types of the ranges to zip.</typeparam>
+    /// <param name="...p_ranges">The ranges to zip. L-values are referenced and r-values (including
+    /// generators) are owned by the returned generator.</param>
+    /// <returns>A generator of tuples of references.</returns>
+    template <std::ranges::viewable_range... Ranges>
+        requires (sizeof...(Ranges) > 0 && (std::ranges::input_range<Ranges> && ...))
+    auto zip(Ranges&&... p_ranges)
+    {
+        return detail::generator_zip(std::views::all(std::forward<Ranges>(p_ranges))...);
+    }
+
+    /// <summary>
+    /// The streaming counterpart of mg::views::chunk for input ranges, such as generators. Elements
+    /// are gathered into a buffer of N, which is yielded as a span each time it fills; unlike
+    /// chunk_view, the trailing partial chunk is yielded last rather than held back. Only one chunk
+    /// is ever held in memory.
+    /// </summary>
+    /// <typeparam name="N">The number of elements in each chunk.</typeparam>
+    /// <typeparam name="Range">The type of the range to chunk.</typeparam>
+    /// <param name="p_range">The range to chunk. L-values are referenced and r-values are owned by the generator.</param>
+    /// <returns>A generator of spans over each chunk, valid until the next is requested.</returns>
+    template <std::size_t N, std::ranges::viewable_range Range>
+        requires (N > 0 && std::ranges::input_range<Range>)
+    auto chunk(Range&& p_range)
+    {
+        return detail::generator_chunk<N>(std::views::all(std::forward<Range>(p_range)));
+    }
+}
@@ -0,0 +1,431 @@
+#pragma once
+
+#include "detail/histogram.hpp"
+#include "detail/ring.hpp"
+#include "serialize.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace mg
+{
+    /// <summary>
+    /// A plain (non-atomic) copy of a latency histogram's counts, as taken by snapshot(). It answers
+    /// the statistical queries, can be merged with other snapshots, and has a compact binary form
+    /// for merging histograms recorded in different processes.
+    /// </summary>
+    /// <remarks>Values are only known to the precision of their bucket. Queries report the highest
+    /// value equivalent to a bucket (so percentiles never under-report), except min() which reports
+    /// the lowest. The relative error of any reported value is at most 2^-(Bits - 1).</remarks>
+    /// <typeparam name="Bits">The precision, as the log2 of the number of sub-buckets.</typeparam>
+    template <unsigned Bits = 8>
+    class latency_snapshot
+    {
+    public:
+        using layout = detail::log_linear_buckets<Bits>;
+
+        latency_snapshot()
+            : m_counts(layout::bucket_count)
+        {
+        }
+
+        /// <summary>
+        /// Add a number of occurrences of a value.
+        /// </summary>
+        void record(std::uint64_t p_value, std::uint64_t p_count = 1) noexcept
+        {
+            m_counts[layout::index_of(p_value)] += p_count;
+            m_total += p_count;
+        }
+
+        /// <summary>
+        /// Add the counts of another snapshot to this one.
+        /// </summary>
+        void merge(const latency_snapshot& p_other) noexcept
+        {
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                m_counts[i] += p_other.m_counts[i];
+            }
+
+            m_total += p_other.m_total;
+        }
+
+        std::uint64_t total_count() const noexcept
+        {
+            return m_total;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_total == 0;
+        }
+
+        /// <summary>
+        /// The lowest value equivalent to the smallest recorded value, or zero if empty.
+        /// </summary>
+        std::uint64_t min() const noexcept
+        {
+            const auto it = std::find_if(m_counts.begin(), m_counts.end(), [](std::uint64_t p_count) { return p_count != 0; });
+            return it == m_counts.end() ? 0 : layout::lowest_equivalent(static_cast<std::size_t>(it - m_counts.begin()));
+        }
+
+        /// <summary>
+        /// The highest value equivalent to the largest recorded value, or zero if empty.
+        /// </summary>
+        std::uint64_t max() const noexcept
+        {
+            const auto it = std::find_if(m_counts.rbegin(), m_counts.rend(), [](std::uint64_t p_count) { return p_count != 0; });
+            return it == m_counts.rend() ? 0 : layout::highest_equivalent(static_cast<std::size_t>(m_counts.rend() - it - 1));
+        }
+
+        /// <summary>
+        /// The mean of the recorded values, taking each to be the middle of its bucket.
+        /// </summary>
+        double mean() const noexcept
+        {
+            if (m_total == 0)
+            {
+                return 0.0;
+            }
+
+            double sum = 0.0;
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                if (m_counts[i] != 0)
+                {
+                    const auto middle = (static_cast<double>(layout::lowest_equivalent(i)) + static_cast<double>(layout::highest_equivalent(i))) / 2;
+                    sum += middle * static_cast<double>(m_counts[i]);
+                }
+            }
+
+            return sum / static_cast<double>(m_total);
+        }
+
+        /// <summary>
+        /// The value at or below which the given percentage of the recorded values fall, or zero if
+        /// empty.
+        /// </summary>
+        /// <param name="p_percentile">The percentile, from 0 to 100 (clamped).</param>
+        std::uint64_t value_at_percentile(double p_percentile) const noexcept
+        {
+            if (m_total == 0)
+            {
+                return 0;
+            }
+
+            const auto fraction = std::clamp(p_percentile, 0.0, 100.0) / 100.0;
+            const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(m_total))));
+
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                seen += m_counts[i];
+                if (seen >= rank)
+                {
+                    return layout::highest_equivalent(i);
+                }
+            }
+
+            return max();
+        }
+
+        /// <summary>
+        /// The count recorded in the bucket holding the given value.
+        /// </summary>
+        std::uint64_t count_at(std::uint64_t p_value) const noexcept
+        {
+            return m_counts[layout::index_of(p_value)];
+        }
+
+        /// <summary>
+        /// Encode the snapshot compactly, in mg::serialize's wire format: the precision, then the
+        /// number of non-empty buckets and the buckets as pairs of varints (the distance from the
+        /// previous non-empty bucket and the count). A histogram of typical latencies encodes in a few
+        /// hundred bytes.
+        /// </summary>
+        std::vector<std::byte> serialize() const
+        {
+            std::uint64_t occupied = 0;
+            std::size_t size = 1;
+            std::size_t previous = 0;
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                if (m_counts[i] != 0)
+                {
+                    ++occupied;
+                    size += detail::varint_size(i - previous) + detail::varint_size(m_counts[i]);
+                    previous = i;
+                }
+            }
+
+            std::vector<std::byte> result(size + detail::varint_size(occupied));
+            detail::wire_writer writer(result.data(), result.data(), result.data() + result.size());
+            *writer.reserve(1) = static_cast<std::byte>(Bits);
+            writer.varint(occupied);
+
+            previous = 0;
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                if (m_counts[i] != 0)
+                {
+                    writer.varint(i - previous);
+                    writer.varint(m_counts[i]);
+                    previous = i;
+                }
+            }
+
+            return result;
+        }
+
+        /// <summary>
+        /// Decode a snapshot encoded by serialize().
+        /// </summary>
+        /// <exception cref="std::invalid_argument">Thrown if the data is malformed or was encoded
+        /// with a different precision.</exception>
+        static latency_snapshot deserialize(std::span<const std::byte> p_data)
+        {
+            if (p_data.empty() || std::to_integer<unsigned>(p_data.front()) != Bits)
+            {
+                throw std::invalid_argument("The serialized histogram has a different precision.");
+            }
+
+            detail::wire_reader reader(p_data);
+            reader.take(1);
+            latency_snapshot result;
+
+            const auto occupied = reader.varint();
+            std::uint64_t index = 0;
+            for (std::uint64_t i = 0; i < occupied; ++i)
+            {
+                index += reader.varint();
+                if (index >= layout::bucket_count)
+                {
+                    throw std::invalid_argument("The serialized histogram contains an invalid bucket.");
+                }
+
+                const auto count = reader.varint();
+                result.m_counts[static_cast<std::size_t>(index)] += count;
+                result.m_total += count;
+            }
+
+            if (reader.remaining() != 0)
+            {
+                throw std::invalid_argument("The serialized histogram has trailing data.");
+            }
+
+            return result;
+        }
+
+        bool operator==(const latency_snapshot&) const = default;
+
+    private:
+        std::vector<std::uint64_t> m_counts;
+        std::uint64_t m_total = 0;
+    };
+
+    /// <summary>
+    /// A concurrent histogram of latencies (or any unsigned values) with log-linear buckets, in the
+    /// style of HdrHistogram. Recording is a single relaxed atomic increment and never allocates or
+    /// locks; the minimum, maximum and total are derived from the buckets when a snapshot is taken.
+    /// </summary>
+    /// <remarks>Bits sets the precision: values below 2^Bits are counted exactly and larger values
+    /// to within a relative error of 2^-(Bits - 1) (0.8% for the default of 8). The whole 64 bit
+    /// range is covered, in (66 - Bits) * 2^(Bits - 1) buckets of 8 bytes (59KB by default).</remarks>
+    /// <remarks>Every thread increments the same buckets, so heavily contended recording of similar
+    /// values will bounce cache lines; see sharded_latency_histogram.</remarks>
+    /// <typeparam name="Bits">The precision, as the log2 of the number of sub-buckets.</typeparam>
+    /// <example><code>
+    /// mg::latency_histogram&lt;&gt; latencies;
+    /// latencies.record(elapsed.count());
+    ///
+    /// auto snapshot = latencies.snapshot_and_reset();
+    /// auto p99 = snapshot.value_at_percentile(99.0);
+    /// </code></example>
+    template <unsigned Bits = 8>
+    class latency_histogram
+    {
+    public:
+        using layout = detail::log_linear_buckets<Bits>;
+        using snapshot_type = latency_snapshot<Bits>;
+
+        latency_histogram()
+            : m_counts(std::make_unique<std::atomic<std::uint64_t>[]>(layout::bucket_count))
+        {
+        }
+
+        void record(std::uint64_t p_value, std::uint64_t p_count = 1) noexcept
+        {
+            m_counts[layout::index_of(p_value)].fetch_add(p_count, std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Add the counts of a snapshot, for example one deserialized from another process.
+        /// </summary>
+        void merge(const snapshot_type& p_snapshot) noexcept
+        {
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                const auto count = p_snapshot.count_at(layout::lowest_equivalent(i));
+                if (count != 0)
+                {
+                    m_counts[i].fetch_add(count, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Copy the counts. Values recorded concurrently may or may not be included.
+        /// </summary>
+        snapshot_type snapshot() const
+        {
+            snapshot_type result;
+            copy_into(result);
+            return result;
+        }
+
+        /// <summary>
+        /// Move the counts into a snapshot, leaving the histogram empty. Every value recorded
+        /// concurrently is included in either this snapshot or the next, never lost or duplicated.
+        /// </summary>
+        snapshot_type snapshot_and_reset()
+        {
+            snapshot_type result;
+            move_into(result);
+            return result;
+        }
+
+        void reset() noexcept
+        {
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                m_counts[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /// <summary>
+        /// Add this histogram's counts to a snapshot.
+        /// </summary>
+        void copy_into(snapshot_type& p_snapshot) const noexcept
+        {
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                add_bucket(p_snapshot, i, m_counts[i].load(std::memory_order_relaxed));
+            }
+        }
+
+        /// <summary>
+        /// Move this histogram's counts into a snapshot, leaving it empty.
+        /// </summary>
+        void move_into(snapshot_type& p_snapshot) noexcept
+        {
+            for (std::size_t i = 0; i < layout::bucket_count; ++i)
+            {
+                add_bucket(p_snapshot, i, m_counts[i].exchange(0, std::memory_order_relaxed));
+            }
+        }
+
+    private:
+        static void add_bucket(snapshot_type& p_snapshot, std::size_t p_index, std::uint64_t p_count) noexcept
+        {
+            if (p_count != 0)
+            {
+                p_snapshot.record(layout::lowest_equivalent(p_index), p_count);
+            }
+        }
+
+        std::unique_ptr<std::atomic<std::uint64_t>[]> m_counts;
+    };
+
+    /// <summary>
+    /// A latency histogram split into shards, with each thread recording into one shard chosen by
+    /// a per-thread index, so that threads recording concurrently rarely touch the same cache
+    /// line. Recording is still a single relaxed increment; snapshots merge the shards.
+    /// </summary>
+    /// <remarks>Uses a shard's worth of memory per hardware thread by default. Threads beyond the
+    /// shard count share shards, which only costs contention.</remarks>
+    /// <typeparam name="Bits">The precision, as the log2 of the number of sub-buckets.</typeparam>
+    template <unsigned Bits = 8>
+    class sharded_latency_histogram
+    {
+    public:
+        using snapshot_type = latency_snapshot<Bits>;
+
+        /// <summary>
+        /// Create a histogram with the given number of shards (rounded up to a power of two), by
+        /// default one per hardware thread.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">Thrown if the shard count is zero.</exception>
+        explicit sharded_latency_histogram(std::size_t p_shardCount = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            if (p_shardCount == 0)
+            {
+                throw std::invalid_argument("A sharded histogram needs at least one shard.");
+            }
+
+            m_shards = std::vector<shard>(std::bit_ceil(p_shardCount));
+        }
+
+        void record(std::uint64_t p_value, std::uint64_t p_count = 1) noexcept
+        {
+            m_shards[detail::histogram_thread_index() & (m_shards.size() - 1)].m_histogram.record(p_value, p_count);
+        }
+
+        void merge(const snapshot_type& p_snapshot) noexcept
+        {
+            m_shards.front().m_histogram.merge(p_snapshot);
+        }
+
+        snapshot_type snapshot() const
+        {
+            snapshot_type result;
+            for (const auto& entry : m_shards)
+            {
+                entry.m_histogram.copy_into(result);
+            }
+
+            return result;
+        }
+
+        snapshot_type snapshot_and_reset()
+        {
+            snapshot_type result;
+            for (auto& entry : m_shards)
+            {
+                entry.m_histogram.move_into(result);
+            }
+
+            return result;
+        }
+
+        void reset() noexcept
+        {
+            for (auto& entry : m_shards)
+            {
+                entry.m_histogram.reset();
+            }
+        }
+
+        std::size_t shard_count() const noexcept
+        {
+            return m_shards.size();
+        }
+
+    private:
+        struct alignas(detail::cache_line_size) shard
+        {
+            latency_histogram<Bits> m_histogram;
+        };
+
+        std::vector<shard> m_shards;
+    };
+}
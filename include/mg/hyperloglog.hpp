@@ -0,0 +1,323 @@
+#pragma once
+
+#include "detail/hash.hpp"
+#include "detail/hyperloglog.hpp"
+#include "serialize.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace mg
+{
+    /// <summary>
+    /// A HyperLogLog sketch, which estimates the number of distinct values added to it in a fixed
+    /// amount of memory: for example 16KB at the default precision, with a standard error of 0.8%.
+    /// Sketches of the same precision can be merged, including across processes through their
+    /// serialized form, to estimate the number of distinct values in the union of their inputs.
+    /// </summary>
+    /// <remarks>A sketch starts sparse, holding only the registers which have been set, and converts
+    /// to the dense array of every register once that would be smaller. Both give the same estimate.
+    /// Merging dense sketches is vectorized, and the estimate is Ertl's improved estimator (see
+    /// detail::hll_estimate), so is accurate for every cardinality without bias correction.</remarks>
+    /// <typeparam name="Precision">The log2 of the number of registers, between 4 and 18. Each extra
+    /// bit doubles the memory and divides the error by the square root of two.</typeparam>
+    /// <example><code>
+    /// mg::hyperloglog&lt;&gt; users;
+    /// for (const auto&amp; event : events)
+    /// {
+    ///     users.add(event.user_id);
+    /// }
+    ///
+    /// table.reserve(static_cast&lt;std::size_t&gt;(users.estimate() * 1.05));
+    /// </code></example>
+    template <unsigned Precision = 14>
+    class hyperloglog
+    {
+        static_assert(Precision >= 4 && Precision <= 18, "The precision of a hyperloglog must be between 4 and 18 bits.");
+
+    public:
+        static constexpr std::size_t register_count = std::size_t(1) << Precision;
+
+        /// <summary>
+        /// The largest value a register can hold: one more than the number of hash bits left after
+        /// the register index.
+        /// </summary>
+        static constexpr std::uint8_t max_rank = 64 - Precision + 1;
+
+        /// <summary>
+        /// The relative standard error of the estimate, 1.04 / sqrt(register_count).
+        /// </summary>
+        static double standard_error() noexcept
+        {
+            return 1.04 / std::sqrt(static_cast<double>(register_count));
+        }
+
+        /// <summary>
+        /// Add a value, given its 64 bit hash, which must be well distributed in every bit.
+        /// </summary>
+        void add_hash(std::uint64_t p_hash)
+        {
+            const auto index = static_cast<std::uint32_t>(p_hash >> (64 - Precision));
+            const auto rank = static_cast<std::uint8_t>(std::min<unsigned>(static_cast<unsigned>(std::countl_zero(p_hash << Precision)), 64 - Precision) + 1);
+            raise(index, rank);
+        }
+
+        /// <summary>
+        /// Add a value. As with all_unique, the hash defaults to std::hash; its result is mixed before
+        /// use, so the identity hashes std::hash provides for integers are fine.
+        /// </summary>
+        template <typename T, typename Hash = std::hash<T>>
+            requires std::invocable<const Hash&, const T&>
+        void add(const T& p_value, const Hash& p_hash = Hash{})
+        {
+            add_hash(detail::mix_hash(static_cast<std::uint64_t>(p_hash(p_value))));
+        }
+
+        /// <summary>
+        /// Add every value in a range.
+        /// </summary>
+        template <std::input_iterator Iter, std::sentinel_for<Iter> Sentinel, typename Hash = std::hash<std::iter_value_t<Iter>>>
+        void add(Iter p_first, Sentinel p_last, const Hash& p_hash = Hash{})
+        {
+            for (; p_first != p_last; ++p_first)
+            {
+                add(*p_first, p_hash);
+            }
+        }
+
+        /// <summary>
+        /// Estimate the number of distinct values added.
+        /// </summary>
+        double estimate() const noexcept
+        {
+            if (is_sparse())
+            {
+                std::array<std::uint32_t, max_rank + 1> counts{};
+                counts[0] = static_cast<std::uint32_t>(register_count - m_sparse.size());
+                for (const auto entry : m_sparse)
+                {
+                    ++counts[entry & 0xff];
+                }
+
+                return detail::hll_estimate(counts, static_cast<double>(register_count));
+            }
+
+            return detail::hll_estimate(detail::register_histogram<max_rank + 1>(m_registers.data(), register_count), static_cast<double>(register_count));
+        }
+
+        /// <summary>
+        /// Add the values of another sketch, so that this one estimates the distinct values of both.
+        /// </summary>
+        void merge(const hyperloglog& p_other)
+        {
+            if (p_other.is_sparse())
+            {
+                for (const auto entry : p_other.m_sparse)
+                {
+                    raise(entry >> 8, static_cast<std::uint8_t>(entry & 0xff));
+                }
+
+                return;
+            }
+
+            make_dense();
+            detail::max_registers(m_registers.data(), p_other.m_registers.data(), register_count);
+        }
+
+        bool is_sparse() const noexcept
+        {
+            return m_registers.empty();
+        }
+
+        void clear() noexcept
+        {
+            m_sparse.clear();
+            m_registers.clear();
+        }
+
+        /// <summary>
+        /// The value of a register (the highest rank of the values which went to it, or zero).
+        /// </summary>
+        std::uint8_t register_at(std::size_t p_index) const noexcept
+        {
+            if (!is_sparse())
+            {
+                return m_registers[p_index];
+            }
+
+            const auto found = lower_bound(static_cast<std::uint32_t>(p_index));
+            return found != m_sparse.end() && (*found >> 8) == p_index ? static_cast<std::uint8_t>(*found & 0xff) : 0;
+        }
+
+        /// <summary>
+        /// Encode the sketch, with mg::serialize: the precision, then either the set registers as
+        /// varints of the distance from the previous one and the value, or every register.
+        /// </summary>
+        std::vector<std::byte> serialize() const
+        {
+            std::vector<std::byte> result;
+            mg::serialize(static_cast<std::uint8_t>(Precision), result);
+            mg::serialize(static_cast<std::uint8_t>(is_sparse()), result);
+            if (is_sparse())
+            {
+                std::vector<std::uint32_t> deltas;
+                deltas.reserve(m_sparse.size());
+                std::uint32_t previous = 0;
+                for (const auto entry : m_sparse)
+                {
+                    deltas.push_back(entry - previous);
+                    previous = entry & ~std::uint32_t(0xff);
+                }
+
+                mg::serialize<varint_format>(deltas, result);
+            }
+            else
+            {
+                mg::serialize(m_registers, result);
+            }
+
+            return result;
+        }
+
+        /// <summary>
+        /// Decode a sketch encoded by serialize().
+        /// </summary>
+        /// <exception cref="std::invalid_argument">Thrown if the data is malformed or was encoded
+        /// with a different precision.</exception>
+        static hyperloglog deserialize(std::span<const std::byte> p_data)
+        {
+            if (mg::deserialize<std::uint8_t>(p_data) != Precision)
+            {
+                throw std::invalid_argument("The serialized hyperloglog has a different precision.");
+            }
+
+            hyperloglog result;
+            if (mg::deserialize<std::uint8_t>(p_data) != 0)
+            {
+                result.m_sparse = mg::deserialize<std::vector<std::uint32_t>, varint_format>(p_data);
+                std::uint32_t previous = 0;
+                for (std::size_t i = 0; i < result.m_sparse.size(); ++i)
+                {
+                    auto& entry = result.m_sparse[i];
+                    entry += previous;
+                    if ((i != 0 && entry >> 8 <= previous >> 8) || entry >> 8 >= register_count || (entry & 0xff) == 0 || (entry & 0xff) > max_rank)
+                    {
+                        throw std::invalid_argument("The serialized hyperloglog contains an invalid register.");
+                    }
+
+                    previous = entry & ~std::uint32_t(0xff);
+                }
+
+                if (result.m_sparse.size() > sparse_limit)
+                {
+                    result.make_dense();
+                }
+            }
+            else
+            {
+                result.m_registers = mg::deserialize<std::vector<std::uint8_t>>(p_data);
+                if (result.m_registers.size() != register_count
+                    || std::any_of(result.m_registers.begin(), result.m_registers.end(), [](std::uint8_t p_rank) { return p_rank > max_rank; }))
+                {
+                    throw std::invalid_argument("The serialized hyperloglog contains an invalid register.");
+                }
+            }
+
+            if (!p_data.empty())
+            {
+                throw std::invalid_argument("The serialized hyperloglog has trailing data.");
+            }
+
+            return result;
+        }
+
+    private:
+        /// <summary>
+        /// The number of set registers beyond which the sparse form (four bytes a register) converts
+        /// to the dense one (a byte a register), at half the dense size.
+        /// </summary>
+        static constexpr std::size_t sparse_limit = register_count / 8;
+
+        std::vector<std::uint32_t>::iterator lower_bound(std::uint32_t p_index) noexcept
+        {
+            return std::lower_bound(m_sparse.begin(), m_sparse.end(), p_index << 8);
+        }
+
+        std::vector<std::uint32_t>::const_iterator lower_bound(std::uint32_t p_index) const noexcept
+        {
+            return std::lower_bound(m_sparse.begin(), m_sparse.end(), p_index << 8);
+        }
+
+        void raise(std::uint32_t p_index, std::uint8_t p_rank)
+        {
+            if (!is_sparse())
+            {
+                m_registers[p_index] = std::max(m_registers[p_index], p_rank);
+                return;
+            }
+
+            const auto found = lower_bound(p_index);
+            if (found != m_sparse.end() && (*found >> 8) == p_index)
+            {
+                *found = std::max(*found, (p_index << 8) | p_rank);
+                return;
+            }
+
+            m_sparse.insert(found, (p_index << 8) | p_rank);
+            if (m_sparse.size() > sparse_limit)
+            {
+                make_dense();
+            }
+        }
+
+        void make_dense()
+        {
+            if (!is_sparse())
+            {
+                return;
+            }
+
+            m_registers.assign(register_count, 0);
+            for (const auto entry : m_sparse)
+            {
+                m_registers[entry >> 8] = static_cast<std::uint8_t>(entry & 0xff);
+            }
+
+            m_sparse.clear();
+            m_sparse.shrink_to_fit();
+        }
+
+        // Sorted entries of (index << 8 | value) for the set registers, while the sketch is sparse.
+        std::vector<std::uint32_t> m_sparse;
+        // Every register, once the sketch is dense.
+        std::vector<std::uint8_t> m_registers;
+    };
+
+    /// <summary>
+    /// Estimate the number of distinct elements in an iterator range with a hyperloglog sketch: the
+    /// approximate counterpart of all_unique, taking the same hash, in a fixed amount of memory.
+    /// </summary>
+    /// <typeparam name="Precision">See hyperloglog.</typeparam>
+    /// <typeparam name="Hash">The type of the hasher.</typeparam>
+    /// <param name="p_first">The start of the range to consider, inclusive.</param>
+    /// <param name="p_last">The end of the range, not inclusive.</param>
+    /// <param name="p_hash">Hasher of the iterator's value type.</param>
+    /// <returns>The estimated number of distinct elements.</returns>
+    template <unsigned Precision = 14, std::input_iterator Iter, std::sentinel_for<Iter> Sentinel, typename Hash = std::hash<std::iter_value_t<Iter>>>
+    double approx_distinct(Iter p_first, Sentinel p_last, const Hash& p_hash = Hash{})
+    {
+        hyperloglog<Precision> sketch;
+        sketch.add(std::move(p_first), std::move(p_last), p_hash);
+        return sketch.estimate();
+    }
+}
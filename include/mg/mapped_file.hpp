@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(_WIN32)
+// Keep windows.h from defining min and max and pulling in rarely used APIs for every consumer.
+#ifndef NOMINMAX
+#define NOMINMAX
+#define MG_MAPPED_FILE_UNDEF_NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define MG_MAPPED_FILE_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#ifdef MG_MAPPED_FILE_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef MG_MAPPED_FILE_UNDEF_NOMINMAX
+#endif
+#ifdef MG_MAPPED_FILE_UNDEF_WIN32_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef MG_MAPPED_FILE_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mg
+{
+    /// <summary>
+    /// A read only memory mapping of a whole file, so that it can be read in place as bytes or as an
+    /// array of trivially copyable records, with the operating system paging it in as it is touched.
+    /// </summary>
+    class mapped_file
+    {
+    public:
+        /// <summary>
+        /// Map a file.
+        /// </summary>
+        /// <exception cref="std::system_error">The file could not be opened or mapped.</exception>
+        explicit mapped_file(const std::filesystem::path& p_path)
+        {
+#if defined(_WIN32)
+            m_file = CreateFileW(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+            {
+                throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Could not open " + p_path.string());
+            }
+
+            LARGE_INTEGER size;
+            GetFileSizeEx(m_file, &size);
+            m_size = static_cast<std::size_t>(size.QuadPart);
+            if (m_size != 0)
+            {
+                m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                m_data = m_mapping == nullptr ? nullptr : static_cast<const std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (m_data == nullptr)
+                {
+                    const auto error = static_cast<int>(GetLastError());
+                    close();
+                    throw std::system_error(error, std::system_category(), "Could not map " + p_path.string());
+                }
+            }
+#else
+            m_file = ::open(p_path.c_str(), O_RDONLY);
+            if (m_file == -1)
+            {
+                throw std::system_error(errno, std::generic_category(), "Could not open " + p_path.string());
+            }
+
+            struct stat status;
+            ::fstat(m_file, &status);
+            m_size = static_cast<std::size_t>(status.st_size);
+            if (m_size != 0)
+            {
+                auto* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+                if (data == MAP_FAILED)
+                {
+                    const auto error = errno;
+                    close();
+                    throw std::system_error(error, std::generic_category(), "Could not map " + p_path.string());
+                }
+
+                m_data = static_cast<const std::byte*>(data);
+                ::madvise(data, m_size, MADV_SEQUENTIAL);
+            }
+#endif
+        }
+
+        mapped_file(mapped_file&& p_other) noexcept
+            : m_data(std::exchange(p_other.m_data, nullptr)),
+            m_size(std::exchange(p_other.m_size, 0)),
+#if defined(_WIN32)
+            m_mapping(std::exchange(p_other.m_mapping, nullptr)),
+            m_file(std::exchange(p_other.m_file, INVALID_HANDLE_VALUE))
+#else
+            m_file(std::exchange(p_other.m_file, -1))
+#endif
+        {
+        }
+
+        mapped_file& operator=(mapped_file&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                close();
+                m_data = std::exchange(p_other.m_data, nullptr);
+                m_size = std::exchange(p_other.m_size, 0);
+#if defined(_WIN32)
+                m_mapping = std::exchange(p_other.m_mapping, nullptr);
+                m_file = std::exchange(p_other.m_file, INVALID_HANDLE_VALUE);
+#else
+                m_file = std::exchange(p_other.m_file, -1);
+#endif
+            }
+
+            return *this;
+        }
+
+        ~mapped_file()
+        {
+            close();
+        }
+
+        std::span<const std::byte> bytes() const noexcept
+        {
+            return { m_data, m_size };
+        }
+
+        /// <summary>
+        /// View the file as an array of records.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">The size of the file is not a multiple of the size
+        /// of a record.</exception>
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        std::span<const T> as() const
+        {
+            if (m_size % sizeof(T) != 0)
+            {
+                throw std::invalid_argument("The size of the mapped file is not a whole number of records.");
+            }
+
+            // Mappings start on a page boundary, so are aligned for any record.
+            return { reinterpret_cast<const T*>(m_data), m_size / sizeof(T) };
+        }
+
+    private:
+        void close() noexcept
+        {
+#if defined(_WIN32)
+            if (m_data != nullptr)
+            {
+                UnmapViewOfFile(m_data);
+            }
+
+            if (m_mapping != nullptr)
+            {
+                CloseHandle(m_mapping);
+            }
+
+            if (m_file != INVALID_HANDLE_VALUE)
+            {
+                CloseHandle(m_file);
+            }
+
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#else
+            if (m_data != nullptr)
+            {
+                ::munmap(const_cast<std::byte*>(m_data), m_size);
+            }
+
+            if (m_file != -1)
+            {
+                ::close(m_file);
+            }
+
+            m_file = -1;
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        const std::byte* m_data = nullptr;
+        std::size_t m_size = 0;
+#if defined(_WIN32)
+        HANDLE m_mapping = nullptr;
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+#else
+        int m_file = -1;
+#endif
+    };
+
+    /// <summary>
+    /// A read write, anonymous shared memory mapping of a fixed size, for example to hand serialized
+    /// data to a child process. The memory starts zeroed and on a page boundary.
+    /// </summary>
+    class mapped_memory
+    {
+    public:
+        /// <summary>
+        /// Map new memory.
+        /// </summary>
+        /// <exception cref="std::system_error">The memory could not be mapped.</exception>
+        explicit mapped_memory(std::size_t p_size)
+            : m_size(p_size)
+        {
+            if (m_size == 0)
+            {
+                return;
+            }
+
+#if defined(_WIN32)
+            const auto size = static_cast<unsigned long long>(p_size);
+            m_mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size), nullptr);
+            m_data = m_mapping == nullptr ? nullptr : static_cast<std::byte*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, p_size));
+            if (m_data == nullptr)
+            {
+                const auto error = static_cast<int>(GetLastError());
+                close();
+                throw std::system_error(error, std::system_category(), "Could not map shared memory");
+            }
+#else
+            auto* data = ::mmap(nullptr, p_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+            if (data == MAP_FAILED)
+            {
+                throw std::system_error(errno, std::generic_category(), "Could not map shared memory");
+            }
+
+            m_data = static_cast<std::byte*>(data);
+#endif
+        }
+
+        mapped_memory(mapped_memory&& p_other) noexcept
+            : m_data(std::exchange(p_other.m_data, nullptr)),
+            m_size(std::exchange(p_other.m_size, 0))
+#if defined(_WIN32)
+            , m_mapping(std::exchange(p_other.m_mapping, nullptr))
+#endif
+        {
+        }
+
+        mapped_memory& operator=(mapped_memory&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                close();
+                m_data = std::exchange(p_other.m_data, nullptr);
+                m_size = std::exchange(p_other.m_size, 0);
+#if defined(_WIN32)
+                m_mapping = std::exchange(p_other.m_mapping, nullptr);
+#endif
+            }
+
+            return *this;
+        }
+
+        ~mapped_memory()
+        {
+            close();
+        }
+
+        std::span<std::byte> bytes() const noexcept
+        {
+            return { m_data, m_size };
+        }
+
+    private:
+        void close() noexcept
+        {
+#if defined(_WIN32)
+            if (m_data != nullptr)
+            {
+                UnmapViewOfFile(m_data);
+            }
+
+            if (m_mapping != nullptr)
+            {
+                CloseHandle(m_mapping);
+            }
+
+            m_mapping = nullptr;
+#else
+            if (m_data != nullptr)
+            {
+                ::munmap(m_data, m_size);
+            }
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        std::byte* m_data = nullptr;
+        std::size_t m_size = 0;
+#if defined(_WIN32)
+        HANDLE m_mapping = nullptr;
+#endif
+    };
+}
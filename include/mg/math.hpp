@@ -1,5 +1,9 @@
 #pragma once
 
+#include "detail/wide_int.hpp"
+
+#include <array>
+#include <cstdint>
 #include <limits>
 #include <stdexcept>
 #include <type_traits>
@@ -13,6 +17,10 @@ namespace mg
     /// still result in a floating point result). Base could be allowed to be negative with these
     /// rules, but given the use case this seems unlikely to be required, and would make the
     /// definition more confusing.
+    ///
+    /// The result is computed by repeated squaring, in a number of multiplications logarithmic in
+    /// the power, so wide integers (see wide_uint) can be raised to powers far beyond what fits in
+    /// 64 bits.
     /// </summary>
     /// <typeparam name="T">The arithmetic type domain to operate in.</typeparam>
     /// <param name="p_base">The base of the operation.</param>
@@ -44,22 +52,91 @@ namespace mg
             return p_base;
         }
 
-        if (p_power == 0)
+        // Square only while bits of the power remain, so that no intermediate exceeds the result.
+        T result{ 1 };
+        auto base = p_base;
+        auto power = p_power;
+        while (true)
+        {
+            if ((power & T{ 1 }) != 0)
+            {
+                result *= base;
+            }
+
+            power >>= 1;
+            if (power == 0)
+            {
+                return result;
+            }
+
+            base *= base;
+        }
+    }
+
+    /// <summary>
+    /// Modular multiplication, (lhs * rhs) mod modulus, computed through the full double width
+    /// product so that it is exact for every value of the type. The overload for wide integers is
+    /// declared in wide_int.hpp.
+    /// </summary>
+    /// <typeparam name="T">The integer type domain to operate in, of at most 64 bits.</typeparam>
+    /// <param name="p_lhs">The first factor, which must not be negative.</param>
+    /// <param name="p_rhs">The second factor, which must not be negative.</param>
+    /// <param name="p_modulus">The modulus, which must be positive.</param>
+    /// <returns>The product reduced modulo the modulus.</returns>
+    template <typename T>
+    constexpr T mul_mod(const T& p_lhs, const T& p_rhs, const T& p_modulus)
+    {
+        static_assert(std::numeric_limits<T>::is_integer
+            && !std::is_same_v<bool, T>,
+            "The type provided must be an arithmetic non-bool type.");
+        if (p_lhs < 0 || p_rhs < 0)
         {
-            return T{ 1 };
+            throw std::invalid_argument("The factors must be whole numbers.");
         }
 
-        if (p_power == 1)
+        if (p_modulus <= 0)
         {
-            return p_base;
+            throw std::invalid_argument("The modulus must be positive.");
         }
 
-        auto result = p_base;
-        for (T i = 0; i < p_power - 1; ++i)
+        static_assert(std::numeric_limits<T>::digits <= 64, "Built-in types of more than 64 bits are not supported; use wide_uint.");
+        const std::array<std::uint64_t, 1> lhs{ static_cast<std::uint64_t>(p_lhs % p_modulus) };
+        const std::array<std::uint64_t, 1> rhs{ static_cast<std::uint64_t>(p_rhs % p_modulus) };
+        const std::array<std::uint64_t, 1> modulus{ static_cast<std::uint64_t>(p_modulus) };
+        std::array<std::uint64_t, 1> result{};
+        detail::mul_mod<1>(lhs.data(), rhs.data(), modulus.data(), result.data());
+        return static_cast<T>(result[0]);
+    }
+
+    /// <summary>
+    /// Modular exponentiation, (base ^ power) mod modulus, with every intermediate reduced, so
+    /// that it never overflows however large the power. Powers are taken four bits at a time,
+    /// and odd moduli multiply in Montgomery form, without division (see detail::mod_pow). The
+    /// overload for wide integers is declared in wide_int.hpp.
+    /// </summary>
+    /// <typeparam name="T">The integer type domain to operate in, of at most 64 bits.</typeparam>
+    /// <param name="p_base">The base, which must not be negative.</param>
+    /// <param name="p_power">The power, which must not be negative.</param>
+    /// <param name="p_modulus">The modulus, which must be positive.</param>
+    /// <returns>The result of (base ^ power) mod modulus, where 0 ^ 0 is 1.</returns>
+    template <typename T>
+    constexpr T mod_pow(const T& p_base, const T& p_power, const T& p_modulus)
+    {
+        static_assert(std::numeric_limits<T>::is_integer
+            && !std::is_same_v<bool, T>,
+            "The type provided must be an arithmetic non-bool type.");
+        if (p_power < 0)
         {
-            result *= p_base;
+            throw std::invalid_argument("The power must be a whole number.");
         }
 
-        return result;
+        // Multiplying by one validates the base and modulus and reduces the base.
+        const auto base = mul_mod(p_base, T{ 1 }, p_modulus);
+        const std::array<std::uint64_t, 1> limbs{ static_cast<std::uint64_t>(base) };
+        const std::array<std::uint64_t, 1> power{ static_cast<std::uint64_t>(p_power) };
+        const std::array<std::uint64_t, 1> modulus{ static_cast<std::uint64_t>(p_modulus) };
+        std::array<std::uint64_t, 1> result{};
+        detail::mod_pow<1>(limbs.data(), power.data(), 1, modulus.data(), result.data());
+        return static_cast<T>(result[0]);
     }
-}
\ No newline at end of file
+}
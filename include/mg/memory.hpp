@@ -0,0 +1,531 @@
+#pragma once
+
+#include "detail/memory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+
+namespace mg
+{
+    /// <summary>
+    /// A bump allocator. Allocation advances a cursor through the current block, and individual
+    /// deallocation is a no-op (other than for the most recent allocation, which is rolled back).
+    /// Memory is reclaimed in bulk with reset, which keeps the blocks for reuse, so a workload that
+    /// repeats between resets stops calling the upstream allocator once it has warmed up.
+    /// </summary>
+    /// <remarks>An arena can start from a caller provided buffer (see inline_arena), only going to
+    /// the heap once that is exhausted. Blocks after that double in size, starting at the given
+    /// block size.</remarks>
+    /// <remarks>An arena is not thread safe.</remarks>
+    class arena
+    {
+    public:
+        static constexpr std::size_t default_block_size = 4096;
+
+        explicit arena(std::size_t p_block_size = default_block_size) noexcept
+            : m_blockSize(std::max<std::size_t>(p_block_size, 64)),
+            m_nextBlockSize(m_blockSize)
+        {
+        }
+
+        /// <summary>
+        /// Create an arena which allocates from the given buffer first. The buffer is not owned and
+        /// must outlive the arena.
+        /// </summary>
+        arena(std::span<std::byte> p_initial, std::size_t p_block_size = default_block_size) noexcept
+            : m_cursor(p_initial.data()),
+            m_end(p_initial.data() + p_initial.size()),
+            m_initial(p_initial),
+            m_blockSize(std::max<std::size_t>(p_block_size, 64)),
+            m_nextBlockSize(m_blockSize)
+        {
+        }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        ~arena()
+        {
+            release();
+        }
+
+        /// <summary>
+        /// Allocate uninitialized memory.
+        /// </summary>
+        /// <param name="p_bytes">The number of bytes.</param>
+        /// <param name="p_alignment">The alignment, which must be a power of two.</param>
+        /// <exception cref="std::bad_alloc">Thrown if a new block cannot be allocated.</exception>
+        void* allocate(std::size_t p_bytes, std::size_t p_alignment = alignof(std::max_align_t))
+        {
+            if (auto* result = bump(std::max<std::size_t>(p_bytes, 1), p_alignment))
+            {
+                return result;
+            }
+
+            return allocate_slow(std::max<std::size_t>(p_bytes, 1), p_alignment);
+        }
+
+        /// <summary>
+        /// Give back memory. Only the most recent allocation is actually reclaimed (so that stack
+        /// like usage does not grow the arena); everything else waits for reset.
+        /// </summary>
+        void deallocate(void* p_memory, std::size_t p_bytes) noexcept
+        {
+            auto* memory = static_cast<std::byte*>(p_memory);
+            if (memory != nullptr && memory + std::max<std::size_t>(p_bytes, 1) == m_cursor)
+            {
+                m_cursor = memory;
+            }
+        }
+
+        /// <summary>
+        /// Make all memory available again without returning any blocks to the heap. Everything
+        /// allocated from the arena is invalidated.
+        /// </summary>
+        void reset() noexcept
+        {
+            m_current = nullptr;
+            m_cursor = m_initial.data();
+            m_end = m_initial.data() + m_initial.size();
+        }
+
+        /// <summary>
+        /// Reset the arena and free all of the blocks which it allocated.
+        /// </summary>
+        void release() noexcept
+        {
+            while (m_head != nullptr)
+            {
+                auto* next = m_head->m_next;
+                ::operator delete(static_cast<void*>(m_head), sizeof(detail::arena_block) + m_head->m_size);
+                m_head = next;
+            }
+
+            m_tail = nullptr;
+            m_nextBlockSize = m_blockSize;
+            reset();
+        }
+
+        /// <summary>
+        /// The total number of bytes that the arena can hand out before needing another block,
+        /// including the initial buffer.
+        /// </summary>
+        std::size_t capacity() const noexcept
+        {
+            auto result = m_initial.size();
+            for (auto* block = m_head; block != nullptr; block = block->m_next)
+            {
+                result += block->m_size;
+            }
+
+            return result;
+        }
+
+    private:
+        void* bump(std::size_t p_bytes, std::size_t p_alignment) noexcept
+        {
+            const auto cursor = reinterpret_cast<std::uintptr_t>(m_cursor);
+            const auto aligned = detail::align_up(cursor, p_alignment);
+            const auto end = reinterpret_cast<std::uintptr_t>(m_end);
+            if (m_cursor == nullptr || aligned > end || end - aligned < p_bytes)
+            {
+                return nullptr;
+            }
+
+            m_cursor += (aligned - cursor) + p_bytes;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        void* allocate_slow(std::size_t p_bytes, std::size_t p_alignment)
+        {
+            // Move through the blocks kept from before a reset, before asking for a new one.
+            for (auto* block = m_current == nullptr ? m_head : m_current->m_next; block != nullptr; block = block->m_next)
+            {
+                enter(block);
+                if (auto* result = bump(p_bytes, p_alignment))
+                {
+                    return result;
+                }
+            }
+
+            constexpr auto Limit = std::numeric_limits<std::size_t>::max() - sizeof(detail::arena_block);
+            if (p_bytes > Limit - p_alignment)
+            {
+                throw std::bad_alloc();
+            }
+
+            const auto size = std::max(m_nextBlockSize, p_bytes + p_alignment);
+            auto* block = ::new (::operator new(sizeof(detail::arena_block) + size)) detail::arena_block{ nullptr, size };
+            (m_tail == nullptr ? m_head : m_tail->m_next) = block;
+            m_tail = block;
+            m_nextBlockSize = std::min(m_nextBlockSize * 2, max_block_size);
+
+            enter(block);
+            return bump(p_bytes, p_alignment);
+        }
+
+        void enter(detail::arena_block* p_block) noexcept
+        {
+            m_current = p_block;
+            m_cursor = p_block->data();
+            m_end = m_cursor + p_block->m_size;
+        }
+
+        static constexpr std::size_t max_block_size = std::size_t(1) << 24;
+
+        std::byte* m_cursor = nullptr;
+        std::byte* m_end = nullptr;
+        detail::arena_block* m_current = nullptr;
+        detail::arena_block* m_head = nullptr;
+        detail::arena_block* m_tail = nullptr;
+        std::span<std::byte> m_initial;
+        std::size_t m_blockSize;
+        std::size_t m_nextBlockSize;
+    };
+
+    /// <summary>
+    /// An arena whose first block of the given size is held inline, so that small workloads (for
+    /// example a stack allocated arena for a single request) never touch the heap.
+    /// </summary>
+    /// <typeparam name="N">The size of the inline block in bytes.</typeparam>
+    template <std::size_t N>
+    class inline_arena : public arena
+    {
+    public:
+        explicit inline_arena(std::size_t p_block_size = default_block_size) noexcept
+            : arena(std::span<std::byte>(m_buffer, N), p_block_size)
+        {
+        }
+
+    private:
+        alignas(std::max_align_t) std::byte m_buffer[N];
+    };
+
+    /// <summary>
+    /// A standard allocator which allocates from an arena. It can be passed wherever mg or the
+    /// standard library take an allocator, and rebinds to any other type while still sharing the
+    /// arena. Two arena_allocators compare equal when they use the same arena.
+    /// </summary>
+    /// <example>
+    /// Checking many small ranges for uniqueness without calling malloc once the arena is warm:
+    /// <code>
+    /// mg::arena scratch;
+    /// for (const auto&amp; request : requests)
+    /// {
+    ///     scratch.reset();
+    ///     auto unique = mg::all_unique(request.begin(), request.end(), {}, {}, mg::arena_allocator&lt;void&gt;(scratch));
+    /// }
+    /// </code>
+    /// </example>
+    /// <typeparam name="T">The type being allocated.</typeparam>
+    template <typename T>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = arena_allocator<U>;
+        };
+
+        arena_allocator(arena& p_arena) noexcept
+            : m_arena(&p_arena)
+        {
+        }
+
+        template <typename U>
+        arena_allocator(const arena_allocator<U>& p_other) noexcept
+            : m_arena(&p_other.get_arena())
+        {
+        }
+
+        T* allocate(std::size_t p_count)
+        {
+            if (p_count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length();
+            }
+
+            return static_cast<T*>(m_arena->allocate(p_count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p_memory, std::size_t p_count) noexcept
+        {
+            m_arena->deallocate(p_memory, p_count * sizeof(T));
+        }
+
+        arena& get_arena() const noexcept
+        {
+            return *m_arena;
+        }
+
+        template <typename U>
+        bool operator==(const arena_allocator<U>& p_other) const noexcept
+        {
+            return m_arena == &p_other.get_arena();
+        }
+
+    private:
+        arena* m_arena;
+    };
+
+    /// <summary>
+    /// A stateless standard allocator which serves single objects from process wide free lists of
+    /// fixed size chunks (one list per size and alignment), and everything else from the heap. This
+    /// suits node based containers, whose nodes are then recycled rather than going back to malloc.
+    /// </summary>
+    /// <remarks>With PerThread the free lists are cached per thread, so that allocation does not
+    /// take a lock. Memory may be freed on a different thread than the one which allocated it, and
+    /// a thread's cached chunks are handed back to the shared list when it exits. Chunks are never
+    /// returned to the heap.</remarks>
+    /// <typeparam name="T">The type being allocated.</typeparam>
+    /// <typeparam name="PerThread">Whether to use thread local free lists.</typeparam>
+    template <typename T, bool PerThread = false>
+    class pool_allocator
+    {
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = pool_allocator<U, PerThread>;
+        };
+
+        pool_allocator() noexcept = default;
+
+        template <typename U>
+        pool_allocator(const pool_allocator<U, PerThread>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t p_count)
+        {
+            using Pool = detail::fixed_pool<sizeof(T), alignof(T)>;
+
+            if (p_count == 1)
+            {
+                return static_cast<T*>(PerThread ? Pool::acquire_local() : Pool::acquire());
+            }
+
+            if (p_count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                throw std::bad_array_new_length();
+            }
+
+            return static_cast<T*>(::operator new(p_count * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* p_memory, std::size_t p_count) noexcept
+        {
+            using Pool = detail::fixed_pool<sizeof(T), alignof(T)>;
+
+            if (p_count == 1)
+            {
+                PerThread ? Pool::release_local(p_memory) : Pool::release(p_memory);
+                return;
+            }
+
+            ::operator delete(p_memory, p_count * sizeof(T), std::align_val_t(alignof(T)));
+        }
+
+        template <typename U>
+        bool operator==(const pool_allocator<U, PerThread>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    /// <summary>
+    /// Allocation statistics recorded by counting_allocator: the number of allocations and
+    /// deallocations, the bytes currently allocated and their peak, the total bytes ever allocated,
+    /// and a histogram of allocation sizes.
+    /// </summary>
+    /// <remarks>The counters are relaxed atomics by default, so one instance can be shared between
+    /// threads. With Atomic set to false they are plain integers, which is cheaper but means that the
+    /// instance must only be used by one thread at a time (for example a thread_local instance).</remarks>
+    /// <typeparam name="Atomic">Whether the counters are atomic.</typeparam>
+    template <bool Atomic = true>
+    class allocation_stats
+    {
+    public:
+        /// <summary>
+        /// The number of histogram buckets. Bucket i counts allocations of up to 2^i bytes which did
+        /// not fit in bucket i - 1 (so bucket 0 is single bytes, bucket 3 is 5 to 8 bytes, etc).
+        /// </summary>
+        static constexpr std::size_t bucket_count = std::numeric_limits<std::size_t>::digits + 1;
+
+        allocation_stats() = default;
+        allocation_stats(const allocation_stats&) = delete;
+        allocation_stats& operator=(const allocation_stats&) = delete;
+
+        void record_allocation(std::size_t p_bytes) noexcept
+        {
+            m_allocations.add(1);
+            m_totalBytes.add(p_bytes);
+            m_peakBytes.raise_to(m_bytesInUse.add(p_bytes));
+            m_histogram[bucket_of(p_bytes)].add(1);
+        }
+
+        void record_deallocation(std::size_t p_bytes) noexcept
+        {
+            m_deallocations.add(1);
+            m_bytesInUse.subtract(p_bytes);
+        }
+
+        std::size_t allocations() const noexcept
+        {
+            return m_allocations.load();
+        }
+
+        std::size_t deallocations() const noexcept
+        {
+            return m_deallocations.load();
+        }
+
+        std::size_t bytes_in_use() const noexcept
+        {
+            return m_bytesInUse.load();
+        }
+
+        std::size_t peak_bytes() const noexcept
+        {
+            return m_peakBytes.load();
+        }
+
+        std::size_t total_bytes() const noexcept
+        {
+            return m_totalBytes.load();
+        }
+
+        /// <summary>
+        /// A snapshot of the size histogram; see bucket_count.
+        /// </summary>
+        std::array<std::size_t, bucket_count> size_histogram() const noexcept
+        {
+            std::array<std::size_t, bucket_count> result;
+            for (std::size_t i = 0; i < bucket_count; ++i)
+            {
+                result[i] = m_histogram[i].load();
+            }
+
+            return result;
+        }
+
+        static constexpr std::size_t bucket_of(std::size_t p_bytes) noexcept
+        {
+            return p_bytes <= 1 ? 0 : static_cast<std::size_t>(std::bit_width(p_bytes - 1));
+        }
+
+        /// <summary>
+        /// Zero every counter, including the bytes in use, which is only meaningful once everything
+        /// allocated has been freed.
+        /// </summary>
+        void reset() noexcept
+        {
+            m_allocations.reset();
+            m_deallocations.reset();
+            m_bytesInUse.reset();
+            m_peakBytes.reset();
+            m_totalBytes.reset();
+            for (auto& bucket : m_histogram)
+            {
+                bucket.reset();
+            }
+        }
+
+    private:
+        detail::stats_counter<Atomic> m_allocations;
+        detail::stats_counter<Atomic> m_deallocations;
+        detail::stats_counter<Atomic> m_bytesInUse;
+        detail::stats_counter<Atomic> m_peakBytes;
+        detail::stats_counter<Atomic> m_totalBytes;
+        std::array<detail::stats_counter<Atomic>, bucket_count> m_histogram;
+    };
+
+    /// <summary>
+    /// An allocator adaptor which forwards to another allocator while recording every allocation in
+    /// an allocation_stats. Rebinding (for example by a container allocating nodes) keeps recording
+    /// into the same statistics, so the counts cover everything done on behalf of the container.
+    /// </summary>
+    /// <typeparam name="Alloc">The allocator being wrapped.</typeparam>
+    /// <typeparam name="Atomic">Whether the statistics are atomic; see allocation_stats.</typeparam>
+    template <typename Alloc, bool Atomic = true>
+    class counting_allocator
+    {
+        using traits = std::allocator_traits<Alloc>;
+
+    public:
+        using value_type = typename traits::value_type;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = counting_allocator<typename traits::template rebind_alloc<U>, Atomic>;
+        };
+
+        counting_allocator(allocation_stats<Atomic>& p_stats, const Alloc& p_alloc = Alloc{}) noexcept
+            : m_alloc(p_alloc),
+            m_stats(&p_stats)
+        {
+        }
+
+        template <typename OtherAlloc>
+        counting_allocator(const counting_allocator<OtherAlloc, Atomic>& p_other) noexcept
+            : m_alloc(p_other.inner()),
+            m_stats(&p_other.stats())
+        {
+        }
+
+        value_type* allocate(std::size_t p_count)
+        {
+            auto* result = std::to_address(traits::allocate(m_alloc, p_count));
+            m_stats->record_allocation(p_count * sizeof(value_type));
+            return result;
+        }
+
+        void deallocate(value_type* p_memory, std::size_t p_count) noexcept
+        {
+            m_stats->record_deallocation(p_count * sizeof(value_type));
+            traits::deallocate(m_alloc, p_memory, p_count);
+        }
+
+        const Alloc& inner() const noexcept
+        {
+            return m_alloc;
+        }
+
+        allocation_stats<Atomic>& stats() const noexcept
+        {
+            return *m_stats;
+        }
+
+        template <typename OtherAlloc>
+        bool operator==(const counting_allocator<OtherAlloc, Atomic>& p_other) const noexcept
+        {
+            return m_stats == &p_other.stats() && m_alloc == p_other.inner();
+        }
+
+    private:
+        Alloc m_alloc;
+        allocation_stats<Atomic>* m_stats;
+    };
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "detail/packed_tuple.hpp"
+#include "sequence.hpp"
+
+#include <cstdlib>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// A tuple whose members are physically reordered by alignment and size so that no padding is
+    /// required between them, while every access still uses the logical (declared) order. For
+    /// example a packed_tuple&lt;char, double, char, int&gt; occupies 16 bytes where the equivalent
+    /// std::tuple commonly occupies 24.
+    ///
+    /// The tuple protocol is supported, so structured bindings, mg::get, tuple_map, and
+    /// iter_zipped_tuples all work in logical order. std::get and std::apply cannot be extended to
+    /// user types and so are not supported; use the get member or mg::get instead.
+    /// </summary>
+    /// <typeparam name="...Ts">The member types in their logical order.</typeparam>
+    template <typename... Ts>
+    class packed_tuple
+    {
+        static_assert(
+            ((std::is_object_v<Ts> && !std::is_array_v<Ts>) && ...),
+            "The members of a packed_tuple must be non-array object types.");
+
+        static constexpr auto s_slots = detail::packed_slots_v<Ts...>;
+
+        using storage_type = decltype(detail::packed_layout<detail::packed_storage, Ts...>(std::index_sequence_for<Ts...>{}));
+
+    public:
+        /// <summary>
+        /// The member types in their logical order.
+        /// </summary>
+        using types = type_sequence<Ts...>;
+
+        /// <summary>
+        /// The member types in the order they are physically stored.
+        /// </summary>
+        using layout = decltype(detail::packed_layout<type_sequence, Ts...>(std::index_sequence_for<Ts...>{}));
+
+        /// <summary>
+        /// The physical slot in which the member with the given logical index is stored.
+        /// </summary>
+        template <std::size_t Idx>
+        static constexpr std::size_t slot_of = s_slots[Idx];
+
+        /// <summary>
+        /// Value initialize all of the members.
+        /// </summary>
+        constexpr packed_tuple() = default;
+
+        /// <summary>
+        /// Construct each member from the argument with the same logical index.
+        /// </summary>
+        template <typename... Args>
+            requires (sizeof...(Args) == sizeof...(Ts) && sizeof...(Ts) > 0 && (std::is_constructible_v<Ts, Args&&> && ...))
+        constexpr explicit(!(std::is_convertible_v<Args&&, Ts> && ...)) packed_tuple(Args&&... p_args)
+            : m_storage(detail::from_getter_t{}, [&]<std::size_t Slot>(std::integral_constant<std::size_t, Slot>) -> decltype(auto)
+                {
+                    return std::get<detail::packed_order_v<Ts...>[Slot]>(std::forward_as_tuple(std::forward<Args>(p_args)...));
+                })
+        {
+        }
+
+        /// <summary>
+        /// Construct from a std::tuple (or anything else with std::get) in the same logical order.
+        /// </summary>
+        template <typename... Us>
+            requires (sizeof...(Us) == sizeof...(Ts) && (std::is_constructible_v<Ts, const Us&> && ...))
+        constexpr explicit packed_tuple(const std::tuple<Us...>& p_tuple)
+            : m_storage(detail::from_getter_t{}, [&]<std::size_t Slot>(std::integral_constant<std::size_t, Slot>) -> decltype(auto)
+                {
+                    return std::get<detail::packed_order_v<Ts...>[Slot]>(p_tuple);
+                })
+        {
+        }
+
+        template <std::size_t Idx>
+        constexpr auto& get() & noexcept
+        {
+            return m_storage.template slot<slot_of<Idx>>();
+        }
+
+        template <std::size_t Idx>
+        constexpr const auto& get() const& noexcept
+        {
+            return m_storage.template slot<slot_of<Idx>>();
+        }
+
+        template <std::size_t Idx>
+        constexpr auto&& get() && noexcept
+        {
+            return std::move(m_storage.template slot<slot_of<Idx>>());
+        }
+
+        template <std::size_t Idx>
+        constexpr const auto&& get() const&& noexcept
+        {
+            return std::move(m_storage.template slot<slot_of<Idx>>());
+        }
+
+        /// <summary>
+        /// Copy the members out into a std::tuple in their logical order.
+        /// </summary>
+        constexpr std::tuple<Ts...> to_tuple() const
+        {
+            return [this]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                return std::tuple<Ts...>(get<Is>()...);
+            }(std::index_sequence_for<Ts...>{});
+        }
+
+        friend constexpr bool operator==(const packed_tuple& p_lhs, const packed_tuple& p_rhs)
+        {
+            return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                return ((p_lhs.template get<Is>() == p_rhs.template get<Is>()) && ...);
+            }(std::index_sequence_for<Ts...>{});
+        }
+
+    private:
+        storage_type m_storage;
+    };
+
+    template <typename... Ts>
+    packed_tuple(Ts...) -> packed_tuple<Ts...>;
+}
+
+template <typename... Ts>
+struct std::tuple_size<mg::packed_tuple<Ts...>> : std::integral_constant<std::size_t, sizeof...(Ts)> {};
+
+template <std::size_t Idx, typename... Ts>
+struct std::tuple_element<Idx, mg::packed_tuple<Ts...>>
+{
+    using type = typename mg::type_sequence<Ts...>::template nth<Idx>;
+};
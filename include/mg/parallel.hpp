@@ -0,0 +1,163 @@
+#pragma once
+
+#include "detail/parallel.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// How transform_reduce accumulates the elements of each leaf of its reduction tree.
+    /// </summary>
+    enum class summation
+    {
+        /// <summary>
+        /// Into a fixed number of interleaved accumulators, which are then combined in a tree. The
+        /// accumulators are independent, so the loop vectorizes for arithmetic types, but the
+        /// elements are combined out of order, so the reduce operation must be commutative.
+        /// </summary>
+        blocked,
+
+        /// <summary>
+        /// By recursively halving the leaf, which bounds the rounding error of a floating point sum
+        /// by the logarithm of the number of elements rather than the number itself.
+        /// </summary>
+        pairwise,
+
+        /// <summary>
+        /// With the rounding error of each addition accumulated alongside the sum and added back
+        /// at the end (Kahan summation, in Neumaier's variant), which makes the error independent
+        /// of the number of elements. Floating point addition only.
+        /// </summary>
+        kahan
+    };
+
+    /// <summary>
+    /// The concurrent counterpart to tuple_map. The callable is applied to every element of the tuple
+    /// with each application submitted to the executor (apart from the first, which is run on the
+    /// calling thread), and the results are collected into a tuple with the same semantics as
+    /// tuple_map. A callable which returns void for an element produces std::monostate in its place.
+    /// </summary>
+    /// <remarks>Evaluation falls back to running every element inline, in order, when the executor is
+    /// null or the tuple has fewer than two elements, since there is nothing to gain from a hand-off.</remarks>
+    /// <remarks>Every application has finished before this returns or throws. Should any of them throw
+    /// then the exception from the lowest index is rethrown and the others are discarded, so the
+    /// outcome does not depend on scheduling.</remarks>
+    /// <remarks>The callable is shared between the concurrent applications and so must be safe to
+    /// invoke from multiple threads at once.</remarks>
+    /// <typeparam name="Fn">The type of the callable being applied.</typeparam>
+    /// <typeparam name="Tuple">The type of the tuple being mapped.</typeparam>
+    /// <param name="p_executor">The pool to run on, or null to run sequentially.</param>
+    /// <param name="p_tuple">The tuple being mapped.</param>
+    /// <param name="p_fn">The callable being applied to each tuple element.</param>
+    /// <returns>The mapped tuple.</returns>
+    template <typename Fn, typename Tuple>
+    auto parallel_tuple_map(thread_pool* p_executor, Tuple&& p_tuple, Fn&& p_fn)
+    {
+        return detail::parallel_tuple_map_impl(
+            p_executor,
+            std::forward<Tuple>(p_tuple),
+            p_fn,
+            std::make_index_sequence<std::tuple_size_v<std::remove_cvref_t<Tuple>>>{});
+    }
+
+    /// <summary>
+    /// Invoke several independent callables concurrently and collect their results into a tuple in
+    /// the order that the callables were given. The execution and exception semantics are those of
+    /// parallel_tuple_map.
+    /// </summary>
+    /// <typeparam name="...Fns">The types of the callables.</typeparam>
+    /// <param name="p_executor">The pool to run on, or null to run sequentially.</param>
+    /// <param name="...p_fns">The callables to invoke, each taking no arguments.</param>
+    /// <returns>A tuple of the results, with std::monostate for callables returning void.</returns>
+    template <typename... Fns>
+    auto when_all(thread_pool* p_executor, Fns&&... p_fns)
+    {
+        return parallel_tuple_map(
+            p_executor,
+            std::forward_as_tuple(std::forward<Fns>(p_fns)...),
+            []<typename F>(F&& p_f) -> decltype(auto) { return std::invoke(std::forward<F>(p_f)); });
+    }
+
+    /// <summary>
+    /// Transform every element of a random access range and reduce the results, in parallel on the
+    /// executor, to the same value bit for bit whatever the number of threads. Unlike
+    /// std::transform_reduce with an execution policy, the order of every operation is fixed by
+    /// the number of elements alone: the range is split into leaves of a fixed size (see
+    /// detail::reduce_leaf_size), each leaf is accumulated according to the summation mode, the
+    /// leaves are combined in a balanced binary tree, and the initial value is combined last. The
+    /// reduce operation must be associative and, for blocked summation which interleaves the
+    /// elements of a leaf, commutative; pairwise summation keeps the elements in order.
+    /// </summary>
+    /// <remarks>Results are only reproducible if the compiler is too: options which let it reorder
+    /// floating point operations, such as -ffast-math, break the guarantee.</remarks>
+    /// <remarks>Exceptions are propagated as by thread_pool::parallel_for.</remarks>
+    /// <typeparam name="Mode">How each leaf is accumulated.</typeparam>
+    /// <param name="p_executor">The pool to run on, or null to run sequentially.</param>
+    /// <param name="p_range">The range of elements.</param>
+    /// <param name="p_init">The initial value, also the result for an empty range.</param>
+    /// <param name="p_reduce">The associative operation combining two values of type T.</param>
+    /// <param name="p_transform">The operation applied to each element, whose result is converted to T.</param>
+    /// <returns>The reduction of the initial value with all of the transformed elements.</returns>
+    /// <example><code>
+    /// const auto energy = mg::transform_reduce&lt;mg::summation::kahan&gt;(
+    ///     &amp;pool, particles, 0.0, std::plus&lt;&gt;(), [](const particle&amp; p_particle) { return p_particle.kinetic_energy(); });
+    /// </code></example>
+    template <summation Mode = summation::blocked, std::ranges::random_access_range Range, typename T, typename Reduce, typename Transform>
+        requires std::ranges::sized_range<Range> && std::convertible_to<std::invoke_result_t<const Transform&, std::ranges::range_reference_t<Range>>, T>
+    T transform_reduce(thread_pool* p_executor, Range&& p_range, T p_init, Reduce p_reduce, Transform p_transform)
+    {
+        const auto size = static_cast<std::size_t>(std::ranges::size(p_range));
+        auto first = std::ranges::begin(p_range);
+        auto element = [&](std::size_t p_index) -> T
+        {
+            return std::invoke(p_transform, first[static_cast<std::ranges::range_difference_t<Range>>(p_index)]);
+        };
+
+        if constexpr (Mode == summation::kahan)
+        {
+            static_assert(std::floating_point<T>, "Kahan summation needs a floating point result type.");
+            static_assert(std::is_same_v<Reduce, std::plus<>> || std::is_same_v<Reduce, std::plus<T>>, "Kahan summation only applies to addition.");
+            return detail::transform_reduce_impl<false>(p_executor, size, std::move(p_init), detail::compensated_accumulator<T>{}, element);
+        }
+        else
+        {
+            return detail::transform_reduce_impl<Mode == summation::pairwise>(p_executor, size, std::move(p_init), detail::plain_accumulator<T, Reduce>{ p_reduce }, element);
+        }
+    }
+
+    /// <summary>
+    /// Transform every element of a tuple, concurrently on the executor through parallel_tuple_map,
+    /// and reduce the results, which may be of different types, in a balanced binary tree fixed at
+    /// compile time, with the initial value combined last.
+    /// </summary>
+    /// <param name="p_executor">The pool to run on, or null to run sequentially.</param>
+    /// <param name="p_tuple">The tuple of elements.</param>
+    /// <param name="p_init">The initial value, also the result for an empty tuple.</param>
+    /// <param name="p_reduce">The associative operation, taking any two of the transformed types.</param>
+    /// <param name="p_transform">The operation applied to each element.</param>
+    /// <returns>The reduction of the initial value with all of the transformed elements.</returns>
+    template <typename Tuple, typename T, typename Reduce, typename Transform>
+        requires (!std::ranges::range<Tuple>) && requires { std::tuple_size<std::remove_cvref_t<Tuple>>::value; }
+    auto transform_reduce(thread_pool* p_executor, Tuple&& p_tuple, T p_init, Reduce p_reduce, Transform p_transform)
+    {
+        constexpr auto size = std::tuple_size_v<std::remove_cvref_t<Tuple>>;
+        if constexpr (size == 0)
+        {
+            return p_init;
+        }
+        else
+        {
+            auto mapped = parallel_tuple_map(p_executor, std::forward<Tuple>(p_tuple), p_transform);
+            return std::invoke(p_reduce, std::move(p_init), detail::reduce_tuple_tree<0, size>(mapped, p_reduce));
+        }
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include "detail/per_thread.hpp"
+#include "detail/ring.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// A value alone on its cache line(s), so that writes to it never invalidate a neighbour's line
+    /// (false sharing). Aligned to std::hardware_destructive_interference_size where the standard
+    /// library provides it, and to 64 bytes otherwise; the size is padded to a multiple of that.
+    /// </summary>
+    /// <example><code>
+    /// std::array&lt;mg::cache_padded&lt;std::atomic&lt;std::uint64_t&gt;&gt;, 8&gt; counters;
+    /// counters[worker]-&gt;fetch_add(1, std::memory_order_relaxed);
+    /// </code></example>
+    template <typename T>
+    class alignas(detail::cache_line_size) cache_padded
+    {
+    public:
+        static constexpr std::size_t alignment = detail::cache_line_size;
+
+        cache_padded() = default;
+
+        template <typename... Args>
+        explicit cache_padded(std::in_place_t, Args&&... p_args)
+            : m_value(std::forward<Args>(p_args)...)
+        {
+        }
+
+        T& get() noexcept
+        {
+            return m_value;
+        }
+
+        const T& get() const noexcept
+        {
+            return m_value;
+        }
+
+        T& operator*() noexcept
+        {
+            return m_value;
+        }
+
+        const T& operator*() const noexcept
+        {
+            return m_value;
+        }
+
+        T* operator->() noexcept
+        {
+            return &m_value;
+        }
+
+        const T* operator->() const noexcept
+        {
+            return &m_value;
+        }
+
+    private:
+        T m_value{};
+    };
+
+    /// <summary>
+    /// A value per thread, such as a counter or accumulator which every thread updates without
+    /// contention and which is combined when read, in the style of TBB's combinable. Each thread's
+    /// slot is created the first time it calls local(), on its own cache line.
+    /// </summary>
+    /// <remarks>When a thread exits its slots are handed back, value included, and given to the
+    /// next thread to need one. Values therefore accumulate per slot rather than per thread, which
+    /// keeps the contributions of exited threads in combine() and bounds the memory used to the
+    /// peak number of threads.</remarks>
+    /// <remarks>local() is lock free after a thread's first call. Enumerating the slots (for_each,
+    /// combine) takes a lock against slots being created, but does not synchronize with threads
+    /// updating their values: read when the writers are done, or use atomic values.</remarks>
+    /// <typeparam name="T">The value type.</typeparam>
+    /// <example><code>
+    /// mg::per_thread&lt;std::uint64_t&gt; matches;
+    /// pool.parallel_for(items, 1024, [&amp;](const item&amp; p_item) { if (test(p_item)) { ++matches.local(); } });
+    /// auto total = matches.combine(std::plus&lt;&gt;());
+    /// </code></example>
+    template <typename T>
+    class per_thread
+    {
+        using slot = cache_padded<T>;
+        using control = detail::per_thread_control<T, slot>;
+
+    public:
+        /// <summary>
+        /// Create the storage with each thread's value initialized as T().
+        /// </summary>
+        per_thread() requires std::default_initializable<T>
+            : per_thread([] { return T(); })
+        {
+        }
+
+        /// <summary>
+        /// Create the storage with each thread's value initialized by calling the given function.
+        /// </summary>
+        template <typename Init>
+            requires std::invocable<Init&> && std::convertible_to<std::invoke_result_t<Init&>, T>
+        explicit per_thread(Init p_init)
+            : m_control(std::make_shared<control>(std::move(p_init))),
+            m_index(detail::per_thread_ids::instance().acquire()),
+            m_serial(detail::per_thread_ids::next_serial())
+        {
+        }
+
+        per_thread(const per_thread&) = delete;
+        per_thread& operator=(const per_thread&) = delete;
+
+        /// <summary>
+        /// Threads holding slots may outlive the storage; they hand their slots back to nothing.
+        /// </summary>
+        ~per_thread()
+        {
+            detail::per_thread_ids::instance().release(m_index);
+        }
+
+        /// <summary>
+        /// The calling thread's value, created on first use.
+        /// </summary>
+        T& local()
+        {
+            const auto* entries = detail::t_per_thread_entries;
+            if (entries != nullptr && m_index < entries->size()) [[likely]]
+            {
+                const auto& entry = (*entries)[m_index];
+                if (entry.m_serial == m_serial) [[likely]]
+                {
+                    return static_cast<slot*>(entry.m_slot)->get();
+                }
+            }
+
+            return local_slow();
+        }
+
+        /// <summary>
+        /// Call the function with every slot's value, including those last used by exited threads.
+        /// </summary>
+        template <typename Fn>
+        void for_each(Fn&& p_fn)
+        {
+            std::scoped_lock lock(m_control->m_mutex);
+            for (auto& entry : m_control->m_slots)
+            {
+                std::invoke(p_fn, entry->get());
+            }
+        }
+
+        template <typename Fn>
+        void for_each(Fn&& p_fn) const
+        {
+            std::scoped_lock lock(m_control->m_mutex);
+            for (const auto& entry : m_control->m_slots)
+            {
+                std::invoke(p_fn, std::as_const(entry->get()));
+            }
+        }
+
+        /// <summary>
+        /// Reduce every slot's value with the given binary operation, or return a newly initialized
+        /// value if no thread has used the storage.
+        /// </summary>
+        template <typename Op>
+        T combine(Op&& p_op) const
+        {
+            std::scoped_lock lock(m_control->m_mutex);
+            if (m_control->m_slots.empty())
+            {
+                return m_control->m_init();
+            }
+
+            T result = m_control->m_slots.front()->get();
+            for (std::size_t i = 1; i < m_control->m_slots.size(); ++i)
+            {
+                result = std::invoke(p_op, std::move(result), std::as_const(m_control->m_slots[i]->get()));
+            }
+
+            return result;
+        }
+
+        /// <summary>
+        /// The number of slots created, which is the peak number of threads to have used the
+        /// storage at once.
+        /// </summary>
+        std::size_t size() const
+        {
+            std::scoped_lock lock(m_control->m_mutex);
+            return m_control->m_slots.size();
+        }
+
+    private:
+        T& local_slow()
+        {
+            auto* entry = detail::thread_entry(m_index);
+            auto* acquired = m_control->acquire();
+            if (entry == nullptr)
+            {
+                // The thread is exiting and has already handed back its slots, so this one is kept.
+                return acquired->get();
+            }
+
+            if (entry->m_release != nullptr)
+            {
+                // A slot of an earlier, destroyed instance which had the same index.
+                entry->m_release(entry->m_control.get(), entry->m_slot);
+            }
+
+            entry->m_serial = m_serial;
+            entry->m_slot = acquired;
+            entry->m_control = m_control;
+            entry->m_release = [](void* p_control, void* p_slot) { static_cast<control*>(p_control)->release(static_cast<slot*>(p_slot)); };
+            return acquired->get();
+        }
+
+        std::shared_ptr<control> m_control;
+        std::size_t m_index;
+        std::uint64_t m_serial;
+    };
+}
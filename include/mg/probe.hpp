@@ -0,0 +1,239 @@
+#pragma once
+
+#include "detail/probe.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// Set to 1 (for example with the MG_ENABLE_PROBES CMake option) to compile the MG_PROBE_ macros in.
+/// When 0 they expand to nothing and their arguments are not evaluated. The probe types themselves
+/// are always available for explicit use.
+/// </summary>
+#ifndef MG_ENABLE_PROBES
+#define MG_ENABLE_PROBES 0
+#endif
+
+namespace mg::probe
+{
+    /// <summary>
+    /// Whether the MG_PROBE_ macros are compiled in.
+    /// </summary>
+    inline constexpr bool enabled = MG_ENABLE_PROBES != 0;
+
+    /// <summary>
+    /// A named, monotonically increasing count. Each thread adds to its own slot; the total is only
+    /// computed when read.
+    /// </summary>
+    /// <remarks>Constructing a probe registers its name (taking a lock), so probes are meant to be
+    /// long lived, typically function local statics as created by the macros. Probes with the same
+    /// name share their values.</remarks>
+    class counter
+    {
+    public:
+        explicit counter(std::string_view p_name)
+            : m_slot(detail::probe_registry::instance().register_probe(p_name, kind::counter))
+        {
+        }
+
+        void add(std::uint64_t p_amount = 1) const
+        {
+            detail::probe_block().add(m_slot, p_amount);
+        }
+
+    private:
+        std::size_t m_slot;
+    };
+
+    /// <summary>
+    /// A named signed level, such as the number of items in flight, read as the sum of every thread's
+    /// contribution. Threads may add and subtract independently (an increment on one thread and the
+    /// matching decrement on another cancel out).
+    /// </summary>
+    class gauge
+    {
+    public:
+        explicit gauge(std::string_view p_name)
+            : m_slot(detail::probe_registry::instance().register_probe(p_name, kind::gauge))
+        {
+        }
+
+        void add(std::int64_t p_delta) const
+        {
+            detail::probe_block().add(m_slot, static_cast<std::uint64_t>(p_delta));
+        }
+
+    private:
+        std::size_t m_slot;
+    };
+
+    /// <summary>
+    /// A named duration statistic, recording the number of samples, their total, and the maximum.
+    /// Durations are recorded in raw ticks and only converted to time when read.
+    /// </summary>
+    class timer
+    {
+    public:
+        explicit timer(std::string_view p_name)
+            : m_slot(detail::probe_registry::instance().register_probe(p_name, kind::timer))
+        {
+        }
+
+        void record(std::uint64_t p_ticks) const
+        {
+            auto& block = detail::probe_block();
+            block.add(m_slot, 1);
+            block.add(m_slot + 1, p_ticks);
+            block.raise_to(m_slot + 2, p_ticks);
+        }
+
+        static std::uint64_t now() noexcept
+        {
+            return detail::probe_ticks();
+        }
+
+    private:
+        std::size_t m_slot;
+    };
+
+    /// <summary>
+    /// Records the lifetime of the enclosing scope into a timer.
+    /// </summary>
+    class scoped_timer
+    {
+    public:
+        explicit scoped_timer(const timer& p_timer) noexcept
+            : m_timer(p_timer),
+            m_start(timer::now())
+        {
+        }
+
+        scoped_timer(const scoped_timer&) = delete;
+        scoped_timer& operator=(const scoped_timer&) = delete;
+
+        ~scoped_timer()
+        {
+            m_timer.record(timer::now() - m_start);
+        }
+
+    private:
+        const timer& m_timer;
+        std::uint64_t m_start;
+    };
+
+    /// <summary>
+    /// The aggregated values of a probe.
+    /// </summary>
+    struct reading
+    {
+        std::string name;
+        probe::kind kind;
+
+        /// <summary>
+        /// The total of a counter, the level of a gauge, or the number of samples of a timer.
+        /// </summary>
+        std::int64_t value = 0;
+
+        /// <summary>
+        /// Timers only: the total and maximum durations.
+        /// </summary>
+        double total_ns = 0;
+        double max_ns = 0;
+    };
+
+    /// <summary>
+    /// Aggregate every probe over all threads, including threads which have exited.
+    /// </summary>
+    inline std::vector<reading> snapshot()
+    {
+        auto& registry = detail::probe_registry::instance();
+        const auto nanosecondsPerTick = registry.nanoseconds_per_tick();
+
+        std::vector<reading> result;
+        registry.visit([&](const detail::probe_descriptor& p_descriptor, const detail::probe_thread_block& p_total)
+            {
+                const auto slot = [&](std::size_t p_offset) { return p_total.m_slots[p_descriptor.m_slot + p_offset].load(std::memory_order_relaxed); };
+
+                reading entry{ p_descriptor.m_name, p_descriptor.m_kind, static_cast<std::int64_t>(slot(0)) };
+                if (p_descriptor.m_kind == kind::timer)
+                {
+                    entry.total_ns = static_cast<double>(slot(1)) * nanosecondsPerTick;
+                    entry.max_ns = static_cast<double>(slot(2)) * nanosecondsPerTick;
+                }
+
+                result.push_back(std::move(entry));
+            });
+
+        return result;
+    }
+
+    /// <summary>
+    /// Aggregate a single probe by name.
+    /// </summary>
+    inline std::optional<reading> read(std::string_view p_name)
+    {
+        for (auto& entry : snapshot())
+        {
+            if (entry.name == p_name)
+            {
+                return std::move(entry);
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /// <summary>
+    /// Zero every probe. Values recorded concurrently with a reset may be partially lost.
+    /// </summary>
+    inline void reset() noexcept
+    {
+        detail::probe_registry::instance().reset();
+    }
+}
+
+#define MG_PROBE_CONCAT_IMPL(a, b) a##b
+#define MG_PROBE_CONCAT(a, b) MG_PROBE_CONCAT_IMPL(a, b)
+
+#if MG_ENABLE_PROBES
+
+/// <summary>
+/// Add to the named counter.
+/// </summary>
+#define MG_PROBE_COUNT(name, amount)                                    \
+    do                                                                  \
+    {                                                                   \
+        static const ::mg::probe::counter mg_probe_counter{ name };     \
+        mg_probe_counter.add(amount);                                   \
+    } while (false)
+
+/// <summary>
+/// Add a (possibly negative) delta to the named gauge.
+/// </summary>
+#define MG_PROBE_GAUGE(name, delta)                                     \
+    do                                                                  \
+    {                                                                   \
+        static const ::mg::probe::gauge mg_probe_gauge{ name };         \
+        mg_probe_gauge.add(delta);                                      \
+    } while (false)
+
+/// <summary>
+/// Time the rest of the enclosing scope into the named timer.
+/// </summary>
+#define MG_PROBE_SCOPE(name)                                                                                \
+    static const ::mg::probe::timer MG_PROBE_CONCAT(mg_probe_timer_, __LINE__){ name };                     \
+    const ::mg::probe::scoped_timer MG_PROBE_CONCAT(mg_probe_scope_, __LINE__){ MG_PROBE_CONCAT(mg_probe_timer_, __LINE__) }
+
+#else
+
+#define MG_PROBE_COUNT(name, amount) ((void)0)
+#define MG_PROBE_GAUGE(name, delta) ((void)0)
+#define MG_PROBE_SCOPE(name) static_assert(true)
+
+#endif
@@ -0,0 +1,610 @@
+#pragma once
+
+#include "detail/ring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// Wait strategy which busy waits with a pause instruction and never gives up the processor.
+    /// Lowest latency, but a waiting thread consumes a whole core.
+    /// </summary>
+    struct busy_wait
+    {
+        static constexpr std::size_t spin_count = 0;
+        static constexpr std::size_t yield_count = 0;
+        static constexpr bool blocks = false;
+    };
+
+    /// <summary>
+    /// Wait strategy which spins briefly and then yields to the scheduler between attempts.
+    /// </summary>
+    struct yield_wait
+    {
+        static constexpr std::size_t spin_count = 64;
+        static constexpr std::size_t yield_count = 1;
+        static constexpr bool blocks = false;
+    };
+
+    /// <summary>
+    /// Wait strategy which spins, then yields, and finally sleeps on an atomic wait (a futex on
+    /// Linux) until the other side of the ring makes progress. Sleeping requires every operation to
+    /// check for sleepers, which costs a fence per operation even when nobody is waiting.
+    /// </summary>
+    struct blocking_wait
+    {
+        static constexpr std::size_t spin_count = 64;
+        static constexpr std::size_t yield_count = 16;
+        static constexpr bool blocks = true;
+    };
+
+    /// <summary>
+    /// A bounded, lock-free, single producer single consumer FIFO queue. Exactly one thread may
+    /// push and exactly one (other) thread may pop at a time. The producer and consumer indices are
+    /// kept on separate cache lines along with a cached copy of the opposite index, so in the steady
+    /// state each side only touches the other's cache line when it appears to be full or empty.
+    /// </summary>
+    /// <remarks>The capacity is a power of two. It is either fixed at compile time, in which case
+    /// the slots are held inline in the ring, or given to the constructor (and rounded up) when
+    /// Capacity is std::dynamic_extent.</remarks>
+    /// <remarks>The try_ operations never wait. The blocking push and pop wait using the strategy
+    /// given by Wait; see busy_wait, yield_wait, and blocking_wait.</remarks>
+    /// <typeparam name="T">The element type.</typeparam>
+    /// <typeparam name="Capacity">The number of elements, or std::dynamic_extent to choose at runtime.</typeparam>
+    /// <typeparam name="Wait">The wait strategy for the blocking operations.</typeparam>
+    template <typename T, std::size_t Capacity = std::dynamic_extent, typename Wait = blocking_wait>
+    class spsc_ring
+    {
+    public:
+        using value_type = T;
+
+        spsc_ring() requires (Capacity != std::dynamic_extent) = default;
+
+        /// <summary>
+        /// Create a ring holding at least the given number of elements.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">Thrown if the capacity is zero.</exception>
+        explicit spsc_ring(std::size_t p_capacity) requires (Capacity == std::dynamic_extent)
+            : m_slots(p_capacity)
+        {
+        }
+
+        spsc_ring(const spsc_ring&) = delete;
+        spsc_ring& operator=(const spsc_ring&) = delete;
+
+        ~spsc_ring()
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            for (auto head = m_head.load(std::memory_order_relaxed); head != tail; ++head)
+            {
+                std::destroy_at(m_slots[head].get());
+            }
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return m_slots.capacity();
+        }
+
+        /// <summary>
+        /// The number of elements in the ring, which may already be out of date when it is returned
+        /// if the other side is active.
+        /// </summary>
+        std::size_t size_approx() const noexcept
+        {
+            const auto head = m_head.load(std::memory_order_acquire);
+            const auto tail = m_tail.load(std::memory_order_acquire);
+            return std::min(tail - head, capacity());
+        }
+
+        /// <summary>
+        /// Construct an element at the back of the ring if there is space. Producer only. Should the
+        /// constructor throw, the ring is unchanged.
+        /// </summary>
+        /// <returns>Whether the element was added.</returns>
+        template <typename... Args>
+        bool try_emplace(Args&&... p_args)
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            if (free_slots(tail) == 0)
+            {
+                return false;
+            }
+
+            ::new (static_cast<void*>(m_slots[tail].m_storage)) T(std::forward<Args>(p_args)...);
+            publish_tail(tail + 1);
+            return true;
+        }
+
+        bool try_push(const T& p_value)
+        {
+            return try_emplace(p_value);
+        }
+
+        /// <summary>
+        /// Move an element to the back of the ring if there is space. The value is only moved from
+        /// when this succeeds. Producer only.
+        /// </summary>
+        bool try_push(T&& p_value)
+        {
+            return try_emplace(std::move(p_value));
+        }
+
+        /// <summary>
+        /// Move as many of the given elements into the ring as there is space for, publishing them to
+        /// the consumer all at once. Producer only.
+        /// </summary>
+        /// <remarks>Should constructing an element throw, the elements before it are still added.</remarks>
+        /// <param name="p_first">The first element to move from.</param>
+        /// <param name="p_count">The number of elements available.</param>
+        /// <returns>The number of elements added, which were the first ones of the input.</returns>
+        template <std::input_iterator It>
+        std::size_t try_push_n(It p_first, std::size_t p_count)
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            const auto count = std::min(p_count, free_slots(tail, p_count));
+
+            std::size_t added = 0;
+            try
+            {
+                for (; added < count; ++added, ++p_first)
+                {
+                    ::new (static_cast<void*>(m_slots[tail + added].m_storage)) T(std::ranges::iter_move(p_first));
+                }
+            }
+            catch (...)
+            {
+                if (added != 0)
+                {
+                    publish_tail(tail + added);
+                }
+
+                throw;
+            }
+
+            if (count != 0)
+            {
+                publish_tail(tail + count);
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Remove the element at the front of the ring if there is one. Consumer only.
+        /// </summary>
+        std::optional<T> try_pop()
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            if (used_slots(head) == 0)
+            {
+                return std::nullopt;
+            }
+
+            auto* element = m_slots[head].get();
+            std::optional<T> result(std::move(*element));
+            std::destroy_at(element);
+            publish_head(head + 1);
+            return result;
+        }
+
+        /// <summary>
+        /// Move up to the given number of elements from the front of the ring to the output, freeing
+        /// their space for the producer all at once. Consumer only.
+        /// </summary>
+        /// <remarks>Should writing an element throw, that element and those after it stay in the ring.</remarks>
+        /// <returns>The number of elements removed.</returns>
+        template <typename Out>
+        std::size_t try_pop_n(Out p_out, std::size_t p_max)
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            const auto count = std::min(p_max, used_slots(head, p_max));
+
+            std::size_t removed = 0;
+            try
+            {
+                for (; removed < count; ++removed, ++p_out)
+                {
+                    auto* element = m_slots[head + removed].get();
+                    *p_out = std::move(*element);
+                    std::destroy_at(element);
+                }
+            }
+            catch (...)
+            {
+                if (removed != 0)
+                {
+                    publish_head(head + removed);
+                }
+
+                throw;
+            }
+
+            if (count != 0)
+            {
+                publish_head(head + count);
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Add an element, waiting for space if the ring is full. Producer only.
+        /// </summary>
+        void push(const T& p_value)
+        {
+            m_waiter.wait_until([&] { return try_emplace(p_value); });
+        }
+
+        void push(T&& p_value)
+        {
+            m_waiter.wait_until([&] { return try_emplace(std::move(p_value)); });
+        }
+
+        /// <summary>
+        /// Remove the element at the front, waiting for one if the ring is empty. Consumer only.
+        /// </summary>
+        T pop()
+        {
+            std::optional<T> result;
+            m_waiter.wait_until([&] { return (result = try_pop()).has_value(); });
+            return std::move(*result);
+        }
+
+    private:
+        /// <summary>
+        /// The free space seen by the producer, only reloading the consumer's index when the cached
+        /// copy does not show enough.
+        /// </summary>
+        std::size_t free_slots(std::size_t p_tail, std::size_t p_wanted = 1) noexcept
+        {
+            if (capacity() - (p_tail - m_cachedHead) < p_wanted)
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+            }
+
+            return capacity() - (p_tail - m_cachedHead);
+        }
+
+        std::size_t used_slots(std::size_t p_head, std::size_t p_wanted = 1) noexcept
+        {
+            if (m_cachedTail - p_head < p_wanted)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+            }
+
+            return m_cachedTail - p_head;
+        }
+
+        void publish_tail(std::size_t p_tail) noexcept
+        {
+            m_tail.store(p_tail, std::memory_order_release);
+            m_waiter.notify();
+        }
+
+        void publish_head(std::size_t p_head) noexcept
+        {
+            m_head.store(p_head, std::memory_order_release);
+            m_waiter.notify();
+        }
+
+        // Producer cache line.
+        alignas(detail::cache_line_size) std::atomic<std::size_t> m_tail{ 0 };
+        std::size_t m_cachedHead = 0;
+
+        // Consumer cache line.
+        alignas(detail::cache_line_size) std::atomic<std::size_t> m_head{ 0 };
+        std::size_t m_cachedTail = 0;
+
+        detail::ring_waiter<Wait> m_waiter;
+        alignas(detail::cache_line_size) detail::ring_storage<detail::ring_slot<T>, Capacity> m_slots;
+    };
+
+    /// <summary>
+    /// A bounded, lock-free, multiple producer multiple consumer FIFO queue, following Dmitry Vyukov's
+    /// design where every slot carries a sequence number saying which lap of the ring it is ready
+    /// for. Producers and consumers each contend on a single index (on separate cache lines) and
+    /// otherwise only touch the slots they claimed. The bulk operations claim a run of consecutive
+    /// slots with a single compare and swap.
+    /// </summary>
+    /// <remarks>A claimed slot cannot be given back, so elements are constructed into the ring only
+    /// by non-throwing operations. T must be nothrow move constructible; pushing a copy makes the copy
+    /// before claiming a slot.</remarks>
+    /// <remarks>The capacity and wait strategy behave as for spsc_ring.</remarks>
+    /// <typeparam name="T">The element type.</typeparam>
+    /// <typeparam name="Capacity">The number of elements, or std::dynamic_extent to choose at runtime.</typeparam>
+    /// <typeparam name="Wait">The wait strategy for the blocking operations.</typeparam>
+    template <typename T, std::size_t Capacity = std::dynamic_extent, typename Wait = blocking_wait>
+    class mpmc_ring
+    {
+    public:
+        static_assert(std::is_nothrow_move_constructible_v<T>, "The elements of an mpmc_ring must be nothrow move constructible.");
+
+        using value_type = T;
+
+        mpmc_ring() requires (Capacity != std::dynamic_extent)
+        {
+            initialize_sequences();
+        }
+
+        /// <summary>
+        /// Create a ring holding at least the given number of elements.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">Thrown if the capacity is zero.</exception>
+        explicit mpmc_ring(std::size_t p_capacity) requires (Capacity == std::dynamic_extent)
+            : m_slots(p_capacity)
+        {
+            initialize_sequences();
+        }
+
+        mpmc_ring(const mpmc_ring&) = delete;
+        mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+        ~mpmc_ring()
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            for (auto head = m_head.load(std::memory_order_relaxed); head != tail; ++head)
+            {
+                std::destroy_at(m_slots[head].get());
+            }
+        }
+
+        std::size_t capacity() const noexcept
+        {
+            return m_slots.capacity();
+        }
+
+        /// <summary>
+        /// The number of elements in the ring (including those still being written or read), which
+        /// may already be out of date when it is returned.
+        /// </summary>
+        std::size_t size_approx() const noexcept
+        {
+            const auto head = m_head.load(std::memory_order_acquire);
+            const auto tail = m_tail.load(std::memory_order_acquire);
+            return std::min(tail - head, capacity());
+        }
+
+        /// <summary>
+        /// Construct an element at the back of the ring if there is space.
+        /// </summary>
+        /// <returns>Whether the element was added.</returns>
+        template <typename... Args>
+            requires std::is_nothrow_constructible_v<T, Args&&...>
+        bool try_emplace(Args&&... p_args) noexcept
+        {
+            std::size_t position;
+            if (claim(m_tail, 0, 1, position) == 0)
+            {
+                return false;
+            }
+
+            publish_element(position, std::forward<Args>(p_args)...);
+            m_waiter.notify();
+            return true;
+        }
+
+        bool try_push(const T& p_value)
+        {
+            if constexpr (std::is_nothrow_copy_constructible_v<T>)
+            {
+                return try_emplace(p_value);
+            }
+            else
+            {
+                return try_emplace(T(p_value));
+            }
+        }
+
+        /// <summary>
+        /// Move an element to the back of the ring if there is space. The value is only moved from
+        /// when this succeeds.
+        /// </summary>
+        bool try_push(T&& p_value) noexcept
+        {
+            return try_emplace(std::move(p_value));
+        }
+
+        /// <summary>
+        /// Move as many of the given elements into the ring as there is space for, claiming all of
+        /// their slots at once.
+        /// </summary>
+        /// <remarks>Neither the iterator nor the element construction may throw.</remarks>
+        /// <param name="p_first">The first element to move from.</param>
+        /// <param name="p_count">The number of elements available.</param>
+        /// <returns>The number of elements added, which were the first ones of the input.</returns>
+        template <std::input_iterator It>
+            requires std::is_nothrow_constructible_v<T, std::iter_rvalue_reference_t<It>>
+        std::size_t try_push_n(It p_first, std::size_t p_count) noexcept
+        {
+            std::size_t position;
+            const auto count = claim(m_tail, 0, p_count, position);
+            for (std::size_t i = 0; i < count; ++i, ++p_first)
+            {
+                publish_element(position + i, std::ranges::iter_move(p_first));
+            }
+
+            if (count != 0)
+            {
+                m_waiter.notify();
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Remove the element at the front of the ring if there is one.
+        /// </summary>
+        std::optional<T> try_pop() noexcept
+        {
+            std::size_t position;
+            if (claim(m_head, 1, 1, position) == 0)
+            {
+                return std::nullopt;
+            }
+
+            std::optional<T> result(take_element(position));
+            m_waiter.notify();
+            return result;
+        }
+
+        /// <summary>
+        /// Move up to the given number of elements from the front of the ring to the output, claiming
+        /// all of them at once.
+        /// </summary>
+        /// <remarks>Claimed elements cannot be returned to the ring, so should writing one to the
+        /// output throw then it and the rest of the batch are discarded before the exception escapes.</remarks>
+        /// <returns>The number of elements removed.</returns>
+        template <typename Out>
+        std::size_t try_pop_n(Out p_out, std::size_t p_max)
+        {
+            std::size_t position;
+            const auto count = claim(m_head, 1, p_max, position);
+
+            std::size_t removed = 0;
+            try
+            {
+                for (; removed < count; ++removed, ++p_out)
+                {
+                    *p_out = take_element(position + removed);
+                }
+            }
+            catch (...)
+            {
+                // The element being written was already released by take_element.
+                for (++removed; removed < count; ++removed)
+                {
+                    take_element(position + removed);
+                }
+
+                m_waiter.notify();
+                throw;
+            }
+
+            if (count != 0)
+            {
+                m_waiter.notify();
+            }
+
+            return count;
+        }
+
+        /// <summary>
+        /// Add an element, waiting for space if the ring is full.
+        /// </summary>
+        void push(const T& p_value)
+        {
+            push(T(p_value));
+        }
+
+        void push(T&& p_value)
+        {
+            m_waiter.wait_until([&] { return try_push(std::move(p_value)); });
+        }
+
+        /// <summary>
+        /// Remove the element at the front, waiting for one if the ring is empty.
+        /// </summary>
+        T pop()
+        {
+            std::optional<T> result;
+            m_waiter.wait_until([&] { return (result = try_pop()).has_value(); });
+            return std::move(*result);
+        }
+
+    private:
+        using slot_type = detail::sequenced_ring_slot<T>;
+
+        void initialize_sequences() noexcept
+        {
+            for (std::size_t i = 0; i < capacity(); ++i)
+            {
+                m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        /// <summary>
+        /// Claim a run of up to the given number of consecutive slots from an index. A slot at a
+        /// position is ready for producers when its sequence equals the position, and ready for
+        /// consumers when it equals the position plus one.
+        /// </summary>
+        /// <param name="p_index">The index being advanced (the tail for producers, the head for consumers).</param>
+        /// <param name="p_offset">The difference between the position and the sequence of a ready slot.</param>
+        /// <param name="p_max">The largest run to claim.</param>
+        /// <param name="p_position">Receives the first claimed position.</param>
+        /// <returns>The number of slots claimed, zero if the ring is full (or empty).</returns>
+        std::size_t claim(std::atomic<std::size_t>& p_index, std::size_t p_offset, std::size_t p_max, std::size_t& p_position) noexcept
+        {
+            if (p_max == 0)
+            {
+                return 0;
+            }
+
+            auto position = p_index.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                const auto sequence = m_slots[position].m_sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::intptr_t>(sequence - (position + p_offset));
+                if (difference < 0)
+                {
+                    return 0;
+                }
+
+                if (difference > 0)
+                {
+                    // Another thread claimed this position since the index was read.
+                    position = p_index.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                std::size_t run = 1;
+                const auto limit = std::min(p_max, capacity());
+                while (run < limit
+                    && m_slots[position + run].m_sequence.load(std::memory_order_acquire) == position + run + p_offset)
+                {
+                    ++run;
+                }
+
+                if (p_index.compare_exchange_weak(position, position + run, std::memory_order_relaxed))
+                {
+                    p_position = position;
+                    return run;
+                }
+            }
+        }
+
+        template <typename... Args>
+        void publish_element(std::size_t p_position, Args&&... p_args) noexcept
+        {
+            auto& slot = m_slots[p_position];
+            ::new (static_cast<void*>(slot.m_storage)) T(std::forward<Args>(p_args)...);
+            slot.m_sequence.store(p_position + 1, std::memory_order_release);
+        }
+
+        T take_element(std::size_t p_position) noexcept
+        {
+            auto& slot = m_slots[p_position];
+            auto* element = slot.get();
+            T result(std::move(*element));
+            std::destroy_at(element);
+            slot.m_sequence.store(p_position + capacity(), std::memory_order_release);
+            return result;
+        }
+
+        alignas(detail::cache_line_size) std::atomic<std::size_t> m_tail{ 0 };
+        alignas(detail::cache_line_size) std::atomic<std::size_t> m_head{ 0 };
+        detail::ring_waiter<Wait> m_waiter;
+        alignas(detail::cache_line_size) detail::ring_storage<slot_type, Capacity> m_slots;
+    };
+}
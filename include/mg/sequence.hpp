@@ -2,7 +2,10 @@
 
 #include "detail/sequence.hpp"
 
+#include <cstddef>
 #include <cstdlib>
+#include <tuple>
+#include <type_traits>
 
 namespace mg
 {
@@ -22,6 +25,21 @@ namespace mg
         template <std::size_t Idx>
         using nth = std::tuple_element_t<Idx, as_tuple>;
 
+        /// <summary>
+        /// The number of times a type occurs in the sequence.
+        /// </summary>
+        template <typename T>
+        static constexpr std::size_t count = (std::size_t(std::is_same_v<T, Ts>) + ... + 0);
+
+        template <typename T>
+        static constexpr bool contains = count<T> != 0;
+
+        /// <summary>
+        /// The position of the first occurrence of a type in the sequence, or size if it does not
+        /// occur: the inverse of nth.
+        /// </summary>
+        template <typename T>
+        static constexpr std::size_t index_of = detail::type_index_of<T, Ts...>();
     };
 
     template <typename... T1, typename... T2>
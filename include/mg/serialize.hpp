@@ -0,0 +1,225 @@
+#pragma once
+
+#include "detail/serialize.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace mg
+{
+    /// <summary>
+    /// How integers (including enums) wider than a byte are encoded.
+    /// </summary>
+    enum class integer_encoding
+    {
+        /// <summary>In their full width.</summary>
+        fixed,
+        /// <summary>As LEB128 varints, zigzag encoded when signed, so that small values take a byte.</summary>
+        varint
+    };
+
+    /// <summary>
+    /// A wire format for mg::serialize: the byte order of fixed width scalars, and the encoding of
+    /// integers. The default, little endian with fixed width integers, is the native format of almost
+    /// every machine, so raw values and arrays are copied with a single memcpy.
+    /// </summary>
+    /// <typeparam name="Order">The byte order of fixed width scalars.</typeparam>
+    /// <typeparam name="Integers">The encoding of integers.</typeparam>
+    template <std::endian Order = std::endian::little, integer_encoding Integers = integer_encoding::fixed>
+    struct wire_format
+    {
+        static constexpr std::endian order = Order;
+        static constexpr integer_encoding integers = Integers;
+        static constexpr bool varint = Integers == integer_encoding::varint;
+    };
+
+    /// <summary>
+    /// Little endian, with integers as varints, for compact messages of mostly small integers.
+    /// </summary>
+    using varint_format = wire_format<std::endian::little, integer_encoding::varint>;
+
+    /// <summary>
+    /// A type mg::serialize can encode: an arithmetic type or enum (of 1, 2, 4 or 8 bytes), a
+    /// tuple-like type (std::tuple, std::pair, std::array, mg::packed_tuple) of serializable
+    /// elements, a std::vector, std::basic_string or std::span of serializable elements, or any other
+    /// trivially copyable class, which is written as its object representation.
+    /// </summary>
+    template <typename T>
+    concept serializable = detail::is_wire_serializable<std::remove_cv_t<T>>();
+
+    /// <summary>
+    /// A bound on the number of bytes which serializing the value will take; it is exact unless the
+    /// value contains arrays which need alignment padding.
+    /// </summary>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_value">The value to be serialized.</param>
+    template <typename Format = wire_format<>, serializable T>
+    std::size_t max_serialized_size(const T& p_value)
+    {
+        return detail::wire_codec<Format>::max_size(p_value);
+    }
+
+    /// <summary>
+    /// Encode a value into a buffer, such as a mapped file or shared memory.
+    /// </summary>
+    /// <remarks>Scalars are written in the format's byte order (or as varints). Tuple-like types are
+    /// written as their elements in order, and sequences as a varint count followed by their
+    /// elements. A value whose object representation is already its encoding, such as an array of
+    /// integers or a tuple of trivially copyable members without padding in native byte order, is
+    /// copied with a single memcpy, and so are contiguous sequences of them.</remarks>
+    /// <remarks>Arrays of fixed width elements are preceded by padding which aligns them relative to
+    /// the start of the buffer, so the encoding does not depend on where the buffer lies in memory.
+    /// view_array and view_columns can read them in place when the buffer read from starts at an
+    /// address aligned for the elements, as the start of a mapping or (for elements not over-aligned)
+    /// of a heap allocation is.</remarks>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_value">The value to serialize.</param>
+    /// <param name="p_out">The buffer to write into, from its start.</param>
+    /// <returns>The number of bytes written.</returns>
+    /// <exception cref="std::length_error">The buffer is too small.</exception>
+    /// <example><code>
+    /// using record = std::tuple&lt;std::uint32_t, double, std::array&lt;char, 8&gt;&gt;;
+    /// std::vector&lt;std::byte&gt; buffer;
+    /// mg::serialize(std::vector&lt;record&gt;{ { 1, 2.5, { "name" } } }, buffer);
+    ///
+    /// std::span&lt;const std::byte&gt; in(buffer);
+    /// const auto records = mg::deserialize&lt;std::vector&lt;record&gt;&gt;(in);
+    /// </code></example>
+    template <typename Format = wire_format<>, serializable T>
+    std::size_t serialize(const T& p_value, std::span<std::byte> p_out)
+    {
+        detail::wire_writer writer(p_out.data(), p_out.data(), p_out.data() + p_out.size());
+        detail::wire_codec<Format>::write(p_value, writer);
+        return static_cast<std::size_t>(writer.cursor() - p_out.data());
+    }
+
+    /// <summary>
+    /// Encode a value onto the end of a byte vector. See serialize(value, span); the padding is
+    /// relative to the start of the vector, so stays correct as the vector reallocates.
+    /// </summary>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_value">The value to serialize.</param>
+    /// <param name="p_out">The vector to append to.</param>
+    template <typename Format = wire_format<>, serializable T>
+    void serialize(const T& p_value, std::vector<std::byte>& p_out)
+    {
+        const auto start = p_out.size();
+        p_out.resize(start + max_serialized_size<Format>(p_value));
+        detail::wire_writer writer(p_out.data(), p_out.data() + start, p_out.data() + p_out.size());
+        detail::wire_codec<Format>::write(p_value, writer);
+        p_out.resize(static_cast<std::size_t>(writer.cursor() - p_out.data()));
+    }
+
+    /// <summary>
+    /// Decode a value from the front of a buffer, advancing the buffer past it.
+    /// </summary>
+    /// <remarks>Tuple-like types must be default constructible; their elements are assigned in order.
+    /// A raw value (see serialize) is copied out with a single memcpy.</remarks>
+    /// <typeparam name="T">The type to decode, which must have been serialized with the same format.</typeparam>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_in">The buffer to read from, which is advanced past the value.</param>
+    /// <returns>The decoded value.</returns>
+    /// <exception cref="std::invalid_argument">The buffer is truncated or malformed.</exception>
+    template <serializable T, typename Format = wire_format<>>
+    T deserialize(std::span<const std::byte>& p_in)
+    {
+        detail::wire_reader reader(p_in);
+        return detail::wire_codec<Format>::template read<std::remove_cv_t<T>>(reader);
+    }
+
+    /// <summary>
+    /// View a serialized sequence (a std::vector, std::basic_string or std::span) in place, without
+    /// copying, advancing the buffer past it. The elements must be raw in the format: scalars in
+    /// native byte order (and not varints) or trivially copyable classes.
+    /// </summary>
+    /// <typeparam name="T">The element type of the serialized sequence.</typeparam>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_in">The buffer to read from, which is advanced past the sequence.</param>
+    /// <returns>A span over the elements, within the buffer.</returns>
+    /// <exception cref="std::invalid_argument">The buffer is truncated or malformed, or the elements
+    /// are not suitably aligned in memory.</exception>
+    template <serializable T, typename Format = wire_format<>>
+    std::span<const T> view_array(std::span<const std::byte>& p_in)
+    {
+        detail::wire_reader reader(p_in);
+        const auto count = detail::wire_codec<Format>::read_count(reader, sizeof(T));
+        return detail::wire_codec<Format>::template view_array<T>(count, reader);
+    }
+
+    /// <summary>
+    /// Encode a batch of tuples column-wise: the row count, then for each element index the column of
+    /// that element from every row. Columns of fixed width elements are aligned and written with
+    /// fixed size copies, and can be read back in place with view_columns.
+    /// </summary>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_rows">A contiguous range of tuple-like rows, such as a std::span.</param>
+    /// <param name="p_out">The buffer to write into, from its start.</param>
+    /// <returns>The number of bytes written.</returns>
+    /// <exception cref="std::length_error">The buffer is too small.</exception>
+    template <typename Format = wire_format<>, std::ranges::contiguous_range Rows>
+        requires detail::wire_tuple<std::ranges::range_value_t<Rows>> && serializable<std::ranges::range_value_t<Rows>>
+    std::size_t serialize_columns(const Rows& p_rows, std::span<std::byte> p_out)
+    {
+        detail::wire_writer writer(p_out.data(), p_out.data(), p_out.data() + p_out.size());
+        detail::wire_codec<Format>::write_columns(std::span<const std::ranges::range_value_t<Rows>>(p_rows), writer);
+        return static_cast<std::size_t>(writer.cursor() - p_out.data());
+    }
+
+    /// <summary>
+    /// Encode a batch of tuples column-wise onto the end of a byte vector. See
+    /// serialize_columns(rows, span).
+    /// </summary>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_rows">A contiguous range of tuple-like rows, such as a std::span.</param>
+    /// <param name="p_out">The vector to append to.</param>
+    template <typename Format = wire_format<>, std::ranges::contiguous_range Rows>
+        requires detail::wire_tuple<std::ranges::range_value_t<Rows>> && serializable<std::ranges::range_value_t<Rows>>
+    void serialize_columns(const Rows& p_rows, std::vector<std::byte>& p_out)
+    {
+        const std::span<const std::ranges::range_value_t<Rows>> rows(p_rows);
+        const auto start = p_out.size();
+        p_out.resize(start + detail::wire_codec<Format>::max_columns_size(rows));
+        detail::wire_writer writer(p_out.data(), p_out.data() + start, p_out.data() + p_out.size());
+        detail::wire_codec<Format>::write_columns(rows, writer);
+        p_out.resize(static_cast<std::size_t>(writer.cursor() - p_out.data()));
+    }
+
+    /// <summary>
+    /// Decode a batch of tuples written by serialize_columns back into rows.
+    /// </summary>
+    /// <typeparam name="Tuple">The (default constructible) tuple-like row type.</typeparam>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_in">The buffer to read from, which is advanced past the batch.</param>
+    /// <returns>The rows.</returns>
+    /// <exception cref="std::invalid_argument">The buffer is truncated or malformed.</exception>
+    template <typename Tuple, typename Format = wire_format<>>
+        requires detail::wire_tuple<Tuple> && serializable<Tuple>
+    std::vector<Tuple> deserialize_columns(std::span<const std::byte>& p_in)
+    {
+        detail::wire_reader reader(p_in);
+        return detail::wire_codec<Format>::template read_columns<Tuple>(reader);
+    }
+
+    /// <summary>
+    /// View the columns of a batch written by serialize_columns in place, without copying. Every
+    /// element type must be raw in the format; see view_array.
+    /// </summary>
+    /// <typeparam name="Tuple">The tuple-like row type.</typeparam>
+    /// <typeparam name="Format">The wire format.</typeparam>
+    /// <param name="p_in">The buffer to read from, which is advanced past the batch.</param>
+    /// <returns>A tuple of spans, one over each column, within the buffer.</returns>
+    /// <exception cref="std::invalid_argument">The buffer is truncated or malformed, or a column is
+    /// not suitably aligned in memory.</exception>
+    template <typename Tuple, typename Format = wire_format<>>
+        requires detail::wire_tuple<Tuple> && serializable<Tuple>
+    auto view_columns(std::span<const std::byte>& p_in)
+    {
+        detail::wire_reader reader(p_in);
+        return detail::wire_codec<Format>::template view_columns<Tuple>(reader);
+    }
+}
@@ -0,0 +1,425 @@
+#pragma once
+
+#include "detail/snapshot_ptr.hpp"
+#include "per_thread.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mg
+{
+    class epoch_domain;
+
+    /// <summary>
+    /// A pin on an epoch_domain, held by a reader for as long as it uses objects loaded from the
+    /// structures the domain protects. Must be destroyed on the thread which took it.
+    /// </summary>
+    class epoch_guard
+    {
+    public:
+        /// <summary>
+        /// A guard which pins nothing.
+        /// </summary>
+        epoch_guard() noexcept = default;
+
+        epoch_guard(epoch_guard&& p_other) noexcept
+            : m_record(std::exchange(p_other.m_record, nullptr))
+        {
+        }
+
+        epoch_guard& operator=(epoch_guard&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                unpin();
+                m_record = std::exchange(p_other.m_record, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~epoch_guard()
+        {
+            unpin();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return m_record != nullptr;
+        }
+
+    private:
+        friend class epoch_domain;
+
+        explicit epoch_guard(detail::epoch_record* p_record) noexcept
+            : m_record(p_record)
+        {
+        }
+
+        void unpin() noexcept
+        {
+            if (m_record != nullptr && --m_record->m_nesting == 0)
+            {
+                std::atomic_ref<std::uint64_t>(m_record->m_epoch).store(0, std::memory_order_release);
+            }
+
+            m_record = nullptr;
+        }
+
+        detail::epoch_record* m_record = nullptr;
+    };
+
+    /// <summary>
+    /// Epoch based reclamation, for lock-free structures whose readers may still hold an object
+    /// after a writer has unlinked it. Readers pin the domain while they use what they load, which
+    /// writes only their own per-thread record; writers retire what they unlink, and it is freed
+    /// once every reader which pinned before the retirement has unpinned.
+    /// </summary>
+    /// <remarks>Pinning costs a load of the global epoch and a sequentially consistent store to the
+    /// reader's own cache line, and pins nest, so only the outermost one stores. Nothing a reader
+    /// does touches a line which other readers write, so readers scale with the number of cores,
+    /// unlike a shared_ptr's reference count or a reader-writer lock.</remarks>
+    /// <remarks>Retiring scans every reader's record under a lock, so is meant for writes which
+    /// are rare next to reads. A reader which stays pinned holds back every object retired since,
+    /// so pins should be short.</remarks>
+    /// <example><code>
+    /// auto guard = domain.pin();
+    /// node* head = m_head.load();
+    /// // ... head stays valid until the guard is destroyed, even if a writer retires it.
+    /// </code></example>
+    class epoch_domain
+    {
+    public:
+        epoch_domain() = default;
+
+        epoch_domain(const epoch_domain&) = delete;
+        epoch_domain& operator=(const epoch_domain&) = delete;
+
+        /// <summary>
+        /// Free everything still retired, including anything retired by those destructors. No
+        /// reader may be pinned and no writer retiring.
+        /// </summary>
+        ~epoch_domain()
+        {
+            while (!m_retired.empty())
+            {
+                const auto retired = std::exchange(m_retired, {});
+                for (const auto& object : retired)
+                {
+                    object.m_deleter(object.m_object);
+                }
+            }
+        }
+
+        /// <summary>
+        /// The domain shared by default. Never destroyed, so that structures with static storage
+        /// duration can still retire into it when they are destroyed.
+        /// </summary>
+        static epoch_domain& global()
+        {
+            static auto* domain = new epoch_domain();
+            return *domain;
+        }
+
+        /// <summary>
+        /// Pin the calling thread, so that nothing retired from now on is freed until the guard
+        /// (and any enclosing one) is destroyed.
+        /// </summary>
+        [[nodiscard]] epoch_guard pin()
+        {
+            auto& record = m_records.local();
+            if (record.m_nesting++ == 0)
+            {
+                // Announce the epoch before loading anything it protects. Paired with the writer
+                // unlinking before it scans the records: either the writer sees the announcement
+                // or the reader loads what replaced the object.
+                std::atomic_ref<std::uint64_t>(record.m_epoch).store(m_epoch->load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            }
+
+            return epoch_guard(&record);
+        }
+
+        /// <summary>
+        /// Free an object, which must already be unreachable to new readers, once every reader
+        /// which might hold it has unpinned. Also frees whatever earlier retirements have become
+        /// safe to.
+        /// </summary>
+        /// <remarks>If recording the object throws, it is leaked rather than freed early.</remarks>
+        void retire(void* p_object, void (*p_deleter)(void*))
+        {
+            if (p_object == nullptr)
+            {
+                return;
+            }
+
+            const auto epoch = m_epoch->fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::scoped_lock lock(m_mutex);
+                m_retired.push_back({ p_object, p_deleter, epoch });
+            }
+
+            reclaim();
+        }
+
+        /// <summary>
+        /// Retire an object allocated with new.
+        /// </summary>
+        template <typename T>
+        void retire(T* p_object)
+        {
+            retire(const_cast<std::remove_cv_t<T>*>(p_object), [](void* p_retired) { delete static_cast<T*>(p_retired); });
+        }
+
+        /// <summary>
+        /// Free every retired object which no pinned reader can still hold.
+        /// </summary>
+        /// <returns>The number of objects freed.</returns>
+        std::size_t reclaim()
+        {
+            std::vector<detail::retired_object> ready;
+            {
+                std::scoped_lock lock(m_mutex);
+                if (m_retired.empty())
+                {
+                    return 0;
+                }
+
+                const auto oldest = oldest_pinned();
+                const auto kept = std::partition(m_retired.begin(), m_retired.end(), [oldest](const detail::retired_object& p_retired) { return !detail::reclaimable(p_retired.m_epoch, oldest); });
+                ready.assign(kept, m_retired.end());
+                m_retired.erase(kept, m_retired.end());
+            }
+
+            // Outside the lock, since a destructor may retire in turn.
+            for (const auto& retired : ready)
+            {
+                retired.m_deleter(retired.m_object);
+            }
+
+            return ready.size();
+        }
+
+        /// <summary>
+        /// Wait until everything retired has been freed, which needs every reader pinned now to
+        /// unpin. The calling thread must not be pinned.
+        /// </summary>
+        void synchronize()
+        {
+            while (reclaim(), pending() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        /// <summary>
+        /// The number of retired objects not yet freed.
+        /// </summary>
+        std::size_t pending() const
+        {
+            std::scoped_lock lock(m_mutex);
+            return m_retired.size();
+        }
+
+    private:
+        std::uint64_t oldest_pinned()
+        {
+            auto oldest = detail::no_pinned_epoch;
+            m_records.for_each([&oldest](detail::epoch_record& p_record)
+                {
+                    const auto epoch = std::atomic_ref<std::uint64_t>(p_record.m_epoch).load(std::memory_order_seq_cst);
+                    if (epoch != 0)
+                    {
+                        oldest = std::min(oldest, epoch);
+                    }
+                });
+
+            return oldest;
+        }
+
+        // Starts at one, since a record's zero means unpinned.
+        cache_padded<std::atomic<std::uint64_t>> m_epoch{ std::in_place, 1 };
+        per_thread<detail::epoch_record> m_records;
+        mutable std::mutex m_mutex;
+        std::vector<detail::retired_object> m_retired;
+    };
+
+    /// <summary>
+    /// A pointer to shared state which is read far more often than it changes, such as a
+    /// configuration which is occasionally swapped at run time. Readers take a snapshot, which pins
+    /// the current version for as long as they hold it without writing to any memory other readers
+    /// use; writers publish a new version, and the old one is freed by the epoch_domain once the
+    /// last snapshot of it is gone.
+    /// </summary>
+    /// <remarks>Readers see a version whole, never a mix of two. Writers do not wait for readers
+    /// and, with update(), do not lose each other's changes.</remarks>
+    /// <typeparam name="T">The type of the state, which readers see as const.</typeparam>
+    /// <example><code>
+    /// inline mg::snapshot_ptr&lt;limits&gt; g_limits(std::make_unique&lt;limits&gt;());
+    ///
+    /// struct current_timeout
+    /// {
+    ///     std::chrono::milliseconds operator()() const { return g_limits.read()-&gt;timeout; }
+    /// };
+    ///
+    /// auto fetch = mg::func_with_defaults&lt;&amp;fetch_impl, current_timeout&gt;();
+    /// g_limits.update([](limits&amp; p_limits) { p_limits.timeout = 250ms; });
+    /// </code></example>
+    template <typename T>
+    class snapshot_ptr
+    {
+    public:
+        /// <summary>
+        /// A version of the state as it was when read, which stays valid while this is held.
+        /// </summary>
+        class snapshot
+        {
+        public:
+            snapshot() noexcept = default;
+
+            snapshot(snapshot&& p_other) noexcept
+                : m_guard(std::move(p_other.m_guard)),
+                m_value(std::exchange(p_other.m_value, nullptr))
+            {
+            }
+
+            snapshot& operator=(snapshot&& p_other) noexcept
+            {
+                m_guard = std::move(p_other.m_guard);
+                m_value = std::exchange(p_other.m_value, nullptr);
+                return *this;
+            }
+
+            const T* get() const noexcept
+            {
+                return m_value;
+            }
+
+            const T& operator*() const noexcept
+            {
+                return *m_value;
+            }
+
+            const T* operator->() const noexcept
+            {
+                return m_value;
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return m_value != nullptr;
+            }
+
+        private:
+            friend class snapshot_ptr;
+
+            snapshot(epoch_guard p_guard, const T* p_value) noexcept
+                : m_guard(std::move(p_guard)),
+                m_value(p_value)
+            {
+            }
+
+            epoch_guard m_guard;
+            const T* m_value = nullptr;
+        };
+
+        explicit snapshot_ptr(epoch_domain& p_domain = epoch_domain::global()) noexcept
+            : m_domain(&p_domain)
+        {
+        }
+
+        explicit snapshot_ptr(std::unique_ptr<T> p_value, epoch_domain& p_domain = epoch_domain::global()) noexcept
+            : m_value(p_value.release()),
+            m_domain(&p_domain)
+        {
+        }
+
+        snapshot_ptr(const snapshot_ptr&) = delete;
+        snapshot_ptr& operator=(const snapshot_ptr&) = delete;
+
+        /// <summary>
+        /// Retire the current version, which readers may still hold.
+        /// </summary>
+        ~snapshot_ptr()
+        {
+            m_domain->retire(m_value.load(std::memory_order_relaxed));
+        }
+
+        /// <summary>
+        /// Take a snapshot of the current version, which is empty if none has been published.
+        /// </summary>
+        snapshot read() const
+        {
+            auto guard = m_domain->pin();
+            return snapshot(std::move(guard), m_value.load(std::memory_order_seq_cst));
+        }
+
+        /// <summary>
+        /// Publish a new version, retiring the previous one.
+        /// </summary>
+        void store(std::unique_ptr<T> p_value)
+        {
+            m_domain->retire(m_value.exchange(p_value.release(), std::memory_order_seq_cst));
+        }
+
+        template <typename... Args>
+            requires std::constructible_from<T, Args...>
+        void emplace(Args&&... p_args)
+        {
+            store(std::make_unique<T>(std::forward<Args>(p_args)...));
+        }
+
+        /// <summary>
+        /// Publish a modified copy of the current version, retrying with a fresh copy if another
+        /// writer published first, so that concurrent updates are never lost.
+        /// </summary>
+        /// <exception cref="std::logic_error">Nothing has been published.</exception>
+        template <typename Fn>
+            requires std::copy_constructible<T> && std::invocable<Fn&, T&>
+        void update(Fn p_fn)
+        {
+            T* replaced = nullptr;
+            {
+                // Stay pinned until the exchange, so that the version compared against cannot be
+                // freed and its address reused by a newer one.
+                auto guard = m_domain->pin();
+                auto* current = m_value.load(std::memory_order_seq_cst);
+                std::unique_ptr<T> next;
+                do
+                {
+                    if (current == nullptr)
+                    {
+                        throw std::logic_error("A snapshot_ptr can only be updated once a value has been published.");
+                    }
+
+                    next = std::make_unique<T>(*current);
+                    std::invoke(p_fn, *next);
+                } while (!m_value.compare_exchange_weak(current, next.get(), std::memory_order_seq_cst));
+
+                next.release();
+                replaced = current;
+            }
+
+            m_domain->retire(replaced);
+        }
+
+        epoch_domain& domain() const noexcept
+        {
+            return *m_domain;
+        }
+
+    private:
+        std::atomic<T*> m_value = nullptr;
+        epoch_domain* m_domain;
+    };
+}
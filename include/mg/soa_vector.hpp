@@ -0,0 +1,518 @@
+#pragma once
+
+#include "detail/soa_vector.hpp"
+#include "sequence.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// A growable sequence of records which is stored as a struct of arrays rather than an array of
+    /// structs. Every element type of the record gets its own contiguous column, and all columns live
+    /// in a single allocation with each column starting on its own aligned boundary. This means that a
+    /// scan which only reads one or two fields of every record only touches the cache lines for those
+    /// fields, and loops over a column are trivially vectorizable.
+    ///
+    /// Columns can be accessed directly as spans through column&lt;Idx&gt;() and whole records through
+    /// indexing or iteration, which yields a tuple of references into every column. For zipped
+    /// iteration over a subset of columns see mg::iter_zipped_ranges.
+    /// </summary>
+    /// <typeparam name="...Ts">The types of the columns in the order that they appear in a record.</typeparam>
+    template <typename... Ts>
+    class soa_vector
+    {
+        static_assert(sizeof...(Ts) > 0, "A soa_vector requires at least one column.");
+        static_assert(
+            ((std::is_object_v<Ts> && !std::is_const_v<Ts> && !std::is_volatile_v<Ts>) && ...),
+            "The column types of a soa_vector must be non-const, non-volatile object types.");
+
+        template <bool Const>
+        class basic_iterator;
+
+    public:
+        using types = type_sequence<Ts...>;
+
+        template <std::size_t Idx>
+        using column_type = typename types::template nth<Idx>;
+
+        using value_type = std::tuple<Ts...>;
+        using reference = std::tuple<Ts&...>;
+        using const_reference = std::tuple<const Ts&...>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+
+        /// <summary>
+        /// The number of columns in each record.
+        /// </summary>
+        static constexpr std::size_t column_count = sizeof...(Ts);
+
+        /// <summary>
+        /// The alignment of the start of every column. At least a cache line so that columns never
+        /// share a line with one another and vector loads from the start of a column are aligned.
+        /// </summary>
+        static constexpr std::size_t column_alignment = detail::soa_storage<Ts...>::alignment;
+
+        soa_vector() noexcept = default;
+
+        /// <summary>
+        /// Create a vector with the given number of value initialized records.
+        /// </summary>
+        /// <param name="p_count">The number of records.</param>
+        explicit soa_vector(size_type p_count)
+        {
+            resize(p_count);
+        }
+
+        soa_vector(std::initializer_list<value_type> p_records)
+        {
+            reserve(p_records.size());
+            for (const auto& record : p_records)
+            {
+                push_back(record);
+            }
+        }
+
+        soa_vector(const soa_vector& p_other)
+        {
+            if (p_other.m_size == 0)
+            {
+                return;
+            }
+
+            auto storage = storage_type::allocate(p_other.m_size);
+            try
+            {
+                storage_type::construct_columns(
+                    [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                    {
+                        std::uninitialized_copy_n(p_other.column_data<Idx>(), p_other.m_size, storage.template column<Idx>());
+                    },
+                    [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                    {
+                        std::destroy_n(storage.template column<Idx>(), p_other.m_size);
+                    });
+            }
+            catch (...)
+            {
+                storage.deallocate();
+                throw;
+            }
+
+            m_storage = storage;
+            m_size = p_other.m_size;
+        }
+
+        soa_vector(soa_vector&& p_other) noexcept
+            : m_storage(std::exchange(p_other.m_storage, storage_type{})),
+            m_size(std::exchange(p_other.m_size, 0))
+        {
+        }
+
+        soa_vector& operator=(const soa_vector& p_other)
+        {
+            if (this != &p_other)
+            {
+                soa_vector copy(p_other);
+                swap(copy);
+            }
+
+            return *this;
+        }
+
+        soa_vector& operator=(soa_vector&& p_other) noexcept
+        {
+            soa_vector moved(std::move(p_other));
+            swap(moved);
+            return *this;
+        }
+
+        ~soa_vector()
+        {
+            clear();
+            m_storage.deallocate();
+        }
+
+        /// <summary>
+        /// Get a column of the vector as a contiguous span over all of the records.
+        /// </summary>
+        /// <typeparam name="Idx">The index of the column within the record.</typeparam>
+        /// <returns>The span over the column, which is invalidated by any reallocation.</returns>
+        template <std::size_t Idx>
+        std::span<column_type<Idx>> column() noexcept
+        {
+            return { column_data<Idx>(), m_size };
+        }
+
+        template <std::size_t Idx>
+        std::span<const column_type<Idx>> column() const noexcept
+        {
+            return { column_data<Idx>(), m_size };
+        }
+
+        reference operator[](size_type p_idx) noexcept
+        {
+            return row(p_idx, std::index_sequence_for<Ts...>{});
+        }
+
+        const_reference operator[](size_type p_idx) const noexcept
+        {
+            return row(p_idx, std::index_sequence_for<Ts...>{});
+        }
+
+        reference at(size_type p_idx)
+        {
+            check_index(p_idx);
+            return (*this)[p_idx];
+        }
+
+        const_reference at(size_type p_idx) const
+        {
+            check_index(p_idx);
+            return (*this)[p_idx];
+        }
+
+        reference front() noexcept { return (*this)[0]; }
+        const_reference front() const noexcept { return (*this)[0]; }
+        reference back() noexcept { return (*this)[m_size - 1]; }
+        const_reference back() const noexcept { return (*this)[m_size - 1]; }
+
+        iterator begin() noexcept { return { this, 0 }; }
+        const_iterator begin() const noexcept { return { this, 0 }; }
+        const_iterator cbegin() const noexcept { return begin(); }
+        iterator end() noexcept { return { this, static_cast<difference_type>(m_size) }; }
+        const_iterator end() const noexcept { return { this, static_cast<difference_type>(m_size) }; }
+        const_iterator cend() const noexcept { return end(); }
+
+        bool empty() const noexcept { return m_size == 0; }
+        size_type size() const noexcept { return m_size; }
+        size_type capacity() const noexcept { return m_storage.m_capacity; }
+        static constexpr size_type max_size() noexcept { return storage_type::max_capacity; }
+
+        /// <summary>
+        /// Make sure that the vector can hold at least the given number of records without any
+        /// further allocation. All columns are resized together in a single new allocation.
+        /// </summary>
+        /// <param name="p_capacity">The minimum number of records to have space for.</param>
+        void reserve(size_type p_capacity)
+        {
+            if (p_capacity > capacity())
+            {
+                reallocate(p_capacity);
+            }
+        }
+
+        void clear() noexcept
+        {
+            destroy_tail(0);
+        }
+
+        /// <summary>
+        /// Resize the vector to hold exactly the given number of records. New records are value
+        /// initialized.
+        /// </summary>
+        /// <param name="p_count">The new number of records.</param>
+        void resize(size_type p_count)
+        {
+            if (p_count <= m_size)
+            {
+                destroy_tail(p_count);
+                return;
+            }
+
+            reserve(p_count);
+            const auto added = p_count - m_size;
+            storage_type::construct_columns(
+                [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                {
+                    std::uninitialized_value_construct_n(column_data<Idx>() + m_size, added);
+                },
+                [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                {
+                    std::destroy_n(column_data<Idx>() + m_size, added);
+                });
+            m_size = p_count;
+        }
+
+        void push_back(const value_type& p_record)
+        {
+            std::apply([this](const Ts&... p_fields) { emplace_back(p_fields...); }, p_record);
+        }
+
+        void push_back(value_type&& p_record)
+        {
+            std::apply([this](Ts&... p_fields) { emplace_back(std::move(p_fields)...); }, p_record);
+        }
+
+        /// <summary>
+        /// Append a record constructing each column in place from the matching argument. If the
+        /// construction of any column throws then the vector is left unchanged.
+        /// </summary>
+        /// <typeparam name="...Args">The types of the arguments, one for each column.</typeparam>
+        /// <param name="...p_args">The arguments to construct each column from.</param>
+        /// <returns>A reference to the newly appended record.</returns>
+        template <typename... Args>
+        reference emplace_back(Args&&... p_args)
+        {
+            static_assert(sizeof...(Args) == column_count, "emplace_back requires exactly one argument per column.");
+
+            if (m_size < capacity())
+            {
+                construct_record(m_storage, m_size, std::forward<Args>(p_args)...);
+                return (*this)[m_size++];
+            }
+
+            // The arguments may refer to records of this vector, so the new record is constructed in
+            // the new allocation before the existing records are moved out from under them.
+            auto storage = storage_type::allocate(next_capacity());
+            try
+            {
+                construct_record(storage, m_size, std::forward<Args>(p_args)...);
+                try
+                {
+                    relocate_into(storage);
+                }
+                catch (...)
+                {
+                    destroy_record(storage, m_size);
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                storage.deallocate();
+                throw;
+            }
+
+            replace_storage(storage);
+            return (*this)[m_size++];
+        }
+
+        void pop_back() noexcept
+        {
+            destroy_tail(m_size - 1);
+        }
+
+        void swap(soa_vector& p_other) noexcept
+        {
+            std::swap(m_storage, p_other.m_storage);
+            std::swap(m_size, p_other.m_size);
+        }
+
+        friend void swap(soa_vector& p_lhs, soa_vector& p_rhs) noexcept
+        {
+            p_lhs.swap(p_rhs);
+        }
+
+    private:
+        using storage_type = detail::soa_storage<Ts...>;
+
+        template <std::size_t Idx>
+        column_type<Idx>* column_data() const noexcept
+        {
+            return m_storage.template column<Idx>();
+        }
+
+        template <std::size_t... Is>
+        reference row(size_type p_idx, std::index_sequence<Is...>) noexcept
+        {
+            return { column_data<Is>()[p_idx]... };
+        }
+
+        template <std::size_t... Is>
+        const_reference row(size_type p_idx, std::index_sequence<Is...>) const noexcept
+        {
+            return { column_data<Is>()[p_idx]... };
+        }
+
+        void check_index(size_type p_idx) const
+        {
+            if (p_idx >= m_size)
+            {
+                throw std::out_of_range("The index is past the end of the soa_vector.");
+            }
+        }
+
+        size_type next_capacity() const
+        {
+            if (capacity() == max_size())
+            {
+                throw std::length_error("The soa_vector cannot grow past its maximum size.");
+            }
+
+            return std::max<size_type>(capacity() + std::min(capacity(), max_size() - capacity()), 8);
+        }
+
+        void destroy_tail(size_type p_newSize) noexcept
+        {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                (std::destroy(column_data<Is>() + p_newSize, column_data<Is>() + m_size), ...);
+            }(std::index_sequence_for<Ts...>{});
+            m_size = p_newSize;
+        }
+
+        /// <summary>
+        /// Construct the record at the given index of some storage from one argument per column. If
+        /// any column throws, the columns already constructed are destroyed again.
+        /// </summary>
+        template <typename... Args>
+        static void construct_record(const storage_type& p_storage, size_type p_idx, Args&&... p_args)
+        {
+            auto args = std::forward_as_tuple(std::forward<Args>(p_args)...);
+            storage_type::construct_columns(
+                [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                {
+                    std::construct_at(p_storage.template column<Idx>() + p_idx, std::get<Idx>(std::move(args)));
+                },
+                [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                {
+                    std::destroy_at(p_storage.template column<Idx>() + p_idx);
+                });
+        }
+
+        static void destroy_record(const storage_type& p_storage, size_type p_idx) noexcept
+        {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>)
+            {
+                (std::destroy_at(p_storage.template column<Is>() + p_idx), ...);
+            }(std::index_sequence_for<Ts...>{});
+        }
+
+        /// <summary>
+        /// Move all records into the start of new storage. Columns are moved only if all of them can
+        /// be moved without throwing, otherwise they are copied so that a failure part way through
+        /// leaves the vector untouched.
+        /// </summary>
+        void relocate_into(const storage_type& p_storage)
+        {
+            constexpr bool MoveColumns = (std::is_nothrow_move_constructible_v<Ts> && ...);
+
+            storage_type::construct_columns(
+                [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                {
+                    if constexpr (MoveColumns)
+                    {
+                        std::uninitialized_move_n(column_data<Idx>(), m_size, p_storage.template column<Idx>());
+                    }
+                    else
+                    {
+                        std::uninitialized_copy_n(column_data<Idx>(), m_size, p_storage.template column<Idx>());
+                    }
+                },
+                [&]<std::size_t Idx>(std::integral_constant<std::size_t, Idx>)
+                {
+                    std::destroy_n(p_storage.template column<Idx>(), m_size);
+                });
+        }
+
+        /// <summary>
+        /// Destroy the records in the current storage and switch to storage the records have been
+        /// relocated into.
+        /// </summary>
+        void replace_storage(const storage_type& p_storage) noexcept
+        {
+            const auto size = m_size;
+            clear();
+            m_storage.deallocate();
+            m_storage = p_storage;
+            m_size = size;
+        }
+
+        /// <summary>
+        /// Move all records into a new allocation of the given capacity.
+        /// </summary>
+        void reallocate(size_type p_capacity)
+        {
+            auto storage = storage_type::allocate(p_capacity);
+            try
+            {
+                relocate_into(storage);
+            }
+            catch (...)
+            {
+                storage.deallocate();
+                throw;
+            }
+
+            replace_storage(storage);
+        }
+
+        storage_type m_storage{};
+        size_type m_size = 0;
+    };
+
+    /// <summary>
+    /// Random access iterator over the records of a soa_vector. Dereferencing yields a tuple of
+    /// references into each of the columns, which means this is a proxy iterator in the same way
+    /// that the iterator of std::vector&lt;bool&gt; is.
+    /// </summary>
+    template <typename... Ts>
+    template <bool Const>
+    class soa_vector<Ts...>::basic_iterator
+    {
+        using container = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = soa_vector::value_type;
+        using reference = std::conditional_t<Const, soa_vector::const_reference, soa_vector::reference>;
+        using difference_type = std::ptrdiff_t;
+
+        basic_iterator() noexcept = default;
+
+        basic_iterator(container* p_container, difference_type p_idx) noexcept
+            : m_container(p_container),
+            m_idx(p_idx)
+        {
+        }
+
+        template <bool OtherConst>
+            requires (Const && !OtherConst)
+        basic_iterator(const basic_iterator<OtherConst>& p_other) noexcept
+            : m_container(p_other.m_container),
+            m_idx(p_other.m_idx)
+        {
+        }
+
+        reference operator*() const noexcept { return (*m_container)[static_cast<size_type>(m_idx)]; }
+        reference operator[](difference_type p_offset) const noexcept { return *(*this + p_offset); }
+
+        basic_iterator& operator++() noexcept { ++m_idx; return *this; }
+        basic_iterator operator++(int) noexcept { auto copy = *this; ++m_idx; return copy; }
+        basic_iterator& operator--() noexcept { --m_idx; return *this; }
+        basic_iterator operator--(int) noexcept { auto copy = *this; --m_idx; return copy; }
+        basic_iterator& operator+=(difference_type p_offset) noexcept { m_idx += p_offset; return *this; }
+        basic_iterator& operator-=(difference_type p_offset) noexcept { m_idx -= p_offset; return *this; }
+
+        friend basic_iterator operator+(basic_iterator p_it, difference_type p_offset) noexcept { return p_it += p_offset; }
+        friend basic_iterator operator+(difference_type p_offset, basic_iterator p_it) noexcept { return p_it += p_offset; }
+        friend basic_iterator operator-(basic_iterator p_it, difference_type p_offset) noexcept { return p_it -= p_offset; }
+        friend difference_type operator-(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx - p_rhs.m_idx; }
+
+        friend bool operator==(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx == p_rhs.m_idx; }
+        friend auto operator<=>(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx <=> p_rhs.m_idx; }
+
+    private:
+        template <bool>
+        friend class basic_iterator;
+
+        container* m_container = nullptr;
+        difference_type m_idx = 0;
+    };
+}
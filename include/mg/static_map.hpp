@@ -0,0 +1,273 @@
+#pragma once
+
+#include "detail/static_map.hpp"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// The hash used by static_map, which must be computable in constant expressions. It is provided
+    /// for integers, enums and anything convertible to a std::string_view, and can be specialized for
+    /// other key types. The hash need not be well distributed, since static_map mixes it with its seed,
+    /// only distinct for distinct keys as often as possible.
+    /// </summary>
+    template <typename T>
+    struct static_hash;
+
+    template <typename T>
+        requires (std::is_integral_v<T> || std::is_enum_v<T>)
+    struct static_hash<T>
+    {
+        constexpr std::uint64_t operator()(T p_key) const noexcept
+        {
+            return static_cast<std::uint64_t>(p_key);
+        }
+    };
+
+    template <typename T>
+        requires std::is_convertible_v<const T&, std::string_view>
+    struct static_hash<T>
+    {
+        constexpr std::uint64_t operator()(std::string_view p_key) const noexcept
+        {
+            // FNV-1a.
+            std::uint64_t hash = 0xcbf29ce484222325ull;
+            for (const auto c : p_key)
+            {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+            }
+
+            return hash;
+        }
+    };
+
+    /// <summary>
+    /// An immutable map over a fixed set of keys, built in a constant expression, for lookups in hot
+    /// paths which would otherwise go to a std::unordered_map built at startup.
+    /// </summary>
+    /// <remarks>The entries are placed by a minimal perfect hash (see detail::build_perfect_hash): a
+    /// lookup hashes the key, reads the pilot of its bucket, and compares the one entry in the slot
+    /// they select, so it makes no allocation and at most two probes into memory. If no perfect hash is
+    /// found within the budget, for example because two keys have the same 64 bit hash, the entries
+    /// are instead sorted and looked up by binary search. Which was chosen is fixed when the map is
+    /// built, so for a constexpr map the compiler removes the other path entirely.</remarks>
+    /// <typeparam name="Key">The key type.</typeparam>
+    /// <typeparam name="Value">The mapped type.</typeparam>
+    /// <typeparam name="N">The number of entries.</typeparam>
+    /// <typeparam name="Hash">The hash of the keys, which must be usable in constant expressions.</typeparam>
+    /// <typeparam name="KeyEqual">The equality comparator of the keys.</typeparam>
+    /// <example><code>
+    /// constexpr auto methods = mg::make_static_map&lt;std::string_view, method&gt;({
+    ///     { "GET", method::get }, { "PUT", method::put }, { "POST", method::post } });
+    /// static_assert(methods.at("PUT") == method::put);
+    ///
+    /// if (const auto* found = methods.find(token)) { ... }
+    /// </code></example>
+    template <typename Key, typename Value, std::size_t N, typename Hash = static_hash<Key>, typename KeyEqual = std::equal_to<>>
+    class static_map
+    {
+    public:
+        using key_type = Key;
+        using mapped_type = Value;
+        using value_type = std::pair<Key, Value>;
+        using const_iterator = typename std::array<value_type, N>::const_iterator;
+
+        /// <summary>
+        /// The default number of slots which may be tried in the search for a perfect hash. The search
+        /// usually takes around twenty per key, so this leaves room for unlucky seeds while bounding
+        /// the time spent in constant evaluation.
+        /// </summary>
+        static constexpr std::size_t default_budget = 64 * N + 1024;
+
+        /// <summary>
+        /// Build the map, which should be done in a constant expression.
+        /// </summary>
+        /// <param name="p_entries">The entries, whose keys must be unique.</param>
+        /// <param name="p_budget">The number of slots which may be tried in the search for a perfect
+        /// hash before falling back to binary search.</param>
+        /// <exception cref="std::invalid_argument">Two entries have the same key, or no perfect hash
+        /// was found and the keys cannot be ordered.</exception>
+        constexpr explicit static_map(const std::array<value_type, N>& p_entries, std::size_t p_budget = default_budget)
+            : static_map(p_entries, build(p_entries, p_budget), std::make_index_sequence<N>{})
+        {
+        }
+
+        /// <summary>
+        /// Find the value mapped to a key.
+        /// </summary>
+        /// <param name="p_key">The key to look up.</param>
+        /// <returns>A pointer to the value, or null if the key is not in the map.</returns>
+        constexpr const Value* find(const Key& p_key) const
+        {
+            if constexpr (N == 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                const auto& entry = m_entries[index_of(p_key)];
+                return KeyEqual{}(entry.first, p_key) ? &entry.second : nullptr;
+            }
+        }
+
+        constexpr bool contains(const Key& p_key) const
+        {
+            return find(p_key) != nullptr;
+        }
+
+        /// <summary>
+        /// Get the value mapped to a key.
+        /// </summary>
+        /// <exception cref="std::out_of_range">The key is not in the map.</exception>
+        constexpr const Value& at(const Key& p_key) const
+        {
+            const auto* found = find(p_key);
+            if (found == nullptr)
+            {
+                throw std::out_of_range("The key is not in the static_map.");
+            }
+
+            return *found;
+        }
+
+        /// <summary>
+        /// Whether the entries are placed by a perfect hash, rather than sorted for binary search.
+        /// </summary>
+        constexpr bool is_perfect() const noexcept
+        {
+            return m_layout.perfect;
+        }
+
+        constexpr std::size_t size() const noexcept
+        {
+            return N;
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            return N == 0;
+        }
+
+        /// <summary>
+        /// The entries, in the order of their slots.
+        /// </summary>
+        constexpr const_iterator begin() const noexcept
+        {
+            return m_entries.begin();
+        }
+
+        constexpr const_iterator end() const noexcept
+        {
+            return m_entries.end();
+        }
+
+    private:
+        struct built
+        {
+            detail::static_map_layout<N> layout;
+            std::array<std::size_t, N> order;
+        };
+
+        template <std::size_t... Is>
+        constexpr static_map(const std::array<value_type, N>& p_entries, const built& p_built, std::index_sequence<Is...>)
+            : m_layout(p_built.layout),
+            m_entries{ p_entries[p_built.order[Is]]... }
+        {
+        }
+
+        static constexpr built build(const std::array<value_type, N>& p_entries, std::size_t p_budget)
+        {
+            built result{};
+            std::array<std::uint64_t, N> hashes{};
+            std::array<std::size_t, N> by_hash{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                hashes[i] = Hash{}(p_entries[i].first);
+                by_hash[i] = i;
+            }
+
+            // Equal keys have equal hashes, so only keys with equal hashes need to be compared. Distinct
+            // keys with equal hashes can never be separated by a perfect hash.
+            std::sort(by_hash.begin(), by_hash.end(), [&](std::size_t p_lhs, std::size_t p_rhs) { return hashes[p_lhs] < hashes[p_rhs]; });
+            bool distinct_hashes = true;
+            for (std::size_t i = 1; i < N; ++i)
+            {
+                for (auto j = i; j > 0 && hashes[by_hash[j - 1]] == hashes[by_hash[i]]; --j)
+                {
+                    if (KeyEqual{}(p_entries[by_hash[j - 1]].first, p_entries[by_hash[i]].first))
+                    {
+                        throw std::invalid_argument("The keys of a static_map must be unique.");
+                    }
+
+                    distinct_hashes = false;
+                }
+            }
+
+            if (distinct_hashes && detail::build_perfect_hash(hashes, p_budget, result.layout, result.order))
+            {
+                return result;
+            }
+
+            if constexpr (std::totally_ordered<Key>)
+            {
+                for (std::size_t i = 0; i < N; ++i)
+                {
+                    result.order[i] = i;
+                }
+
+                std::sort(result.order.begin(), result.order.end(), [&](std::size_t p_lhs, std::size_t p_rhs) { return p_entries[p_lhs].first < p_entries[p_rhs].first; });
+                return result;
+            }
+            else
+            {
+                throw std::invalid_argument("No perfect hash was found for the keys of the static_map within its budget, and they cannot be ordered for binary search.");
+            }
+        }
+
+        constexpr std::size_t index_of(const Key& p_key) const
+        {
+            if (m_layout.perfect)
+            {
+                const auto seeded = m_layout.seeded(Hash{}(p_key));
+                return m_layout.slot_of(seeded, m_layout.pilots[m_layout.bucket_of(seeded)]);
+            }
+
+            if constexpr (std::totally_ordered<Key>)
+            {
+                const auto found = std::lower_bound(m_entries.begin(), m_entries.end(), p_key, [](const value_type& p_entry, const Key& p_value) { return p_entry.first < p_value; });
+                return std::min(static_cast<std::size_t>(found - m_entries.begin()), N - 1);
+            }
+            else
+            {
+                return 0;
+            }
+        }
+
+        detail::static_map_layout<N> m_layout;
+        std::array<value_type, N> m_entries;
+    };
+
+    /// <summary>
+    /// Build a static_map from a braced list of entries, deducing its size.
+    /// </summary>
+    /// <example><code>
+    /// constexpr auto handlers = mg::make_static_map&lt;opcode, handler_fn&gt;({ { opcode::add, &amp;add }, { opcode::sub, &amp;sub } });
+    /// </code></example>
+    /// <param name="p_entries">The entries, whose keys must be unique.</param>
+    /// <param name="p_budget">See static_map::static_map.</param>
+    template <typename Key, typename Value, typename Hash = static_hash<Key>, typename KeyEqual = std::equal_to<>, std::size_t N>
+    constexpr static_map<Key, Value, N, Hash, KeyEqual> make_static_map(std::pair<Key, Value> (&&p_entries)[N], std::size_t p_budget = static_map<Key, Value, N, Hash, KeyEqual>::default_budget)
+    {
+        return static_map<Key, Value, N, Hash, KeyEqual>(std::to_array(std::move(p_entries)), p_budget);
+    }
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "detail/coroutine.hpp"
+#include "thread_pool.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace mg
+{
+    template <typename T = void>
+    class task;
+
+    namespace detail
+    {
+        /// <summary>
+        /// The part of a task's promise shared by every result type: the awaiting coroutine, to
+        /// which the task transfers directly when it completes.
+        /// </summary>
+        class task_promise_base : public coroutine_frame_allocation
+        {
+            struct final_awaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> p_handle) noexcept
+                {
+                    const auto continuation = p_handle.promise().m_continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+        public:
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            final_awaiter final_suspend() const noexcept { return {}; }
+
+            void set_continuation(std::coroutine_handle<> p_continuation) noexcept
+            {
+                m_continuation = p_continuation;
+            }
+
+        private:
+            std::coroutine_handle<> m_continuation;
+        };
+
+        template <typename T>
+        class task_promise : public task_promise_base
+        {
+        public:
+            task<T> get_return_object() noexcept;
+
+            template <typename U = T>
+                requires std::is_convertible_v<U&&, T>
+            void return_value(U&& p_value) noexcept(std::is_nothrow_constructible_v<T, U&&>)
+            {
+                m_result.template emplace<1>(std::forward<U>(p_value));
+            }
+
+            void unhandled_exception() noexcept
+            {
+                m_result.template emplace<2>(std::current_exception());
+            }
+
+            T result()
+            {
+                if (m_result.index() == 2)
+                {
+                    std::rethrow_exception(std::get<2>(m_result));
+                }
+
+                return std::move(std::get<1>(m_result));
+            }
+
+        private:
+            std::variant<std::monostate, T, std::exception_ptr> m_result;
+        };
+
+        template <>
+        class task_promise<void> : public task_promise_base
+        {
+        public:
+            task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() noexcept
+            {
+                m_exception = std::current_exception();
+            }
+
+            void result()
+            {
+                if (m_exception)
+                {
+                    std::rethrow_exception(m_exception);
+                }
+            }
+
+        private:
+            std::exception_ptr m_exception;
+        };
+    }
+
+    /// <summary>
+    /// A lazily started coroutine producing a single result, which runs when it is co_awaited and
+    /// resumes its awaiter when it completes. Starting and completing use symmetric transfer, so
+    /// arbitrarily long chains of tasks awaiting each other run without growing the stack.
+    /// </summary>
+    /// <remarks>A task is move only, and may be awaited once. An exception thrown by the coroutine is
+    /// rethrown by co_await (or sync_wait). Like mg::generator, the coroutine frame is allocated with
+    /// an allocator when the coroutine's parameters begin with std::allocator_arg and the allocator.
+    /// </remarks>
+    /// <remarks>Tasks run on whichever thread resumes them; co_await mg::resume_on(pool) moves the
+    /// rest of a task onto a thread_pool worker.</remarks>
+    /// <typeparam name="T">The type of the result.</typeparam>
+    /// <example><code>
+    /// mg::task&lt;std::size_t&gt; count_lines(mg::thread_pool&amp; p_pool, std::string p_path)
+    /// {
+    ///     co_await mg::resume_on(p_pool);
+    ///     co_return std::ranges::count(read_file(p_path), '\n');
+    /// }
+    ///
+    /// const auto lines = mg::sync_wait(count_lines(pool, "log.txt"));
+    /// </code></example>
+    template <typename T>
+    class task
+    {
+    public:
+        using promise_type = detail::task_promise<T>;
+        using value_type = T;
+
+        task() noexcept = default;
+
+        task(task&& p_other) noexcept
+            : m_handle(std::exchange(p_other.m_handle, nullptr))
+        {
+        }
+
+        task& operator=(task&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                reset();
+                m_handle = std::exchange(p_other.m_handle, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~task()
+        {
+            reset();
+        }
+
+        /// <summary>
+        /// Whether the task holds a coroutine which has not yet been destroyed.
+        /// </summary>
+        bool valid() const noexcept
+        {
+            return static_cast<bool>(m_handle);
+        }
+
+        auto operator co_await() && noexcept
+        {
+            struct awaiter
+            {
+                bool await_ready() const noexcept
+                {
+                    return !m_handle;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> p_awaiting) noexcept
+                {
+                    m_handle.promise().set_continuation(p_awaiting);
+                    return m_handle;
+                }
+
+                T await_resume()
+                {
+                    return m_handle.promise().result();
+                }
+
+                std::coroutine_handle<promise_type> m_handle;
+            };
+
+            return awaiter{ m_handle };
+        }
+
+    private:
+        friend promise_type;
+
+        explicit task(std::coroutine_handle<promise_type> p_handle) noexcept
+            : m_handle(p_handle)
+        {
+        }
+
+        void reset() noexcept
+        {
+            if (m_handle)
+            {
+                std::exchange(m_handle, nullptr).destroy();
+            }
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    template <typename T>
+    task<T> detail::task_promise<T>::get_return_object() noexcept
+    {
+        return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+    }
+
+    inline task<void> detail::task_promise<void>::get_return_object() noexcept
+    {
+        return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+    }
+
+    /// <summary>
+    /// An awaitable which resumes the awaiting coroutine on a worker of the pool.
+    /// </summary>
+    /// <param name="p_pool">The pool to continue on.</param>
+    inline auto resume_on(thread_pool& p_pool) noexcept
+    {
+        struct awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> p_handle)
+            {
+                // The future is dropped, detaching the resumption.
+                m_pool->submit([p_handle] { p_handle.resume(); });
+            }
+
+            void await_resume() const noexcept {}
+
+            thread_pool* m_pool;
+        };
+
+        return awaiter{ &p_pool };
+    }
+
+    namespace detail
+    {
+        template <typename T>
+        detached_coroutine run_task(task<T>& p_task, std::variant<std::monostate, std::conditional_t<std::is_void_v<T>, std::monostate, T>, std::exception_ptr>& p_result, completion_signal& p_done)
+        {
+            try
+            {
+                if constexpr (std::is_void_v<T>)
+                {
+                    co_await std::move(p_task);
+                    p_result.template emplace<1>();
+                }
+                else
+                {
+                    p_result.template emplace<1>(co_await std::move(p_task));
+                }
+            }
+            catch (...)
+            {
+                p_result.template emplace<2>(std::current_exception());
+            }
+
+            p_done.set();
+        }
+    }
+
+    /// <summary>
+    /// Run a task to completion, blocking the calling thread until it finishes (on whichever
+    /// thread it ends up).
+    /// </summary>
+    /// <param name="p_task">The task to run.</param>
+    /// <returns>The result of the task.</returns>
+    /// <exception cref="std::exception">Any exception thrown by the task.</exception>
+    template <typename T>
+    T sync_wait(task<T> p_task)
+    {
+        std::variant<std::monostate, std::conditional_t<std::is_void_v<T>, std::monostate, T>, std::exception_ptr> result;
+        detail::completion_signal done;
+        detail::run_task(p_task, result, done);
+        done.wait();
+
+        if (result.index() == 2)
+        {
+            std::rethrow_exception(std::get<2>(result));
+        }
+
+        if constexpr (!std::is_void_v<T>)
+        {
+            return std::move(std::get<1>(result));
+        }
+    }
+}
@@ -0,0 +1,633 @@
+#pragma once
+
+#include "detail/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mg
+{
+    /// <summary>
+    /// Thrown from a future whose task was cancelled through its stop token before it started.
+    /// </summary>
+    class operation_cancelled : public std::runtime_error
+    {
+    public:
+        operation_cancelled()
+            : std::runtime_error("The operation was cancelled before it started.")
+        {
+        }
+    };
+
+    /// <summary>
+    /// A lightweight, move only handle to the result of a task submitted to a thread_pool. Unlike
+    /// std::future there is no separately allocated shared state; the result lives in the pool's
+    /// recycled task node. Dropping a future without waiting detaches the task, which still runs.
+    ///
+    /// Waiting from a worker thread of a pool runs other pending tasks of that pool in the meantime,
+    /// so nested fork-join on the same pool cannot deadlock.
+    /// </summary>
+    /// <typeparam name="T">The type of the task result.</typeparam>
+    template <typename T>
+    class future
+    {
+    public:
+        future() noexcept = default;
+
+        future(future&& p_other) noexcept
+            : m_node(std::exchange(p_other.m_node, nullptr))
+        {
+        }
+
+        future& operator=(future&& p_other) noexcept
+        {
+            if (this != &p_other)
+            {
+                reset();
+                m_node = std::exchange(p_other.m_node, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~future()
+        {
+            reset();
+        }
+
+        bool valid() const noexcept { return m_node != nullptr; }
+
+        /// <summary>
+        /// Check whether the task has completed without blocking. Always false for a future that is
+        /// not valid.
+        /// </summary>
+        bool is_ready() const noexcept
+        {
+            return m_node != nullptr && m_node->m_done.load(std::memory_order_acquire) != 0;
+        }
+
+        /// <summary>
+        /// Block until the task has completed. Throws std::logic_error if the future is not valid,
+        /// that is default constructed, moved from or already consumed by get.
+        /// </summary>
+        void wait() const;
+
+        /// <summary>
+        /// Wait for the task and then take its result, rethrowing any exception the task threw. The
+        /// future is no longer valid afterwards. Throws std::logic_error if the future is not valid.
+        /// </summary>
+        /// <returns>The result of the task.</returns>
+        T get()
+        {
+            wait();
+            future consumed(std::move(*this));
+            if (consumed.m_node->m_exception)
+            {
+                std::rethrow_exception(consumed.m_node->m_exception);
+            }
+
+            if constexpr (!std::is_void_v<T>)
+            {
+                return std::move(*static_cast<detail::task_result<T>*>(consumed.m_node->m_payload)->m_value);
+            }
+        }
+
+    private:
+        friend class thread_pool;
+
+        explicit future(detail::task_node* p_node) noexcept
+            : m_node(p_node)
+        {
+        }
+
+        void reset() noexcept
+        {
+            if (m_node != nullptr)
+            {
+                detail::release_task_node(std::exchange(m_node, nullptr));
+            }
+        }
+
+        detail::task_node* m_node = nullptr;
+    };
+
+    /// <summary>
+    /// A work stealing thread pool. Every worker owns a bounded Chase-Lev deque which it pushes to
+    /// and pops from in LIFO order, while idle workers steal from the other end. Tasks submitted from
+    /// threads outside of the pool (or which overflow a worker's deque) go to a shared injection
+    /// queue. Task nodes are recycled so that submission does not allocate in steady state for
+    /// callables of up to a few pointers in size.
+    ///
+    /// Destroying the pool runs every task which was already submitted before joining the workers.
+    /// </summary>
+    class thread_pool
+    {
+    public:
+        struct options
+        {
+            /// <summary>
+            /// The number of worker threads, or 0 for the hardware concurrency.
+            /// </summary>
+            std::size_t thread_count = 0;
+
+            /// <summary>
+            /// Pin worker i to the i-th CPU the constructing thread may run on, modulo the number of
+            /// such CPUs. Only supported on Linux.
+            /// </summary>
+            bool pin_threads = false;
+
+            /// <summary>
+            /// The capacity of each worker's deque before tasks overflow into the injection queue.
+            /// </summary>
+            std::size_t local_queue_capacity = 1024;
+        };
+
+        thread_pool()
+            : thread_pool(options{})
+        {
+        }
+
+        explicit thread_pool(std::size_t p_threadCount)
+            : thread_pool(options{ .thread_count = p_threadCount })
+        {
+        }
+
+        /// <exception cref="std::system_error">A worker could not be pinned to its CPU.</exception>
+        explicit thread_pool(const options& p_options)
+        {
+            auto count = p_options.thread_count;
+            if (count == 0)
+            {
+                count = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            m_workers.reserve(count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                m_workers.push_back(std::make_unique<worker>(p_options.local_queue_capacity));
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                m_workers[i]->m_thread = std::jthread([this, i] { worker_main(i); });
+            }
+
+            if (p_options.pin_threads)
+            {
+                try
+                {
+                    const auto cpus = detail::allowed_cpus();
+                    for (std::size_t i = 0; i < count && !cpus.empty(); ++i)
+                    {
+                        detail::pin_thread(m_workers[i]->m_thread, cpus[i % cpus.size()]);
+                    }
+                }
+                catch (...)
+                {
+                    // The destructor does not run for a throwing constructor, and the workers only
+                    // leave their loop once told to stop.
+                    shutdown();
+                    throw;
+                }
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            shutdown();
+        }
+
+        std::size_t thread_count() const noexcept { return m_workers.size(); }
+
+        /// <summary>
+        /// The stop token of the pool, which is passed to tasks that accept one and is signaled by
+        /// request_stop.
+        /// </summary>
+        std::stop_token get_stop_token() const noexcept { return m_stopSource.get_token(); }
+
+        /// <summary>
+        /// Ask cooperatively cancellable tasks to stop. Tasks which are already queued still run.
+        /// </summary>
+        void request_stop() noexcept { m_stopSource.request_stop(); }
+
+        /// <summary>
+        /// True if the calling thread is one of this pool's workers.
+        /// </summary>
+        bool is_worker_thread() const noexcept { return detail::current_worker().m_pool == this; }
+
+        /// <summary>
+        /// Submit a callable to be run on the pool. If the callable accepts a std::stop_token it is
+        /// invoked with the pool's stop token.
+        /// </summary>
+        /// <typeparam name="Fn">The type of the callable.</typeparam>
+        /// <param name="p_fn">The callable to run.</param>
+        /// <returns>A future for the result of the callable.</returns>
+        template <typename Fn>
+        auto submit(Fn&& p_fn)
+        {
+            if constexpr (std::is_invocable_v<std::decay_t<Fn>&&, std::stop_token>)
+            {
+                return submit_node(
+                    [fn = std::forward<Fn>(p_fn), token = get_stop_token()]() mutable -> decltype(auto)
+                    {
+                        return std::invoke(std::move(fn), std::move(token));
+                    });
+            }
+            else
+            {
+                return submit_node(std::forward<Fn>(p_fn));
+            }
+        }
+
+        /// <summary>
+        /// Submit a callable which is cancelled if the stop token is signaled before it starts, in
+        /// which case the future throws operation_cancelled. If the callable accepts a std::stop_token
+        /// it is invoked with the given token so that it can also stop part way through.
+        /// </summary>
+        template <typename Fn>
+        auto submit(std::stop_token p_token, Fn&& p_fn)
+        {
+            return submit_node(
+                [fn = std::forward<Fn>(p_fn), token = std::move(p_token)]() mutable -> decltype(auto)
+                {
+                    if (token.stop_requested())
+                    {
+                        throw operation_cancelled();
+                    }
+
+                    if constexpr (std::is_invocable_v<std::decay_t<Fn>&&, std::stop_token>)
+                    {
+                        return std::invoke(std::move(fn), std::move(token));
+                    }
+                    else
+                    {
+                        return std::invoke(std::move(fn));
+                    }
+                });
+        }
+
+        /// <summary>
+        /// Invoke a callable on every element of a random access range in parallel and wait for all
+        /// of them to finish. The range is split into blocks of the grain size which are claimed
+        /// dynamically by the calling thread and by helpers running on the pool, so uneven work is
+        /// balanced. If an invocation throws, no further blocks are started and the first exception
+        /// is rethrown once every running block has finished. Signaling the stop token likewise stops
+        /// any further blocks from being started.
+        /// </summary>
+        /// <typeparam name="Range">The type of the range.</typeparam>
+        /// <typeparam name="Fn">The type of the callable, invoked with each element.</typeparam>
+        /// <param name="p_range">The range to iterate over.</param>
+        /// <param name="p_grain">The number of consecutive elements processed by one claim.</param>
+        /// <param name="p_fn">The callable to invoke.</param>
+        /// <param name="p_token">Optional token to stop starting new blocks.</param>
+        /// <returns>False if the stop token stopped iteration before every element was visited.</returns>
+        template <std::ranges::random_access_range Range, typename Fn>
+            requires std::ranges::sized_range<Range>
+        bool parallel_for(Range&& p_range, std::size_t p_grain, Fn&& p_fn, std::stop_token p_token = {})
+        {
+            const auto size = static_cast<std::size_t>(std::ranges::size(p_range));
+            const auto grain = std::max<std::size_t>(p_grain, 1);
+            const auto blocks = (size + grain - 1) / grain;
+            auto first = std::ranges::begin(p_range);
+
+            struct context
+            {
+                std::atomic<std::size_t> m_next{ 0 };
+                std::atomic<std::size_t> m_pending{ 0 };
+                std::atomic<bool> m_failed{ false };
+                std::exception_ptr m_exception;
+            } ctx;
+
+            auto claim_blocks = [&]
+            {
+                while (!ctx.m_failed.load(std::memory_order_relaxed) && !p_token.stop_requested())
+                {
+                    const auto block = ctx.m_next.fetch_add(1, std::memory_order_relaxed);
+                    if (block >= blocks)
+                    {
+                        return;
+                    }
+
+                    const auto end = std::min(size, (block + 1) * grain);
+                    try
+                    {
+                        for (auto i = block * grain; i < end; ++i)
+                        {
+                            std::invoke(p_fn, first[static_cast<std::ranges::range_difference_t<Range>>(i)]);
+                        }
+                    }
+                    catch (...)
+                    {
+                        if (!ctx.m_failed.exchange(true, std::memory_order_acq_rel))
+                        {
+                            ctx.m_exception = std::current_exception();
+                        }
+                    }
+                }
+            };
+
+            const auto helpers = std::min(blocks > 0 ? blocks - 1 : 0, thread_count());
+            ctx.m_pending.store(helpers, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < helpers; ++i)
+            {
+                enqueue(detail::make_task_node(
+                    [this, &ctx, &claim_blocks]
+                    {
+                        claim_blocks();
+
+                        // The caller may return and destroy ctx as soon as it sees the count reach
+                        // zero, so the last helper wakes it through the pool's own counter instead.
+                        if (ctx.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        {
+                            m_joins.fetch_add(1, std::memory_order_release);
+                            m_joins.notify_all();
+                        }
+                    },
+                    1));
+            }
+
+            claim_blocks();
+            wait_until([&] { return ctx.m_pending.load(std::memory_order_acquire) == 0; }, m_joins);
+
+            if (ctx.m_exception)
+            {
+                std::rethrow_exception(ctx.m_exception);
+            }
+
+            return ctx.m_next.load(std::memory_order_relaxed) >= blocks;
+        }
+
+    private:
+        template <typename T>
+        friend class future;
+
+        struct worker
+        {
+            explicit worker(std::size_t p_capacity)
+                : m_deque(p_capacity)
+            {
+            }
+
+            detail::work_stealing_deque m_deque;
+            std::jthread m_thread;
+        };
+
+        template <typename Fn>
+        auto submit_node(Fn&& p_fn)
+        {
+            using R = std::invoke_result_t<std::decay_t<Fn>&&>;
+            static_assert(!std::is_reference_v<R>, "Tasks may not return references, return a pointer or reference_wrapper instead.");
+
+            auto* node = detail::make_task_node(std::forward<Fn>(p_fn), 2);
+            enqueue(node);
+            return future<R>(node);
+        }
+
+        void enqueue(detail::task_node* p_node)
+        {
+            auto& current = detail::current_worker();
+            if (current.m_pool == this && m_workers[current.m_index]->m_deque.push(p_node))
+            {
+                // Only wake a sleeper when there is one, keeping the local push free of shared writes.
+                // The pushing worker will get to the task itself if no one steals it.
+                if (m_sleepers.load(std::memory_order_seq_cst) > 0)
+                {
+                    m_epoch.fetch_add(1, std::memory_order_seq_cst);
+                    m_epoch.notify_one();
+                }
+
+                return;
+            }
+
+            {
+                std::scoped_lock lock(m_injectionMutex);
+                if (m_injectionTail == nullptr)
+                {
+                    m_injectionHead = p_node;
+                }
+                else
+                {
+                    m_injectionTail->m_next = p_node;
+                }
+
+                m_injectionTail = p_node;
+                m_injectionSize.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+            if (m_sleepers.load(std::memory_order_seq_cst) > 0)
+            {
+                m_epoch.notify_one();
+            }
+        }
+
+        detail::task_node* pop_injected()
+        {
+            if (m_injectionSize.load(std::memory_order_relaxed) == 0)
+            {
+                return nullptr;
+            }
+
+            std::scoped_lock lock(m_injectionMutex);
+            auto* node = m_injectionHead;
+            if (node != nullptr)
+            {
+                m_injectionHead = node->m_next;
+                if (m_injectionHead == nullptr)
+                {
+                    m_injectionTail = nullptr;
+                }
+
+                node->m_next = nullptr;
+                m_injectionSize.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            return node;
+        }
+
+        /// <summary>
+        /// Find a task for the calling thread: its own deque first (if it is a worker), then the
+        /// injection queue, then stealing from the other workers starting at a random victim.
+        /// </summary>
+        detail::task_node* find_task()
+        {
+            auto& current = detail::current_worker();
+            const bool isWorker = current.m_pool == this;
+            if (isWorker)
+            {
+                if (auto* node = m_workers[current.m_index]->m_deque.pop())
+                {
+                    return node;
+                }
+            }
+
+            if (auto* node = pop_injected())
+            {
+                return node;
+            }
+
+            thread_local std::uint64_t rng = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<std::uintptr_t>(&rng);
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+
+            const auto count = m_workers.size();
+            const auto start = static_cast<std::size_t>(rng % count);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const auto victim = (start + i) % count;
+                if (isWorker && victim == current.m_index)
+                {
+                    continue;
+                }
+
+                if (auto* node = m_workers[victim]->m_deque.steal())
+                {
+                    return node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        static void run(detail::task_node* p_node)
+        {
+            p_node->m_run(*p_node);
+            detail::release_task_node(p_node);
+        }
+
+        /// <summary>
+        /// Wait until the predicate holds, running pending tasks in the meantime. Worker threads never
+        /// block here, since a blocked worker could strand tasks in its deque that the predicate
+        /// depends on; other threads block on the given atomic once there is nothing to help with.
+        /// </summary>
+        template <typename Pred, typename Atomic>
+        void wait_until(Pred&& p_pred, const Atomic& p_atomic)
+        {
+            const bool isWorker = is_worker_thread();
+            while (!p_pred())
+            {
+                if (auto* node = find_task())
+                {
+                    run(node);
+                    continue;
+                }
+
+                if (isWorker)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                const auto observed = p_atomic.load(std::memory_order_acquire);
+                if (!p_pred())
+                {
+                    p_atomic.wait(observed, std::memory_order_acquire);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Let the workers drain the queues and exit, and join them.
+        /// </summary>
+        void shutdown() noexcept
+        {
+            m_stopping.store(true, std::memory_order_seq_cst);
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+            m_epoch.notify_all();
+            for (auto& w : m_workers)
+            {
+                w->m_thread.join();
+            }
+        }
+
+        void worker_main(std::size_t p_index)
+        {
+            detail::current_worker() = { this, p_index };
+
+            while (true)
+            {
+                if (auto* node = find_task())
+                {
+                    run(node);
+                    continue;
+                }
+
+                const auto epoch = m_epoch.load(std::memory_order_seq_cst);
+                if (auto* node = find_task())
+                {
+                    run(node);
+                    continue;
+                }
+
+                if (m_stopping.load(std::memory_order_seq_cst))
+                {
+                    break;
+                }
+
+                m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+                if (m_epoch.load(std::memory_order_seq_cst) == epoch)
+                {
+                    m_epoch.wait(epoch, std::memory_order_seq_cst);
+                }
+
+                m_sleepers.fetch_sub(1, std::memory_order_seq_cst);
+            }
+
+            detail::current_worker() = {};
+        }
+
+        std::vector<std::unique_ptr<worker>> m_workers;
+        std::stop_source m_stopSource;
+
+        std::mutex m_injectionMutex;
+        detail::task_node* m_injectionHead = nullptr;
+        detail::task_node* m_injectionTail = nullptr;
+        alignas(64) std::atomic<std::size_t> m_injectionSize{ 0 };
+
+        alignas(64) std::atomic<std::uint32_t> m_epoch{ 0 };
+        alignas(64) std::atomic<std::uint32_t> m_sleepers{ 0 };
+        alignas(64) std::atomic<std::uint32_t> m_joins{ 0 };
+        std::atomic<bool> m_stopping{ false };
+    };
+
+    template <typename T>
+    void future<T>::wait() const
+    {
+        if (!valid())
+        {
+            throw std::logic_error("Cannot wait on a future without an associated task.");
+        }
+
+        if (is_ready())
+        {
+            return;
+        }
+
+        if (auto* pool = detail::current_worker().m_pool)
+        {
+            pool->wait_until([this] { return is_ready(); }, m_node->m_done);
+        }
+        else
+        {
+            m_node->m_done.wait(0, std::memory_order_acquire);
+        }
+    }
+}
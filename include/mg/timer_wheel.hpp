@@ -0,0 +1,307 @@
+#pragma once
+
+#include "detail/timer_wheel.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace mg
+{
+    /// <summary>
+    /// Identifies a timer scheduled on a timer_wheel, for cancelling it. Default constructed and
+    /// stale handles (of timers which have expired or been cancelled) cancel nothing.
+    /// </summary>
+    using timer_handle = detail::timer_wheel_core::handle;
+
+    /// <summary>
+    /// A hierarchical timer wheel for large numbers of timeouts and retry delays. Scheduling and
+    /// cancelling are O(1) regardless of how many timers are pending; time is kept in ticks of a
+    /// fixed resolution, and a timer fires on the first poll at or after its deadline, never early.
+    /// </summary>
+    /// <remarks>The wheel does not run a thread of its own. Something must call poll regularly (for
+    /// example a loop sleeping until next_expiry, or a periodic task), which collects the expired
+    /// callbacks under the lock and then dispatches them outside of it: submitted to the executor in
+    /// batches, one task per batch, or run on the polling thread if the executor is null. A callback
+    /// which throws does not stop the others in its batch. If the executor cannot take a batch, it
+    /// and the batches after it are run on the polling thread instead, since they have already left
+    /// the wheel.</remarks>
+    /// <remarks>All operations are thread safe. Callbacks may schedule and cancel timers.</remarks>
+    /// <typeparam name="Clock">The clock, as a type with a now() member returning a time_point. It
+    /// is held by value, so a simulated clock for tests can refer to externally controlled time.</typeparam>
+    /// <example><code>
+    /// mg::timer_wheel&lt;&gt; timers(&amp;pool);
+    /// auto timeout = timers.schedule_after(std::chrono::seconds(5), [&amp;] { request.abandon(); });
+    /// ...
+    /// timers.cancel(timeout);
+    /// </code></example>
+    template <typename Clock = std::chrono::steady_clock>
+    class timer_wheel
+    {
+    public:
+        using clock = Clock;
+        using duration = typename Clock::duration;
+        using time_point = typename Clock::time_point;
+
+        static constexpr std::size_t default_batch_size = 256;
+
+        /// <summary>
+        /// Create a timer wheel.
+        /// </summary>
+        /// <param name="p_executor">The pool to dispatch expired callbacks to, or null to run them
+        /// on the polling thread.</param>
+        /// <param name="p_resolution">The length of a tick.</param>
+        /// <param name="p_clock">The clock.</param>
+        /// <param name="p_batchSize">The number of callbacks dispatched as one pool task.</param>
+        /// <param name="p_onError">Called on the pool thread with the exception of each callback
+        /// run on the executor which throws; it should not throw itself. If null, the first such
+        /// exception is rethrown from the next advance_to or poll.</param>
+        /// <exception cref="std::invalid_argument">Thrown if the resolution is not positive or the
+        /// batch size is zero.</exception>
+        explicit timer_wheel(thread_pool* p_executor = nullptr, duration p_resolution = std::chrono::milliseconds(1),
+            Clock p_clock = Clock(), std::size_t p_batchSize = default_batch_size,
+            std::function<void(std::exception_ptr)> p_onError = nullptr)
+            : m_executor(p_executor),
+            m_resolution(p_resolution),
+            m_clock(std::move(p_clock)),
+            m_batchSize(p_batchSize),
+            m_start(m_clock.now()),
+            m_onError(std::move(p_onError))
+        {
+            if (p_resolution <= duration::zero())
+            {
+                throw std::invalid_argument("The timer resolution must be positive.");
+            }
+
+            if (p_batchSize == 0)
+            {
+                throw std::invalid_argument("The batch size must be at least one.");
+            }
+
+            if (!m_onError)
+            {
+                // Shared with the tasks, which may outlive the wheel.
+                m_failures = std::make_shared<pool_failures>();
+                m_onError = [failures = m_failures](std::exception_ptr p_exception)
+                    {
+                        std::scoped_lock lock(failures->m_mutex);
+                        if (!failures->m_first)
+                        {
+                            failures->m_first = std::move(p_exception);
+                        }
+                    };
+            }
+        }
+
+        timer_wheel(const timer_wheel&) = delete;
+        timer_wheel& operator=(const timer_wheel&) = delete;
+
+        /// <summary>
+        /// Schedule a callback to run at (or shortly after) the given time.
+        /// </summary>
+        template <typename Fn>
+        timer_handle schedule_at(time_point p_deadline, Fn&& p_fn)
+        {
+            const auto deadline = p_deadline <= m_start ? 0 : ticks_until(p_deadline - m_start, true);
+            std::function<void()> callback(std::forward<Fn>(p_fn));
+
+            std::scoped_lock lock(m_mutex);
+            return m_core.insert(deadline, std::move(callback));
+        }
+
+        /// <summary>
+        /// Schedule a callback to run once the given delay has passed.
+        /// </summary>
+        template <typename Fn>
+        timer_handle schedule_after(duration p_delay, Fn&& p_fn)
+        {
+            return schedule_at(m_clock.now() + p_delay, std::forward<Fn>(p_fn));
+        }
+
+        /// <summary>
+        /// Cancel a pending timer.
+        /// </summary>
+        /// <returns>False if the timer has already expired (its callback may be running) or been
+        /// cancelled.</returns>
+        bool cancel(timer_handle p_handle) noexcept
+        {
+            std::scoped_lock lock(m_mutex);
+            return m_core.cancel(p_handle);
+        }
+
+        /// <summary>
+        /// Expire every timer whose deadline has passed according to the clock and dispatch the
+        /// callbacks.
+        /// </summary>
+        /// <returns>The number of callbacks dispatched.</returns>
+        std::size_t poll()
+        {
+            return advance_to(m_clock.now());
+        }
+
+        /// <summary>
+        /// Expire every timer with a deadline up to the given time and dispatch the callbacks. When
+        /// running them on the calling thread, an exception from a callback is rethrown once every
+        /// callback has run (the first, if several throw). Without an error handler, an exception
+        /// from a callback run on the executor since the last call is rethrown once they are
+        /// dispatched.
+        /// </summary>
+        /// <returns>The number of callbacks dispatched.</returns>
+        std::size_t advance_to(time_point p_now)
+        {
+            std::vector<std::function<void()>> expired;
+            {
+                std::scoped_lock lock(m_mutex);
+                if (p_now >= m_start)
+                {
+                    m_core.advance(ticks_until(p_now - m_start, false), expired);
+                }
+            }
+
+            dispatch(expired);
+            if (m_failures)
+            {
+                std::exception_ptr failure;
+                {
+                    std::scoped_lock lock(m_failures->m_mutex);
+                    failure = std::exchange(m_failures->m_first, nullptr);
+                }
+
+                if (failure)
+                {
+                    std::rethrow_exception(failure);
+                }
+            }
+
+            return expired.size();
+        }
+
+        /// <summary>
+        /// A time no later than the earliest pending deadline, for deciding how long to sleep before
+        /// polling, or nothing if there are no timers.
+        /// </summary>
+        std::optional<time_point> next_expiry() const
+        {
+            std::scoped_lock lock(m_mutex);
+            const auto tick = m_core.next_deadline();
+            return tick.has_value() ? std::optional(m_start + static_cast<typename duration::rep>(*tick) * m_resolution) : std::nullopt;
+        }
+
+        /// <summary>
+        /// The number of pending timers.
+        /// </summary>
+        std::size_t size() const
+        {
+            std::scoped_lock lock(m_mutex);
+            return m_core.size();
+        }
+
+    private:
+        std::uint64_t ticks_until(duration p_elapsed, bool p_roundUp) const noexcept
+        {
+            const auto ticks = p_elapsed / m_resolution;
+            const auto partial = p_roundUp && p_elapsed % m_resolution != duration::zero();
+            return static_cast<std::uint64_t>(ticks) + (partial ? 1 : 0);
+        }
+
+        /// <summary>
+        /// The first exception from a callback run on the executor, for a wheel without an error
+        /// handler.
+        /// </summary>
+        struct pool_failures
+        {
+            std::mutex m_mutex;
+            std::exception_ptr m_first;
+        };
+
+        static void run_inline(std::vector<std::function<void()>>& p_callbacks)
+        {
+            std::exception_ptr first;
+            for (auto& callback : p_callbacks)
+            {
+                try
+                {
+                    callback();
+                }
+                catch (...)
+                {
+                    if (!first)
+                    {
+                        first = std::current_exception();
+                    }
+                }
+            }
+
+            if (first)
+            {
+                std::rethrow_exception(first);
+            }
+        }
+
+        void dispatch(std::vector<std::function<void()>>& p_expired)
+        {
+            if (m_executor == nullptr)
+            {
+                run_inline(p_expired);
+                return;
+            }
+
+            for (std::size_t begin = 0; begin < p_expired.size(); begin += m_batchSize)
+            {
+                const auto end = std::min(p_expired.size(), begin + m_batchSize);
+
+                // Shared with the task, so that the batch is still here if the submit throws.
+                auto batch = std::make_shared<std::vector<std::function<void()>>>(
+                    std::make_move_iterator(p_expired.begin() + static_cast<std::ptrdiff_t>(begin)),
+                    std::make_move_iterator(p_expired.begin() + static_cast<std::ptrdiff_t>(end)));
+
+                try
+                {
+                    m_executor->submit([batch, onError = m_onError]
+                        {
+                            for (const auto& callback : *batch)
+                            {
+                                try
+                                {
+                                    callback();
+                                }
+                                catch (...)
+                                {
+                                    onError(std::current_exception());
+                                }
+                            }
+                        });
+                }
+                catch (...)
+                {
+                    batch->insert(batch->end(),
+                        std::make_move_iterator(p_expired.begin() + static_cast<std::ptrdiff_t>(end)),
+                        std::make_move_iterator(p_expired.end()));
+                    run_inline(*batch);
+                    return;
+                }
+            }
+        }
+
+        thread_pool* m_executor;
+        duration m_resolution;
+        Clock m_clock;
+        std::size_t m_batchSize;
+        time_point m_start;
+        mutable std::mutex m_mutex;
+        detail::timer_wheel_core m_core;
+        std::function<void(std::exception_ptr)> m_onError;
+        std::shared_ptr<pool_failures> m_failures;
+    };
+}
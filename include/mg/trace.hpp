@@ -0,0 +1,102 @@
+#pragma once
+
+#include "detail/trace.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+/// <summary>
+/// Set to 1 (for example with the MG_ENABLE_TRACING CMake option) to compile MG_TRACE_ZONE in. When
+/// 0 it expands to nothing. The zone type and the session functions are always available.
+/// </summary>
+#ifndef MG_ENABLE_TRACING
+#define MG_ENABLE_TRACING 0
+#endif
+
+namespace mg::trace
+{
+    /// <summary>
+    /// Whether MG_TRACE_ZONE is compiled in.
+    /// </summary>
+    inline constexpr bool enabled = MG_ENABLE_TRACING != 0;
+
+    /// <summary>
+    /// Start recording zones to a file in the Chrome trace event format, which can be opened in
+    /// chrome://tracing or ui.perfetto.dev. A background thread writes out the events buffered by
+    /// each thread at the given interval. The session is stopped at exit if still running.
+    /// </summary>
+    /// <exception cref="std::logic_error">Thrown if a session is already running.</exception>
+    /// <exception cref="std::runtime_error">Thrown if the file cannot be opened.</exception>
+    inline void start(const std::filesystem::path& p_path, std::chrono::milliseconds p_flushInterval = std::chrono::milliseconds(100))
+    {
+        detail::trace_registry::instance().start(p_path, p_flushInterval);
+    }
+
+    /// <summary>
+    /// Stop the session, writing out the remaining events and closing the file. Does nothing if no
+    /// session is running.
+    /// </summary>
+    inline void stop()
+    {
+        detail::trace_registry::instance().stop();
+    }
+
+    /// <summary>
+    /// Whether a session is running.
+    /// </summary>
+    inline bool active() noexcept
+    {
+        return (detail::trace_generation.load(std::memory_order_relaxed) & 1) != 0;
+    }
+
+    /// <summary>
+    /// Records the lifetime of the enclosing scope as a begin and end event on the current thread.
+    /// When no session is running this costs a single relaxed load.
+    /// </summary>
+    /// <remarks>The name is not copied, so it must outlive the session (a string literal). Zones
+    /// must be destroyed in the reverse order of their construction, as scoped variables are. If a
+    /// thread's buffer is full the whole zone is dropped, and counted in the file's otherData.</remarks>
+    class zone
+    {
+    public:
+        explicit zone(const char* p_name)
+            : m_name(p_name),
+            m_generation(detail::trace_generation.load(std::memory_order_relaxed)),
+            m_buffer((m_generation & 1) != 0 ? detail::trace_begin(p_name, m_generation) : nullptr)
+        {
+        }
+
+        zone(const zone&) = delete;
+        zone& operator=(const zone&) = delete;
+
+        ~zone()
+        {
+            if (m_buffer != nullptr)
+            {
+                detail::trace_end(m_buffer, m_name, m_generation);
+            }
+        }
+
+    private:
+        const char* m_name;
+        std::uint32_t m_generation;
+        detail::trace_thread_buffer* m_buffer;
+    };
+}
+
+#define MG_TRACE_CONCAT_IMPL(a, b) a##b
+#define MG_TRACE_CONCAT(a, b) MG_TRACE_CONCAT_IMPL(a, b)
+
+#if MG_ENABLE_TRACING
+
+/// <summary>
+/// Trace the rest of the enclosing scope as a zone with the given (string literal) name.
+/// </summary>
+#define MG_TRACE_ZONE(name) const ::mg::trace::zone MG_TRACE_CONCAT(mg_trace_zone_, __LINE__){ name }
+
+#else
+
+#define MG_TRACE_ZONE(name) static_assert(true)
+
+#endif
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "collections.hpp"
+#include "detail/type_map.hpp"
+#include "sequence.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// Heterogeneous storage holding at most one value of each of a fixed set of types, such as
+    /// per-type singletons or caches: the compile time counterpart of an unordered_map from
+    /// std::type_index to std::any. Each type's slot is found through type_sequence::index_of, so
+    /// an access is a member at a constant offset with no hashing, allocation or cast.
+    /// </summary>
+    /// <remarks>Slots start empty and are constructed on first use by get(), or explicitly by
+    /// emplace(). For slots constructed on first use by several threads, see concurrent_type_map.</remarks>
+    /// <typeparam name="...Ts">The distinct, unqualified object types which may be stored.</typeparam>
+    /// <example><code>
+    /// mg::type_map&lt;texture_cache, shader_cache, font_cache&gt; caches;
+    /// caches.get&lt;shader_cache&gt;().load("blur");
+    /// caches.for_each([](auto&amp; p_cache) { p_cache.trim(); });
+    /// </code></example>
+    template <typename... Ts>
+    class type_map
+    {
+    public:
+        using types = type_sequence<Ts...>;
+
+        static_assert(((types::template count<Ts> == 1) && ...), "The types of a type_map must be distinct.");
+        static_assert(((std::is_object_v<Ts> && !std::is_const_v<Ts> && !std::is_volatile_v<Ts>) && ...), "The types of a type_map must be unqualified object types.");
+
+        /// <summary>
+        /// Whether a type is one of the types of the map.
+        /// </summary>
+        template <typename T>
+        static constexpr bool holds = types::template contains<T>;
+
+        /// <summary>
+        /// Whether the slot of a type has been constructed.
+        /// </summary>
+        template <typename T>
+            requires holds<T>
+        bool contains() const noexcept
+        {
+            return slot<T>().has_value();
+        }
+
+        /// <summary>
+        /// The value of a type, default constructed if the slot is empty.
+        /// </summary>
+        template <typename T>
+            requires holds<T> && std::default_initializable<T>
+        T& get()
+        {
+            auto& value = slot<T>();
+            if (!value.has_value())
+            {
+                value.emplace();
+            }
+
+            return *value;
+        }
+
+        /// <summary>
+        /// The value of a type, constructed from the given arguments if the slot is empty. The
+        /// arguments are unused otherwise.
+        /// </summary>
+        template <typename T, typename... Args>
+            requires holds<T> && std::constructible_from<T, Args&&...>
+        T& get_or_emplace(Args&&... p_args)
+        {
+            auto& value = slot<T>();
+            if (!value.has_value())
+            {
+                value.emplace(std::forward<Args>(p_args)...);
+            }
+
+            return *value;
+        }
+
+        /// <summary>
+        /// Construct the value of a type from the given arguments, replacing any existing value.
+        /// </summary>
+        template <typename T, typename... Args>
+            requires holds<T> && std::constructible_from<T, Args&&...>
+        T& emplace(Args&&... p_args)
+        {
+            return slot<T>().emplace(std::forward<Args>(p_args)...);
+        }
+
+        /// <summary>
+        /// The value of a type, or null if the slot is empty.
+        /// </summary>
+        template <typename T>
+            requires holds<T>
+        T* find() noexcept
+        {
+            return detail::slot_value(slot<T>());
+        }
+
+        template <typename T>
+            requires holds<T>
+        const T* find() const noexcept
+        {
+            return detail::slot_value(slot<T>());
+        }
+
+        /// <summary>
+        /// Destroy the value of a type, if there is one.
+        /// </summary>
+        template <typename T>
+            requires holds<T>
+        void reset() noexcept
+        {
+            slot<T>().reset();
+        }
+
+        void clear() noexcept
+        {
+            (reset<Ts>(), ...);
+        }
+
+        /// <summary>
+        /// The number of slots which have been constructed.
+        /// </summary>
+        std::size_t size() const noexcept
+        {
+            return (std::size_t(contains<Ts>()) + ... + 0);
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        /// <summary>
+        /// Invoke a callable on the value of every constructed slot, in the order of the types. As
+        /// with iter_zipped_tuples, the callable may return a bool to signal whether to continue.
+        /// </summary>
+        /// <returns>False if the callable signaled iteration to stop and true otherwise.</returns>
+        template <typename Fn>
+        bool for_each(Fn&& p_fn)
+        {
+            return iter_zipped_tuples(detail::present_slots(p_fn), m_slots);
+        }
+
+        template <typename Fn>
+        bool for_each(Fn&& p_fn) const
+        {
+            return iter_zipped_tuples(detail::present_slots(p_fn), m_slots);
+        }
+
+    private:
+        template <typename T>
+        std::optional<T>& slot() noexcept
+        {
+            return std::get<types::template index_of<T>>(m_slots);
+        }
+
+        template <typename T>
+        const std::optional<T>& slot() const noexcept
+        {
+            return std::get<types::template index_of<T>>(m_slots);
+        }
+
+        std::tuple<std::optional<Ts>...> m_slots;
+    };
+
+    /// <summary>
+    /// A type_map whose slots may be constructed on first use by several threads at once: each is
+    /// constructed exactly once, and found without locking once it has been. Slots cannot be
+    /// replaced or destroyed until the map is, and the values themselves are not synchronized.
+    /// </summary>
+    /// <typeparam name="...Ts">The distinct, unqualified object types which may be stored.</typeparam>
+    /// <example><code>
+    /// mg::concurrent_type_map&lt;metrics_registry, codec_table&gt; globals;
+    /// pool.parallel_for(requests, 64, [&amp;](const request&amp; p_request)
+    /// {
+    ///     globals.get&lt;codec_table&gt;().decode(p_request);
+    /// });
+    /// </code></example>
+    template <typename... Ts>
+    class concurrent_type_map
+    {
+    public:
+        using types = type_sequence<Ts...>;
+
+        static_assert(((types::template count<Ts> == 1) && ...), "The types of a concurrent_type_map must be distinct.");
+        static_assert(((std::is_object_v<Ts> && !std::is_const_v<Ts> && !std::is_volatile_v<Ts>) && ...), "The types of a concurrent_type_map must be unqualified object types.");
+
+        template <typename T>
+        static constexpr bool holds = types::template contains<T>;
+
+        concurrent_type_map() = default;
+
+        concurrent_type_map(const concurrent_type_map&) = delete;
+        concurrent_type_map& operator=(const concurrent_type_map&) = delete;
+
+        template <typename T>
+            requires holds<T>
+        bool contains() const noexcept
+        {
+            return slot<T>().find() != nullptr;
+        }
+
+        /// <summary>
+        /// The value of a type, default constructed if no thread has yet constructed it.
+        /// </summary>
+        template <typename T>
+            requires holds<T> && std::default_initializable<T>
+        T& get()
+        {
+            return slot<T>().get_or_make([] { return T(); });
+        }
+
+        /// <summary>
+        /// The value of a type, constructed from the given arguments if no thread has yet
+        /// constructed it. The arguments are unused otherwise.
+        /// </summary>
+        template <typename T, typename... Args>
+            requires holds<T> && std::constructible_from<T, Args&&...>
+        T& get_or_emplace(Args&&... p_args)
+        {
+            return slot<T>().get_or_make([&] { return T(std::forward<Args>(p_args)...); });
+        }
+
+        template <typename T>
+            requires holds<T>
+        T* find() noexcept
+        {
+            return slot<T>().find();
+        }
+
+        template <typename T>
+            requires holds<T>
+        const T* find() const noexcept
+        {
+            return slot<T>().find();
+        }
+
+        /// <summary>
+        /// Invoke a callable on the value of every slot constructed so far, in the order of the
+        /// types, stopping if it returns false.
+        /// </summary>
+        template <typename Fn>
+        bool for_each(Fn&& p_fn)
+        {
+            return iter_zipped_tuples(detail::present_slots(p_fn), m_slots);
+        }
+
+        template <typename Fn>
+        bool for_each(Fn&& p_fn) const
+        {
+            return iter_zipped_tuples(detail::present_slots(p_fn), m_slots);
+        }
+
+    private:
+        template <typename T>
+        detail::concurrent_type_slot<T>& slot() noexcept
+        {
+            return std::get<types::template index_of<T>>(m_slots);
+        }
+
+        template <typename T>
+        const detail::concurrent_type_slot<T>& slot() const noexcept
+        {
+            return std::get<types::template index_of<T>>(m_slots);
+        }
+
+        std::tuple<detail::concurrent_type_slot<Ts>...> m_slots;
+    };
+}
@@ -24,6 +24,10 @@ namespace mg
             {
                 return std::get<Idx>(std::forward<T>(p_arg));
             }
+            else if constexpr (requires { std::forward<T>(p_arg).template get<Idx>(); })
+            {
+                return std::forward<T>(p_arg).template get<Idx>();
+            }
             else if constexpr (requires { std::forward<T>(p_arg)[Idx]; })
             {
                 return std::forward<T>(p_arg)[Idx];
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "detail/views.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mg
+{
+    /// <summary>
+    /// A view over several random access ranges in parallel, which is the runtime counterpart of
+    /// iter_zipped_tuples. Iteration stops at the end of the shortest range, whose length is computed
+    /// once when the view is created. Dereferencing an iterator yields a tuple of the references of
+    /// each range so elements can be modified in place, which means the iterators are proxy
+    /// iterators (in the same way as std::vector&lt;bool&gt;). To stop iteration early from a
+    /// callable, see iter_zipped_ranges.
+    /// </summary>
+    /// <typeparam name="...Views">The views being zipped.</typeparam>
+    template <std::ranges::view... Views>
+        requires (sizeof...(Views) > 0 && ((std::ranges::random_access_range<Views> && std::ranges::sized_range<Views>) && ...))
+    class zip_view : public std::ranges::view_interface<zip_view<Views...>>
+    {
+        template <bool Const>
+        class basic_iterator;
+
+    public:
+        zip_view() = default;
+
+        constexpr explicit zip_view(Views... p_views)
+            : m_views(std::move(p_views)...),
+            m_size(std::apply(
+                [](auto&... p_inner) { return std::min({ static_cast<std::size_t>(std::ranges::size(p_inner))... }); },
+                m_views))
+        {
+        }
+
+        constexpr auto begin() { return basic_iterator<false>(*this, 0); }
+        constexpr auto end() { return basic_iterator<false>(*this, static_cast<std::ptrdiff_t>(m_size)); }
+
+        constexpr auto begin() const
+            requires ((std::ranges::random_access_range<const Views>) && ...)
+        {
+            return basic_iterator<true>(*this, 0);
+        }
+
+        constexpr auto end() const
+            requires ((std::ranges::random_access_range<const Views>) && ...)
+        {
+            return basic_iterator<true>(*this, static_cast<std::ptrdiff_t>(m_size));
+        }
+
+        constexpr std::size_t size() const noexcept { return m_size; }
+        constexpr bool empty() const noexcept { return m_size == 0; }
+
+        constexpr decltype(auto) operator[](std::size_t p_idx) { return begin()[static_cast<std::ptrdiff_t>(p_idx)]; }
+
+    private:
+        std::tuple<Views...> m_views;
+        std::size_t m_size = 0;
+    };
+
+    template <std::ranges::view... Views>
+        requires (sizeof...(Views) > 0 && ((std::ranges::random_access_range<Views> && std::ranges::sized_range<Views>) && ...))
+    template <bool Const>
+    class zip_view<Views...>::basic_iterator
+    {
+        using parent = detail::maybe_const<Const, zip_view>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::tuple<std::ranges::range_value_t<detail::maybe_const<Const, Views>>...>;
+        using reference = std::tuple<std::ranges::range_reference_t<detail::maybe_const<Const, Views>>...>;
+        using difference_type = std::ptrdiff_t;
+
+        basic_iterator() = default;
+
+        constexpr basic_iterator(parent& p_parent, difference_type p_idx)
+            : m_begins(std::apply([](auto&... p_views) { return std::tuple(std::ranges::begin(p_views)...); }, p_parent.m_views)),
+            m_idx(p_idx)
+        {
+        }
+
+        constexpr reference operator*() const
+        {
+            return std::apply(
+                [this](const auto&... p_begins) { return reference(p_begins[m_idx]...); },
+                m_begins);
+        }
+
+        constexpr reference operator[](difference_type p_offset) const { return *(*this + p_offset); }
+
+        constexpr basic_iterator& operator++() noexcept { ++m_idx; return *this; }
+        constexpr basic_iterator operator++(int) noexcept { auto copy = *this; ++m_idx; return copy; }
+        constexpr basic_iterator& operator--() noexcept { --m_idx; return *this; }
+        constexpr basic_iterator operator--(int) noexcept { auto copy = *this; --m_idx; return copy; }
+        constexpr basic_iterator& operator+=(difference_type p_offset) noexcept { m_idx += p_offset; return *this; }
+        constexpr basic_iterator& operator-=(difference_type p_offset) noexcept { m_idx -= p_offset; return *this; }
+
+        friend constexpr basic_iterator operator+(basic_iterator p_it, difference_type p_offset) noexcept { return p_it += p_offset; }
+        friend constexpr basic_iterator operator+(difference_type p_offset, basic_iterator p_it) noexcept { return p_it += p_offset; }
+        friend constexpr basic_iterator operator-(basic_iterator p_it, difference_type p_offset) noexcept { return p_it -= p_offset; }
+        friend constexpr difference_type operator-(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx - p_rhs.m_idx; }
+
+        friend constexpr bool operator==(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx == p_rhs.m_idx; }
+        friend constexpr auto operator<=>(const basic_iterator& p_lhs, const basic_iterator& p_rhs) noexcept { return p_lhs.m_idx <=> p_rhs.m_idx; }
+
+    private:
+        std::tuple<std::ranges::iterator_t<detail::maybe_const<Const, Views>>...> m_begins;
+        difference_type m_idx = 0;
+    };
+
+    /// <summary>
+    /// A view over a random access range in fixed size chunks, which is the runtime counterpart of
+    /// iter_n. Only whole chunks are visited by iteration, and any trailing elements which do not fill
+    /// a whole chunk are available through remainder().
+    ///
+    /// When the underlying range is contiguous each chunk is a std::span with a static extent of N,
+    /// so a loop over the elements of a chunk has a compile time trip count and can be fully unrolled
+    /// and vectorized. Otherwise each chunk is a subrange of N elements.
+    /// </summary>
+    /// <typeparam name="View">The view being chunked.</typeparam>
+    /// <typeparam name="N">The number of elements in each chunk.</typeparam>
+    template <std::ranges::view View, std::size_t N>
+        requires (N > 0 && std::ranges::random_access_range<View> && std::ranges::sized_range<View>)
+    class chunk_view : public std::ranges::view_interface<chunk_view<View, N>>
+    {
+        template <bool Const>
+        class basic_iterator;
+
+    public:
+        static constexpr std::size_t chunk_size = N;
+
+        chunk_view() = default;
+
+        constexpr explicit chunk_view(View p_view)
+            : m_view(std::move(p_view))
+        {
+        }
+
+        constexpr auto begin() { return basic_iterator<false>(std::ranges::begin(m_view)); }
+        constexpr auto end() { return begin() + static_cast<std::ptrdiff_t>(size()); }
+
+        constexpr auto begin() const
+            requires std::ranges::random_access_range<const View>
+        {
+            return basic_iterator<true>(std::ranges::begin(m_view));
+        }
+
+        constexpr auto end() const
+            requires std::ranges::random_access_range<const View>
+        {
+            return begin() + static_cast<std::ptrdiff_t>(size());
+        }
+
+        /// <summary>
+        /// The number of whole chunks in the view.
+        /// </summary>
+        constexpr std::size_t size() const
+        {
+            return static_cast<std::size_t>(std::ranges::size(m_view)) / N;
+        }
+
+        /// <summary>
+        /// The trailing elements which did not fill a whole chunk. Always has fewer than N elements.
+        /// </summary>
+        constexpr auto remainder()
+        {
+            return detail::make_dynamic_chunk(std::ranges::begin(m_view) + static_cast<std::ptrdiff_t>(size() * N), std::ranges::size(m_view) % N);
+        }
+
+        constexpr auto remainder() const
+            requires std::ranges::random_access_range<const View>
+        {
+            return detail::make_dynamic_chunk(std::ranges::begin(m_view) + static_cast<std::ptrdiff_t>(size() * N), std::ranges::size(m_view) % N);
+        }
+
+        constexpr View base() const& { return m_view; }
+        constexpr View base() && { return std::move(m_view); }
+
+    private:
+        View m_view;
+    };
+
+    template <std::ranges::view View, std::size_t N>
+        requires (N > 0 && std::ranges::random_access_range<View> && std::ranges::sized_range<View>)
+    template <bool Const>
+    class chunk_view<View, N>::basic_iterator
+    {
+        using base_iterator = std::ranges::iterator_t<detail::maybe_const<Const, View>>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = decltype(detail::make_static_chunk<N>(std::declval<base_iterator>()));
+        using reference = value_type;
+        using difference_type = std::ptrdiff_t;
+
+        basic_iterator() = default;
+
+        constexpr explicit basic_iterator(base_iterator p_it)
+            : m_it(std::move(p_it))
+        {
+        }
+
+        constexpr reference operator*() const { return detail::make_static_chunk<N>(m_it); }
+        constexpr reference operator[](difference_type p_offset) const { return *(*this + p_offset); }
+
+        constexpr basic_iterator& operator++() { m_it += Stride; return *this; }
+        constexpr basic_iterator operator++(int) { auto copy = *this; ++*this; return copy; }
+        constexpr basic_iterator& operator--() { m_it -= Stride; return *this; }
+        constexpr basic_iterator operator--(int) { auto copy = *this; --*this; return copy; }
+        constexpr basic_iterator& operator+=(difference_type p_offset) { m_it += p_offset * Stride; return *this; }
+        constexpr basic_iterator& operator-=(difference_type p_offset) { m_it -= p_offset * Stride; return *this; }
+
+        friend constexpr basic_iterator operator+(basic_iterator p_it, difference_type p_offset) { return p_it += p_offset; }
+        friend constexpr basic_iterator operator+(difference_type p_offset, basic_iterator p_it) { return p_it += p_offset; }
+        friend constexpr basic_iterator operator-(basic_iterator p_it, difference_type p_offset) { return p_it -= p_offset; }
+        friend constexpr difference_type operator-(const basic_iterator& p_lhs, const basic_iterator& p_rhs) { return (p_lhs.m_it - p_rhs.m_it) / Stride; }
+
+        friend constexpr bool operator==(const basic_iterator& p_lhs, const basic_iterator& p_rhs) { return p_lhs.m_it == p_rhs.m_it; }
+        friend constexpr auto operator<=>(const basic_iterator& p_lhs, const basic_iterator& p_rhs) { return p_lhs.m_it <=> p_rhs.m_it; }
+
+    private:
+        static constexpr difference_type Stride = static_cast<difference_type>(N);
+
+        base_iterator m_it{};
+    };
+}
+
+namespace mg::detail
+{
+    struct zip_fn
+    {
+        template <std::ranges::viewable_range... Ranges>
+        constexpr auto operator()(Ranges&&... p_ranges) const
+        {
+            return zip_view<std::views::all_t<Ranges>...>(std::views::all(std::forward<Ranges>(p_ranges))...);
+        }
+    };
+
+    template <std::size_t N>
+    struct chunk_fn
+    {
+        template <std::ranges::viewable_range Range>
+        constexpr auto operator()(Range&& p_range) const
+        {
+            return chunk_view<std::views::all_t<Range>, N>(std::views::all(std::forward<Range>(p_range)));
+        }
+
+        template <std::ranges::viewable_range Range>
+        friend constexpr auto operator|(Range&& p_range, const chunk_fn& p_chunk)
+        {
+            return p_chunk(std::forward<Range>(p_range));
+        }
+    };
+}
+
+namespace mg::views
+{
+    /// <summary>
+    /// Zip a set of random access, sized ranges together, as in zip(lhs, rhs). See mg::zip_view.
+    /// L-values are referenced and r-values are owned by the view.
+    /// </summary>
+    inline constexpr detail::zip_fn zip{};
+
+    /// <summary>
+    /// View a random access, sized range in chunks of N elements, either as chunk&lt;N&gt;(range) or
+    /// as a pipe, range | chunk&lt;N&gt;, so that it composes with the standard adaptors. See
+    /// mg::chunk_view. L-values are referenced and r-values are owned by the view.
+    /// </summary>
+    /// <typeparam name="N">The number of elements in each chunk.</typeparam>
+    template <std::size_t N>
+    inline constexpr detail::chunk_fn<N> chunk{};
+}
@@ -0,0 +1,529 @@
+#pragma once
+
+#include "detail/wide_int.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace mg
+{
+    /// <summary>
+    /// A fixed width integer of 128 to 4096 bits, for arithmetic beyond the built-in types without
+    /// the heap allocation of arbitrary precision libraries. It behaves like the built-in integers
+    /// of its signedness: two's complement, wrapping on overflow, division truncating toward zero.
+    /// Everything is constexpr and held inline, so values can be computed at compile time and live
+    /// on the stack.
+    /// </summary>
+    /// <remarks>Additions use add with carry and multiplications the full 64 bit product (mulx
+    /// where BMI2 is enabled), through intrinsics at run time and portable code in constant
+    /// evaluation. Products of 2048 bits and more use Karatsuba multiplication (see
+    /// detail::mul_full), and division is Knuth's algorithm D.</remarks>
+    /// <remarks>numeric_limits is specialized, so the types are accepted wherever the library
+    /// takes integers, such as whole_pow. The wide overloads of mul_mod and mod_pow are declared
+    /// below, so that math.hpp does not need this header.</remarks>
+    /// <typeparam name="Bits">The width, a multiple of 64 from 128 to 4096.</typeparam>
+    /// <typeparam name="Signed">Whether the value is two's complement signed.</typeparam>
+    /// <example><code>
+    /// constexpr auto big = mg::whole_pow(mg::wide_uint&lt;256&gt;(3), mg::wide_uint&lt;256&gt;(150));
+    /// std::cout &lt;&lt; mg::to_string(big % 1'000'000'007) &lt;&lt; '\n';
+    /// </code></example>
+    template <std::size_t Bits, bool Signed>
+    class basic_wide_int
+    {
+        static_assert(Bits >= 128 && Bits <= 4096 && Bits % 64 == 0, "The width of a wide integer must be a multiple of 64 from 128 to 4096 bits.");
+
+        template <std::size_t, bool>
+        friend class basic_wide_int;
+
+    public:
+        static constexpr std::size_t bits = Bits;
+        static constexpr std::size_t limb_count = Bits / 64;
+        static constexpr bool is_signed = Signed;
+
+        constexpr basic_wide_int() noexcept = default;
+
+        /// <summary>
+        /// Convert a built-in integer, sign extending it if it is signed.
+        /// </summary>
+        template <std::integral T>
+            requires (!std::same_as<T, bool>)
+        constexpr basic_wide_int(T p_value) noexcept
+        {
+            m_limbs[0] = static_cast<std::uint64_t>(p_value);
+            if constexpr (std::is_signed_v<T>)
+            {
+                if (p_value < 0)
+                {
+                    std::fill(m_limbs.begin() + 1, m_limbs.end(), ~std::uint64_t(0));
+                }
+            }
+        }
+
+        /// <summary>
+        /// Convert another wide integer, sign extending or truncating. Implicit only where every
+        /// value is preserved.
+        /// </summary>
+        template <std::size_t OtherBits, bool OtherSigned>
+            requires (OtherBits != Bits || OtherSigned != Signed)
+        constexpr explicit(!((OtherSigned == Signed && OtherBits <= Bits) || (Signed && !OtherSigned && OtherBits < Bits)))
+            basic_wide_int(const basic_wide_int<OtherBits, OtherSigned>& p_other) noexcept
+        {
+            constexpr auto common = std::min(limb_count, basic_wide_int<OtherBits, OtherSigned>::limb_count);
+            std::copy(p_other.m_limbs.begin(), p_other.m_limbs.begin() + common, m_limbs.begin());
+            if (p_other.negative())
+            {
+                std::fill(m_limbs.begin() + common, m_limbs.end(), ~std::uint64_t(0));
+            }
+        }
+
+        /// <summary>
+        /// The limbs of the two's complement representation, least significant first.
+        /// </summary>
+        constexpr const std::array<std::uint64_t, limb_count>& limbs() const noexcept
+        {
+            return m_limbs;
+        }
+
+        static constexpr basic_wide_int from_limbs(const std::array<std::uint64_t, limb_count>& p_limbs) noexcept
+        {
+            basic_wide_int result;
+            result.m_limbs = p_limbs;
+            return result;
+        }
+
+        /// <summary>
+        /// Truncate to a built-in integer, as converting between built-in integers does.
+        /// </summary>
+        template <std::integral T>
+        explicit constexpr operator T() const noexcept
+        {
+            if constexpr (std::same_as<T, bool>)
+            {
+                return !is_zero();
+            }
+            else
+            {
+                return static_cast<T>(m_limbs[0]);
+            }
+        }
+
+        /// <summary>
+        /// The number of bits needed to represent the magnitude of the value.
+        /// </summary>
+        constexpr std::size_t bit_width() const noexcept
+        {
+            const auto magnitude = negative() ? -*this : *this;
+            const auto used = detail::significant_limbs(magnitude.m_limbs.data(), limb_count);
+            return used == 0 ? 0 : (used - 1) * 64 + static_cast<std::size_t>(std::bit_width(magnitude.m_limbs[used - 1]));
+        }
+
+        constexpr basic_wide_int& operator+=(const basic_wide_int& p_rhs) noexcept
+        {
+            detail::add_limbs(m_limbs.data(), p_rhs.m_limbs.data(), limb_count);
+            return *this;
+        }
+
+        constexpr basic_wide_int& operator-=(const basic_wide_int& p_rhs) noexcept
+        {
+            detail::sub_limbs(m_limbs.data(), p_rhs.m_limbs.data(), limb_count);
+            return *this;
+        }
+
+        constexpr basic_wide_int& operator*=(const basic_wide_int& p_rhs) noexcept
+        {
+            // The low half of the product is the same for signed and unsigned operands.
+            std::array<std::uint64_t, limb_count> product{};
+            detail::mul_low<limb_count>(m_limbs.data(), p_rhs.m_limbs.data(), product.data());
+            m_limbs = product;
+            return *this;
+        }
+
+        /// <exception cref="std::domain_error">Thrown if the divisor is zero.</exception>
+        constexpr basic_wide_int& operator/=(const basic_wide_int& p_rhs)
+        {
+            divide(p_rhs, this, nullptr);
+            return *this;
+        }
+
+        /// <exception cref="std::domain_error">Thrown if the divisor is zero.</exception>
+        constexpr basic_wide_int& operator%=(const basic_wide_int& p_rhs)
+        {
+            divide(p_rhs, nullptr, this);
+            return *this;
+        }
+
+        constexpr basic_wide_int& operator&=(const basic_wide_int& p_rhs) noexcept
+        {
+            for (std::size_t i = 0; i < limb_count; ++i)
+            {
+                m_limbs[i] &= p_rhs.m_limbs[i];
+            }
+
+            return *this;
+        }
+
+        constexpr basic_wide_int& operator|=(const basic_wide_int& p_rhs) noexcept
+        {
+            for (std::size_t i = 0; i < limb_count; ++i)
+            {
+                m_limbs[i] |= p_rhs.m_limbs[i];
+            }
+
+            return *this;
+        }
+
+        constexpr basic_wide_int& operator^=(const basic_wide_int& p_rhs) noexcept
+        {
+            for (std::size_t i = 0; i < limb_count; ++i)
+            {
+                m_limbs[i] ^= p_rhs.m_limbs[i];
+            }
+
+            return *this;
+        }
+
+        /// <summary>
+        /// Shift left, giving zero rather than undefined behaviour for shifts of the width or more.
+        /// </summary>
+        constexpr basic_wide_int& operator<<=(std::size_t p_shift) noexcept
+        {
+            const auto whole = std::min(p_shift / 64, limb_count);
+            const auto part = p_shift % 64;
+            for (auto i = limb_count; i-- > 0;)
+            {
+                const auto source = i >= whole ? i - whole : limb_count;
+                const auto low = source < limb_count ? m_limbs[source] : 0;
+                const auto carried = part != 0 && source >= 1 && source < limb_count ? m_limbs[source - 1] >> (64 - part) : 0;
+                m_limbs[i] = low << part | carried;
+            }
+
+            return *this;
+        }
+
+        /// <summary>
+        /// Shift right, arithmetically if signed, giving zero (or minus one) for shifts of the
+        /// width or more.
+        /// </summary>
+        constexpr basic_wide_int& operator>>=(std::size_t p_shift) noexcept
+        {
+            const auto fill = negative() ? ~std::uint64_t(0) : 0;
+            const auto whole = std::min(p_shift / 64, limb_count);
+            const auto part = p_shift % 64;
+            for (std::size_t i = 0; i < limb_count; ++i)
+            {
+                const auto source = i + whole;
+                const auto high = source < limb_count ? m_limbs[source] : fill;
+                const auto next = source + 1 < limb_count ? m_limbs[source + 1] : fill;
+                m_limbs[i] = part == 0 ? high : high >> part | next << (64 - part);
+            }
+
+            return *this;
+        }
+
+        constexpr basic_wide_int& operator++() noexcept
+        {
+            detail::add_carry_limbs(m_limbs.data(), limb_count, 1);
+            return *this;
+        }
+
+        constexpr basic_wide_int operator++(int) noexcept
+        {
+            auto previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        constexpr basic_wide_int& operator--() noexcept
+        {
+            return *this -= basic_wide_int(1);
+        }
+
+        constexpr basic_wide_int operator--(int) noexcept
+        {
+            auto previous = *this;
+            --*this;
+            return previous;
+        }
+
+        constexpr basic_wide_int operator+() const noexcept
+        {
+            return *this;
+        }
+
+        constexpr basic_wide_int operator-() const noexcept
+        {
+            return basic_wide_int() - *this;
+        }
+
+        constexpr basic_wide_int operator~() const noexcept
+        {
+            auto result = *this;
+            for (auto& limb : result.m_limbs)
+            {
+                limb = ~limb;
+            }
+
+            return result;
+        }
+
+        friend constexpr basic_wide_int operator+(basic_wide_int p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            return p_lhs += p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator-(basic_wide_int p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            return p_lhs -= p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator*(basic_wide_int p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            return p_lhs *= p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator/(basic_wide_int p_lhs, const basic_wide_int& p_rhs)
+        {
+            return p_lhs /= p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator%(basic_wide_int p_lhs, const basic_wide_int& p_rhs)
+        {
+            return p_lhs %= p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator&(basic_wide_int p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            return p_lhs &= p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator|(basic_wide_int p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            return p_lhs |= p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator^(basic_wide_int p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            return p_lhs ^= p_rhs;
+        }
+
+        friend constexpr basic_wide_int operator<<(basic_wide_int p_lhs, std::size_t p_shift) noexcept
+        {
+            return p_lhs <<= p_shift;
+        }
+
+        friend constexpr basic_wide_int operator>>(basic_wide_int p_lhs, std::size_t p_shift) noexcept
+        {
+            return p_lhs >>= p_shift;
+        }
+
+        friend constexpr bool operator==(const basic_wide_int& p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            return p_lhs.m_limbs == p_rhs.m_limbs;
+        }
+
+        friend constexpr std::strong_ordering operator<=>(const basic_wide_int& p_lhs, const basic_wide_int& p_rhs) noexcept
+        {
+            if (p_lhs.negative() != p_rhs.negative())
+            {
+                return p_lhs.negative() ? std::strong_ordering::less : std::strong_ordering::greater;
+            }
+
+            // Two's complement values of the same sign order as their unsigned representations.
+            return detail::compare_limbs(p_lhs.m_limbs.data(), p_rhs.m_limbs.data(), limb_count) <=> 0;
+        }
+
+    private:
+        constexpr bool negative() const noexcept
+        {
+            return Signed && (m_limbs[limb_count - 1] >> 63) != 0;
+        }
+
+        constexpr bool is_zero() const noexcept
+        {
+            return detail::significant_limbs(m_limbs.data(), limb_count) == 0;
+        }
+
+        /// <summary>
+        /// Divide by the magnitudes and fix up the signs, so that the quotient truncates toward
+        /// zero and the remainder takes the dividend's sign.
+        /// </summary>
+        constexpr void divide(const basic_wide_int& p_divisor, basic_wide_int* p_quotient, basic_wide_int* p_remainder) const
+        {
+            if (p_divisor.is_zero())
+            {
+                throw std::domain_error("Wide integer division by zero.");
+            }
+
+            const auto dividend = negative() ? -*this : *this;
+            const auto divisor = p_divisor.negative() ? -p_divisor : p_divisor;
+            const auto quotient_negative = negative() != p_divisor.negative();
+            const auto remainder_negative = negative();
+
+            basic_wide_int quotient;
+            basic_wide_int remainder;
+            detail::divide<limb_count, limb_count>(dividend.m_limbs.data(), divisor.m_limbs.data(), quotient.m_limbs.data(), remainder.m_limbs.data());
+            if (p_quotient != nullptr)
+            {
+                *p_quotient = quotient_negative ? -quotient : quotient;
+            }
+
+            if (p_remainder != nullptr)
+            {
+                *p_remainder = remainder_negative ? -remainder : remainder;
+            }
+        }
+
+        std::array<std::uint64_t, limb_count> m_limbs{};
+    };
+
+    template <std::size_t Bits>
+    using wide_uint = basic_wide_int<Bits, false>;
+
+    template <std::size_t Bits>
+    using wide_int = basic_wide_int<Bits, true>;
+
+    /// <summary>
+    /// Format a wide integer in decimal, nineteen digits at a time.
+    /// </summary>
+    template <std::size_t Bits, bool Signed>
+    std::string to_string(const basic_wide_int<Bits, Signed>& p_value)
+    {
+        constexpr std::uint64_t chunk = 10'000'000'000'000'000'000ull;
+        using unsigned_type = basic_wide_int<Bits, false>;
+        const auto negative = p_value < basic_wide_int<Bits, Signed>(0);
+        auto magnitude = static_cast<unsigned_type>(negative ? -p_value : p_value);
+
+        std::string digits;
+        do
+        {
+            std::array<std::uint64_t, unsigned_type::limb_count> quotient{};
+            std::array<std::uint64_t, 1> remainder{};
+            const std::array<std::uint64_t, 1> divisor{ chunk };
+            detail::divide<unsigned_type::limb_count, 1>(magnitude.limbs().data(), divisor.data(), quotient.data(), remainder.data());
+            magnitude = unsigned_type::from_limbs(quotient);
+
+            auto part = remainder[0];
+            for (int i = 0; i < 19 && (part != 0 || magnitude != 0); ++i)
+            {
+                digits.push_back(static_cast<char>('0' + part % 10));
+                part /= 10;
+            }
+        } while (magnitude != 0);
+
+        if (digits.empty())
+        {
+            digits.push_back('0');
+        }
+
+        if (negative)
+        {
+            digits.push_back('-');
+        }
+
+        std::reverse(digits.begin(), digits.end());
+        return digits;
+    }
+
+    /// <summary>
+    /// Modular multiplication of wide integers, (lhs * rhs) mod modulus, through the full double
+    /// width product. See the built-in overload in math.hpp.
+    /// </summary>
+    /// <param name="p_lhs">The first factor, which must not be negative.</param>
+    /// <param name="p_rhs">The second factor, which must not be negative.</param>
+    /// <param name="p_modulus">The modulus, which must be positive.</param>
+    /// <returns>The product reduced modulo the modulus.</returns>
+    template <std::size_t Bits, bool Signed>
+    constexpr basic_wide_int<Bits, Signed> mul_mod(
+        const basic_wide_int<Bits, Signed>& p_lhs,
+        const basic_wide_int<Bits, Signed>& p_rhs,
+        const basic_wide_int<Bits, Signed>& p_modulus)
+    {
+        using type = basic_wide_int<Bits, Signed>;
+        if (p_lhs < 0 || p_rhs < 0)
+        {
+            throw std::invalid_argument("The factors must be whole numbers.");
+        }
+
+        if (p_modulus <= 0)
+        {
+            throw std::invalid_argument("The modulus must be positive.");
+        }
+
+        const auto lhs = p_lhs < p_modulus ? p_lhs : p_lhs % p_modulus;
+        const auto rhs = p_rhs < p_modulus ? p_rhs : p_rhs % p_modulus;
+        std::array<std::uint64_t, type::limb_count> result{};
+        detail::mul_mod<type::limb_count>(lhs.limbs().data(), rhs.limbs().data(), p_modulus.limbs().data(), result.data());
+        return type::from_limbs(result);
+    }
+
+    /// <summary>
+    /// Modular exponentiation of wide integers, (base ^ power) mod modulus, by four bit windows
+    /// and Montgomery multiplication for odd moduli. See the built-in overload in math.hpp.
+    /// </summary>
+    /// <param name="p_base">The base, which must not be negative.</param>
+    /// <param name="p_power">The power, which must not be negative.</param>
+    /// <param name="p_modulus">The modulus, which must be positive.</param>
+    /// <returns>The result of (base ^ power) mod modulus, where 0 ^ 0 is 1.</returns>
+    template <std::size_t Bits, bool Signed>
+    constexpr basic_wide_int<Bits, Signed> mod_pow(
+        const basic_wide_int<Bits, Signed>& p_base,
+        const basic_wide_int<Bits, Signed>& p_power,
+        const basic_wide_int<Bits, Signed>& p_modulus)
+    {
+        using type = basic_wide_int<Bits, Signed>;
+        if (p_power < 0)
+        {
+            throw std::invalid_argument("The power must be a whole number.");
+        }
+
+        // Multiplying by one validates the base and modulus and reduces the base.
+        const auto base = mul_mod(p_base, type(1), p_modulus);
+        std::array<std::uint64_t, type::limb_count> result{};
+        detail::mod_pow<type::limb_count>(base.limbs().data(), p_power.limbs().data(), type::limb_count, p_modulus.limbs().data(), result.data());
+        return type::from_limbs(result);
+    }
+}
+
+template <std::size_t Bits, bool Signed>
+class std::numeric_limits<mg::basic_wide_int<Bits, Signed>>
+{
+    using type = mg::basic_wide_int<Bits, Signed>;
+
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = Signed;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool has_infinity = false;
+    static constexpr bool has_quiet_NaN = false;
+    static constexpr bool has_signaling_NaN = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = !Signed;
+    static constexpr int radix = 2;
+    static constexpr int digits = static_cast<int>(Bits) - (Signed ? 1 : 0);
+    static constexpr int digits10 = digits * 30103 / 100000;
+
+    static constexpr type min() noexcept
+    {
+        return Signed ? type(1) << (Bits - 1) : type(0);
+    }
+
+    static constexpr type lowest() noexcept
+    {
+        return min();
+    }
+
+    static constexpr type max() noexcept
+    {
+        return ~min();
+    }
+};
@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+
+#include <mg/alloc_guard.hpp>
+
+#include <cstddef>
+
+// Counts the allocations made by each thread so that tests can assert allocation budgets with
+// mg::alloc_guard, failing the current test rather than aborting when one is exceeded.
+MG_DEFINE_ALLOC_HOOKS()
+
+namespace
+{
+    void fail_current_test(std::size_t p_allocations, std::size_t p_budget)
+    {
+        if (p_allocations == mg::alloc_guard::unknown_allocations)
+        {
+            ADD_FAILURE() << "mg::alloc_guard used without the allocation hooks installed.";
+            return;
+        }
+
+        ADD_FAILURE() << "mg::alloc_guard saw " << p_allocations << " allocations with a budget of " << p_budget << ".";
+    }
+
+    [[maybe_unused]] const auto previous_handler = mg::alloc_guard::set_violation_handler(&fail_current_test);
+}
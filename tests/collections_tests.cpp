@@ -1,11 +1,14 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <mg/alloc_guard.hpp>
 #include <mg/collections.hpp>
+#include <mg/memory.hpp>
 
 #include <array>
 #include <functional>
 #include <list>
+#include <numeric>
 #include <span>
 #include <string>
 #include <tuple>
@@ -61,6 +64,49 @@ TEST(iter_zipped_tuples, uneven_zero_length) {
     ASSERT_THAT(nums, testing::ElementsAre());
 }
 
+TEST(iter_zipped_ranges, uneven) {
+    std::vector longer{ 1, 2, 3 };
+    std::array shorter{ 4, 5 };
+
+    std::vector<int> nums;
+
+    bool completed = mg::iter_zipped_ranges(
+        [&](int i, int j)
+        {
+            nums.push_back(i);
+            nums.push_back(j);
+        },
+        longer, shorter);
+
+    EXPECT_TRUE(completed);
+    ASSERT_THAT(nums, testing::ElementsAre(1, 4, 2, 5));
+}
+
+TEST(iter_zipped_ranges, early_exit) {
+    std::vector values{ 1, 2, 3, 4 };
+    std::vector<int> seen;
+
+    bool completed = mg::iter_zipped_ranges(
+        [&](int i)
+        {
+            seen.push_back(i);
+            return i < 2;
+        },
+        values);
+
+    EXPECT_FALSE(completed);
+    ASSERT_THAT(seen, testing::ElementsAre(1, 2));
+}
+
+TEST(iter_zipped_ranges, writes_through) {
+    std::array inputs{ 1, 2, 3 };
+    std::vector<int> outputs(3);
+
+    mg::iter_zipped_ranges([](int in, int& out) { out = in * in; }, inputs, std::span(outputs));
+
+    ASSERT_THAT(outputs, testing::ElementsAre(1, 4, 9));
+}
+
 TEST(tuple_map, from_values) {
     auto mapped = mg::tuple_map(
         std::tuple{ 1, 10, 100, 1000 },
@@ -113,6 +159,16 @@ TEST(tuple_map, moved_into) {
     EXPECT_EQ(moved_into, std::make_tuple(false, false, true, true));
 }
 
+TEST(tuple_map, allocation_budget) {
+    auto values = std::tuple{ 1, 2.5, 'c' };
+    {
+        mg::alloc_guard guard;
+        auto mapped = mg::tuple_map(values, [](auto el) { return el + 1; });
+        EXPECT_EQ(guard.allocations(), 0u);
+        EXPECT_EQ(std::get<2>(mapped), 'd');
+    }
+}
+
 TEST(all_unique, empty) {
     std::array<int, 0> arr{};
     EXPECT_TRUE(mg::all_unique(std::begin(arr), std::end(arr)));
@@ -152,3 +208,22 @@ TEST(all_unique, valid_containers) {
     static_assert(has_all_unique<int[3]>);
     static_assert(has_all_unique<std::span<float>>);
 }
+
+TEST(all_unique, allocation_budget) {
+    std::vector<int> values(256);
+    std::iota(values.begin(), values.end(), 0);
+
+    // One node per element plus the bucket arrays for a rehash at most every doubling.
+    mg::allocation_stats stats;
+    EXPECT_TRUE(mg::all_unique(values.begin(), values.end(), {}, {}, mg::counting_allocator<std::allocator<void>>(stats)));
+    EXPECT_LE(stats.allocations(), values.size() + 16);
+    EXPECT_EQ(stats.bytes_in_use(), 0u);
+
+    // Nothing at all reaches the heap when the scratch memory comes from an inline arena.
+    mg::inline_arena<32 * 1024> scratch;
+    {
+        mg::alloc_guard guard;
+        EXPECT_TRUE(mg::all_unique(values.begin(), values.end(), {}, {}, mg::arena_allocator<void>(scratch)));
+        EXPECT_EQ(guard.allocations(), 0u);
+    }
+}
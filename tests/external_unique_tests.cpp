@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <mg/external_unique.hpp>
+#include <mg/mapped_file.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    /// <summary>
+    /// A fresh directory for spill files, removed after the test.
+    /// </summary>
+    class scratch_directory
+    {
+    public:
+        explicit scratch_directory(const char* p_name)
+            : m_path(std::filesystem::temp_directory_path() / p_name)
+        {
+            std::filesystem::remove_all(m_path);
+            std::filesystem::create_directories(m_path);
+        }
+
+        ~scratch_directory()
+        {
+            std::filesystem::remove_all(m_path);
+        }
+
+        const std::filesystem::path& path() const noexcept
+        {
+            return m_path;
+        }
+
+        bool empty() const
+        {
+            return std::filesystem::is_empty(m_path);
+        }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    mg::external_unique_options small_budget(const scratch_directory& p_directory)
+    {
+        mg::external_unique_options options;
+        options.memory_budget = 16 << 10;
+        options.partitions = 8;
+        options.temp_directory = p_directory.path();
+        return options;
+    }
+
+    // Scattered but distinct, since multiplying by an odd number is a bijection modulo 2^32.
+    std::vector<std::uint64_t> distinct_keys(std::uint64_t p_count)
+    {
+        std::vector<std::uint64_t> keys(p_count);
+        for (std::uint64_t i = 0; i < p_count; ++i)
+        {
+            keys[i] = (i * 2654435761ull) & 0xffffffffull;
+        }
+
+        return keys;
+    }
+}
+
+TEST(all_unique_external, in_memory) {
+    scratch_directory directory("mg_unique_in_memory");
+    auto options = small_budget(directory);
+    options.memory_budget = 64 << 20;
+
+    const std::vector<int> unique{ 5, 3, 9, 1 };
+    const auto result = mg::all_unique_external(unique.begin(), unique.end(), options);
+    EXPECT_TRUE(result);
+    EXPECT_FALSE(result.spilled);
+
+    const std::vector<int> duplicated{ 5, 3, 9, 3, 1 };
+    const auto duplicate = mg::all_unique_external(duplicated.begin(), duplicated.end(), options);
+    ASSERT_FALSE(duplicate);
+    EXPECT_EQ(duplicate.duplicate, 3);
+    EXPECT_EQ(duplicate.first_position, 1);
+    EXPECT_EQ(duplicate.second_position, 3);
+
+    const std::vector<int> empty;
+    EXPECT_TRUE(mg::all_unique_external(empty.begin(), empty.end(), options));
+    EXPECT_TRUE(directory.empty());
+}
+
+TEST(all_unique_external, spills_unique) {
+    scratch_directory directory("mg_unique_spills_unique");
+    const auto keys = distinct_keys(100'000);
+    const auto result = mg::all_unique_external(keys.begin(), keys.end(), small_budget(directory));
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(result.spilled);
+    EXPECT_TRUE(directory.empty());
+}
+
+TEST(all_unique_external, spills_duplicate) {
+    scratch_directory directory("mg_unique_spills_duplicate");
+    auto keys = distinct_keys(100'000);
+    keys[76'543] = keys[1'234];
+
+    const auto result = mg::all_unique_external(keys.begin(), keys.end(), small_budget(directory));
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.spilled);
+    EXPECT_EQ(result.duplicate, keys[1'234]);
+    EXPECT_EQ(result.first_position, 1'234);
+    EXPECT_EQ(result.second_position, 76'543);
+    EXPECT_TRUE(directory.empty());
+}
+
+TEST(all_unique_external, duplicate_at_end) {
+    scratch_directory directory("mg_unique_duplicate_at_end");
+    auto keys = distinct_keys(50'000);
+    keys.push_back(keys.front());
+
+    const auto result = mg::all_unique_external(keys.begin(), keys.end(), small_budget(directory));
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.first_position, 0);
+    EXPECT_EQ(result.second_position, 50'000);
+}
+
+TEST(all_unique_external, tiny_budget_with_default_partitions) {
+    // Too small for a block for each of the default partitions, so fewer are used rather than
+    // leaving no room for the elements themselves.
+    scratch_directory directory("mg_unique_tiny_budget");
+    mg::external_unique_options options;
+    options.memory_budget = 4 << 10;
+    options.temp_directory = directory.path();
+
+    auto keys = distinct_keys(20'000);
+    const auto unique = mg::all_unique_external(keys.begin(), keys.end(), options);
+    EXPECT_TRUE(unique);
+    EXPECT_TRUE(unique.spilled);
+
+    keys[15'000] = keys[42];
+    const auto duplicate = mg::all_unique_external(keys.begin(), keys.end(), options);
+    ASSERT_FALSE(duplicate);
+    EXPECT_EQ(duplicate.first_position, 42);
+    EXPECT_EQ(duplicate.second_position, 15'000);
+    EXPECT_TRUE(directory.empty());
+
+    options.memory_budget = 1 << 10;
+    EXPECT_THROW(mg::all_unique_external(keys.begin(), keys.end(), options), std::invalid_argument);
+}
+
+TEST(all_unique_external, colliding_hashes) {
+    // Every element goes to the same partition at every depth, which must still terminate.
+    scratch_directory directory("mg_unique_colliding_hashes");
+    const auto keys = distinct_keys(5'000);
+    const auto constant = [](std::uint64_t) { return std::size_t(7); };
+    EXPECT_TRUE(mg::all_unique_external(keys.begin(), keys.end(), small_budget(directory), constant));
+
+    auto duplicated = keys;
+    duplicated.push_back(keys[10]);
+    EXPECT_FALSE(mg::all_unique_external(duplicated.begin(), duplicated.end(), small_budget(directory), constant));
+}
+
+TEST(all_unique_external, strings_from_a_stream) {
+    scratch_directory directory("mg_unique_strings");
+    std::stringstream words;
+    for (int i = 0; i < 20'000; ++i)
+    {
+        words << "word" << i << ' ';
+    }
+
+    words << "word123 ";
+    const auto result = mg::all_unique_external(std::istream_iterator<std::string>(words), std::istream_iterator<std::string>(), small_budget(directory));
+    ASSERT_FALSE(result);
+    EXPECT_TRUE(result.spilled);
+    EXPECT_EQ(result.duplicate, "word123");
+    EXPECT_EQ(result.first_position, 123);
+    EXPECT_EQ(result.second_position, 20'000);
+}
+
+TEST(all_unique_external, tuples_with_custom_equality) {
+    scratch_directory directory("mg_unique_tuples");
+    using record = std::tuple<std::uint32_t, std::uint32_t>;
+    std::vector<record> records;
+    for (std::uint32_t i = 0; i < 10'000; ++i)
+    {
+        records.emplace_back(i, i % 7);
+    }
+
+    // Equal by the first field only, with a hash to match.
+    const auto hash = [](const record& p_record) { return std::hash<std::uint32_t>{}(std::get<0>(p_record)); };
+    const auto equal = [](const record& p_lhs, const record& p_rhs) { return std::get<0>(p_lhs) == std::get<0>(p_rhs); };
+    EXPECT_TRUE(mg::all_unique_external(records.begin(), records.end(), small_budget(directory), hash, equal));
+
+    records.emplace_back(9'999, 1);
+    const auto result = mg::all_unique_external(records.begin(), records.end(), small_budget(directory), hash, equal);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(std::get<0>(*result.duplicate), 9'999);
+}
+
+TEST(all_unique_external, mapped_file) {
+    scratch_directory directory("mg_unique_mapped_file");
+    const auto path = directory.path() / "keys.bin";
+    auto keys = distinct_keys(40'000);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(keys.data()), static_cast<std::streamsize>(keys.size() * sizeof(std::uint64_t)));
+    }
+
+    auto options = small_budget(directory);
+    {
+        const mg::mapped_file file(path);
+        EXPECT_EQ(file.bytes().size(), keys.size() * sizeof(std::uint64_t));
+        EXPECT_TRUE(mg::all_unique_external<std::uint64_t>(file, options));
+        EXPECT_THROW((file.as<std::array<std::byte, 3>>()), std::invalid_argument);
+    }
+
+    keys[39'999] = keys[0];
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(keys.data()), static_cast<std::streamsize>(keys.size() * sizeof(std::uint64_t)));
+    }
+
+    const mg::mapped_file file(path);
+    const auto result = mg::all_unique_external<std::uint64_t>(file, options);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.second_position, 39'999);
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+
+#include <mg/flat_map.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    // Sorted, unique keys spread over the whole range of the type, including both signs.
+    template <typename Key>
+    std::vector<Key> spread_keys(std::size_t p_count, std::mt19937_64& p_rng)
+    {
+        std::vector<Key> keys;
+        while (keys.size() < p_count)
+        {
+            if constexpr (std::is_floating_point_v<Key>)
+            {
+                keys.push_back(static_cast<Key>(std::uniform_real_distribution<double>(-1e6, 1e6)(p_rng)));
+            }
+            else
+            {
+                keys.push_back(static_cast<Key>(p_rng()));
+            }
+
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        }
+
+        return keys;
+    }
+
+    template <typename Key>
+    void expect_lower_bounds_match()
+    {
+        std::mt19937_64 rng(42);
+        for (std::size_t count = 0; count < 600; count += count < 80 ? 1 : 37)
+        {
+            const auto keys = spread_keys<Key>(count, rng);
+            const mg::flat_set<Key> set(mg::sorted_unique, keys);
+
+            std::vector<Key> probes{ std::numeric_limits<Key>::lowest(), std::numeric_limits<Key>::max() };
+            for (const auto key : keys)
+            {
+                probes.push_back(key);
+                probes.push_back(static_cast<Key>(key - 1));
+                probes.push_back(static_cast<Key>(key + 1));
+            }
+
+            for (const auto probe : probes)
+            {
+                const auto expected = std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin();
+                ASSERT_EQ(set.lower_bound(probe) - set.begin(), expected) << "count " << count << " probe " << +probe;
+                ASSERT_EQ(set.contains(probe), std::binary_search(keys.begin(), keys.end(), probe));
+            }
+        }
+    }
+}
+
+TEST(flat_set, search_index_matches_lower_bound) {
+    expect_lower_bounds_match<std::int32_t>();
+    expect_lower_bounds_match<std::uint32_t>();
+    expect_lower_bounds_match<std::int64_t>();
+    expect_lower_bounds_match<std::uint64_t>();
+    expect_lower_bounds_match<std::int16_t>();
+    expect_lower_bounds_match<double>();
+}
+
+TEST(flat_set, basic) {
+    mg::flat_set<int> set{ 5, 1, 3, 1, 5 };
+    EXPECT_EQ(set.size(), 3);
+    EXPECT_EQ(set.keys(), (std::vector<int>{ 1, 3, 5 }));
+
+    EXPECT_TRUE(set.insert(2).second);
+    EXPECT_FALSE(set.insert(3).second);
+    EXPECT_EQ(*set.find(2), 2);
+    EXPECT_EQ(set.find(4), set.end());
+    EXPECT_EQ(set.erase(3), 1);
+    EXPECT_EQ(set.erase(3), 0);
+    EXPECT_EQ(set.keys(), (std::vector<int>{ 1, 2, 5 }));
+    EXPECT_EQ(*set.upper_bound(2), 5);
+
+    auto keys = std::move(set).extract();
+    EXPECT_TRUE(set.empty());
+    EXPECT_EQ(keys.size(), 3);
+    set.replace(std::move(keys));
+    EXPECT_EQ(set, (mg::flat_set<int>{ 5, 2, 1 }));
+}
+
+TEST(flat_map, construct_sorts_and_keeps_first_duplicate) {
+    const mg::flat_map<int, std::string> map(std::vector<int>{ 3, 1, 3, 2, 1 }, std::vector<std::string>{ "c", "a", "x", "b", "y" });
+    EXPECT_EQ(map.keys(), (std::vector<int>{ 1, 2, 3 }));
+    EXPECT_EQ(map.values(), (std::vector<std::string>{ "a", "b", "c" }));
+
+    const mg::flat_map<int, std::string> listed{ { 2, "b" }, { 1, "a" }, { 2, "z" } };
+    EXPECT_EQ(listed.size(), 2);
+    EXPECT_EQ(listed.at(2), "b");
+    EXPECT_THROW(listed.at(7), std::out_of_range);
+}
+
+TEST(flat_map, element_access_and_iteration) {
+    mg::flat_map<std::uint32_t, int> map;
+    map[10] = 1;
+    map[5] = 2;
+    map[20] += 3;
+    EXPECT_EQ(map.size(), 3);
+
+    std::vector<std::uint32_t> keys;
+    for (const auto& [key, value] : map)
+    {
+        keys.push_back(key);
+    }
+
+    EXPECT_EQ(keys, (std::vector<std::uint32_t>{ 5, 10, 20 }));
+    EXPECT_EQ(map.begin()->second, 2);
+    EXPECT_EQ(map.rbegin()->first, 20);
+
+    for (auto [key, value] : map)
+    {
+        value = static_cast<int>(key);
+    }
+
+    EXPECT_EQ(map.values(), (std::vector<int>{ 5, 10, 20 }));
+
+    const auto [lower, upper] = map.equal_range(10);
+    EXPECT_EQ(upper - lower, 1);
+    EXPECT_EQ(map.lower_bound(11)->first, 20);
+    EXPECT_EQ(map.upper_bound(20), map.end());
+}
+
+TEST(flat_map, modifiers) {
+    mg::flat_map<int, std::string> map;
+    EXPECT_TRUE(map.emplace(2, "b").second);
+    EXPECT_FALSE(map.emplace(2, "x").second);
+    EXPECT_TRUE(map.insert({ 1, "a" }).second);
+    EXPECT_FALSE(map.try_emplace(1, "x").second);
+    EXPECT_FALSE(map.insert_or_assign(1, "A").second);
+    EXPECT_TRUE(map.insert_or_assign(3, "c").second);
+    EXPECT_EQ(map.values(), (std::vector<std::string>{ "A", "b", "c" }));
+
+    // Existing elements win over inserted ones, in either form of range insert.
+    const std::vector<std::pair<int, std::string>> sorted{ { 0, "z" }, { 2, "x" }, { 4, "d" } };
+    map.insert(mg::sorted_unique, sorted.begin(), sorted.end());
+    EXPECT_EQ(map.keys(), (std::vector<int>{ 0, 1, 2, 3, 4 }));
+    EXPECT_EQ(map.at(2), "b");
+    map.insert({ { 6, "f" }, { 5, "e" }, { 0, "x" } });
+    EXPECT_EQ(map.keys(), (std::vector<int>{ 0, 1, 2, 3, 4, 5, 6 }));
+    EXPECT_EQ(map.at(0), "z");
+
+    EXPECT_EQ(map.erase(3), 1);
+    EXPECT_EQ(map.erase(map.find(0))->first, 1);
+    EXPECT_EQ(map.erase(map.begin() + 1, map.begin() + 3)->first, 5);
+    EXPECT_EQ(map.keys(), (std::vector<int>{ 1, 5, 6 }));
+
+    auto [keys, values] = std::move(map).extract();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(values.size(), 3);
+    map.replace(std::move(keys), std::move(values));
+    EXPECT_EQ(map.at(6), "f");
+}
+
+TEST(flat_map, matches_std_map) {
+    std::mt19937_64 rng(7);
+    mg::flat_map<std::int64_t, std::int64_t> map;
+    std::map<std::int64_t, std::int64_t> expected;
+    for (int step = 0; step < 20'000; ++step)
+    {
+        const auto key = static_cast<std::int64_t>(rng() % 2'000) - 1'000;
+        switch (rng() % 4)
+        {
+        case 0:
+            ASSERT_EQ(map.insert_or_assign(key, step).second, expected.insert_or_assign(key, step).second);
+            break;
+        case 1:
+            ASSERT_EQ(map.erase(key), expected.erase(key));
+            break;
+        default:
+            {
+                const auto found = map.find(key);
+                const auto other = expected.find(key);
+                ASSERT_EQ(found == map.end(), other == expected.end()) << key;
+                if (found != map.end())
+                {
+                    ASSERT_EQ(found->second, other->second);
+                }
+
+                const auto lower = map.lower_bound(key);
+                const auto other_lower = expected.lower_bound(key);
+                ASSERT_EQ(lower == map.end(), other_lower == expected.end());
+                if (lower != map.end())
+                {
+                    ASSERT_EQ(lower->first, other_lower->first);
+                }
+            }
+        }
+    }
+
+    ASSERT_EQ(map.size(), expected.size());
+    EXPECT_TRUE(std::equal(map.keys().begin(), map.keys().end(), expected.begin(), expected.end(), [](auto p_key, const auto& p_entry) { return p_key == p_entry.first; }));
+}
+
+TEST(flat_map, transparent_string_keys) {
+    mg::flat_map<std::string, int, std::less<>> map{ { "pear", 3 }, { "apple", 1 }, { "fig", 2 } };
+    EXPECT_EQ(map.keys().front(), "apple");
+    EXPECT_TRUE(map.contains(std::string_view("fig")));
+    EXPECT_EQ(map.find("pear")->second, 3);
+    EXPECT_EQ(map.erase(std::string_view("fig")), 1);
+    EXPECT_EQ(map.size(), 2);
+
+    const mg::flat_map<std::string, int, std::greater<>> reversed{ { "a", 1 }, { "c", 3 }, { "b", 2 } };
+    EXPECT_EQ(reversed.begin()->first, "c");
+    EXPECT_EQ(reversed.lower_bound("bb")->first, "b");
+}
@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <mg/alloc_guard.hpp>
 #include <mg/functional.hpp>
+#include <mg/utility.hpp>
 #include <mg/detail/function_traits.hpp>
 
+#include <functional>
 #include <string>
 
 std::string concat(std::string pre, std::string post)
@@ -87,3 +90,29 @@ TEST(iter_n_test, stride_3) {
     EXPECT_EQ(sum, 13);
 }
 
+namespace
+{
+    int subtract(int p_lhs, int p_rhs)
+    {
+        return p_lhs - p_rhs;
+    }
+}
+
+TEST(func_with_defaults, allocation_budget) {
+    mg::alloc_guard guard;
+    auto subtractOne = mg::func_with_defaults<&subtract, mg::constant_func<1>>();
+    EXPECT_EQ(subtractOne(5), 4);
+    EXPECT_EQ(subtractOne(5, 2), 3);
+    EXPECT_EQ(guard.allocations(), 0u);
+}
+
+TEST(map_args, allocation_budget) {
+    int a = 1;
+    int b = 2;
+
+    mg::alloc_guard guard;
+    auto lessByPointer = mg::map_args<std::less<>, mg::deref>();
+    EXPECT_TRUE(lessByPointer(&a, &b));
+    EXPECT_FALSE(lessByPointer(&b, &a));
+    EXPECT_EQ(guard.allocations(), 0u);
+}
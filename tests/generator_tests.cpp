@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <mg/generator.hpp>
+#include <mg/memory.hpp>
+#include <mg/views.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+    mg::generator<int> iota(int p_count)
+    {
+        for (int i = 0; i < p_count; ++i)
+        {
+            co_yield i;
+        }
+    }
+
+    mg::generator<int> tree(int p_depth)
+    {
+        if (p_depth == 0)
+        {
+            co_yield 1;
+            co_return;
+        }
+
+        co_yield mg::elements_of(tree(p_depth - 1));
+        co_yield mg::elements_of(tree(p_depth - 1));
+    }
+
+    mg::generator<int> throws_after(int p_count)
+    {
+        co_yield mg::elements_of(iota(p_count));
+        throw std::runtime_error("failed");
+    }
+
+    template <typename Alloc>
+    mg::generator<int> allocated_iota(std::allocator_arg_t, Alloc, int p_count)
+    {
+        co_yield mg::elements_of(iota(p_count));
+    }
+
+    struct counter
+    {
+        template <typename Alloc>
+        mg::generator<int> iota(std::allocator_arg_t, Alloc, int p_count) const
+        {
+            for (int i = 0; i < p_count; ++i)
+            {
+                co_yield m_start + i;
+            }
+        }
+
+        int m_start;
+    };
+
+    mg::generator<std::string&> words(std::vector<std::string>& p_words)
+    {
+        for (auto& word : p_words)
+        {
+            co_yield word;
+        }
+    }
+
+    template <typename Range>
+    std::vector<std::ranges::range_value_t<Range>> to_vector(Range&& p_range)
+    {
+        std::vector<std::ranges::range_value_t<Range>> result;
+        for (auto&& element : p_range)
+        {
+            result.push_back(element);
+        }
+
+        return result;
+    }
+}
+
+TEST(generator, yields_lazily) {
+    int started = 0;
+    auto counted = [&started]() -> mg::generator<int>
+    {
+        ++started;
+        const int constant = 7;
+        co_yield constant;
+        co_yield 8;
+    };
+
+    auto values = counted();
+    EXPECT_EQ(started, 0);
+    EXPECT_EQ(to_vector(values), std::vector<int>({ 7, 8 }));
+    EXPECT_EQ(started, 1);
+
+    EXPECT_EQ(to_vector(iota(5)), std::vector<int>({ 0, 1, 2, 3, 4 }));
+    EXPECT_TRUE(to_vector(iota(0)).empty());
+    EXPECT_TRUE(to_vector(mg::generator<int>()).empty());
+
+    static_assert(std::ranges::input_range<mg::generator<int>>);
+    static_assert(std::ranges::view<mg::generator<int>>);
+    const auto evens = to_vector(iota(10) | std::views::filter([](int p_value) { return p_value % 2 == 0; }));
+    EXPECT_EQ(evens, std::vector<int>({ 0, 2, 4, 6, 8 }));
+}
+
+TEST(generator, yields_references) {
+    std::vector<std::string> source{ "a", "b" };
+    for (auto& word : words(source))
+    {
+        word += "!";
+    }
+
+    EXPECT_EQ(source, std::vector<std::string>({ "a!", "b!" }));
+}
+
+TEST(generator, nested_elements) {
+    // 2^12 leaves, each handed straight to the consumer rather than through every level.
+    int total = 0;
+    for (int value : tree(12))
+    {
+        total += value;
+    }
+
+    EXPECT_EQ(total, 1 << 12);
+
+    auto failing = throws_after(3);
+    auto it = failing.begin();
+    EXPECT_EQ(*it, 0);
+    ++it;
+    ++it;
+    EXPECT_EQ(*it, 2);
+    EXPECT_THROW(++it, std::runtime_error);
+    EXPECT_TRUE(it == std::default_sentinel);
+}
+
+TEST(generator, frames_from_allocator) {
+    mg::arena arena(4096);
+    EXPECT_EQ(arena.capacity(), 0);
+    {
+        auto values = allocated_iota(std::allocator_arg, mg::arena_allocator<std::byte>(arena), 4);
+        EXPECT_GT(arena.capacity(), 0);
+        EXPECT_EQ(to_vector(values), std::vector<int>({ 0, 1, 2, 3 }));
+    }
+
+    mg::allocation_stats<> stats;
+    {
+        auto values = allocated_iota(std::allocator_arg, mg::counting_allocator<std::allocator<std::byte>>(stats), 3);
+        EXPECT_EQ(stats.allocations(), 1);
+        EXPECT_EQ(to_vector(values), std::vector<int>({ 0, 1, 2 }));
+    }
+
+    EXPECT_EQ(stats.deallocations(), 1);
+    {
+        // Member functions take the allocator after the object parameter.
+        const counter fromTen{ 10 };
+        auto values = fromTen.iota(std::allocator_arg, mg::counting_allocator<std::allocator<std::byte>>(stats), 2);
+        EXPECT_EQ(stats.allocations(), 2);
+        EXPECT_EQ(to_vector(values), std::vector<int>({ 10, 11 }));
+    }
+
+    EXPECT_EQ(stats.deallocations(), 2);
+    EXPECT_EQ(stats.bytes_in_use(), 0);
+}
+
+TEST(generator, composes_with_views) {
+    // Streaming zip and chunk take generators (owned) and containers (referenced).
+    std::vector<char> letters{ 'a', 'b', 'c', 'd' };
+    std::vector<std::tuple<int, char>> zipped;
+    for (auto [number, letter] : mg::generators::zip(iota(10), letters))
+    {
+        letter = static_cast<char>(letter - 'a' + 'A');
+        zipped.emplace_back(number, letter);
+    }
+
+    EXPECT_EQ(zipped, (std::vector<std::tuple<int, char>>{ { 0, 'A' }, { 1, 'B' }, { 2, 'C' }, { 3, 'D' } }));
+    EXPECT_EQ(letters, std::vector<char>({ 'A', 'B', 'C', 'D' }));
+
+    std::vector<int> sums;
+    for (auto chunk : mg::generators::chunk<4>(iota(10)))
+    {
+        sums.push_back(std::accumulate(chunk.begin(), chunk.end(), 0));
+    }
+
+    EXPECT_EQ(sums, std::vector<int>({ 6, 22, 17 }));
+
+    // And generators can consume mg's random access views, feeding further streaming stages.
+    const std::vector<int> left{ 1, 2, 3, 4, 5, 6, 7, 8 };
+    const std::vector<int> right{ 8, 7, 6, 5, 4, 3, 2, 1 };
+    auto products = [](const std::vector<int>& p_left, const std::vector<int>& p_right) -> mg::generator<int>
+    {
+        for (auto [l, r] : mg::views::zip(p_left, p_right))
+        {
+            co_yield l * r;
+        }
+    };
+
+    std::vector<int> pairSums;
+    for (auto chunk : mg::generators::chunk<2>(products(left, right)))
+    {
+        pairSums.push_back(chunk[0] + chunk[1]);
+    }
+
+    EXPECT_EQ(pairSums, std::vector<int>({ 22, 38, 38, 22 }));
+
+    auto quads = [](const std::vector<int>& p_values) -> mg::generator<int>
+    {
+        for (const auto chunk : mg::views::chunk<4>(p_values))
+        {
+            co_yield std::accumulate(chunk.begin(), chunk.end(), 0);
+        }
+    };
+
+    EXPECT_EQ(to_vector(quads(left)), std::vector<int>({ 10, 26 }));
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <mg/histogram.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(latency_histogram, bucket_layout) {
+    using layout = mg::detail::log_linear_buckets<4>;
+
+    // Exact below 2^Bits, then 2^(Bits - 1) buckets per power of two.
+    static_assert(layout::index_of(15) == 15);
+    static_assert(layout::index_of(16) == 16);
+    static_assert(layout::index_of(17) == 16);
+    static_assert(layout::index_of(18) == 17);
+    static_assert(layout::index_of(32) == 24);
+    static_assert(layout::index_of(UINT64_MAX) == layout::bucket_count - 1);
+    static_assert(layout::highest_equivalent(layout::bucket_count - 1) == UINT64_MAX);
+
+    for (std::size_t i = 0; i < layout::bucket_count; ++i)
+    {
+        EXPECT_EQ(layout::index_of(layout::lowest_equivalent(i)), i);
+        EXPECT_EQ(layout::index_of(layout::highest_equivalent(i)), i);
+        if (i + 1 < layout::bucket_count)
+        {
+            EXPECT_EQ(layout::highest_equivalent(i) + 1, layout::lowest_equivalent(i + 1));
+        }
+    }
+}
+
+TEST(latency_histogram, percentiles_within_precision) {
+    constexpr unsigned Bits = 7;
+    constexpr double Precision = 1.0 / (1 << (Bits - 1));
+
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> distribution(10.0, 2.0);
+
+    std::vector<std::uint64_t> values;
+    mg::latency_histogram<Bits> histogram;
+    for (int i = 0; i < 100'000; ++i)
+    {
+        values.push_back(static_cast<std::uint64_t>(distribution(rng)));
+        histogram.record(values.back());
+    }
+
+    std::sort(values.begin(), values.end());
+    const auto snapshot = histogram.snapshot();
+    ASSERT_EQ(snapshot.total_count(), values.size());
+
+    for (double percentile : { 0.0, 1.0, 10.0, 50.0, 90.0, 99.0, 99.9, 99.99, 100.0 })
+    {
+        const auto rank = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size()))));
+        const auto exact = values[rank - 1];
+        const auto reported = snapshot.value_at_percentile(percentile);
+
+        EXPECT_GE(reported, exact) << percentile;
+        EXPECT_LE(static_cast<double>(reported - exact), static_cast<double>(exact) * Precision) << percentile;
+    }
+
+    EXPECT_LE(snapshot.min(), values.front());
+    EXPECT_GE(snapshot.max(), values.back());
+    EXPECT_LE(static_cast<double>(snapshot.max() - values.back()), static_cast<double>(values.back()) * Precision);
+
+    double exactMean = 0;
+    for (auto value : values)
+    {
+        exactMean += static_cast<double>(value);
+    }
+
+    exactMean /= static_cast<double>(values.size());
+    EXPECT_NEAR(snapshot.mean(), exactMean, exactMean * Precision);
+}
+
+TEST(latency_histogram, small_values_are_exact) {
+    mg::latency_histogram<> histogram;
+    for (std::uint64_t value = 0; value < 100; ++value)
+    {
+        histogram.record(value);
+    }
+
+    const auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.min(), 0);
+    EXPECT_EQ(snapshot.max(), 99);
+    EXPECT_EQ(snapshot.value_at_percentile(50), 49);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 49.5);
+
+    const mg::latency_snapshot<> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.value_at_percentile(99), 0);
+    EXPECT_EQ(empty.max(), 0);
+}
+
+TEST(latency_histogram, snapshot_and_reset_loses_nothing) {
+    mg::latency_histogram<> histogram;
+    mg::latency_snapshot<> collected;
+
+    constexpr int Threads = 4;
+    constexpr int PerThread = 50'000;
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < Threads; ++t)
+        {
+            threads.emplace_back([&histogram, t]
+                {
+                    for (int i = 0; i < PerThread; ++i)
+                    {
+                        histogram.record(static_cast<std::uint64_t>(t * 1000 + i % 1000));
+                    }
+                });
+        }
+
+        for (int i = 0; i < 20; ++i)
+        {
+            collected.merge(histogram.snapshot_and_reset());
+            std::this_thread::yield();
+        }
+    }
+
+    collected.merge(histogram.snapshot_and_reset());
+    EXPECT_EQ(collected.total_count(), Threads * PerThread);
+    EXPECT_EQ(collected.count_at(100), PerThread / 1000);
+    EXPECT_TRUE(histogram.snapshot().empty());
+}
+
+TEST(latency_histogram, sharded_merges_shards) {
+    mg::sharded_latency_histogram<> histogram(3);
+    EXPECT_EQ(histogram.shard_count(), 4);
+    EXPECT_THROW(mg::sharded_latency_histogram<>(0), std::invalid_argument);
+
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 6; ++t)
+        {
+            threads.emplace_back([&histogram]
+                {
+                    for (std::uint64_t i = 1; i <= 1000; ++i)
+                    {
+                        histogram.record(i * 1000);
+                    }
+                });
+        }
+    }
+
+    const auto snapshot = histogram.snapshot_and_reset();
+    EXPECT_EQ(snapshot.total_count(), 6000);
+    EXPECT_EQ(snapshot.min(), 1000);
+    EXPECT_TRUE(histogram.snapshot().empty());
+}
+
+TEST(latency_histogram, merge_and_serialize) {
+    mg::latency_histogram<> first;
+    mg::latency_histogram<> second;
+    mg::latency_snapshot<> combined;
+    for (std::uint64_t i = 0; i < 10'000; ++i)
+    {
+        first.record(i * 37);
+        second.record(i * i);
+        combined.record(i * 37);
+        combined.record(i * i);
+    }
+
+    // Merging a snapshot which has been through its binary form, as from another process.
+    const auto bytes = second.snapshot().serialize();
+    const auto decoded = mg::latency_snapshot<>::deserialize(bytes);
+    EXPECT_EQ(decoded, second.snapshot());
+    first.merge(decoded);
+    EXPECT_EQ(first.snapshot(), combined);
+    EXPECT_LT(bytes.size(), 10'000u);
+
+    const auto empty = mg::latency_snapshot<>().serialize();
+    EXPECT_EQ(empty.size(), 2);
+    EXPECT_TRUE(mg::latency_snapshot<>::deserialize(empty).empty());
+
+    // Malformed input.
+    EXPECT_THROW(mg::latency_snapshot<7>::deserialize(bytes), std::invalid_argument);
+    EXPECT_THROW(mg::latency_snapshot<>::deserialize(std::span(bytes).first(bytes.size() - 1)), std::invalid_argument);
+    auto trailing = bytes;
+    trailing.push_back(std::byte{ 0 });
+    EXPECT_THROW(mg::latency_snapshot<>::deserialize(trailing), std::invalid_argument);
+
+    // A tenth varint byte may only carry the top bit.
+    std::vector<std::byte> overlong(11, std::byte{ 0x80 });
+    overlong.front() = std::byte{ 8 };
+    overlong.back() = std::byte{ 0x02 };
+    EXPECT_THROW(mg::latency_snapshot<>::deserialize(overlong), std::invalid_argument);
+}
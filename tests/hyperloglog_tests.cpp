@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <mg/collections.hpp>
+#include <mg/hyperloglog.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    template <unsigned Precision>
+    void expect_within_error(const mg::hyperloglog<Precision>& p_sketch, double p_exact)
+    {
+        // Four standard errors, which a deterministic input either always or never exceeds.
+        const auto tolerance = 4 * mg::hyperloglog<Precision>::standard_error() * p_exact;
+        EXPECT_NEAR(p_sketch.estimate(), p_exact, std::max(tolerance, 1.0)) << "exact " << p_exact;
+    }
+}
+
+TEST(hyperloglog, empty) {
+    const mg::hyperloglog<> sketch;
+    EXPECT_TRUE(sketch.is_sparse());
+    EXPECT_EQ(sketch.estimate(), 0.0);
+}
+
+TEST(hyperloglog, small_cardinalities_are_nearly_exact) {
+    mg::hyperloglog<> sketch;
+    for (int i = 0; i < 100; ++i)
+    {
+        sketch.add(i);
+        sketch.add(i);
+    }
+
+    EXPECT_TRUE(sketch.is_sparse());
+    EXPECT_NEAR(sketch.estimate(), 100.0, 1.0);
+}
+
+TEST(hyperloglog, error_bounds) {
+    mg::hyperloglog<12> coarse;
+    mg::hyperloglog<> fine;
+    std::uint64_t exact = 0;
+    for (const std::uint64_t checkpoint : { 1'000u, 10'000u, 100'000u, 1'000'000u })
+    {
+        for (; exact < checkpoint; ++exact)
+        {
+            coarse.add(exact);
+            fine.add(exact);
+            // Repeats do not count.
+            fine.add(exact / 2);
+        }
+
+        expect_within_error(coarse, static_cast<double>(exact));
+        expect_within_error(fine, static_cast<double>(exact));
+    }
+
+    EXPECT_FALSE(fine.is_sparse());
+}
+
+TEST(hyperloglog, strings_against_all_unique) {
+    std::vector<std::string> words;
+    for (int i = 0; i < 5'000; ++i)
+    {
+        words.push_back("key" + std::to_string(i % 3'000));
+    }
+
+    EXPECT_FALSE(mg::all_unique(words.begin(), words.end()));
+    const auto estimate = mg::approx_distinct(words.begin(), words.end());
+    EXPECT_NEAR(estimate, 3'000.0, 4 * mg::hyperloglog<>::standard_error() * 3'000.0);
+
+    // The same custom hash convention as all_unique.
+    const auto by_length = [](const std::string& p_word) { return std::hash<std::size_t>{}(p_word.size()); };
+    EXPECT_NEAR(mg::approx_distinct(words.begin(), words.end(), by_length), 4.0, 0.5);
+}
+
+TEST(hyperloglog, sparse_and_dense_agree) {
+    mg::hyperloglog<10> sketch;
+    for (int i = 0; i < 100; ++i)
+    {
+        sketch.add(i);
+    }
+
+    ASSERT_TRUE(sketch.is_sparse());
+
+    // The dense estimate of the same registers.
+    std::vector<std::uint8_t> registers(mg::hyperloglog<10>::register_count);
+    for (std::size_t r = 0; r < registers.size(); ++r)
+    {
+        registers[r] = sketch.register_at(r);
+    }
+
+    const auto counts = mg::detail::register_histogram<mg::hyperloglog<10>::max_rank + 1>(registers.data(), registers.size());
+    EXPECT_EQ(sketch.estimate(), mg::detail::hll_estimate(counts, static_cast<double>(registers.size())));
+
+    // Merging a sparse sketch into a dense one raises the same registers.
+    mg::hyperloglog<10> dense;
+    for (int i = 0; i < 1'000; ++i)
+    {
+        dense.add(i + 1'000'000);
+    }
+
+    ASSERT_FALSE(dense.is_sparse());
+    auto merged = dense;
+    merged.merge(sketch);
+    for (std::size_t r = 0; r < registers.size(); ++r)
+    {
+        ASSERT_EQ(merged.register_at(r), std::max(dense.register_at(r), registers[r])) << r;
+    }
+}
+
+TEST(hyperloglog, merge_matches_union) {
+    mg::hyperloglog<> shards[4];
+    mg::hyperloglog<> whole;
+    for (std::uint64_t i = 0; i < 200'000; ++i)
+    {
+        // Overlapping shards.
+        shards[i % 4].add(i % 150'000);
+        whole.add(i % 150'000);
+    }
+
+    mg::hyperloglog<> merged;
+    for (const auto& shard : shards)
+    {
+        merged.merge(shard);
+    }
+
+    for (std::size_t r = 0; r < mg::hyperloglog<>::register_count; ++r)
+    {
+        ASSERT_EQ(merged.register_at(r), whole.register_at(r)) << r;
+    }
+
+    EXPECT_EQ(merged.estimate(), whole.estimate());
+    expect_within_error(merged, 150'000.0);
+}
+
+TEST(hyperloglog, serialize_round_trip) {
+    mg::hyperloglog<> sparse;
+    mg::hyperloglog<> dense;
+    for (int i = 0; i < 50'000; ++i)
+    {
+        if (i < 500)
+        {
+            sparse.add(i);
+        }
+
+        dense.add(i);
+    }
+
+    for (const auto* sketch : { &sparse, &dense })
+    {
+        const auto bytes = sketch->serialize();
+        const auto copy = mg::hyperloglog<>::deserialize(bytes);
+        EXPECT_EQ(copy.is_sparse(), sketch->is_sparse());
+        EXPECT_EQ(copy.estimate(), sketch->estimate());
+        for (std::size_t r = 0; r < mg::hyperloglog<>::register_count; ++r)
+        {
+            ASSERT_EQ(copy.register_at(r), sketch->register_at(r)) << r;
+        }
+    }
+
+    // A sparse sketch serializes to a few bytes a register.
+    EXPECT_LT(sparse.serialize().size(), 4 * 500);
+
+    // Shards combine through their serialized form.
+    auto combined = mg::hyperloglog<>::deserialize(sparse.serialize());
+    combined.merge(mg::hyperloglog<>::deserialize(dense.serialize()));
+    EXPECT_EQ(combined.estimate(), dense.estimate());
+}
+
+TEST(hyperloglog, deserialize_rejects_malformed) {
+    mg::hyperloglog<> sketch;
+    sketch.add(1);
+    auto bytes = sketch.serialize();
+
+    EXPECT_THROW(mg::hyperloglog<12>::deserialize(bytes), std::invalid_argument);
+    EXPECT_THROW(mg::hyperloglog<>::deserialize(std::span(bytes).first(bytes.size() - 1)), std::invalid_argument);
+
+    bytes.push_back(std::byte{ 0 });
+    EXPECT_THROW(mg::hyperloglog<>::deserialize(bytes), std::invalid_argument);
+
+    mg::hyperloglog<4> tiny;
+    for (int i = 0; i < 100; ++i)
+    {
+        tiny.add(i);
+    }
+
+    auto dense = tiny.serialize();
+    dense.back() = std::byte{ 200 };
+    EXPECT_THROW(mg::hyperloglog<4>::deserialize(dense), std::invalid_argument);
+}
@@ -51,3 +51,18 @@ INSTANTIATE_TEST_SUITE_P(
 		WholePowExceptionTestCase{ 4, -1 },
 		WholePowExceptionTestCase{ 0, 0 },
 		WholePowExceptionTestCase{ -2, 4 }));
+
+TEST(mod_pow, built_in_types) {
+	constexpr auto prime = 18446744073709551557ull;
+	static_assert(mg::mod_pow(2ull, 63ull, prime) == 9223372036854775808ull);
+	EXPECT_EQ(mg::mul_mod(prime - 2, prime - 3, prime), 6ull);
+	EXPECT_EQ(mg::mul_mod(~0ull - 1, ~0ull - 2, prime), 3192ull);
+	EXPECT_EQ(mg::mod_pow(7ll, 1'000'000'000'000'000'000ll, 1'000'000'007ll), 259'616'729ll);
+	EXPECT_EQ(mg::mod_pow(0, 0, 5), 1);
+	EXPECT_EQ(mg::mod_pow(9, 3, 1), 0);
+	EXPECT_EQ(mg::mod_pow(3ull, 1000ull, 1ull << 40), 531'833'051'937ull);
+
+	EXPECT_THROW(mg::mod_pow(2, -1, 5), std::invalid_argument);
+	EXPECT_THROW(mg::mod_pow(-2, 1, 5), std::invalid_argument);
+	EXPECT_THROW(mg::mod_pow(2, 1, 0), std::invalid_argument);
+}
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+
+#include <mg/alloc_guard.hpp>
+#include <mg/collections.hpp>
+#include <mg/memory.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <latch>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    bool is_aligned(const void* p_pointer, std::size_t p_alignment)
+    {
+        return reinterpret_cast<std::uintptr_t>(p_pointer) % p_alignment == 0;
+    }
+}
+
+TEST(arena, allocation_and_alignment) {
+    mg::arena arena(256);
+
+    auto* a = static_cast<char*>(arena.allocate(3, 1));
+    auto* b = arena.allocate(8, 8);
+    auto* c = arena.allocate(64, 64);
+    EXPECT_TRUE(is_aligned(b, 8));
+    EXPECT_TRUE(is_aligned(c, 64));
+    EXPECT_GE(static_cast<char*>(b), a + 3);
+
+    // Requests larger than a block get a block of their own.
+    auto* large = arena.allocate(10000, 16);
+    EXPECT_TRUE(is_aligned(large, 16));
+    EXPECT_GE(arena.capacity(), 10000u);
+
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 0u);
+}
+
+TEST(arena, deallocate_rolls_back_last) {
+    mg::arena arena;
+
+    auto* first = arena.allocate(32, 8);
+    auto* second = arena.allocate(32, 8);
+    arena.deallocate(first, 32);
+    arena.deallocate(second, 32);
+    EXPECT_EQ(arena.allocate(32, 8), second);
+}
+
+TEST(arena, reset_reuses_blocks) {
+    mg::arena arena(128);
+
+    auto run = [&]
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                arena.allocate(24, 8);
+            }
+        };
+
+    run();
+    const auto warm = arena.capacity();
+    for (int i = 0; i < 10; ++i)
+    {
+        arena.reset();
+        run();
+        EXPECT_EQ(arena.capacity(), warm);
+    }
+}
+
+TEST(arena, inline_first_block) {
+    mg::inline_arena<1024> arena;
+    EXPECT_EQ(arena.capacity(), 1024u);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        arena.allocate(32, 8);
+    }
+
+    EXPECT_EQ(arena.capacity(), 1024u);
+    arena.allocate(512, 8);
+    EXPECT_GT(arena.capacity(), 1024u);
+
+    // Release frees the heap blocks but the inline buffer stays usable.
+    arena.release();
+    EXPECT_EQ(arena.capacity(), 1024u);
+}
+
+TEST(arena_allocator, standard_containers) {
+    mg::arena arena;
+    mg::arena_allocator<int> alloc(arena);
+
+    std::vector<int, mg::arena_allocator<int>> values(alloc);
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.push_back(i);
+    }
+
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 999 * 1000 / 2);
+
+    using rebound = std::allocator_traits<mg::arena_allocator<int>>::rebind_alloc<double>;
+    static_assert(std::is_same_v<rebound, mg::arena_allocator<double>>);
+    EXPECT_TRUE(rebound(alloc) == alloc);
+
+    mg::arena other;
+    EXPECT_FALSE(mg::arena_allocator<int>(other) == alloc);
+}
+
+TEST(arena_allocator, all_unique_without_growth) {
+    std::vector<int> unique(500);
+    std::iota(unique.begin(), unique.end(), 0);
+    auto duplicated = unique;
+    duplicated.back() = 0;
+
+    mg::arena scratch;
+    EXPECT_TRUE(mg::all_unique(unique.begin(), unique.end(), std::hash<int>{}, std::equal_to<>{}, mg::arena_allocator<void>(scratch)));
+    const auto warm = scratch.capacity();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        scratch.reset();
+        EXPECT_TRUE(mg::all_unique(unique.begin(), unique.end(), {}, {}, mg::arena_allocator<void>(scratch)));
+        scratch.reset();
+        EXPECT_FALSE(mg::all_unique(duplicated.begin(), duplicated.end(), std::hash<int>{}, std::equal_to<>{}, mg::arena_allocator<void>(scratch)));
+        EXPECT_EQ(scratch.capacity(), warm);
+    }
+}
+
+TEST(pool_allocator, recycles_chunks) {
+    mg::pool_allocator<std::uint64_t> alloc;
+
+    auto* first = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+    EXPECT_EQ(alloc.allocate(1), first);
+    alloc.deallocate(first, 1);
+
+    auto* array = alloc.allocate(10);
+    std::fill(array, array + 10, 7);
+    alloc.deallocate(array, 10);
+
+    std::list<int, mg::pool_allocator<int>> values;
+    for (int i = 0; i < 10000; ++i)
+    {
+        values.push_back(i);
+    }
+
+    values.remove_if([](int p_value) { return p_value % 2 == 0; });
+    EXPECT_EQ(values.size(), 5000u);
+    EXPECT_EQ(values.front(), 1);
+
+    static_assert(std::is_same_v<std::allocator_traits<mg::pool_allocator<int, true>>::rebind_alloc<char>, mg::pool_allocator<char, true>>);
+    EXPECT_TRUE(mg::pool_allocator<int>() == mg::pool_allocator<char>());
+}
+
+TEST(pool_allocator, per_thread_cross_thread_free) {
+    mg::pool_allocator<std::uint64_t, true> alloc;
+
+    std::vector<std::uint64_t*> chunks;
+    std::jthread([&]
+        {
+            for (int i = 0; i < 5000; ++i)
+            {
+                chunks.push_back(alloc.allocate(1));
+                *chunks.back() = static_cast<std::uint64_t>(i);
+            }
+        }).join();
+
+    for (std::size_t i = 0; i < chunks.size(); ++i)
+    {
+        EXPECT_EQ(*chunks[i], i);
+        alloc.deallocate(chunks[i], 1);
+    }
+
+    std::list<int, mg::pool_allocator<int, true>> values(100, 1);
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 100);
+}
+
+TEST(pool_allocator, all_unique) {
+    std::vector<int> values(100);
+    std::iota(values.begin(), values.end(), 0);
+    EXPECT_TRUE(mg::all_unique(values.begin(), values.end(), std::hash<int>{}, std::equal_to<>{}, mg::pool_allocator<void>{}));
+    values.push_back(50);
+    EXPECT_FALSE(mg::all_unique(values.begin(), values.end(), std::hash<int>{}, std::equal_to<>{}, mg::pool_allocator<void, true>{}));
+}
+
+TEST(counting_allocator, records_statistics) {
+    mg::allocation_stats stats;
+    {
+        std::vector<std::uint32_t, mg::counting_allocator<std::allocator<std::uint32_t>>> values(stats);
+        values.reserve(4);
+        values.reserve(100);
+        EXPECT_EQ(stats.allocations(), 2u);
+        EXPECT_EQ(stats.deallocations(), 1u);
+        EXPECT_EQ(stats.bytes_in_use(), 400u);
+        EXPECT_EQ(stats.peak_bytes(), 416u);
+        EXPECT_EQ(stats.total_bytes(), 416u);
+
+        const auto histogram = stats.size_histogram();
+        EXPECT_EQ(histogram[mg::allocation_stats<>::bucket_of(16)], 1u);
+        EXPECT_EQ(histogram[mg::allocation_stats<>::bucket_of(400)], 1u);
+        EXPECT_EQ(std::accumulate(histogram.begin(), histogram.end(), std::size_t(0)), 2u);
+    }
+
+    EXPECT_EQ(stats.bytes_in_use(), 0u);
+    EXPECT_EQ(stats.peak_bytes(), 416u);
+
+    stats.reset();
+    EXPECT_EQ(stats.allocations(), 0u);
+    EXPECT_EQ(stats.peak_bytes(), 0u);
+}
+
+TEST(counting_allocator, rebinding_shares_statistics) {
+    mg::allocation_stats<false> stats;
+    mg::arena arena;
+    mg::counting_allocator<mg::arena_allocator<int>, false> alloc(stats, arena);
+
+    std::list<int, decltype(alloc)> values(alloc);
+    values.push_back(1);
+    values.push_back(2);
+    EXPECT_EQ(stats.allocations(), 2u);
+    EXPECT_EQ(stats.size_histogram()[decltype(stats)::bucket_of(sizeof(int))], 0u);
+
+    using rebound = std::allocator_traits<decltype(alloc)>::rebind_alloc<double>;
+    static_assert(std::is_same_v<rebound, mg::counting_allocator<mg::arena_allocator<double>, false>>);
+    EXPECT_TRUE(rebound(alloc) == alloc);
+    EXPECT_EQ(&rebound(alloc).stats(), &stats);
+}
+
+namespace
+{
+    std::size_t s_violationCount = 0;
+    std::size_t s_violationBudget = 0;
+    int* volatile s_sink = nullptr;
+
+    void record_violation(std::size_t p_allocations, std::size_t p_budget)
+    {
+        s_violationCount = p_allocations;
+        s_violationBudget = p_budget;
+    }
+}
+
+TEST(alloc_guard, detects_allocations) {
+    ASSERT_TRUE(mg::alloc_guard::hooks_installed());
+
+    {
+        mg::alloc_guard guard;
+        EXPECT_EQ(guard.allocations(), 0u);
+    }
+
+    auto previous = mg::alloc_guard::set_violation_handler(&record_violation);
+    {
+        mg::alloc_guard guard(1);
+        // Published through a volatile so that the allocations cannot be elided.
+        s_sink = new int(1);
+        delete s_sink;
+        s_sink = new int(2);
+        delete s_sink;
+    }
+
+    mg::alloc_guard::set_violation_handler(previous);
+    EXPECT_EQ(s_violationCount, 2u);
+    EXPECT_EQ(s_violationBudget, 1u);
+
+    // Allocations from other threads do not count against the guard.
+    std::latch start(1);
+    std::jthread other([&] { start.wait(); s_sink = new int(3); delete s_sink; });
+    mg::alloc_guard guard;
+    start.count_down();
+    other.join();
+    EXPECT_EQ(guard.allocations(), 0u);
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mg/collections.hpp>
+#include <mg/packed_tuple.hpp>
+#include <mg/utility.hpp>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+TEST(packed_tuple, removes_padding) {
+    using Packed = mg::packed_tuple<char, double, char, int>;
+    static_assert(sizeof(Packed) == 16);
+    static_assert(sizeof(Packed) < sizeof(std::tuple<char, double, char, int>));
+    static_assert(std::is_same_v<Packed::layout, mg::type_sequence<double, int, char, char>>);
+    static_assert(Packed::slot_of<0> == 2 && Packed::slot_of<1> == 0 && Packed::slot_of<2> == 3 && Packed::slot_of<3> == 1);
+
+    static_assert(sizeof(mg::packed_tuple<std::int8_t, std::int64_t, std::int16_t, std::int32_t, std::int8_t>) == 16);
+    static_assert(sizeof(mg::packed_tuple<char>) == 1);
+    static_assert(std::is_trivially_copyable_v<Packed>);
+}
+
+TEST(packed_tuple, logical_order_access) {
+    constexpr mg::packed_tuple<char, double, char, int> packed('a', 2.5, 'b', 7);
+    static_assert(packed.get<0>() == 'a');
+    static_assert(packed.get<3>() == 7);
+
+    EXPECT_EQ(packed.get<1>(), 2.5);
+    EXPECT_EQ(packed.get<2>(), 'b');
+    EXPECT_EQ(mg::get<3>{}(packed), 7);
+    EXPECT_EQ(packed.to_tuple(), std::make_tuple('a', 2.5, 'b', 7));
+    EXPECT_TRUE((std::is_same_v<std::tuple_element_t<1, decltype(packed)>, const double>));
+    EXPECT_EQ(std::tuple_size_v<decltype(packed)>, 4);
+}
+
+TEST(packed_tuple, structured_bindings) {
+    mg::packed_tuple<std::int8_t, std::string, std::int64_t> packed(1, "two", 3);
+
+    auto& [first, second, third] = packed;
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, "two");
+    EXPECT_EQ(third, 3);
+
+    second = "changed";
+    EXPECT_EQ(packed.get<1>(), "changed");
+
+    auto copy = packed;
+    EXPECT_EQ(copy, packed);
+    copy.get<2>() = 4;
+    EXPECT_FALSE(copy == packed);
+}
+
+TEST(packed_tuple, from_std_tuple) {
+    mg::packed_tuple<char, double> packed(std::make_tuple('x', 1.0));
+    EXPECT_EQ(packed.get<0>(), 'x');
+    EXPECT_EQ(packed.get<1>(), 1.0);
+}
+
+TEST(packed_tuple, tuple_map) {
+    mg::packed_tuple<char, std::int64_t, std::int16_t> packed('a', 10, 100);
+
+    auto mapped = mg::tuple_map(packed, [](auto el) { return static_cast<int>(el) + 1; });
+    EXPECT_EQ(mapped, std::make_tuple(98, 11, 101));
+}
+
+TEST(packed_tuple, iter_zipped_tuples) {
+    mg::packed_tuple<char, double, char, int> packed('a', 2.5, 'b', 7);
+    auto names = std::make_tuple("first", "second", "third", "fourth");
+
+    std::vector<std::string> seen;
+    mg::iter_zipped_tuples(
+        [&](const auto& p_value, const char* p_name)
+        {
+            seen.push_back(p_name + std::string("=") + std::to_string(p_value));
+        },
+        packed, names);
+
+    EXPECT_THAT(seen, testing::ElementsAre("first=97", "second=2.500000", "third=98", "fourth=7"));
+}
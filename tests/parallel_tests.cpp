@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <mg/parallel.hpp>
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <latch>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace
+{
+    struct describe
+    {
+        std::string operator()(int p_value) const { return "int " + std::to_string(p_value); }
+        std::string operator()(const std::string& p_value) const { return "string " + p_value; }
+        std::string operator()(double) const { return "double"; }
+    };
+
+    // Values over many orders of magnitude and both signs, whose floating point sum depends on
+    // the order it is taken in.
+    std::vector<double> spread_values(std::size_t p_count)
+    {
+        std::mt19937_64 rng(11);
+        std::uniform_real_distribution<double> mantissa(-1.0, 1.0);
+        std::uniform_int_distribution<int> exponent(-20, 20);
+        std::vector<double> values(p_count);
+        for (auto& value : values)
+        {
+            value = std::ldexp(mantissa(rng), exponent(rng));
+        }
+
+        return values;
+    }
+
+    template <mg::summation Mode>
+    void expect_bit_exact_across_thread_counts(const std::vector<double>& p_values)
+    {
+        const auto square = [](double p_value) { return p_value * p_value - 0.25; };
+        const auto expected = mg::transform_reduce<Mode>(nullptr, p_values, 0.5, std::plus<>(), square);
+        for (const std::size_t threads : { 1, 2, 3, 8 })
+        {
+            mg::thread_pool pool(threads);
+            for (int repeat = 0; repeat < 3; ++repeat)
+            {
+                const auto result = mg::transform_reduce<Mode>(&pool, p_values, 0.5, std::plus<>(), square);
+                ASSERT_EQ(std::bit_cast<std::uint64_t>(result), std::bit_cast<std::uint64_t>(expected)) << threads << " threads";
+            }
+        }
+    }
+}
+
+TEST(parallel, parallel_tuple_map_results) {
+    mg::thread_pool pool(3);
+
+    auto result = mg::parallel_tuple_map(&pool, std::tuple(1, std::string("two"), 3.0), describe{});
+    static_assert(std::is_same_v<decltype(result), std::tuple<std::string, std::string, std::string>>);
+    EXPECT_EQ(result, std::tuple("int 1", "string two", "double"));
+
+    auto doubled = mg::parallel_tuple_map(&pool, std::tuple(1, 2.5f), [](auto p_value) { return p_value * 2; });
+    static_assert(std::is_same_v<decltype(doubled), std::tuple<int, float>>);
+    EXPECT_EQ(doubled, std::tuple(2, 5.0f));
+}
+
+TEST(parallel, parallel_tuple_map_sequential_fallback) {
+    const auto caller = std::this_thread::get_id();
+    auto onCaller = [caller](auto) { return std::this_thread::get_id() == caller; };
+
+    EXPECT_EQ(mg::parallel_tuple_map(nullptr, std::tuple(1, 'a', 2.0), onCaller), std::tuple(true, true, true));
+
+    mg::thread_pool pool(2);
+    EXPECT_EQ(mg::parallel_tuple_map(&pool, std::tuple(1), onCaller), std::tuple(true));
+    EXPECT_EQ(mg::parallel_tuple_map(&pool, std::tuple<>(), onCaller), std::tuple<>());
+}
+
+TEST(parallel, parallel_tuple_map_first_exception_wins) {
+    mg::thread_pool pool(4);
+
+    auto thrower = [](int p_index)
+    {
+        if (p_index == 1)
+        {
+            throw std::invalid_argument("first");
+        }
+
+        if (p_index == 3)
+        {
+            throw std::out_of_range("second");
+        }
+
+        return p_index;
+    };
+
+    for (int i = 0; i < 50; ++i)
+    {
+        EXPECT_THROW(mg::parallel_tuple_map(&pool, std::tuple(0, 1, 2, 3), thrower), std::invalid_argument);
+        EXPECT_THROW(mg::parallel_tuple_map(nullptr, std::tuple(0, 1, 2, 3), thrower), std::invalid_argument);
+    }
+
+    EXPECT_THROW(mg::parallel_tuple_map(&pool, std::tuple(1, 3), thrower), std::invalid_argument);
+    EXPECT_THROW(mg::parallel_tuple_map(&pool, std::tuple(0, 3), thrower), std::out_of_range);
+}
+
+TEST(parallel, when_all_heterogeneous) {
+    mg::thread_pool pool(2);
+
+    int sideEffect = 0;
+    auto result = mg::when_all(&pool,
+        [] { return 7; },
+        [] { return std::string("seven"); },
+        [&] { sideEffect = 7; });
+
+    static_assert(std::is_same_v<decltype(result), std::tuple<int, std::string, std::monostate>>);
+    EXPECT_EQ(std::get<0>(result), 7);
+    EXPECT_EQ(std::get<1>(result), "seven");
+    EXPECT_EQ(sideEffect, 7);
+
+    EXPECT_EQ(mg::when_all(nullptr, [] { return 1; }, [] { return 2; }), std::tuple(1, 2));
+}
+
+TEST(parallel, when_all_runs_concurrently) {
+    mg::thread_pool pool(2);
+
+    // Each callable blocks until all three have started, so this only completes if they overlap.
+    std::latch started(3);
+    auto arrive = [&] { started.arrive_and_wait(); return true; };
+    EXPECT_EQ(mg::when_all(&pool, arrive, arrive, arrive), std::tuple(true, true, true));
+}
+
+TEST(parallel, transform_reduce_bit_exact_across_thread_counts) {
+    for (const std::size_t count : { 0, 1, 7, 4'096, 4'097, 100'003 })
+    {
+        const auto values = spread_values(count);
+        expect_bit_exact_across_thread_counts<mg::summation::blocked>(values);
+        expect_bit_exact_across_thread_counts<mg::summation::pairwise>(values);
+        expect_bit_exact_across_thread_counts<mg::summation::kahan>(values);
+    }
+
+    // The sum differs from a left to right std::accumulate, which is why a fixed order matters.
+    const auto values = spread_values(100'003);
+    EXPECT_NE(
+        std::bit_cast<std::uint64_t>(mg::transform_reduce(nullptr, values, 0.0, std::plus<>(), std::identity())),
+        std::bit_cast<std::uint64_t>(std::accumulate(values.begin(), values.end(), 0.0)));
+}
+
+TEST(parallel, transform_reduce_summation_accuracy) {
+    // One large value followed by many small ones which a naive sum rounds away entirely.
+    std::vector<double> values(50'000, 1.0);
+    values.front() = 1e17;
+    const auto exact = 1e17 + 49'999.0;
+
+    mg::thread_pool pool(4);
+    const auto naive = std::accumulate(values.begin(), values.end(), 0.0);
+    const auto pairwise = mg::transform_reduce<mg::summation::pairwise>(&pool, values, 0.0, std::plus<>(), std::identity());
+    const auto kahan = mg::transform_reduce<mg::summation::kahan>(&pool, values, 0.0, std::plus<>(), std::identity());
+    EXPECT_EQ(naive, 1e17);
+    EXPECT_LT(std::abs(pairwise - exact), std::abs(naive - exact));
+    EXPECT_EQ(kahan, exact);
+}
+
+TEST(parallel, transform_reduce_keeps_order) {
+    // Concatenation is associative but not commutative, so this checks that pairwise summation
+    // keeps the operands in order.
+    std::vector<int> digits(20'000);
+    for (std::size_t i = 0; i < digits.size(); ++i)
+    {
+        digits[i] = static_cast<int>(i % 10);
+    }
+
+    std::string expected = ">";
+    for (const auto digit : digits)
+    {
+        expected += static_cast<char>('0' + digit);
+    }
+
+    mg::thread_pool pool(4);
+    const auto to_string = [](int p_digit) { return std::string(1, static_cast<char>('0' + p_digit)); };
+    EXPECT_EQ(mg::transform_reduce<mg::summation::pairwise>(&pool, digits, std::string(">"), std::plus<>(), to_string), expected);
+    EXPECT_EQ(mg::transform_reduce<mg::summation::pairwise>(nullptr, digits, std::string(">"), std::plus<>(), to_string), expected);
+}
+
+TEST(parallel, transform_reduce_propagates_exceptions) {
+    mg::thread_pool pool(4);
+    const std::vector<int> values(50'000, 1);
+    const auto thrower = [](int p_value) -> int
+    {
+        if (p_value == 1)
+        {
+            throw std::runtime_error("transform");
+        }
+
+        return p_value;
+    };
+
+    EXPECT_THROW(mg::transform_reduce(&pool, values, 0, std::plus<>(), thrower), std::runtime_error);
+}
+
+TEST(parallel, transform_reduce_tuple) {
+    mg::thread_pool pool(3);
+    const auto length = [](const auto& p_value) { return std::size(p_value); };
+    const auto total = mg::transform_reduce(&pool, std::tuple(std::string("abc"), std::vector<int>(4), std::string_view("xy")), std::size_t(10), std::plus<>(), length);
+    EXPECT_EQ(total, 19);
+
+    // Heterogeneous results, combined by a reduce which accepts each pair of them.
+    const auto mixed = mg::transform_reduce(nullptr, std::tuple(1, 2.5f, 3.25), 0.0, std::plus<>(), [](auto p_value) { return p_value * 2; });
+    EXPECT_EQ(mixed, 13.5);
+
+    EXPECT_EQ(mg::transform_reduce(&pool, std::tuple<>(), 5, std::plus<>(), length), 5);
+}
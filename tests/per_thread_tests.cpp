@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <mg/per_thread.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <latch>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(cache_padded, layout) {
+    using padded = mg::cache_padded<std::atomic<std::uint64_t>>;
+    static_assert(alignof(padded) == padded::alignment);
+    static_assert(sizeof(padded) % padded::alignment == 0);
+    static_assert(padded::alignment >= 64);
+
+    std::array<padded, 4> counters;
+    for (auto& counter : counters)
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&counter.get()) % padded::alignment, 0);
+        EXPECT_EQ(counter->load(), 0);
+    }
+
+    const mg::cache_padded<std::string> text(std::in_place, 3, 'x');
+    EXPECT_EQ(*text, "xxx");
+    EXPECT_EQ(text->size(), 3);
+}
+
+TEST(per_thread, combines_thread_values) {
+    mg::per_thread<std::uint64_t> counter;
+    EXPECT_EQ(counter.combine(std::plus<>()), 0);
+    EXPECT_EQ(counter.size(), 0);
+
+    constexpr int Threads = 8;
+    std::latch started(Threads);
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < Threads; ++t)
+        {
+            threads.emplace_back([&]
+                {
+                    // Every thread holds its slot at once, so each needs its own.
+                    auto& local = counter.local();
+                    started.arrive_and_wait();
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        ++counter.local();
+                    }
+
+                    EXPECT_EQ(&local, &counter.local());
+                });
+        }
+    }
+
+    EXPECT_EQ(counter.size(), Threads);
+    EXPECT_EQ(counter.combine(std::plus<>()), Threads * 1000);
+
+    std::size_t visited = 0;
+    counter.for_each([&](std::uint64_t p_value) { visited += p_value == 1000 ? 1 : 0; });
+    EXPECT_EQ(visited, Threads);
+}
+
+TEST(per_thread, slots_are_reused_after_thread_exit) {
+    mg::per_thread<std::vector<int>> values([] { return std::vector<int>{ -1 }; });
+
+    for (int t = 0; t < 10; ++t)
+    {
+        std::jthread([&, t] { values.local().push_back(t); }).join();
+    }
+
+    // Each thread took over the previous thread's slot, value included.
+    EXPECT_EQ(values.size(), 1);
+    const auto all = values.combine([](std::vector<int> p_left, const std::vector<int>& p_right)
+        {
+            p_left.insert(p_left.end(), p_right.begin(), p_right.end());
+            return p_left;
+        });
+    EXPECT_EQ(all, (std::vector<int>{ -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+}
+
+TEST(per_thread, instances_are_independent) {
+    {
+        mg::per_thread<int> first;
+        first.local() = 5;
+    }
+
+    // A new instance may reuse the destroyed instance's index, but not its slot.
+    mg::per_thread<int> second;
+    mg::per_thread<int> third([] { return 7; });
+    EXPECT_EQ(second.local(), 0);
+    EXPECT_EQ(third.local(), 7);
+    second.local() = 1;
+    EXPECT_EQ(third.local(), 7);
+
+    // Threads may outlive the instance they used.
+    std::latch used(1);
+    std::latch destroyed(1);
+    auto temporary = std::make_unique<mg::per_thread<int>>();
+    std::jthread thread([&]
+        {
+            temporary->local() = 3;
+            used.count_down();
+            destroyed.wait();
+        });
+
+    used.wait();
+    EXPECT_EQ(temporary->combine(std::plus<>()), 3);
+    temporary.reset();
+    destroyed.count_down();
+}
@@ -0,0 +1,106 @@
+// Built as its own test executable with MG_ENABLE_PROBES=1, to test the macros and the hooks in mg algorithms.
+
+#include <gtest/gtest.h>
+
+#include <mg/collections.hpp>
+#include <mg/probe.hpp>
+
+#include <chrono>
+#include <deque>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(probe, counters_aggregate_across_threads) {
+    const mg::probe::counter counter("test.probe.counter");
+
+    std::vector<std::jthread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&]
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    counter.add();
+                }
+            });
+    }
+
+    counter.add(5);
+    threads.clear();
+
+    // The exited threads' values are retained.
+    auto reading = mg::probe::read("test.probe.counter");
+    ASSERT_TRUE(reading.has_value());
+    EXPECT_EQ(reading->kind, mg::probe::kind::counter);
+    EXPECT_EQ(reading->value, 4005);
+
+    // Probes with the same name share values, but not across kinds.
+    mg::probe::counter("test.probe.counter").add(1);
+    EXPECT_EQ(mg::probe::read("test.probe.counter")->value, 4006);
+    EXPECT_THROW(mg::probe::gauge("test.probe.counter"), std::invalid_argument);
+}
+
+TEST(probe, gauges_sum_contributions) {
+    const mg::probe::gauge gauge("test.probe.gauge");
+
+    gauge.add(5);
+    std::jthread([&] { gauge.add(-2); }).join();
+    EXPECT_EQ(mg::probe::read("test.probe.gauge")->value, 3);
+}
+
+TEST(probe, timers) {
+    const mg::probe::timer timer("test.probe.timer");
+    {
+        mg::probe::scoped_timer scope(timer);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    auto reading = mg::probe::read("test.probe.timer");
+    ASSERT_TRUE(reading.has_value());
+    EXPECT_EQ(reading->value, 1);
+    EXPECT_GE(reading->total_ns, 1.5e6);
+    EXPECT_LT(reading->total_ns, 1e9);
+    EXPECT_DOUBLE_EQ(reading->max_ns, reading->total_ns);
+
+    timer.record(0);
+    EXPECT_EQ(mg::probe::read("test.probe.timer")->value, 2);
+}
+
+TEST(probe, macros) {
+    static_assert(mg::probe::enabled);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        MG_PROBE_SCOPE("test.probe.macro_scope");
+        MG_PROBE_COUNT("test.probe.macro_count", 2);
+        MG_PROBE_GAUGE("test.probe.macro_gauge", i % 2 == 0 ? 1 : -1);
+    }
+
+    EXPECT_EQ(mg::probe::read("test.probe.macro_scope")->value, 10);
+    EXPECT_EQ(mg::probe::read("test.probe.macro_count")->value, 20);
+    EXPECT_EQ(mg::probe::read("test.probe.macro_gauge")->value, 0);
+}
+
+TEST(probe, all_unique_hooks) {
+    // A container type used nowhere else, so that this instantiation of all_unique is the only one.
+    std::deque<short> values{ 1, 2, 3, 4 };
+    const auto before = mg::probe::read("mg.all_unique").value_or(mg::probe::reading{}).value;
+    const auto elementsBefore = mg::probe::read("mg.all_unique.elements").value_or(mg::probe::reading{}).value;
+
+    EXPECT_TRUE(mg::all_unique(values.begin(), values.end()));
+    values.push_back(2);
+    EXPECT_FALSE(mg::all_unique(values.begin(), values.end()));
+
+    EXPECT_EQ(mg::probe::read("mg.all_unique")->value - before, 2);
+    EXPECT_EQ(mg::probe::read("mg.all_unique.elements")->value - elementsBefore, 9);
+}
+
+TEST(probe, reset) {
+    const mg::probe::counter counter("test.probe.reset");
+    counter.add(3);
+    mg::probe::reset();
+    EXPECT_EQ(mg::probe::read("test.probe.reset")->value, 0);
+    counter.add(1);
+    EXPECT_EQ(mg::probe::read("test.probe.reset")->value, 1);
+}
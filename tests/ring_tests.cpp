@@ -0,0 +1,352 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mg/ring.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ::testing::ElementsAre;
+
+namespace
+{
+    struct counted
+    {
+        explicit counted(int p_value, bool p_throw = false)
+            : m_value(p_value)
+        {
+            if (p_throw)
+            {
+                throw std::runtime_error("construction failed");
+            }
+
+            ++s_alive;
+        }
+
+        counted(counted&& p_other) noexcept
+            : m_value(p_other.m_value)
+        {
+            ++s_alive;
+        }
+
+        counted& operator=(counted&&) noexcept = default;
+
+        ~counted()
+        {
+            --s_alive;
+        }
+
+        int m_value;
+        static inline int s_alive = 0;
+    };
+
+    constexpr std::uint64_t StressCount = 100000;
+}
+
+TEST(spsc_ring, fifo_and_capacity) {
+    mg::spsc_ring<int> ring(5);
+    EXPECT_EQ(ring.capacity(), 8u);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+
+    EXPECT_FALSE(ring.try_push(8));
+    EXPECT_EQ(ring.size_approx(), 8u);
+
+    // Wrap around the end of the storage a few times.
+    for (int i = 8; i < 100; ++i)
+    {
+        EXPECT_EQ(ring.try_pop(), i - 8);
+        EXPECT_TRUE(ring.try_push(i));
+    }
+
+    for (int i = 92; i < 100; ++i)
+    {
+        EXPECT_EQ(ring.pop(), i);
+    }
+
+    EXPECT_EQ(ring.try_pop(), std::nullopt);
+    EXPECT_THROW(mg::spsc_ring<int>(0), std::invalid_argument);
+}
+
+TEST(spsc_ring, compile_time_capacity) {
+    mg::spsc_ring<std::string, 4> ring;
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    EXPECT_TRUE(ring.try_emplace(3, 'a'));
+    std::string text = "moved";
+    EXPECT_TRUE(ring.try_push(std::move(text)));
+    EXPECT_EQ(ring.try_pop(), "aaa");
+    EXPECT_EQ(ring.try_pop(), "moved");
+}
+
+TEST(spsc_ring, batches) {
+    mg::spsc_ring<int, 8> ring;
+    std::vector<int> input(12);
+    std::iota(input.begin(), input.end(), 0);
+
+    EXPECT_EQ(ring.try_push_n(input.begin(), input.size()), 8u);
+    EXPECT_EQ(ring.try_push_n(input.begin() + 8, 4), 0u);
+
+    std::array<int, 3> output{};
+    EXPECT_EQ(ring.try_pop_n(output.begin(), output.size()), 3u);
+    EXPECT_THAT(output, ElementsAre(0, 1, 2));
+
+    EXPECT_EQ(ring.try_push_n(input.begin() + 8, 4), 3u);
+
+    std::vector<int> rest;
+    EXPECT_EQ(ring.try_pop_n(std::back_inserter(rest), 100), 8u);
+    EXPECT_THAT(rest, ElementsAre(3, 4, 5, 6, 7, 8, 9, 10));
+    EXPECT_EQ(ring.try_pop_n(std::back_inserter(rest), 100), 0u);
+}
+
+TEST(spsc_ring, element_lifetimes) {
+    {
+        mg::spsc_ring<counted> ring(4);
+        EXPECT_TRUE(ring.try_emplace(1));
+        EXPECT_THROW(ring.try_emplace(2, true), std::runtime_error);
+        EXPECT_EQ(ring.size_approx(), 1u);
+        EXPECT_TRUE(ring.try_emplace(3));
+        EXPECT_EQ(ring.try_pop()->m_value, 1);
+        EXPECT_TRUE(ring.try_emplace(4));
+        EXPECT_EQ(counted::s_alive, 2);
+    }
+
+    EXPECT_EQ(counted::s_alive, 0);
+}
+
+TEST(spsc_ring, blocking_stress) {
+    mg::spsc_ring<std::uint64_t> ring(64);
+
+    std::jthread producer([&]
+        {
+            std::array<std::uint64_t, 16> batch;
+            std::uint64_t next = 0;
+            while (next < StressCount)
+            {
+                // Alternate between single pushes and batches to exercise both publication paths.
+                if (next % 3 == 0)
+                {
+                    ring.push(next++);
+                    continue;
+                }
+
+                const auto size = std::min<std::uint64_t>(batch.size(), StressCount - next);
+                std::iota(batch.begin(), batch.begin() + size, next);
+                const auto pushed = ring.try_push_n(batch.begin(), size);
+                if (pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+
+                next += pushed;
+            }
+        });
+
+    std::uint64_t expected = 0;
+    std::array<std::uint64_t, 32> batch;
+    while (expected < StressCount)
+    {
+        if (expected % 2 == 0)
+        {
+            ASSERT_EQ(ring.pop(), expected++);
+            continue;
+        }
+
+        const auto count = ring.try_pop_n(batch.begin(), batch.size());
+        if (count == 0)
+        {
+            std::this_thread::yield();
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(batch[i], expected++);
+        }
+    }
+}
+
+TEST(spsc_ring, sleeping_consumer_is_woken) {
+    mg::spsc_ring<int, 2, mg::blocking_wait> ring;
+
+    std::jthread producer([&]
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ring.push(i);
+            }
+        });
+
+    for (int i = 0; i < 20; ++i)
+    {
+        EXPECT_EQ(ring.pop(), i);
+    }
+}
+
+TEST(mpmc_ring, fifo_and_batches) {
+    mg::mpmc_ring<std::unique_ptr<int>> ring(4);
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    EXPECT_TRUE(ring.try_push(std::make_unique<int>(1)));
+    EXPECT_TRUE(ring.try_emplace(new int(2)));
+
+    std::vector<std::unique_ptr<int>> input;
+    for (int i = 3; i <= 6; ++i)
+    {
+        input.push_back(std::make_unique<int>(i));
+    }
+
+    EXPECT_EQ(ring.try_push_n(input.begin(), input.size()), 2u);
+    EXPECT_EQ(input[0], nullptr);
+    EXPECT_NE(input[2], nullptr);
+    EXPECT_FALSE(ring.try_push(std::move(input[2])));
+    EXPECT_NE(input[2], nullptr);
+
+    EXPECT_EQ(*ring.pop(), 1);
+
+    std::vector<std::unique_ptr<int>> output;
+    EXPECT_EQ(ring.try_pop_n(std::back_inserter(output), 8), 3u);
+    ASSERT_EQ(output.size(), 3u);
+    EXPECT_EQ(*output[0], 2);
+    EXPECT_EQ(*output[2], 4);
+    EXPECT_EQ(ring.try_pop(), std::nullopt);
+}
+
+TEST(mpmc_ring, compile_time_capacity_and_cleanup) {
+    {
+        mg::mpmc_ring<counted, 8, mg::busy_wait> ring;
+        for (int i = 0; i < 5; ++i)
+        {
+            EXPECT_TRUE(ring.try_push(counted(i)));
+        }
+
+        EXPECT_EQ(ring.try_pop()->m_value, 0);
+        EXPECT_EQ(counted::s_alive, 4);
+    }
+
+    EXPECT_EQ(counted::s_alive, 0);
+}
+
+TEST(mpmc_ring, stress) {
+    constexpr std::size_t Producers = 4;
+    constexpr std::size_t Consumers = 4;
+    constexpr std::uint64_t PerProducer = StressCount / Producers;
+
+    // Values carry their producer in the top bits so that per-producer ordering can be checked.
+    mg::mpmc_ring<std::uint64_t, std::dynamic_extent, mg::yield_wait> ring(64);
+    std::atomic<std::uint64_t> consumed{ 0 };
+    std::atomic<std::uint64_t> sum{ 0 };
+    std::atomic<bool> ordered{ true };
+
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t p = 0; p < Producers; ++p)
+        {
+            threads.emplace_back([&, p]
+                {
+                    std::array<std::uint64_t, 8> batch;
+                    std::uint64_t next = 0;
+                    while (next < PerProducer)
+                    {
+                        if (p % 2 == 0)
+                        {
+                            ring.push((p << 32) | next++);
+                            continue;
+                        }
+
+                        const auto size = std::min<std::uint64_t>(batch.size(), PerProducer - next);
+                        for (std::size_t i = 0; i < size; ++i)
+                        {
+                            batch[i] = (p << 32) | (next + i);
+                        }
+
+                        const auto pushed = ring.try_push_n(batch.begin(), size);
+                        if (pushed == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+
+                        next += pushed;
+                    }
+                });
+        }
+
+        for (std::size_t c = 0; c < Consumers; ++c)
+        {
+            threads.emplace_back([&, c]
+                {
+                    std::array<std::uint64_t, Producers> last;
+                    last.fill(~std::uint64_t(0));
+                    std::array<std::uint64_t, 8> batch;
+                    while (consumed.load() < Producers * PerProducer)
+                    {
+                        const auto count = c % 2 == 0
+                            ? ring.try_pop_n(batch.begin(), batch.size())
+                            : ring.try_pop_n(batch.begin(), 1);
+                        for (std::size_t i = 0; i < count; ++i)
+                        {
+                            const auto producer = batch[i] >> 32;
+                            const auto value = batch[i] & 0xffffffff;
+                            if (last[producer] != ~std::uint64_t(0) && value <= last[producer])
+                            {
+                                ordered = false;
+                            }
+
+                            last[producer] = value;
+                            sum += value;
+                        }
+
+                        consumed += count;
+                        if (count == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+    }
+
+    EXPECT_EQ(consumed, Producers * PerProducer);
+    EXPECT_EQ(sum, Producers * (PerProducer * (PerProducer - 1) / 2));
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(ring.size_approx(), 0u);
+}
+
+TEST(mpmc_ring, blocking_many_to_one) {
+    mg::mpmc_ring<int, 2> ring;
+
+    {
+        std::vector<std::jthread> producers;
+        for (int p = 0; p < 3; ++p)
+        {
+            producers.emplace_back([&]
+                {
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        ring.push(1);
+                    }
+                });
+        }
+
+        int total = 0;
+        for (int i = 0; i < 3000; ++i)
+        {
+            total += ring.pop();
+        }
+
+        EXPECT_EQ(total, 3000);
+    }
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+
+#include <mg/mapped_file.hpp>
+#include <mg/packed_tuple.hpp>
+#include <mg/serialize.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    enum class color : std::uint16_t
+    {
+        red = 1,
+        blue = 300
+    };
+
+    struct vec3
+    {
+        float m_x;
+        float m_y;
+        float m_z;
+
+        bool operator==(const vec3&) const = default;
+    };
+
+    using record = std::tuple<std::uint32_t, std::int64_t, double, color, bool, std::string, std::vector<std::int16_t>, std::pair<char, float>>;
+
+    record sample_record(int p_seed)
+    {
+        return {
+            static_cast<std::uint32_t>(p_seed * 2654435761u),
+            -p_seed * 1'000'003LL,
+            p_seed / 7.0,
+            p_seed % 2 == 0 ? color::red : color::blue,
+            p_seed % 3 == 0,
+            std::string(static_cast<std::size_t>(p_seed % 5), 'x'),
+            std::vector<std::int16_t>(static_cast<std::size_t>(p_seed % 4), static_cast<std::int16_t>(-p_seed)),
+            { static_cast<char>('a' + p_seed % 26), p_seed * 0.5f } };
+    }
+
+    template <typename Format, typename T>
+    T round_trip(const T& p_value)
+    {
+        std::vector<std::byte> buffer;
+        mg::serialize<Format>(p_value, buffer);
+        EXPECT_LE(buffer.size(), mg::max_serialized_size<Format>(p_value));
+
+        std::span<const std::byte> in(buffer);
+        auto result = mg::deserialize<T, Format>(in);
+        EXPECT_TRUE(in.empty());
+        return result;
+    }
+
+    template <typename T>
+    std::vector<std::uint8_t> bytes_of(const T& p_value)
+    {
+        std::vector<std::byte> buffer;
+        mg::serialize(p_value, buffer);
+        std::vector<std::uint8_t> result;
+        for (const auto byte : buffer)
+        {
+            result.push_back(std::to_integer<std::uint8_t>(byte));
+        }
+
+        return result;
+    }
+}
+
+TEST(serialize, scalars_in_byte_order) {
+    std::vector<std::byte> little;
+    std::vector<std::byte> big;
+    mg::serialize(std::uint32_t(0x01020304), little);
+    mg::serialize<mg::wire_format<std::endian::big>>(std::uint32_t(0x01020304), big);
+    EXPECT_EQ(little, (std::vector<std::byte>{ std::byte(4), std::byte(3), std::byte(2), std::byte(1) }));
+    EXPECT_EQ(big, (std::vector<std::byte>{ std::byte(1), std::byte(2), std::byte(3), std::byte(4) }));
+
+    using big_endian = mg::wire_format<std::endian::big>;
+    EXPECT_EQ(round_trip<big_endian>(-1.25), -1.25);
+    EXPECT_EQ(round_trip<big_endian>(std::numeric_limits<float>::max()), std::numeric_limits<float>::max());
+    EXPECT_EQ(round_trip<big_endian>(color::blue), color::blue);
+    EXPECT_EQ(round_trip<big_endian>(std::int16_t(-2)), std::int16_t(-2));
+    EXPECT_EQ(round_trip<mg::wire_format<>>(true), true);
+}
+
+TEST(serialize, varints) {
+    // Small magnitudes take a byte, signed ones by zigzag encoding.
+    EXPECT_EQ(mg::max_serialized_size<mg::varint_format>(std::uint64_t(127)), 1);
+    EXPECT_EQ(mg::max_serialized_size<mg::varint_format>(std::int32_t(-64)), 1);
+    EXPECT_EQ(mg::max_serialized_size<mg::varint_format>(std::uint64_t(128)), 2);
+    EXPECT_EQ(mg::max_serialized_size<mg::varint_format>(std::numeric_limits<std::uint64_t>::max()), 10);
+
+    for (const auto value : { std::numeric_limits<std::int64_t>::min(), std::int64_t(-1), std::int64_t(0), std::numeric_limits<std::int64_t>::max() })
+    {
+        EXPECT_EQ(round_trip<mg::varint_format>(value), value);
+    }
+
+    EXPECT_EQ(round_trip<mg::varint_format>(std::numeric_limits<std::int16_t>::min()), std::numeric_limits<std::int16_t>::min());
+    EXPECT_EQ(round_trip<mg::varint_format>(color::blue), color::blue);
+
+    // A value too wide for the type being read, and an overlong encoding.
+    std::vector<std::byte> buffer;
+    mg::serialize<mg::varint_format>(std::uint32_t(70'000), buffer);
+    std::span<const std::byte> in(buffer);
+    EXPECT_THROW((mg::deserialize<std::uint16_t, mg::varint_format>(in)), std::invalid_argument);
+
+    const std::vector<std::byte> overlong(11, std::byte(0x80));
+    in = overlong;
+    EXPECT_THROW((mg::deserialize<std::uint64_t, mg::varint_format>(in)), std::invalid_argument);
+}
+
+TEST(serialize, tuples_and_sequences) {
+    std::vector<record> records;
+    for (int i = 0; i < 50; ++i)
+    {
+        records.push_back(sample_record(i));
+    }
+
+    EXPECT_EQ(round_trip<mg::wire_format<>>(records), records);
+    EXPECT_EQ(round_trip<mg::wire_format<std::endian::big>>(records), records);
+    EXPECT_EQ(round_trip<mg::varint_format>(records), records);
+
+    const mg::packed_tuple<char, std::uint64_t, std::uint16_t> packed('p', 1ull << 40, 7);
+    EXPECT_EQ(round_trip<mg::wire_format<std::endian::big>>(packed), packed);
+
+    const std::vector<bool> flags{ true, false, true };
+    EXPECT_EQ(round_trip<mg::wire_format<>>(flags), flags);
+
+    // Every truncation of the encoding is detected.
+    std::vector<std::byte> buffer;
+    mg::serialize<mg::varint_format>(records[7], buffer);
+    for (std::size_t size = 0; size < buffer.size(); ++size)
+    {
+        std::span<const std::byte> in(buffer.data(), size);
+        EXPECT_THROW((mg::deserialize<record, mg::varint_format>(in)), std::invalid_argument) << size;
+    }
+
+    std::array<std::byte, 8> small;
+    EXPECT_THROW(mg::serialize(records[7], std::span<std::byte>(small)), std::length_error);
+}
+
+TEST(serialize, raw_values_are_copied_whole) {
+    // Tuple-like values without padding, and arrays of them, are their object representation.
+    const std::array<std::uint32_t, 3> triple{ 1, 2, 3 };
+    std::vector<std::uint8_t> expected(sizeof(triple));
+    std::memcpy(expected.data(), triple.data(), sizeof(triple));
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        EXPECT_EQ(bytes_of(triple), expected);
+    }
+
+    const std::vector<vec3> points{ { 1, 2, 3 }, { 4, 5, 6 } };
+    EXPECT_EQ(round_trip<mg::wire_format<std::endian::native>>(points), points);
+
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs{ { 1, 2 }, { 3, 4 } };
+    EXPECT_EQ(round_trip<mg::wire_format<std::endian::big>>(pairs), pairs);
+    EXPECT_EQ(round_trip<mg::wire_format<std::endian::native>>(pairs), pairs);
+
+    // Arrays of raw elements can be viewed where they lie.
+    std::vector<std::byte> buffer;
+    mg::serialize(std::string("header"), buffer);
+    mg::serialize<mg::wire_format<std::endian::native>>(points, buffer);
+    std::span<const std::byte> in(buffer);
+    EXPECT_EQ(mg::deserialize<std::string>(in), "header");
+    const auto view = mg::view_array<vec3, mg::wire_format<std::endian::native>>(in);
+    ASSERT_EQ(view.size(), 2);
+    EXPECT_EQ(view[1], (vec3{ 4, 5, 6 }));
+    EXPECT_GE(reinterpret_cast<const std::byte*>(view.data()), buffer.data());
+    EXPECT_LT(reinterpret_cast<const std::byte*>(view.data()), buffer.data() + buffer.size());
+    EXPECT_TRUE(in.empty());
+}
+
+TEST(serialize, array_padding_is_relative_to_the_buffer) {
+    // The count, the padding length, padding to a multiple of 4 from the start, then the elements.
+    const std::vector<std::uint32_t> values{ 1, 2 };
+    EXPECT_EQ(bytes_of(values), (std::vector<std::uint8_t>{ 2, 2, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0 }));
+
+    std::vector<std::byte> buffer;
+    mg::serialize(std::string("a"), buffer);
+    mg::serialize(values, buffer);
+    ASSERT_EQ(buffer.size(), 12);
+    EXPECT_EQ(std::to_integer<int>(buffer[3]), 0);
+
+    // The same bytes wherever the buffer lies in memory.
+    std::array<std::byte, 32> storage{};
+    for (std::size_t offset = 1; offset < 4; ++offset)
+    {
+        const auto out = std::span<std::byte>(storage).subspan(offset);
+        const auto written = mg::serialize(values, out);
+        ASSERT_EQ(written, 12);
+        EXPECT_EQ(std::memcmp(out.data(), bytes_of(values).data(), written), 0) << offset;
+    }
+}
+
+TEST(serialize, columns) {
+    using row = std::tuple<std::uint64_t, float, std::int16_t, char>;
+    std::vector<row> rows;
+    for (int i = 0; i < 1000; ++i)
+    {
+        rows.emplace_back(static_cast<std::uint64_t>(i) * 977, i * 0.25f, static_cast<std::int16_t>(-i), static_cast<char>('a' + i % 26));
+    }
+
+    std::vector<std::byte> buffer;
+    mg::serialize_columns(rows, buffer);
+    mg::serialize_columns<mg::wire_format<std::endian::big>>(std::span<const row>(rows).first(10), buffer);
+    mg::serialize_columns<mg::varint_format>(rows, buffer);
+
+    std::span<const std::byte> in(buffer);
+    const auto [ids, weights, deltas, letters] = mg::view_columns<row>(in);
+    ASSERT_EQ(ids.size(), rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+        EXPECT_EQ(std::tie(ids[i], weights[i], deltas[i], letters[i]), rows[i]) << i;
+    }
+
+    EXPECT_EQ((mg::deserialize_columns<row, mg::wire_format<std::endian::big>>(in)), std::vector<row>(rows.begin(), rows.begin() + 10));
+    EXPECT_EQ((mg::deserialize_columns<row, mg::varint_format>(in)), rows);
+    EXPECT_TRUE(in.empty());
+}
+
+TEST(serialize, mapped_and_heap_buffers) {
+    std::vector<record> records;
+    for (int i = 0; i < 200; ++i)
+    {
+        records.push_back(sample_record(i));
+    }
+
+    using row = std::tuple<std::uint32_t, double>;
+    std::vector<row> rows;
+    for (int i = 0; i < 200; ++i)
+    {
+        rows.emplace_back(i, i * 1.5);
+    }
+
+    const mg::mapped_memory mapped(1 << 20);
+    std::vector<std::byte> heap(1 << 20);
+    for (const auto buffer : { mapped.bytes(), std::span<std::byte>(heap) })
+    {
+        // The columns go first, so that they are aligned relative to the (aligned) start.
+        auto written = mg::serialize_columns(rows, buffer);
+        written += mg::serialize(records, buffer.subspan(written));
+
+        std::span<const std::byte> in(buffer.data(), written);
+        const auto [ids, values] = mg::view_columns<row>(in);
+        EXPECT_EQ(ids.size(), rows.size());
+        EXPECT_EQ(values[199], 199 * 1.5);
+        EXPECT_GE(reinterpret_cast<const std::byte*>(values.data()), buffer.data());
+        EXPECT_EQ(mg::deserialize<std::vector<record>>(in), records);
+        EXPECT_TRUE(in.empty());
+    }
+}
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+
+#include <mg/functional.hpp>
+#include <mg/snapshot_ptr.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <latch>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /// <summary>
+    /// Counts the live instances, and marks itself dead when destroyed so that a reader of a freed
+    /// version sees it (and the sanitizers see the use after free).
+    /// </summary>
+    struct tracked
+    {
+        static inline std::atomic<int> s_live{ 0 };
+
+        explicit tracked(std::uint64_t p_value)
+            : m_first(p_value),
+            m_second(p_value * 3)
+        {
+            s_live.fetch_add(1);
+        }
+
+        tracked(const tracked& p_other)
+            : m_first(p_other.m_first),
+            m_second(p_other.m_second)
+        {
+            s_live.fetch_add(1);
+        }
+
+        ~tracked()
+        {
+            m_alive = false;
+            s_live.fetch_sub(1);
+        }
+
+        bool consistent() const noexcept
+        {
+            return m_alive && m_second == m_first * 3;
+        }
+
+        std::uint64_t m_first;
+        std::uint64_t m_second;
+        bool m_alive = true;
+    };
+
+    struct settings
+    {
+        int retries;
+    };
+
+    mg::snapshot_ptr<settings> g_settings(std::make_unique<settings>(settings{ 3 }));
+
+    struct current_retries
+    {
+        int operator()() const
+        {
+            return g_settings.read()->retries;
+        }
+    };
+
+    int attempts(int p_failures, int p_retries)
+    {
+        return p_failures <= p_retries ? p_failures + 1 : p_retries + 1;
+    }
+}
+
+TEST(snapshot_ptr, read_and_store) {
+    mg::epoch_domain domain;
+    {
+        mg::snapshot_ptr<tracked> ptr(domain);
+        EXPECT_FALSE(ptr.read());
+
+        ptr.emplace(1u);
+        auto first = ptr.read();
+        ASSERT_TRUE(first);
+        EXPECT_EQ(first->m_first, 1u);
+
+        // The old version stays valid while a snapshot of it is held.
+        ptr.store(std::make_unique<tracked>(2u));
+        EXPECT_EQ(ptr.read()->m_first, 2u);
+        EXPECT_TRUE(first->consistent());
+        EXPECT_EQ(tracked::s_live.load(), 2);
+        EXPECT_EQ(domain.pending(), 1u);
+
+        first = {};
+        EXPECT_EQ(domain.reclaim(), 1u);
+        EXPECT_EQ(tracked::s_live.load(), 1);
+    }
+
+    // The last version is retired with the pointer, and freed at once since no reader holds it.
+    EXPECT_EQ(domain.pending(), 0u);
+    EXPECT_EQ(tracked::s_live.load(), 0);
+}
+
+TEST(snapshot_ptr, nested_pins) {
+    mg::epoch_domain domain;
+    auto* object = new tracked(5u);
+    {
+        auto outer = domain.pin();
+        {
+            auto inner = domain.pin();
+            domain.retire(object);
+        }
+
+        // The outer pin still protects the object.
+        EXPECT_EQ(domain.reclaim(), 0u);
+        EXPECT_TRUE(object->consistent());
+
+        auto moved = std::move(outer);
+        EXPECT_FALSE(outer);
+        EXPECT_TRUE(moved);
+        EXPECT_EQ(domain.reclaim(), 0u);
+    }
+
+    EXPECT_EQ(domain.reclaim(), 1u);
+    EXPECT_EQ(tracked::s_live.load(), 0);
+}
+
+TEST(snapshot_ptr, pins_on_other_threads) {
+    mg::epoch_domain domain;
+    mg::snapshot_ptr<tracked> ptr(std::make_unique<tracked>(1u), domain);
+
+    std::latch pinned(1);
+    std::latch retired(1);
+    std::jthread reader([&]
+        {
+            const auto snapshot = ptr.read();
+            pinned.count_down();
+            retired.wait();
+            EXPECT_TRUE(snapshot->consistent());
+            EXPECT_EQ(snapshot->m_first, 1u);
+        });
+
+    pinned.wait();
+    ptr.emplace(2u);
+    EXPECT_EQ(domain.reclaim(), 0u);
+    retired.count_down();
+    reader.join();
+
+    EXPECT_EQ(domain.reclaim(), 1u);
+}
+
+TEST(snapshot_ptr, concurrent_updates) {
+    mg::epoch_domain domain;
+    mg::snapshot_ptr<tracked> ptr(domain);
+    EXPECT_THROW(ptr.update([](tracked&) {}), std::logic_error);
+    ptr.emplace(0u);
+
+    constexpr int Threads = 4;
+    constexpr int Updates = 2000;
+    {
+        std::vector<std::jthread> writers;
+        for (int t = 0; t < Threads; ++t)
+        {
+            writers.emplace_back([&]
+                {
+                    for (int i = 0; i < Updates; ++i)
+                    {
+                        ptr.update([](tracked& p_value)
+                            {
+                                ++p_value.m_first;
+                                p_value.m_second = p_value.m_first * 3;
+                            });
+                    }
+                });
+        }
+    }
+
+    // No update was lost to another writer.
+    EXPECT_EQ(ptr.read()->m_first, std::uint64_t(Threads) * Updates);
+    domain.synchronize();
+    EXPECT_EQ(tracked::s_live.load(), 1);
+}
+
+TEST(snapshot_ptr, readers_during_writes) {
+    mg::epoch_domain domain;
+    {
+        mg::snapshot_ptr<tracked> ptr(std::make_unique<tracked>(0u), domain);
+        std::atomic<bool> done{ false };
+        std::atomic<std::uint64_t> inconsistent{ 0 };
+
+        constexpr int Readers = 4;
+        std::vector<std::jthread> readers;
+        for (int t = 0; t < Readers; ++t)
+        {
+            readers.emplace_back([&]
+                {
+                    std::uint64_t last = 0;
+                    while (!done.load(std::memory_order_relaxed))
+                    {
+                        const auto snapshot = ptr.read();
+                        if (!snapshot->consistent() || snapshot->m_first < last)
+                        {
+                            inconsistent.fetch_add(1);
+                        }
+
+                        last = snapshot->m_first;
+                    }
+                });
+        }
+
+        for (std::uint64_t i = 1; i <= 5000; ++i)
+        {
+            ptr.emplace(i);
+            if (i % 64 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        done = true;
+        readers.clear();
+        EXPECT_EQ(inconsistent.load(), 0u);
+        EXPECT_EQ(ptr.read()->m_first, 5000u);
+    }
+
+    domain.synchronize();
+    EXPECT_EQ(tracked::s_live.load(), 0);
+}
+
+TEST(snapshot_ptr, default_provider) {
+    g_settings.emplace(settings{ 3 });
+    auto retrying = mg::func_with_defaults<&attempts, current_retries>();
+    EXPECT_EQ(retrying(1), 2);
+    EXPECT_EQ(retrying(5), 4);
+
+    g_settings.update([](settings& p_settings) { p_settings.retries = 10; });
+    EXPECT_EQ(retrying(5), 6);
+    EXPECT_EQ(retrying(5, 1), 2);
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mg/collections.hpp>
+#include <mg/soa_vector.hpp>
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+TEST(soa_vector, push_and_index) {
+    mg::soa_vector<int, double, char> vec;
+    EXPECT_TRUE(vec.empty());
+
+    vec.push_back({ 1, 1.5, 'a' });
+    vec.emplace_back(2, 2.5, 'b');
+
+    ASSERT_EQ(vec.size(), 2);
+    EXPECT_EQ(vec[0], std::make_tuple(1, 1.5, 'a'));
+    EXPECT_EQ(vec[1], std::make_tuple(2, 2.5, 'b'));
+
+    std::get<1>(vec[0]) = 10.0;
+    EXPECT_EQ(vec.column<1>()[0], 10.0);
+
+    EXPECT_THROW(vec.at(2), std::out_of_range);
+}
+
+TEST(soa_vector, columns_are_contiguous_and_aligned) {
+    mg::soa_vector<char, std::int64_t, std::int16_t> vec(100);
+    EXPECT_EQ(vec.size(), 100);
+
+    auto chars = vec.column<0>();
+    auto longs = vec.column<1>();
+    auto shorts = vec.column<2>();
+    EXPECT_EQ(chars.size(), 100);
+    EXPECT_EQ(longs.size(), 100);
+    EXPECT_EQ(shorts.size(), 100);
+
+    for (const void* column : { static_cast<const void*>(chars.data()), static_cast<const void*>(longs.data()), static_cast<const void*>(shorts.data()) })
+    {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(column) % decltype(vec)::column_alignment, 0);
+    }
+
+    EXPECT_THAT(longs, testing::Each(0));
+}
+
+TEST(soa_vector, growth_preserves_records) {
+    mg::soa_vector<std::string, int> vec;
+    for (int i = 0; i < 1000; ++i)
+    {
+        vec.emplace_back(std::to_string(i), i);
+    }
+
+    ASSERT_EQ(vec.size(), 1000);
+    EXPECT_GE(vec.capacity(), 1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(vec[i], std::make_tuple(std::to_string(i), i));
+    }
+
+    vec.resize(10);
+    EXPECT_EQ(vec.size(), 10);
+    vec.pop_back();
+    EXPECT_EQ(std::get<0>(vec.back()), "8");
+}
+
+TEST(soa_vector, emplace_own_element_while_growing) {
+    mg::soa_vector<std::string, int> vec;
+    vec.emplace_back(std::string(100, 'x'), 1);
+    while (vec.size() < vec.capacity())
+    {
+        vec.emplace_back("filler", 0);
+    }
+
+    const auto capacity = vec.capacity();
+    vec.emplace_back(vec.column<0>()[0], std::get<1>(vec[0]));
+    EXPECT_GT(vec.capacity(), capacity);
+    EXPECT_EQ(vec.back(), std::make_tuple(std::string(100, 'x'), 1));
+    EXPECT_EQ(vec.front(), vec.back());
+}
+
+TEST(soa_vector, copy_and_move) {
+    mg::soa_vector<std::string, int> original{ { "a", 1 }, { "b", 2 } };
+
+    auto copy = original;
+    std::get<0>(copy[0]) = "changed";
+    EXPECT_EQ(std::get<0>(original[0]), "a");
+
+    auto moved = std::move(original);
+    EXPECT_TRUE(original.empty());
+    ASSERT_EQ(moved.size(), 2);
+    EXPECT_EQ(moved[1], std::make_tuple(std::string("b"), 2));
+}
+
+TEST(soa_vector, failed_emplace_leaves_vector_unchanged) {
+    struct Throwing
+    {
+        Throwing(bool p_throw)
+        {
+            if (p_throw)
+            {
+                throw std::runtime_error("construction failed");
+            }
+        }
+    };
+
+    mg::soa_vector<std::string, Throwing> vec;
+    vec.emplace_back("kept", false);
+    EXPECT_THROW(vec.emplace_back("dropped", true), std::runtime_error);
+    ASSERT_EQ(vec.size(), 1);
+    EXPECT_EQ(std::get<0>(vec[0]), "kept");
+}
+
+TEST(soa_vector, row_iteration) {
+    mg::soa_vector<int, int> vec{ { 1, 2 }, { 3, 4 }, { 5, 6 } };
+
+    for (auto [first, second] : vec)
+    {
+        second += first;
+    }
+
+    EXPECT_THAT(vec.column<1>(), testing::ElementsAre(3, 7, 11));
+    EXPECT_EQ(vec.end() - vec.begin(), 3);
+    EXPECT_EQ(std::get<0>(vec.cbegin()[2]), 5);
+}
+
+TEST(soa_vector, zipped_columns) {
+    mg::soa_vector<float, int, float> vec;
+    for (int i = 0; i < 16; ++i)
+    {
+        vec.emplace_back(static_cast<float>(i), i, 0.0f);
+    }
+
+    mg::iter_zipped_ranges(
+        [](float in, float& out) { out = in * 2; },
+        vec.column<0>(), vec.column<2>());
+
+    auto outputs = vec.column<2>();
+    EXPECT_EQ(std::accumulate(outputs.begin(), outputs.end(), 0.0f), 240.0f);
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mg/static_map.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+    enum class opcode : std::uint8_t
+    {
+        add,
+        sub,
+        mul,
+        div,
+        halt
+    };
+
+    int apply_add(int p_lhs, int p_rhs) { return p_lhs + p_rhs; }
+    int apply_sub(int p_lhs, int p_rhs) { return p_lhs - p_rhs; }
+    int apply_mul(int p_lhs, int p_rhs) { return p_lhs * p_rhs; }
+
+    template <std::size_t N>
+    constexpr std::array<std::pair<std::uint32_t, std::uint32_t>, N> squares()
+    {
+        std::array<std::pair<std::uint32_t, std::uint32_t>, N> entries{};
+        for (std::uint32_t i = 0; i < N; ++i)
+        {
+            entries[i] = { i * 7919, i * i };
+        }
+
+        return entries;
+    }
+
+    /// <summary>
+    /// A hash which sends every key to the same value, so that no perfect hash exists.
+    /// </summary>
+    struct constant_hash
+    {
+        constexpr std::uint64_t operator()(int) const noexcept
+        {
+            return 42;
+        }
+    };
+}
+
+TEST(static_map, string_keys) {
+    constexpr auto keywords = mg::make_static_map<std::string_view, int>({
+        { "if", 1 }, { "else", 2 }, { "for", 3 }, { "while", 4 }, { "return", 5 }, { "break", 6 }, { "continue", 7 } });
+    static_assert(keywords.is_perfect());
+    static_assert(keywords.size() == 7);
+    static_assert(keywords.at("while") == 4);
+    static_assert(!keywords.contains("do"));
+
+    EXPECT_EQ(*keywords.find("return"), 5);
+    EXPECT_EQ(keywords.find(""), nullptr);
+    EXPECT_EQ(keywords.find("whilst"), nullptr);
+    EXPECT_EQ(keywords.at(std::string("continue")), 7);
+
+    std::set<int> values;
+    for (const auto& [key, value] : keywords)
+    {
+        EXPECT_EQ(keywords.at(key), value);
+        values.insert(value);
+    }
+
+    EXPECT_THAT(values, ::testing::ElementsAre(1, 2, 3, 4, 5, 6, 7));
+}
+
+TEST(static_map, enum_keys_to_handlers) {
+    using handler = int (*)(int, int);
+    constexpr auto handlers = mg::make_static_map<opcode, handler>({
+        { opcode::add, &apply_add }, { opcode::sub, &apply_sub }, { opcode::mul, &apply_mul } });
+    static_assert(handlers.contains(opcode::mul));
+    static_assert(!handlers.contains(opcode::halt));
+
+    EXPECT_EQ(handlers.at(opcode::add)(3, 4), 7);
+    EXPECT_EQ(handlers.at(opcode::sub)(3, 4), -1);
+    EXPECT_EQ(handlers.at(opcode::mul)(3, 4), 12);
+    EXPECT_EQ(handlers.find(opcode::div), nullptr);
+    EXPECT_THROW((void)handlers.at(opcode::halt), std::out_of_range);
+}
+
+TEST(static_map, many_keys) {
+    constexpr mg::static_map<std::uint32_t, std::uint32_t, 2000> map(squares<2000>());
+    static_assert(map.is_perfect());
+    static_assert(map.at(1999 * 7919) == 1999 * 1999);
+
+    for (std::uint32_t i = 0; i < 2000; ++i)
+    {
+        ASSERT_EQ(map.at(i * 7919), i * i) << i;
+        ASSERT_FALSE(map.contains(i * 7919 + 1)) << i;
+    }
+}
+
+TEST(static_map, falls_back_to_binary_search) {
+    // With no budget the search for a perfect hash fails immediately.
+    constexpr mg::static_map<std::uint32_t, std::uint32_t, 100> map(squares<100>(), 0);
+    static_assert(!map.is_perfect());
+    static_assert(map.at(99 * 7919) == 99 * 99);
+
+    for (std::uint32_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(map.at(i * 7919), i * i) << i;
+        ASSERT_FALSE(map.contains(i * 7919 + 1)) << i;
+    }
+
+    EXPECT_FALSE(map.contains(100 * 7919));
+    EXPECT_TRUE(std::is_sorted(map.begin(), map.end()));
+}
+
+TEST(static_map, falls_back_on_colliding_hashes) {
+    constexpr mg::static_map<int, char, 3, constant_hash> map({ { { 3, 'c' }, { 1, 'a' }, { 2, 'b' } } });
+    static_assert(!map.is_perfect());
+
+    EXPECT_EQ(map.at(1), 'a');
+    EXPECT_EQ(map.at(2), 'b');
+    EXPECT_EQ(map.at(3), 'c');
+    EXPECT_FALSE(map.contains(0));
+    EXPECT_FALSE(map.contains(4));
+}
+
+TEST(static_map, duplicate_keys) {
+    EXPECT_THROW((mg::make_static_map<std::string_view, int>({ { "a", 1 }, { "b", 2 }, { "a", 3 } })), std::invalid_argument);
+    EXPECT_THROW((mg::static_map<int, char, 2, constant_hash>({ { { 1, 'a' }, { 1, 'b' } } })), std::invalid_argument);
+}
+
+TEST(static_map, built_at_runtime) {
+    const auto map = mg::make_static_map<std::string, std::string>({ { "one", "1" }, { "two", "2" }, { "three", "3" } });
+    EXPECT_TRUE(map.is_perfect());
+    EXPECT_EQ(map.at("two"), "2");
+    EXPECT_FALSE(map.contains("four"));
+}
+
+TEST(static_map, empty) {
+    constexpr mg::static_map<int, int, 0> map({});
+    static_assert(map.empty());
+    static_assert(!map.contains(0));
+    EXPECT_EQ(map.begin(), map.end());
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <mg/memory.hpp>
+#include <mg/task.hpp>
+#include <mg/thread_pool.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    mg::task<int> value(int p_value)
+    {
+        co_return p_value;
+    }
+
+    mg::task<int> sum_chain(int p_depth)
+    {
+        // Each level awaits the next, and is resumed by the next's final suspend.
+        if (p_depth == 0)
+        {
+            co_return 0;
+        }
+
+        co_return 1 + co_await sum_chain(p_depth - 1);
+    }
+
+    mg::task<std::string> failing()
+    {
+        co_await value(1);
+        throw std::runtime_error("failed");
+    }
+
+    mg::task<> append(std::vector<int>& p_out, int p_value)
+    {
+        p_out.push_back(co_await value(p_value));
+    }
+
+    mg::task<int> allocated(std::allocator_arg_t, mg::arena_allocator<std::byte>, int p_value)
+    {
+        co_return co_await value(p_value) * 2;
+    }
+
+    mg::task<std::thread::id> on_pool(mg::thread_pool& p_pool, bool& p_wasWorker)
+    {
+        co_await mg::resume_on(p_pool);
+        p_wasWorker = p_pool.is_worker_thread();
+        co_return std::this_thread::get_id();
+    }
+}
+
+TEST(task, runs_when_awaited) {
+    bool started = false;
+    auto lazy = [&started]() -> mg::task<int>
+    {
+        started = true;
+        co_return 3;
+    };
+
+    auto pending = lazy();
+    EXPECT_FALSE(started);
+    EXPECT_TRUE(pending.valid());
+    EXPECT_EQ(mg::sync_wait(std::move(pending)), 3);
+    EXPECT_TRUE(started);
+
+    std::vector<int> out;
+    mg::sync_wait(append(out, 5));
+    EXPECT_EQ(out, std::vector<int>({ 5 }));
+
+    EXPECT_EQ(mg::sync_wait(sum_chain(1000)), 1000);
+}
+
+TEST(task, propagates_exceptions) {
+    EXPECT_THROW(mg::sync_wait(failing()), std::runtime_error);
+
+    auto catching = []() -> mg::task<bool>
+    {
+        try
+        {
+            co_await failing();
+        }
+        catch (const std::runtime_error&)
+        {
+            co_return true;
+        }
+
+        co_return false;
+    };
+
+    EXPECT_TRUE(mg::sync_wait(catching()));
+}
+
+TEST(task, frames_from_allocator) {
+    mg::arena arena(4096);
+    EXPECT_EQ(mg::sync_wait(allocated(std::allocator_arg, mg::arena_allocator<std::byte>(arena), 21)), 42);
+    EXPECT_GT(arena.capacity(), 0);
+}
+
+TEST(task, resumes_on_pool) {
+    mg::thread_pool pool(2);
+    bool wasWorker = false;
+    const auto id = mg::sync_wait(on_pool(pool, wasWorker));
+    EXPECT_TRUE(wasWorker);
+    EXPECT_NE(id, std::this_thread::get_id());
+}
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <mg/thread_pool.hpp>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(thread_pool, submit_results) {
+    mg::thread_pool pool(4);
+
+    auto number = pool.submit([] { return 42; });
+    auto text = pool.submit([] { return std::string("forty two"); });
+    std::atomic<bool> ran{ false };
+    auto nothing = pool.submit([&] { ran = true; });
+
+    EXPECT_EQ(number.get(), 42);
+    EXPECT_EQ(text.get(), "forty two");
+    nothing.get();
+    EXPECT_TRUE(ran);
+    EXPECT_FALSE(number.valid());
+}
+
+TEST(thread_pool, invalid_future) {
+    mg::future<int> empty;
+    EXPECT_FALSE(empty.valid());
+    EXPECT_FALSE(empty.is_ready());
+    EXPECT_THROW(empty.wait(), std::logic_error);
+
+    mg::thread_pool pool(1);
+    auto number = pool.submit([] { return 1; });
+    EXPECT_EQ(number.get(), 1);
+    EXPECT_FALSE(number.is_ready());
+    EXPECT_THROW(number.get(), std::logic_error);
+}
+
+TEST(thread_pool, exceptions_propagate) {
+    mg::thread_pool pool(2);
+    auto failing = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+    EXPECT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST(thread_pool, many_tasks) {
+    mg::thread_pool pool(4);
+
+    std::vector<mg::future<int>> futures;
+    for (int i = 0; i < 10000; ++i)
+    {
+        futures.push_back(pool.submit([i] { return i; }));
+    }
+
+    long long sum = 0;
+    for (auto& f : futures)
+    {
+        sum += f.get();
+    }
+
+    EXPECT_EQ(sum, 10000LL * 9999 / 2);
+}
+
+namespace
+{
+    int fib(mg::thread_pool& p_pool, int p_n)
+    {
+        if (p_n < 2)
+        {
+            return p_n;
+        }
+
+        auto left = p_pool.submit([&p_pool, p_n] { return fib(p_pool, p_n - 1); });
+        auto right = fib(p_pool, p_n - 2);
+        return left.get() + right;
+    }
+}
+
+TEST(thread_pool, nested_fork_join) {
+    mg::thread_pool pool(3);
+    auto result = pool.submit([&] { return fib(pool, 18); });
+    EXPECT_EQ(result.get(), 2584);
+}
+
+TEST(thread_pool, parallel_for_visits_every_element) {
+    mg::thread_pool pool(4);
+
+    std::vector<int> values(100000, 0);
+    EXPECT_TRUE(pool.parallel_for(values, 128, [](int& value) { ++value; }));
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), 0), 100000);
+
+    std::vector<int> empty;
+    EXPECT_TRUE(pool.parallel_for(empty, 16, [](int&) { FAIL(); }));
+}
+
+TEST(thread_pool, parallel_for_nested) {
+    mg::thread_pool pool(2);
+
+    std::vector<std::vector<int>> rows(64, std::vector<int>(64, 1));
+    std::atomic<int> total{ 0 };
+    pool.parallel_for(rows, 1, [&](std::vector<int>& row)
+        {
+            pool.parallel_for(row, 8, [&](int value) { total += value; });
+        });
+
+    EXPECT_EQ(total, 64 * 64);
+}
+
+TEST(thread_pool, parallel_for_exception) {
+    mg::thread_pool pool(4);
+
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+    EXPECT_THROW(
+        pool.parallel_for(values, 10, [](int value)
+            {
+                if (value == 5000)
+                {
+                    throw std::runtime_error("bad element");
+                }
+            }),
+        std::runtime_error);
+}
+
+TEST(thread_pool, cancellation) {
+    mg::thread_pool pool(2);
+
+    std::stop_source source;
+    source.request_stop();
+    auto cancelled = pool.submit(source.get_token(), [] { return 1; });
+    EXPECT_THROW(cancelled.get(), mg::operation_cancelled);
+
+    std::vector<int> values(1000);
+    std::atomic<int> visited{ 0 };
+    EXPECT_FALSE(pool.parallel_for(values, 1, [&](int) { ++visited; }, source.get_token()));
+    EXPECT_EQ(visited, 0);
+
+    auto observed = pool.submit([](std::stop_token p_token) { return p_token.stop_requested(); });
+    EXPECT_FALSE(observed.get());
+    pool.request_stop();
+    auto observedAfter = pool.submit([](std::stop_token p_token) { return p_token.stop_requested(); });
+    EXPECT_TRUE(observedAfter.get());
+}
+
+TEST(thread_pool, destruction_runs_queued_tasks) {
+    std::atomic<int> ran{ 0 };
+    {
+        mg::thread_pool pool(1);
+        for (int i = 0; i < 1000; ++i)
+        {
+            pool.submit([&] { ++ran; });
+        }
+    }
+
+    EXPECT_EQ(ran, 1000);
+}
+
+TEST(thread_pool, pins_more_workers_than_cpus) {
+    const auto workers = 2 * std::max(1u, std::thread::hardware_concurrency()) + 1;
+    mg::thread_pool pool(mg::thread_pool::options{ .thread_count = workers, .pin_threads = true });
+    EXPECT_EQ(pool.thread_count(), workers);
+
+    std::vector<mg::future<int>> futures;
+    for (std::size_t i = 0; i < 4 * workers; ++i)
+    {
+        futures.push_back(pool.submit([] {
+#if defined(__linux__)
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            sched_getaffinity(0, sizeof(set), &set);
+            return CPU_COUNT(&set);
+#else
+            return 1;
+#endif
+        }));
+    }
+
+    // Every worker is pinned, so wherever a task runs it sees exactly one allowed CPU.
+    for (auto& f : futures)
+    {
+        EXPECT_EQ(f.get(), 1);
+    }
+}
@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+
+#include <mg/thread_pool.hpp>
+#include <mg/timer_wheel.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <latch>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Simulated time, shared between the test and the copy of the clock held by the wheel.
+    struct manual_clock
+    {
+        using duration = std::chrono::milliseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<manual_clock, duration>;
+
+        time_point now() const
+        {
+            return *m_now;
+        }
+
+        void advance(duration p_delta) const
+        {
+            *m_now += p_delta;
+        }
+
+        std::shared_ptr<time_point> m_now = std::make_shared<time_point>();
+    };
+
+    using ms = std::chrono::milliseconds;
+}
+
+TEST(timer_wheel, fires_at_deadlines_never_early) {
+    const manual_clock clock;
+    mg::timer_wheel<manual_clock> timers(nullptr, ms(1), clock);
+
+    std::mt19937_64 rng(11);
+    std::vector<std::int64_t> deadlines;
+    std::vector<std::int64_t> firedAt;
+    for (int i = 0; i < 5000; ++i)
+    {
+        // A mix of short delays and ones reaching the higher levels.
+        const auto delay = static_cast<std::int64_t>(rng() % (i % 2 == 0 ? 200 : 5'000'000));
+        deadlines.push_back(delay);
+        firedAt.push_back(-1);
+        timers.schedule_after(ms(delay), [&firedAt, &clock, i] { firedAt[i] = clock.now().time_since_epoch().count(); });
+    }
+
+    EXPECT_EQ(timers.size(), 5000);
+    std::size_t fired = 0;
+    while (timers.size() != 0)
+    {
+        const auto next = timers.next_expiry();
+        ASSERT_TRUE(next.has_value());
+        ASSERT_GE(*next, clock.now());
+
+        clock.advance(ms(1 + static_cast<std::int64_t>(rng() % 3000)));
+        fired += timers.poll();
+    }
+
+    EXPECT_EQ(fired, 5000);
+    EXPECT_FALSE(timers.next_expiry().has_value());
+    for (std::size_t i = 0; i < deadlines.size(); ++i)
+    {
+        // Fired on the first poll at or after the deadline.
+        EXPECT_GE(firedAt[i], deadlines[i]) << i;
+        EXPECT_LT(firedAt[i] - deadlines[i], 3000) << i;
+    }
+}
+
+TEST(timer_wheel, exact_deadlines_across_levels) {
+    const manual_clock clock;
+    mg::timer_wheel<manual_clock> timers(nullptr, ms(1), clock);
+
+    for (std::int64_t delay : { std::int64_t(0), std::int64_t(1), std::int64_t(63), std::int64_t(64), std::int64_t(4095), std::int64_t(4097), std::int64_t(1) << 20, std::int64_t(1) << 40 })
+    {
+        bool fired = false;
+        timers.schedule_after(ms(delay), [&] { fired = true; });
+
+        if (delay > 0)
+        {
+            timers.advance_to(clock.now() + ms(delay - 1));
+            EXPECT_FALSE(fired) << delay;
+        }
+
+        clock.advance(ms(delay));
+        EXPECT_EQ(timers.poll(), 1) << delay;
+        EXPECT_TRUE(fired) << delay;
+    }
+}
+
+TEST(timer_wheel, cancel) {
+    const manual_clock clock;
+    mg::timer_wheel<manual_clock> timers(nullptr, ms(10), clock);
+
+    int fired = 0;
+    std::vector<mg::timer_handle> handles;
+    for (int i = 0; i < 100; ++i)
+    {
+        handles.push_back(timers.schedule_after(ms(i * 100), [&] { ++fired; }));
+    }
+
+    for (std::size_t i = 0; i < handles.size(); i += 2)
+    {
+        EXPECT_TRUE(timers.cancel(handles[i]));
+        EXPECT_FALSE(timers.cancel(handles[i]));
+    }
+
+    EXPECT_EQ(timers.size(), 50);
+    clock.advance(ms(10'000));
+    EXPECT_EQ(timers.poll(), 50);
+    EXPECT_EQ(fired, 50);
+
+    // Expired and default handles cancel nothing, even once their nodes are reused.
+    timers.schedule_after(ms(5), [&] { ++fired; });
+    EXPECT_FALSE(timers.cancel(handles[1]));
+    EXPECT_FALSE(timers.cancel(mg::timer_handle{}));
+    EXPECT_EQ(timers.size(), 1);
+}
+
+TEST(timer_wheel, callbacks_run_inline) {
+    const manual_clock clock;
+    mg::timer_wheel<manual_clock> timers(nullptr, ms(1), clock);
+
+    // Callbacks may schedule more timers, and one throwing does not stop the others.
+    int ran = 0;
+    timers.schedule_after(ms(5), [&]
+        {
+            ++ran;
+            timers.schedule_after(ms(5), [&] { ++ran; });
+        });
+    timers.schedule_after(ms(5), [] { throw std::runtime_error("failed"); });
+    timers.schedule_after(ms(5), [&] { ++ran; });
+
+    clock.advance(ms(5));
+    EXPECT_THROW(timers.poll(), std::runtime_error);
+    EXPECT_EQ(ran, 2);
+
+    clock.advance(ms(5));
+    EXPECT_EQ(timers.poll(), 1);
+    EXPECT_EQ(ran, 3);
+
+    EXPECT_THROW(mg::timer_wheel<manual_clock>(nullptr, ms(0), clock), std::invalid_argument);
+    EXPECT_THROW(mg::timer_wheel<manual_clock>(nullptr, ms(1), clock, 0), std::invalid_argument);
+}
+
+TEST(timer_wheel, dispatches_batches_to_executor) {
+    mg::thread_pool pool(2);
+    const manual_clock clock;
+    mg::timer_wheel<manual_clock> timers(&pool, ms(1), clock, 64);
+
+    constexpr int Count = 1000;
+    std::latch done(Count);
+    std::atomic<int> onWorkers{ 0 };
+    for (int i = 0; i < Count; ++i)
+    {
+        timers.schedule_after(ms(i % 10), [&]
+            {
+                onWorkers.fetch_add(pool.is_worker_thread() ? 1 : 0);
+                done.count_down();
+            });
+    }
+
+    clock.advance(ms(10));
+    EXPECT_EQ(timers.poll(), Count);
+    done.wait();
+    EXPECT_EQ(onWorkers.load(), Count);
+}
+
+TEST(timer_wheel, executor_failures_reach_the_handler) {
+    mg::thread_pool pool(2);
+    const manual_clock clock;
+    constexpr int Count = 100;
+    std::latch done(Count);
+    std::atomic<int> failures{ 0 };
+    mg::timer_wheel<manual_clock> timers(&pool, ms(1), clock, 16, [&](std::exception_ptr p_exception)
+        {
+            EXPECT_THROW(std::rethrow_exception(p_exception), std::runtime_error);
+            ++failures;
+        });
+
+    for (int i = 0; i < Count; ++i)
+    {
+        timers.schedule_after(ms(1), [&, i]
+            {
+                done.count_down();
+                if (i % 10 == 0)
+                {
+                    throw std::runtime_error("failed");
+                }
+            });
+    }
+
+    clock.advance(ms(1));
+    EXPECT_EQ(timers.poll(), Count);
+    done.wait();
+    while (failures.load() != Count / 10)
+    {
+        std::this_thread::yield();
+    }
+}
+
+TEST(timer_wheel, executor_failures_rethrown_without_a_handler) {
+    mg::thread_pool pool(1);
+    const manual_clock clock;
+    mg::timer_wheel<manual_clock> timers(&pool, ms(1), clock);
+
+    std::atomic<bool> ran{ false };
+    timers.schedule_after(ms(1), [] { throw std::runtime_error("failed"); });
+    timers.schedule_after(ms(1), [&] { ran = true; });
+    clock.advance(ms(1));
+    EXPECT_EQ(timers.poll(), 2);
+
+    // Both are in one batch, so the failure is recorded before the second callback runs.
+    while (!ran.load())
+    {
+        std::this_thread::yield();
+    }
+
+    EXPECT_THROW(timers.poll(), std::runtime_error);
+    EXPECT_EQ(timers.poll(), 0);
+}
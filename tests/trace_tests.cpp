@@ -0,0 +1,335 @@
+// Built as its own test executable with MG_ENABLE_TRACING=1.
+
+#include <gtest/gtest.h>
+
+#include <mg/trace.hpp>
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace
+{
+    // A minimal JSON reader, strict enough to reject anything a trace viewer would.
+    struct json_value;
+    using json_object = std::map<std::string, json_value>;
+    using json_array = std::vector<json_value>;
+
+    struct json_value
+    {
+        std::variant<std::nullptr_t, bool, double, std::string, std::shared_ptr<json_array>, std::shared_ptr<json_object>> m_value;
+
+        const json_object& object() const { return *std::get<std::shared_ptr<json_object>>(m_value); }
+        const json_array& array() const { return *std::get<std::shared_ptr<json_array>>(m_value); }
+        const std::string& string() const { return std::get<std::string>(m_value); }
+        double number() const { return std::get<double>(m_value); }
+    };
+
+    class json_reader
+    {
+    public:
+        explicit json_reader(std::string p_text)
+            : m_text(std::move(p_text))
+        {
+        }
+
+        json_value read_document()
+        {
+            auto value = read();
+            skip_space();
+            if (m_position != m_text.size())
+            {
+                throw std::runtime_error("Trailing characters.");
+            }
+
+            return value;
+        }
+
+    private:
+        json_value read()
+        {
+            skip_space();
+            const auto c = peek();
+            if (c == '{')
+            {
+                auto object = std::make_shared<json_object>();
+                ++m_position;
+                if (skip_space(), peek() != '}')
+                {
+                    do
+                    {
+                        skip_space();
+                        auto key = read_string();
+                        expect(':');
+                        (*object)[key] = read();
+                    } while (accept(','));
+                }
+
+                expect('}');
+                return { object };
+            }
+
+            if (c == '[')
+            {
+                auto array = std::make_shared<json_array>();
+                ++m_position;
+                if (skip_space(), peek() != ']')
+                {
+                    do
+                    {
+                        array->push_back(read());
+                    } while (accept(','));
+                }
+
+                expect(']');
+                return { array };
+            }
+
+            if (c == '"')
+            {
+                return { read_string() };
+            }
+
+            if (m_text.compare(m_position, 4, "true") == 0) { m_position += 4; return { true }; }
+            if (m_text.compare(m_position, 5, "false") == 0) { m_position += 5; return { false }; }
+            if (m_text.compare(m_position, 4, "null") == 0) { m_position += 4; return { nullptr }; }
+
+            const auto* start = m_text.c_str() + m_position;
+            char* end = nullptr;
+            const auto number = std::strtod(start, &end);
+            if (end == start)
+            {
+                throw std::runtime_error("Expected a value.");
+            }
+
+            m_position += static_cast<std::size_t>(end - start);
+            return { number };
+        }
+
+        std::string read_string()
+        {
+            expect('"');
+            std::string result;
+            while (peek() != '"')
+            {
+                auto c = m_text[m_position++];
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    throw std::runtime_error("Unescaped control character.");
+                }
+
+                if (c == '\\')
+                {
+                    c = m_text[m_position++];
+                    if (c == 'u')
+                    {
+                        c = static_cast<char>(std::stoi(m_text.substr(m_position, 4), nullptr, 16));
+                        m_position += 4;
+                    }
+                    else if (c != '"' && c != '\\' && c != '/')
+                    {
+                        throw std::runtime_error("Unsupported escape.");
+                    }
+                }
+
+                result += c;
+            }
+
+            ++m_position;
+            return result;
+        }
+
+        char peek() const
+        {
+            if (m_position >= m_text.size())
+            {
+                throw std::runtime_error("Unexpected end.");
+            }
+
+            return m_text[m_position];
+        }
+
+        void skip_space()
+        {
+            while (m_position < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_position])))
+            {
+                ++m_position;
+            }
+        }
+
+        bool accept(char p_c)
+        {
+            skip_space();
+            if (peek() == p_c)
+            {
+                ++m_position;
+                return true;
+            }
+
+            return false;
+        }
+
+        void expect(char p_c)
+        {
+            if (!accept(p_c))
+            {
+                throw std::runtime_error(std::string("Expected ") + p_c);
+            }
+        }
+
+        std::string m_text;
+        std::size_t m_position = 0;
+    };
+
+    json_value load(const std::filesystem::path& p_path)
+    {
+        std::ifstream file(p_path);
+        std::stringstream text;
+        text << file.rdbuf();
+        return json_reader(text.str()).read_document();
+    }
+
+    void nested(int p_depth)
+    {
+        MG_TRACE_ZONE("nested");
+        if (p_depth > 0)
+        {
+            nested(p_depth - 1);
+        }
+    }
+
+    std::filesystem::path trace_path(const char* p_name)
+    {
+        return std::filesystem::temp_directory_path() / p_name;
+    }
+}
+
+TEST(trace, writes_valid_nested_events) {
+    static_assert(mg::trace::enabled);
+    const auto path = trace_path("mg_trace_tests.json");
+
+    EXPECT_FALSE(mg::trace::active());
+    {
+        MG_TRACE_ZONE("not recorded");
+    }
+
+    mg::trace::start(path, std::chrono::milliseconds(10));
+    EXPECT_TRUE(mg::trace::active());
+    EXPECT_THROW(mg::trace::start(path), std::logic_error);
+
+    {
+        MG_TRACE_ZONE("main \"quoted\"\n");
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([]
+                {
+                    for (int i = 0; i < 100; ++i)
+                    {
+                        MG_TRACE_ZONE("outer");
+                        nested(3);
+                    }
+                });
+        }
+    }
+
+    mg::trace::stop();
+    EXPECT_FALSE(mg::trace::active());
+    mg::trace::stop();
+
+    const auto document = load(path);
+    const auto& root = document.object();
+    EXPECT_EQ(root.at("otherData").object().at("droppedZones").number(), 0);
+
+    // Every thread's events must nest properly, with non-decreasing timestamps.
+    std::map<double, std::vector<std::string>> stacks;
+    std::map<double, double> lastTimes;
+    std::map<std::string, int> begins;
+    for (const auto& entry : root.at("traceEvents").array())
+    {
+        const auto& event = entry.object();
+        EXPECT_EQ(event.at("pid").number(), 1);
+        const auto tid = event.at("tid").number();
+        const auto ts = event.at("ts").number();
+        const auto& name = event.at("name").string();
+        const auto& phase = event.at("ph").string();
+
+        EXPECT_GE(ts, lastTimes[tid]);
+        lastTimes[tid] = ts;
+
+        auto& stack = stacks[tid];
+        if (phase == "B")
+        {
+            stack.push_back(name);
+            ++begins[name];
+        }
+        else
+        {
+            ASSERT_EQ(phase, "E");
+            ASSERT_FALSE(stack.empty());
+            EXPECT_EQ(stack.back(), name);
+            stack.pop_back();
+        }
+    }
+
+    EXPECT_EQ(stacks.size(), 5);
+    for (const auto& [tid, stack] : stacks)
+    {
+        EXPECT_TRUE(stack.empty()) << tid;
+    }
+
+    EXPECT_EQ(begins.at("main \"quoted\"\n"), 1);
+    EXPECT_EQ(begins.at("outer"), 400);
+    EXPECT_EQ(begins.at("nested"), 1600);
+    EXPECT_EQ(begins.count("not recorded"), 0);
+
+    std::filesystem::remove(path);
+}
+
+TEST(trace, zones_straddling_sessions) {
+    const auto first = trace_path("mg_trace_tests_first.json");
+    const auto second = trace_path("mg_trace_tests_second.json");
+
+    mg::trace::start(first);
+    auto straddling = std::make_unique<mg::trace::zone>("straddling");
+    mg::trace::stop();
+
+    // The end of a zone begun in an earlier session is not written into the next one.
+    mg::trace::start(second);
+    straddling.reset();
+    {
+        MG_TRACE_ZONE("second");
+    }
+    mg::trace::stop();
+
+    const auto events = load(second).object().at("traceEvents").array();
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].object().at("name").string(), "second");
+    EXPECT_EQ(load(first).object().at("traceEvents").array().size(), 1);
+
+    // Nor is the begin of a zone which saw the earlier session but was preempted before pushing.
+    mg::trace::start(first);
+    const auto generation = mg::detail::trace_generation.load();
+    mg::trace::stop();
+    mg::trace::start(second);
+    if (auto* buffer = mg::detail::trace_begin("preempted", generation))
+    {
+        mg::detail::trace_end(buffer, "preempted", generation);
+    }
+
+    mg::trace::stop();
+    EXPECT_TRUE(load(second).object().at("traceEvents").array().empty());
+
+    std::filesystem::remove(first);
+    std::filesystem::remove(second);
+}
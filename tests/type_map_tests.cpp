@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <mg/sequence.hpp>
+#include <mg/type_map.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    struct counted
+    {
+        static inline int constructions = 0;
+
+        counted()
+        {
+            ++constructions;
+        }
+
+        int value = 7;
+    };
+
+    struct pinned
+    {
+        explicit pinned(int p_value)
+            : value(p_value)
+        {
+        }
+
+        pinned(const pinned&) = delete;
+        pinned& operator=(const pinned&) = delete;
+
+        int value;
+    };
+
+    struct slow
+    {
+        slow()
+        {
+            constructions.fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        static inline std::atomic<int> constructions = 0;
+        std::atomic<int> uses = 0;
+    };
+}
+
+TEST(type_sequence, index_of) {
+    using seq = mg::type_sequence<int, double, char, double>;
+    static_assert(seq::index_of<int> == 0);
+    static_assert(seq::index_of<double> == 1);
+    static_assert(seq::index_of<char> == 2);
+    static_assert(seq::index_of<float> == seq::size);
+    static_assert(std::is_same_v<seq::nth<seq::index_of<char>>, char>);
+
+    static_assert(seq::count<double> == 2);
+    static_assert(seq::contains<char>);
+    static_assert(!seq::contains<const char>);
+}
+
+TEST(type_map, lazy_construction) {
+    counted::constructions = 0;
+    mg::type_map<int, counted, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_FALSE(map.contains<counted>());
+    EXPECT_EQ(map.find<counted>(), nullptr);
+    EXPECT_EQ(counted::constructions, 0);
+
+    EXPECT_EQ(map.get<counted>().value, 7);
+    map.get<counted>().value = 9;
+    EXPECT_EQ(map.get<counted>().value, 9);
+    EXPECT_EQ(counted::constructions, 1);
+
+    EXPECT_TRUE(map.contains<counted>());
+    EXPECT_EQ(map.size(), 1);
+    static_assert(mg::type_map<int, counted>::holds<counted>);
+    static_assert(!mg::type_map<int, counted>::holds<long>);
+}
+
+TEST(type_map, emplace_and_reset) {
+    mg::type_map<int, std::string, pinned> map;
+    EXPECT_EQ(map.get_or_emplace<std::string>(3, 'a'), "aaa");
+    EXPECT_EQ(map.get_or_emplace<std::string>("unused"), "aaa");
+    EXPECT_EQ(map.emplace<std::string>("replaced"), "replaced");
+    EXPECT_EQ(map.get_or_emplace<pinned>(4).value, 4);
+
+    const auto& view = map;
+    ASSERT_NE(view.find<std::string>(), nullptr);
+    EXPECT_EQ(*view.find<std::string>(), "replaced");
+    EXPECT_EQ(view.find<int>(), nullptr);
+
+    map.reset<std::string>();
+    EXPECT_FALSE(map.contains<std::string>());
+    EXPECT_EQ(map.size(), 1);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(type_map, copies_are_independent) {
+    mg::type_map<int, std::string> map;
+    map.get<int>() = 3;
+
+    auto copy = map;
+    copy.get<int>() = 4;
+    copy.get<std::string>() = "copy";
+
+    EXPECT_EQ(map.get<int>(), 3);
+    EXPECT_FALSE(map.contains<std::string>());
+    EXPECT_EQ(copy.size(), 2);
+}
+
+TEST(type_map, for_each_present) {
+    mg::type_map<int, double, std::string, char> map;
+    map.get<std::string>() = "s";
+    map.get<int>() = 1;
+    map.get<char>() = 'c';
+
+    std::vector<std::string> visited;
+    const auto record = [&visited](const auto& p_value)
+    {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(p_value)>, std::string>)
+        {
+            visited.push_back(p_value);
+        }
+        else
+        {
+            visited.push_back(std::to_string(p_value));
+        }
+    };
+
+    EXPECT_TRUE(map.for_each(record));
+    EXPECT_EQ(visited, (std::vector<std::string>{ "1", "s", "99" }));
+
+    // Stops on false, and visits the values in place.
+    visited.clear();
+    EXPECT_FALSE(map.for_each([&](auto& p_value)
+    {
+        p_value = p_value + p_value;
+        record(p_value);
+        return visited.size() < 2;
+    }));
+
+    EXPECT_EQ(visited, (std::vector<std::string>{ "2", "ss" }));
+    EXPECT_EQ(map.get<char>(), 'c');
+
+    const auto& view = map;
+    int count = 0;
+    view.for_each([&count](const auto&) { ++count; });
+    EXPECT_EQ(count, 3);
+}
+
+TEST(concurrent_type_map, constructs_once) {
+    mg::concurrent_type_map<slow, pinned> map;
+    std::vector<std::jthread> threads;
+    for (int i = 0; i < 8; ++i)
+    {
+        threads.emplace_back([&map, i]
+        {
+            map.get<slow>().uses.fetch_add(1);
+            const auto& value = map.get_or_emplace<pinned>(i);
+            EXPECT_EQ(map.find<pinned>(), &value);
+        });
+    }
+
+    threads.clear();
+    EXPECT_EQ(slow::constructions.load(), 1);
+    EXPECT_EQ(map.get<slow>().uses.load(), 8);
+    EXPECT_TRUE(map.contains<pinned>());
+
+    int count = 0;
+    map.for_each([&count](auto&) { ++count; });
+    EXPECT_EQ(count, 2);
+}
+
+TEST(concurrent_type_map, retries_after_throw) {
+    struct fragile
+    {
+        explicit fragile(bool p_fail)
+        {
+            if (p_fail)
+            {
+                throw std::runtime_error("construction failed");
+            }
+        }
+    };
+
+    mg::concurrent_type_map<fragile> map;
+    EXPECT_THROW(map.get_or_emplace<fragile>(true), std::runtime_error);
+    EXPECT_FALSE(map.contains<fragile>());
+    map.get_or_emplace<fragile>(false);
+    EXPECT_TRUE(map.contains<fragile>());
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mg/views.hpp>
+
+#include <array>
+#include <deque>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TEST(zip, stops_at_shortest) {
+    std::vector longer{ 1, 2, 3 };
+    std::array shorter{ 4, 5 };
+
+    auto zipped = mg::views::zip(longer, shorter);
+    EXPECT_EQ(zipped.size(), 2);
+
+    std::vector<int> nums;
+    for (auto [i, j] : zipped)
+    {
+        nums.push_back(i);
+        nums.push_back(j);
+    }
+
+    ASSERT_THAT(nums, testing::ElementsAre(1, 4, 2, 5));
+}
+
+TEST(zip, writes_through_and_random_access) {
+    std::vector<int> inputs{ 1, 2, 3, 4 };
+    std::deque<std::string> outputs(4);
+
+    auto zipped = mg::views::zip(inputs, outputs);
+    for (auto [in, out] : zipped)
+    {
+        out = std::to_string(in * in);
+    }
+
+    EXPECT_THAT(outputs, testing::ElementsAre("1", "4", "9", "16"));
+
+    auto it = zipped.begin() + 2;
+    EXPECT_EQ(std::get<0>(*it), 3);
+    EXPECT_EQ(std::get<1>(it[1]), "16");
+    EXPECT_EQ(zipped.end() - zipped.begin(), 4);
+    EXPECT_EQ(std::get<0>(zipped[0]), 1);
+}
+
+TEST(zip, owns_rvalues) {
+    auto zipped = mg::views::zip(std::vector{ 1, 2, 3 }, std::vector{ 10, 20, 30 });
+
+    int sum = 0;
+    for (auto [i, j] : zipped)
+    {
+        sum += i * j;
+    }
+
+    EXPECT_EQ(sum, 140);
+}
+
+TEST(zip, composes_with_standard_adaptors) {
+    std::vector<int> keys{ 1, 2, 3, 4 };
+    std::vector<char> names{ 'a', 'b', 'c', 'd' };
+
+    auto zipped = mg::views::zip(keys, names);
+    static_assert(std::ranges::view<decltype(zipped)>);
+    static_assert(std::ranges::random_access_range<decltype(zipped)>);
+
+    std::vector<char> reversed;
+    for (auto [key, name] : zipped | std::views::reverse | std::views::take(3))
+    {
+        reversed.push_back(name);
+    }
+
+    EXPECT_THAT(reversed, testing::ElementsAre('d', 'c', 'b'));
+    EXPECT_EQ(std::get<0>(zipped.back()), 4);
+}
+
+TEST(chunk, contiguous_static_extent) {
+    std::vector<int> values(10);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto chunks = mg::views::chunk<4>(values);
+    static_assert(std::is_same_v<std::ranges::range_reference_t<decltype(chunks)>, std::span<int, 4>>);
+    static_assert(std::ranges::random_access_range<decltype(chunks)>);
+    static_assert(std::ranges::view<decltype(chunks)>);
+    EXPECT_EQ(chunks.size(), 2);
+
+    std::vector<int> sums;
+    for (auto chunk : chunks)
+    {
+        sums.push_back(std::accumulate(chunk.begin(), chunk.end(), 0));
+    }
+
+    EXPECT_THAT(sums, testing::ElementsAre(6, 22));
+    EXPECT_THAT(chunks.remainder(), testing::ElementsAre(8, 9));
+    EXPECT_EQ(chunks[1][0], 4);
+}
+
+TEST(chunk, non_contiguous) {
+    std::deque<int> values{ 1, 2, 3, 4, 5, 6, 7 };
+
+    auto chunks = mg::views::chunk<3>(values);
+    EXPECT_EQ(chunks.size(), 2);
+
+    std::vector<int> products;
+    for (auto chunk : chunks)
+    {
+        products.push_back(std::accumulate(chunk.begin(), chunk.end(), 1, std::multiplies<>{}));
+    }
+
+    EXPECT_THAT(products, testing::ElementsAre(6, 120));
+    auto remainder = chunks.remainder();
+    EXPECT_THAT(std::vector(remainder.begin(), remainder.end()), testing::ElementsAre(7));
+}
+
+TEST(chunk, pipes_with_standard_adaptors) {
+    std::vector<int> values(11);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto chunks = values | std::views::drop(1) | mg::views::chunk<4>;
+    static_assert(std::ranges::view<decltype(chunks)>);
+    static_assert(std::is_same_v<std::ranges::range_value_t<decltype(chunks)>, std::span<int, 4>>);
+    ASSERT_EQ(chunks.size(), 2);
+    EXPECT_THAT(chunks[1], testing::ElementsAre(5, 6, 7, 8));
+    EXPECT_THAT(chunks.remainder(), testing::ElementsAre(9, 10));
+
+    std::vector<int> firsts;
+    for (const auto chunk : mg::views::chunk<2>(values) | std::views::reverse)
+    {
+        firsts.push_back(chunk[0]);
+    }
+
+    EXPECT_THAT(firsts, testing::ElementsAre(8, 6, 4, 2, 0));
+}
+
+TEST(chunk, exact_and_empty) {
+    std::array<int, 6> exact{ 1, 2, 3, 4, 5, 6 };
+    auto exactChunks = mg::views::chunk<2>(exact);
+    EXPECT_EQ(exactChunks.size(), 3);
+    EXPECT_TRUE(exactChunks.remainder().empty());
+
+    std::vector<int> empty;
+    auto emptyChunks = mg::views::chunk<8>(empty);
+    EXPECT_TRUE(emptyChunks.empty());
+    EXPECT_EQ(emptyChunks.begin(), emptyChunks.end());
+}
@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <mg/alloc_guard.hpp>
+#include <mg/math.hpp>
+#include <mg/wide_int.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    /// <summary>
+    /// Limbs biased toward the values which exercise carries and quotient corrections: zero, one,
+    /// all ones and the high bit, with random limbs between.
+    /// </summary>
+    template <typename T>
+    T structured(std::mt19937_64& p_random, std::size_t p_limbs = T::limb_count)
+    {
+        constexpr std::array<std::uint64_t, 5> special{ 0, 1, ~std::uint64_t(0), std::uint64_t(1) << 63, ~std::uint64_t(0) - 1 };
+        std::array<std::uint64_t, T::limb_count> limbs{};
+        for (std::size_t i = 0; i < p_limbs; ++i)
+        {
+            const auto pick = p_random() % 8;
+            limbs[i] = pick < special.size() ? special[pick] : p_random();
+        }
+
+        return T::from_limbs(limbs);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    __extension__ using int128 = __int128;
+    __extension__ using uint128 = unsigned __int128;
+
+    template <typename T>
+    T from_builtin(uint128 p_value)
+    {
+        return T::from_limbs({ static_cast<std::uint64_t>(p_value), static_cast<std::uint64_t>(p_value >> 64) });
+    }
+
+    template <typename T>
+    uint128 to_builtin(const T& p_value)
+    {
+        return static_cast<uint128>(p_value.limbs()[1]) << 64 | p_value.limbs()[0];
+    }
+#endif
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST(wide_int, matches_int128) {
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 20'000; ++i)
+    {
+        const auto a = to_builtin(structured<mg::wide_uint<128>>(random, 1 + random() % 2));
+        const auto b = to_builtin(structured<mg::wide_uint<128>>(random, 1 + random() % 2));
+        const auto shift = static_cast<std::size_t>(random() % 128);
+
+        const auto ua = from_builtin<mg::wide_uint<128>>(a);
+        const auto ub = from_builtin<mg::wide_uint<128>>(b);
+        ASSERT_EQ(to_builtin(ua + ub), a + b);
+        ASSERT_EQ(to_builtin(ua - ub), a - b);
+        ASSERT_EQ(to_builtin(ua * ub), a * b);
+        ASSERT_EQ(to_builtin(ua << shift), a << shift);
+        ASSERT_EQ(to_builtin(ua >> shift), a >> shift);
+        ASSERT_EQ(ua < ub, a < b);
+        if (b != 0)
+        {
+            ASSERT_EQ(to_builtin(ua / ub), a / b);
+            ASSERT_EQ(to_builtin(ua % ub), a % b);
+        }
+
+        const auto sa = static_cast<int128>(a);
+        const auto sb = static_cast<int128>(b);
+        const auto wa = from_builtin<mg::wide_int<128>>(a);
+        const auto wb = from_builtin<mg::wide_int<128>>(b);
+        ASSERT_EQ(static_cast<int128>(to_builtin(wa >> shift)), sa >> shift);
+        ASSERT_EQ(wa < wb, sa < sb);
+        if (sb != 0 && !(sa == std::numeric_limits<int128>::min() && sb == -1))
+        {
+            ASSERT_EQ(static_cast<int128>(to_builtin(wa / wb)), sa / sb);
+            ASSERT_EQ(static_cast<int128>(to_builtin(wa % wb)), sa % sb);
+        }
+    }
+}
+#endif
+
+TEST(wide_int, conversions) {
+    const mg::wide_int<256> negative(-5);
+    EXPECT_EQ(mg::to_string(negative), "-5");
+    EXPECT_EQ(negative.limbs()[3], ~std::uint64_t(0));
+    EXPECT_EQ(static_cast<int>(negative), -5);
+    EXPECT_EQ(negative.bit_width(), 3u);
+
+    // Widening keeps the value, narrowing truncates, and changing signedness reinterprets.
+    const mg::wide_int<512> wider = negative;
+    EXPECT_EQ(wider, -5);
+    const auto narrower = static_cast<mg::wide_int<128>>(mg::wide_int<256>(1) << 200 | 9);
+    EXPECT_EQ(narrower, 9);
+    const auto reinterpreted = static_cast<mg::wide_uint<256>>(negative);
+    EXPECT_EQ(reinterpreted, std::numeric_limits<mg::wide_uint<256>>::max() - 4);
+    static_assert(std::is_convertible_v<mg::wide_uint<128>, mg::wide_int<256>>);
+    static_assert(!std::is_convertible_v<mg::wide_uint<256>, mg::wide_int<256>>);
+    static_assert(!std::is_convertible_v<mg::wide_uint<256>, mg::wide_uint<128>>);
+
+    EXPECT_EQ(mg::to_string(std::numeric_limits<mg::wide_uint<128>>::max()), "340282366920938463463374607431768211455");
+    EXPECT_EQ(mg::to_string(std::numeric_limits<mg::wide_int<128>>::min()), "-170141183460469231731687303715884105728");
+    EXPECT_EQ(mg::to_string(mg::wide_uint<256>(10'000'000'000'000'000'000ull) * 10), "100000000000000000000");
+    EXPECT_EQ(mg::to_string(mg::wide_uint<128>()), "0");
+    EXPECT_THROW(mg::wide_uint<256>(1) / 0, std::domain_error);
+
+    auto counter = std::numeric_limits<mg::wide_uint<192>>::max();
+    EXPECT_EQ(++counter, 0);
+    EXPECT_EQ(counter--, 0);
+    EXPECT_EQ(counter, std::numeric_limits<mg::wide_uint<192>>::max());
+    EXPECT_EQ(counter << 192, 0);
+    EXPECT_EQ(mg::wide_int<192>(-1) >> 500, -1);
+}
+
+TEST(wide_int, karatsuba_matches_schoolbook) {
+    static_assert(mg::wide_uint<4096>::limb_count >= mg::detail::karatsuba_threshold);
+    constexpr auto N = mg::wide_uint<4096>::limb_count;
+    std::mt19937_64 random(11);
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto a = structured<mg::wide_uint<4096>>(random);
+        const auto b = structured<mg::wide_uint<4096>>(random);
+
+        std::array<std::uint64_t, 2 * N> expected{};
+        std::array<std::uint64_t, 2 * N> actual{};
+        mg::detail::mul_schoolbook(a.limbs().data(), b.limbs().data(), N, expected.data());
+        mg::detail::mul_full<N>(a.limbs().data(), b.limbs().data(), actual.data());
+        ASSERT_EQ(actual, expected);
+
+        const auto low = (a * b).limbs();
+        ASSERT_TRUE(std::equal(low.begin(), low.end(), expected.begin()));
+
+        // Squares take their own path, recognized by the operands being the same limbs.
+        mg::detail::mul_schoolbook(a.limbs().data(), a.limbs().data(), N, expected.data());
+        mg::detail::mul_full<N>(a.limbs().data(), a.limbs().data(), actual.data());
+        ASSERT_EQ(actual, expected);
+
+        auto square = a;
+        square *= square;
+        ASSERT_TRUE(std::equal(square.limbs().begin(), square.limbs().end(), expected.begin()));
+    }
+}
+
+TEST(wide_int, division_identities) {
+    // Divide 2048 bit numbers by divisors of every length, checking q d + r = n and r < d at
+    // twice the width so that nothing wraps.
+    using narrow = mg::wide_uint<2048>;
+    using wide = mg::wide_uint<4096>;
+    std::mt19937_64 random(13);
+    for (int i = 0; i < 2'000; ++i)
+    {
+        const auto dividend = structured<narrow>(random);
+        auto divisor = structured<narrow>(random, 1 + random() % narrow::limb_count);
+        if (divisor == 0)
+        {
+            divisor = 3;
+        }
+
+        const auto quotient = dividend / divisor;
+        const auto remainder = dividend % divisor;
+        ASSERT_LT(remainder, divisor);
+        ASSERT_EQ(wide(quotient) * wide(divisor) + wide(remainder), wide(dividend));
+    }
+
+    const mg::wide_int<1024> negative = -mg::whole_pow(mg::wide_int<1024>(10), mg::wide_int<1024>(200)) - 7;
+    EXPECT_EQ(negative / 10, -mg::whole_pow(mg::wide_int<1024>(10), mg::wide_int<1024>(199)));
+    EXPECT_EQ(negative % 10, -7);
+    EXPECT_EQ(negative % -10, -7);
+}
+
+TEST(wide_int, constexpr_math) {
+    using u256 = mg::wide_uint<256>;
+    constexpr auto power = mg::whole_pow(u256(3), u256(100));
+    static_assert(power % 1'000'000'007 == mg::mod_pow(u256(3), u256(100), u256(1'000'000'007)));
+    EXPECT_EQ(mg::to_string(power), "515377520732011331036461129765621272702107522001");
+
+    // Fermat's little theorem for the Mersenne prime 2^127 - 1, evaluated at compile time.
+    using u128 = mg::wide_uint<128>;
+    constexpr auto mersenne = (u128(1) << 127) - 1;
+    static_assert(mg::mod_pow(u128(3), mersenne - 1, mersenne) == 1);
+
+    EXPECT_EQ(mg::to_string(-mg::whole_pow(mg::wide_int<512>(7), mg::wide_int<512>(60))), "-508021860739623365322188197652216501772434524836001");
+    EXPECT_EQ(mg::whole_pow(mg::wide_uint<4096>(2), mg::wide_uint<4096>(4095)), mg::wide_uint<4096>(1) << 4095);
+}
+
+TEST(wide_int, mod_pow_matches_square_and_multiply) {
+    // Odd moduli take the Montgomery path and even ones the division path; both must agree with
+    // the plainest method over mul_mod.
+    using u1024 = mg::wide_uint<1024>;
+    std::mt19937_64 random(17);
+    for (int i = 0; i < 40; ++i)
+    {
+        const auto modulus = structured<u1024>(random, 1 + random() % u1024::limb_count) | (i % 2 == 0 ? 1 : 2);
+        const auto base = structured<u1024>(random);
+        const auto power = structured<u1024>(random, 1 + random() % 3);
+
+        u1024 expected = 1 % modulus;
+        for (auto bit = power.bit_width(); bit-- > 0;)
+        {
+            expected = mg::mul_mod(expected, expected, modulus);
+            if (((power >> bit) & 1) != 0)
+            {
+                expected = mg::mul_mod(expected, base, modulus);
+            }
+        }
+
+        ASSERT_EQ(mg::mod_pow(base, power, modulus), expected);
+    }
+
+    EXPECT_EQ(mg::mod_pow(u1024(3), u1024(1000), u1024(1) << 200), u1024(mg::wide_uint<256>::from_limbs({ 0x5616937bd3b85b21ull, 0xc4940c56f7867dbeull, 0x39dc42ec08348318ull, 0x29ull })));
+    EXPECT_EQ(mg::mod_pow(u1024(12345), u1024(0), u1024(1)), 0);
+}
+
+TEST(wide_int, allocation_budget) {
+    using u640 = mg::wide_uint<640>;
+    const auto mersenne = (u640(1) << 521) - 1;
+
+    mg::alloc_guard guard;
+    const auto witness = mg::mod_pow(u640(123'456'789), mg::whole_pow(u640(10), u640(30)), mersenne);
+    EXPECT_EQ(mg::mod_pow(u640(5), mersenne - 1, mersenne), 1);
+    EXPECT_EQ(guard.allocations(), 0u);
+    EXPECT_EQ(witness % mg::whole_pow(u640(10), u640(19)), u640(8'650'825'105'862'779'149ull));
+}